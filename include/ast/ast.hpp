@@ -6,10 +6,12 @@
 #include <functional> // for std::function in TypeSafeVisitor
 #include "ast_rtti.hpp"
 #include "ast_allocator.hpp"
+#include "ast_handle.hpp"
 #include "common/token.hpp"
 
 // Define this to include a parent pointer in each AST node, which can be useful
-// for analysis but adds memory overhead.
+// for analysis but adds memory overhead. AstParentIndex (ast_side_table.hpp) gives
+// the same information on demand without growing every node.
 // #define AST_HAS_PARENT_POINTER
 
 namespace Mycelium::Scripting::Lang
@@ -98,6 +100,130 @@ namespace Mycelium::Scripting::Lang
     struct FieldKeywordExpressionNode;
     struct ValueKeywordExpressionNode;
 
+    // --- Node Type List ---
+    // Every AST node type below the root, paired with its direct base type.
+    // Listed in hierarchy pre-order: each type is followed by all of its descendants.
+    // Type ids are positions in this list (AstNode is 0), so a type and its
+    // descendants always occupy a contiguous id range. Passes that need one entry
+    // per node type (dispatch tables, walkers) expand this instead of repeating
+    // the list by hand. New node types must be added here.
+    #define AST_NODE_LIST(X) \
+        X(ErrorNode, AstNode) \
+        X(TokenNode, AstNode) \
+        X(IdentifierNode, AstNode) \
+        X(ExpressionNode, AstNode) \
+        X(LiteralExpressionNode, ExpressionNode) \
+        X(IdentifierExpressionNode, ExpressionNode) \
+        X(ParenthesizedExpressionNode, ExpressionNode) \
+        X(UnaryExpressionNode, ExpressionNode) \
+        X(BinaryExpressionNode, ExpressionNode) \
+        X(AssignmentExpressionNode, ExpressionNode) \
+        X(CallExpressionNode, ExpressionNode) \
+        X(MemberAccessExpressionNode, ExpressionNode) \
+        X(NewExpressionNode, ExpressionNode) \
+        X(ThisExpressionNode, ExpressionNode) \
+        X(CastExpressionNode, ExpressionNode) \
+        X(IndexerExpressionNode, ExpressionNode) \
+        X(TypeOfExpressionNode, ExpressionNode) \
+        X(SizeOfExpressionNode, ExpressionNode) \
+        X(MatchExpressionNode, ExpressionNode) \
+        X(ConditionalExpressionNode, ExpressionNode) \
+        X(RangeExpressionNode, ExpressionNode) \
+        X(EnumMemberExpressionNode, ExpressionNode) \
+        X(FieldKeywordExpressionNode, ExpressionNode) \
+        X(ValueKeywordExpressionNode, ExpressionNode) \
+        X(StatementNode, AstNode) \
+        X(EmptyStatementNode, StatementNode) \
+        X(BlockStatementNode, StatementNode) \
+        X(ExpressionStatementNode, StatementNode) \
+        X(IfStatementNode, StatementNode) \
+        X(WhileStatementNode, StatementNode) \
+        X(ForStatementNode, StatementNode) \
+        X(ForInStatementNode, StatementNode) \
+        X(ReturnStatementNode, StatementNode) \
+        X(BreakStatementNode, StatementNode) \
+        X(ContinueStatementNode, StatementNode) \
+        X(UsingDirectiveNode, StatementNode) \
+        X(DeclarationNode, StatementNode) \
+        X(ParameterNode, DeclarationNode) \
+        X(VariableDeclarationNode, DeclarationNode) \
+        X(GenericParameterNode, DeclarationNode) \
+        X(MemberDeclarationNode, DeclarationNode) \
+        X(FunctionDeclarationNode, MemberDeclarationNode) \
+        X(PropertyDeclarationNode, MemberDeclarationNode) \
+        X(ConstructorDeclarationNode, MemberDeclarationNode) \
+        X(EnumCaseNode, MemberDeclarationNode) \
+        X(TypeDeclarationNode, DeclarationNode) \
+        X(InterfaceDeclarationNode, DeclarationNode) \
+        X(EnumDeclarationNode, DeclarationNode) \
+        X(NamespaceDeclarationNode, DeclarationNode) \
+        X(TypeNameNode, AstNode) \
+        X(QualifiedTypeNameNode, TypeNameNode) \
+        X(ArrayTypeNameNode, TypeNameNode) \
+        X(GenericTypeNameNode, TypeNameNode) \
+        X(MatchArmNode, AstNode) \
+        X(MatchPatternNode, AstNode) \
+        X(EnumPatternNode, MatchPatternNode) \
+        X(RangePatternNode, MatchPatternNode) \
+        X(ComparisonPatternNode, MatchPatternNode) \
+        X(WildcardPatternNode, MatchPatternNode) \
+        X(LiteralPatternNode, MatchPatternNode) \
+        X(PropertyAccessorNode, AstNode) \
+        X(CompilationUnitNode, AstNode)
+
+    // --- Compile-Time Type Ids ---
+    enum class AstTypeId : uint8_t
+    {
+        AstNode,
+        #define AST_TYPE_ID_ENUM(NodeType, BaseType) NodeType,
+        AST_NODE_LIST(AST_TYPE_ID_ENUM)
+        #undef AST_TYPE_ID_ENUM
+    };
+
+    constexpr size_t AST_TYPE_COUNT = 1
+        #define AST_TYPE_COUNT_ONE(NodeType, BaseType) + 1
+        AST_NODE_LIST(AST_TYPE_COUNT_ONE)
+        #undef AST_TYPE_COUNT_ONE
+        ;
+
+    // Base type id for every type id; the root is its own base.
+    constexpr uint8_t AST_BASE_TYPE_IDS[AST_TYPE_COUNT] = {
+        static_cast<uint8_t>(AstTypeId::AstNode),
+        #define AST_BASE_TYPE_ID(NodeType, BaseType) static_cast<uint8_t>(AstTypeId::BaseType),
+        AST_NODE_LIST(AST_BASE_TYPE_ID)
+        #undef AST_BASE_TYPE_ID
+    };
+
+    constexpr bool ast_type_derives_from(uint8_t type_id, uint8_t base_id)
+    {
+        while (type_id != base_id && type_id != 0) {
+            type_id = AST_BASE_TYPE_IDS[type_id];
+        }
+        return type_id == base_id;
+    }
+
+    // Number of descendants of a type, i.e. the length of the id run that follows it.
+    constexpr uint8_t ast_full_derived_count(uint8_t type_id)
+    {
+        size_t last = type_id;
+        while (last + 1 < AST_TYPE_COUNT && ast_type_derives_from(static_cast<uint8_t>(last + 1), type_id)) {
+            last++;
+        }
+        return static_cast<uint8_t>(last - type_id);
+    }
+
+    constexpr bool ast_type_list_is_preorder()
+    {
+        for (size_t id = 1; id < AST_TYPE_COUNT; ++id) {
+            uint8_t base = AST_BASE_TYPE_IDS[id];
+            if (base >= id || id > base + ast_full_derived_count(base)) return false;
+        }
+        return true;
+    }
+
+    static_assert(AST_TYPE_COUNT <= 256, "AST type ids must fit in a uint8_t");
+    static_assert(ast_type_list_is_preorder(), "AST_NODE_LIST must list every type after its base, with descendants kept contiguous");
+
 
     // --- SizedArray Utility ---
     // A simple, non-owning array view for collections of AST nodes.
@@ -105,7 +231,7 @@ namespace Mycelium::Scripting::Lang
     template <typename T>
     struct SizedArray
     {
-        T* values;
+        AstPtr<T> values = nullptr;
         int size;
 
         SizedArray() : values(nullptr), size(0) {}
@@ -115,8 +241,8 @@ namespace Mycelium::Scripting::Lang
             return values[index];
         }
 
-        T* begin() const { return values; }
-        T* end() const { return values + size; }
+        T* begin() const { return ast_ptr_get(values); }
+        T* end() const { return ast_ptr_get(values) + size; }
         bool empty() const { return size == 0; }
         T back() const { return values[size - 1]; }
     };
@@ -227,15 +353,16 @@ namespace Mycelium::Scripting::Lang
         AST_ROOT_TYPE(AstNode) // Root node has no base type
 
         #ifdef AST_HAS_PARENT_POINTER
-        AstNode* parent;
+        AstPtr<AstNode> parent = nullptr;
         #endif
 
-        uint8_t typeId;
-        bool contains_errors;  // Fast error detection flag
-        TokenKind tokenKind;
-        int sourceStart;
-        int sourceLength;
-        int triviaStart;
+        uint8_t typeId = 0;
+        bool contains_errors = false;  // Fast error detection flag
+        uint32_t nodeId = 0;   // Dense per-allocator id, assigned by AstAllocator::alloc<T>()
+        TokenKind tokenKind{};
+        int sourceStart = 0;
+        int sourceLength = 0;
+        int triviaStart = 0;
 
         // Must be implemented in ast.cpp
         void init_with_type_id(uint8_t id);
@@ -255,7 +382,7 @@ namespace Mycelium::Scripting::Lang
     struct ErrorNode : AstNode {
         AST_TYPE(ErrorNode, AstNode)
 
-        ErrorKind kind;
+        ErrorKind kind{};
         std::string error_message;
 
         static ErrorNode* create(ErrorKind k, const char* msg, const Token& token, AstAllocator& allocator) {
@@ -291,166 +418,166 @@ namespace Mycelium::Scripting::Lang
     struct LiteralExpressionNode : ExpressionNode
     {
         AST_TYPE(LiteralExpressionNode, ExpressionNode)
-        LiteralKind kind;
-        TokenNode* token; // Contains the raw text
+        LiteralKind kind{};
+        AstPtr<TokenNode> token = nullptr; // Contains the raw text
     };
 
     struct IdentifierExpressionNode : ExpressionNode
     {
         AST_TYPE(IdentifierExpressionNode, ExpressionNode)
-        IdentifierNode* identifier;
+        AstPtr<IdentifierNode> identifier = nullptr;
     };
 
     struct ParenthesizedExpressionNode : ExpressionNode
     {
         AST_TYPE(ParenthesizedExpressionNode, ExpressionNode)
-        TokenNode* openParen;
-        ExpressionNode* expression;
-        TokenNode* closeParen;
+        AstPtr<TokenNode> openParen = nullptr;
+        AstPtr<ExpressionNode> expression = nullptr;
+        AstPtr<TokenNode> closeParen = nullptr;
     };
 
     struct UnaryExpressionNode : ExpressionNode
     {
         AST_TYPE(UnaryExpressionNode, ExpressionNode)
-        UnaryOperatorKind opKind;
-        TokenNode* operatorToken;
-        ExpressionNode* operand;
-        bool isPostfix;
+        UnaryOperatorKind opKind{};
+        AstPtr<TokenNode> operatorToken = nullptr;
+        AstPtr<ExpressionNode> operand = nullptr;
+        bool isPostfix = false;
     };
 
     struct BinaryExpressionNode : ExpressionNode
     {
         AST_TYPE(BinaryExpressionNode, ExpressionNode)
-        AstNode* left;        // Can be ExpressionNode* or ErrorNode*
-        BinaryOperatorKind opKind;
-        TokenNode* operatorToken;
-        AstNode* right;       // Can be ExpressionNode* or ErrorNode*
+        AstPtr<AstNode> left = nullptr;        // Can be ExpressionNode* or ErrorNode*
+        BinaryOperatorKind opKind{};
+        AstPtr<TokenNode> operatorToken = nullptr;
+        AstPtr<AstNode> right = nullptr;       // Can be ExpressionNode* or ErrorNode*
     };
 
     struct AssignmentExpressionNode : ExpressionNode
     {
         AST_TYPE(AssignmentExpressionNode, ExpressionNode)
-        ExpressionNode* target;
-        AssignmentOperatorKind opKind;
-        TokenNode* operatorToken;
-        ExpressionNode* source;
+        AstPtr<ExpressionNode> target = nullptr;
+        AssignmentOperatorKind opKind{};
+        AstPtr<TokenNode> operatorToken = nullptr;
+        AstPtr<ExpressionNode> source = nullptr;
     };
 
     struct CallExpressionNode : ExpressionNode
     {
         AST_TYPE(CallExpressionNode, ExpressionNode)
-        ExpressionNode* target;
-        TokenNode* openParen;
+        AstPtr<ExpressionNode> target = nullptr;
+        AstPtr<TokenNode> openParen = nullptr;
         SizedArray<AstNode*> arguments;  // Can contain ExpressionNodes or ErrorNodes
         SizedArray<TokenNode*> commas;
-        TokenNode* closeParen;
+        AstPtr<TokenNode> closeParen = nullptr;
     };
 
     struct MemberAccessExpressionNode : ExpressionNode
     {
         AST_TYPE(MemberAccessExpressionNode, ExpressionNode)
-        ExpressionNode* target;
-        TokenNode* dotToken;
-        IdentifierNode* member;
+        AstPtr<ExpressionNode> target = nullptr;
+        AstPtr<TokenNode> dotToken = nullptr;
+        AstPtr<IdentifierNode> member = nullptr;
     };
 
     struct NewExpressionNode : ExpressionNode
     {
         AST_TYPE(NewExpressionNode, ExpressionNode)
-        TokenNode* newKeyword;
-        TypeNameNode* type;
-        CallExpressionNode* constructorCall; // Optional, can be null
+        AstPtr<TokenNode> newKeyword = nullptr;
+        AstPtr<TypeNameNode> type = nullptr;
+        AstPtr<CallExpressionNode> constructorCall = nullptr; // Optional, can be null
     };
 
     struct ThisExpressionNode : ExpressionNode
     {
         AST_TYPE(ThisExpressionNode, ExpressionNode)
-        TokenNode* thisKeyword;
+        AstPtr<TokenNode> thisKeyword = nullptr;
     };
 
     struct CastExpressionNode : ExpressionNode
     {
         AST_TYPE(CastExpressionNode, ExpressionNode)
-        TokenNode* openParen;
-        TypeNameNode* targetType;
-        TokenNode* closeParen;
-        ExpressionNode* expression;
+        AstPtr<TokenNode> openParen = nullptr;
+        AstPtr<TypeNameNode> targetType = nullptr;
+        AstPtr<TokenNode> closeParen = nullptr;
+        AstPtr<ExpressionNode> expression = nullptr;
     };
 
     struct IndexerExpressionNode : ExpressionNode
     {
         AST_TYPE(IndexerExpressionNode, ExpressionNode)
-        ExpressionNode* target;
-        TokenNode* openBracket;
-        ExpressionNode* index;
-        TokenNode* closeBracket;
+        AstPtr<ExpressionNode> target = nullptr;
+        AstPtr<TokenNode> openBracket = nullptr;
+        AstPtr<ExpressionNode> index = nullptr;
+        AstPtr<TokenNode> closeBracket = nullptr;
     };
 
     struct TypeOfExpressionNode : ExpressionNode
     {
         AST_TYPE(TypeOfExpressionNode, ExpressionNode)
-        TokenNode* typeOfKeyword;
-        TokenNode* openParen;
-        TypeNameNode* type;
-        TokenNode* closeParen;
+        AstPtr<TokenNode> typeOfKeyword = nullptr;
+        AstPtr<TokenNode> openParen = nullptr;
+        AstPtr<TypeNameNode> type = nullptr;
+        AstPtr<TokenNode> closeParen = nullptr;
     };
 
     struct SizeOfExpressionNode : ExpressionNode
     {
         AST_TYPE(SizeOfExpressionNode, ExpressionNode)
-        TokenNode* sizeOfKeyword;
-        TokenNode* openParen;
-        TypeNameNode* type;
-        TokenNode* closeParen;
+        AstPtr<TokenNode> sizeOfKeyword = nullptr;
+        AstPtr<TokenNode> openParen = nullptr;
+        AstPtr<TypeNameNode> type = nullptr;
+        AstPtr<TokenNode> closeParen = nullptr;
     };
 
     struct MatchExpressionNode : ExpressionNode
     {
         AST_TYPE(MatchExpressionNode, ExpressionNode)
-        TokenNode* matchKeyword;
-        TokenNode* openParen;
-        ExpressionNode* expression;
-        TokenNode* closeParen;
-        TokenNode* openBrace;
+        AstPtr<TokenNode> matchKeyword = nullptr;
+        AstPtr<TokenNode> openParen = nullptr;
+        AstPtr<ExpressionNode> expression = nullptr;
+        AstPtr<TokenNode> closeParen = nullptr;
+        AstPtr<TokenNode> openBrace = nullptr;
         SizedArray<MatchArmNode*> arms;
-        TokenNode* closeBrace;
+        AstPtr<TokenNode> closeBrace = nullptr;
     };
 
     struct ConditionalExpressionNode : ExpressionNode
     {
         AST_TYPE(ConditionalExpressionNode, ExpressionNode)
-        ExpressionNode* condition;
-        TokenNode* question;
-        ExpressionNode* whenTrue;
-        TokenNode* colon;
-        ExpressionNode* whenFalse;
+        AstPtr<ExpressionNode> condition = nullptr;
+        AstPtr<TokenNode> question = nullptr;
+        AstPtr<ExpressionNode> whenTrue = nullptr;
+        AstPtr<TokenNode> colon = nullptr;
+        AstPtr<ExpressionNode> whenFalse = nullptr;
     };
 
     struct RangeExpressionNode : ExpressionNode
     {
         AST_TYPE(RangeExpressionNode, ExpressionNode)
-        ExpressionNode* start;
-        TokenNode* rangeOp; // .. or ..=
-        ExpressionNode* end;
+        AstPtr<ExpressionNode> start = nullptr;
+        AstPtr<TokenNode> rangeOp = nullptr; // .. or ..=
+        AstPtr<ExpressionNode> end = nullptr;
     };
 
     struct EnumMemberExpressionNode : ExpressionNode
     {
         AST_TYPE(EnumMemberExpressionNode, ExpressionNode)
-        TokenNode* dot;
-        IdentifierNode* memberName;
+        AstPtr<TokenNode> dot = nullptr;
+        AstPtr<IdentifierNode> memberName = nullptr;
     };
 
     struct FieldKeywordExpressionNode : ExpressionNode
     {
         AST_TYPE(FieldKeywordExpressionNode, ExpressionNode)
-        TokenNode* fieldKeyword;
+        AstPtr<TokenNode> fieldKeyword = nullptr;
     };
 
     struct ValueKeywordExpressionNode : ExpressionNode
     {
         AST_TYPE(ValueKeywordExpressionNode, ExpressionNode)
-        TokenNode* valueKeyword;
+        AstPtr<TokenNode> valueKeyword = nullptr;
     };
 
     // --- Statements ---
@@ -459,128 +586,128 @@ namespace Mycelium::Scripting::Lang
     struct EmptyStatementNode : StatementNode
     {
         AST_TYPE(EmptyStatementNode, StatementNode)
-        TokenNode* semicolon;
+        AstPtr<TokenNode> semicolon = nullptr;
     };
 
     struct BlockStatementNode : StatementNode
     {
         AST_TYPE(BlockStatementNode, StatementNode)
-        TokenNode* openBrace;
+        AstPtr<TokenNode> openBrace = nullptr;
         // A block can contain both statements and local declarations (including ErrorNodes)
         SizedArray<AstNode*> statements;
-        TokenNode* closeBrace;
+        AstPtr<TokenNode> closeBrace = nullptr;
     };
 
     struct ExpressionStatementNode : StatementNode
     {
         AST_TYPE(ExpressionStatementNode, StatementNode)
-        AstNode* expression;  // Can be ExpressionNode* or ErrorNode*
-        TokenNode* semicolon;
+        AstPtr<AstNode> expression = nullptr;  // Can be ExpressionNode* or ErrorNode*
+        AstPtr<TokenNode> semicolon = nullptr;
     };
 
     struct IfStatementNode : StatementNode
     {
         AST_TYPE(IfStatementNode, StatementNode)
-        TokenNode* ifKeyword;
-        TokenNode* openParen;
-        ExpressionNode* condition;
-        TokenNode* closeParen;
-        StatementNode* thenStatement;
-        TokenNode* elseKeyword; // Optional, can be null
-        StatementNode* elseStatement; // Optional, can be null
+        AstPtr<TokenNode> ifKeyword = nullptr;
+        AstPtr<TokenNode> openParen = nullptr;
+        AstPtr<ExpressionNode> condition = nullptr;
+        AstPtr<TokenNode> closeParen = nullptr;
+        AstPtr<StatementNode> thenStatement = nullptr;
+        AstPtr<TokenNode> elseKeyword = nullptr; // Optional, can be null
+        AstPtr<StatementNode> elseStatement = nullptr; // Optional, can be null
     };
 
     struct WhileStatementNode : StatementNode
     {
         AST_TYPE(WhileStatementNode, StatementNode)
-        TokenNode* whileKeyword;
-        TokenNode* openParen;
-        ExpressionNode* condition;
-        TokenNode* closeParen;
-        StatementNode* body;
+        AstPtr<TokenNode> whileKeyword = nullptr;
+        AstPtr<TokenNode> openParen = nullptr;
+        AstPtr<ExpressionNode> condition = nullptr;
+        AstPtr<TokenNode> closeParen = nullptr;
+        AstPtr<StatementNode> body = nullptr;
     };
 
     struct ForStatementNode : StatementNode
     {
         AST_TYPE(ForStatementNode, StatementNode)
-        TokenNode* forKeyword;
-        TokenNode* openParen;
-        StatementNode* initializer; // VariableDeclarationNode or ExpressionStatementNode
-        ExpressionNode* condition;
-        TokenNode* firstSemicolon;
+        AstPtr<TokenNode> forKeyword = nullptr;
+        AstPtr<TokenNode> openParen = nullptr;
+        AstPtr<StatementNode> initializer = nullptr; // VariableDeclarationNode or ExpressionStatementNode
+        AstPtr<ExpressionNode> condition = nullptr;
+        AstPtr<TokenNode> firstSemicolon = nullptr;
         SizedArray<ExpressionNode*> incrementors;
-        TokenNode* secondSemicolon;
-        TokenNode* closeParen;
-        StatementNode* body;
+        AstPtr<TokenNode> secondSemicolon = nullptr;
+        AstPtr<TokenNode> closeParen = nullptr;
+        AstPtr<StatementNode> body = nullptr;
     };
 
     struct ForInStatementNode : StatementNode
     {
         AST_TYPE(ForInStatementNode, StatementNode)
-        TokenNode* forKeyword;
-        TokenNode* openParen;
-        StatementNode* mainVariable;  // var i or Type var or just an identifier
-        TokenNode* inKeyword;
-        ExpressionNode* iterable;  // 0..10 or collection
-        TokenNode* atKeyword; // optional
-        StatementNode* indexVariable;  // var i or Type var or just an identifier, optional
-        TokenNode* closeParen;
-        StatementNode* body;
+        AstPtr<TokenNode> forKeyword = nullptr;
+        AstPtr<TokenNode> openParen = nullptr;
+        AstPtr<StatementNode> mainVariable = nullptr;  // var i or Type var or just an identifier
+        AstPtr<TokenNode> inKeyword = nullptr;
+        AstPtr<ExpressionNode> iterable = nullptr;  // 0..10 or collection
+        AstPtr<TokenNode> atKeyword = nullptr; // optional
+        AstPtr<StatementNode> indexVariable = nullptr;  // var i or Type var or just an identifier, optional
+        AstPtr<TokenNode> closeParen = nullptr;
+        AstPtr<StatementNode> body = nullptr;
     };
 
     struct ReturnStatementNode : StatementNode
     {
         AST_TYPE(ReturnStatementNode, StatementNode)
-        TokenNode* returnKeyword;
-        ExpressionNode* expression; // Optional, can be null
-        TokenNode* semicolon;
+        AstPtr<TokenNode> returnKeyword = nullptr;
+        AstPtr<ExpressionNode> expression = nullptr; // Optional, can be null
+        AstPtr<TokenNode> semicolon = nullptr;
     };
 
     struct BreakStatementNode : StatementNode
     {
         AST_TYPE(BreakStatementNode, StatementNode)
-        TokenNode* breakKeyword;
-        TokenNode* semicolon;
+        AstPtr<TokenNode> breakKeyword = nullptr;
+        AstPtr<TokenNode> semicolon = nullptr;
     };
 
     struct ContinueStatementNode : StatementNode
     {
         AST_TYPE(ContinueStatementNode, StatementNode)
-        TokenNode* continueKeyword;
-        TokenNode* semicolon;
+        AstPtr<TokenNode> continueKeyword = nullptr;
+        AstPtr<TokenNode> semicolon = nullptr;
     };
 
     // --- Type Names ---
     struct TypeNameNode : AstNode
     {
         AST_TYPE(TypeNameNode, AstNode)
-        IdentifierNode* identifier;
+        AstPtr<IdentifierNode> identifier = nullptr;
     };
 
     struct QualifiedTypeNameNode : TypeNameNode
     {
         AST_TYPE(QualifiedTypeNameNode, TypeNameNode)
-        TypeNameNode* left;
-        TokenNode* dotToken;
-        IdentifierNode* right;
+        AstPtr<TypeNameNode> left = nullptr;
+        AstPtr<TokenNode> dotToken = nullptr;
+        AstPtr<IdentifierNode> right = nullptr;
     };
 
     struct ArrayTypeNameNode : TypeNameNode
     {
         AST_TYPE(ArrayTypeNameNode, TypeNameNode)
-        TypeNameNode* elementType;
-        TokenNode* openBracket;
-        TokenNode* closeBracket;
+        AstPtr<TypeNameNode> elementType = nullptr;
+        AstPtr<TokenNode> openBracket = nullptr;
+        AstPtr<TokenNode> closeBracket = nullptr;
     };
 
     struct GenericTypeNameNode : TypeNameNode
     {
         AST_TYPE(GenericTypeNameNode, TypeNameNode)
-        TypeNameNode* baseType;
-        TokenNode* openAngle;
+        AstPtr<TypeNameNode> baseType = nullptr;
+        AstPtr<TokenNode> openAngle = nullptr;
         SizedArray<AstNode*> arguments;  // Can contain TypeNameNodes or ErrorNodes
         SizedArray<TokenNode*> commas;
-        TokenNode* closeAngle;
+        AstPtr<TokenNode> closeAngle = nullptr;
     };
 
     // --- Declarations ---
@@ -588,27 +715,27 @@ namespace Mycelium::Scripting::Lang
     {
         AST_TYPE(DeclarationNode, StatementNode)
         SizedArray<ModifierKind> modifiers;
-        IdentifierNode* name;
+        AstPtr<IdentifierNode> name = nullptr;
     };
 
     struct ParameterNode : DeclarationNode
     {
         AST_TYPE(ParameterNode, DeclarationNode)
-        TypeNameNode* type;
-        TokenNode* equalsToken; // Optional, can be null
-        ExpressionNode* defaultValue; // Optional, can be null
+        AstPtr<TypeNameNode> type = nullptr;
+        AstPtr<TokenNode> equalsToken = nullptr; // Optional, can be null
+        AstPtr<ExpressionNode> defaultValue = nullptr; // Optional, can be null
     };
 
     struct VariableDeclarationNode : DeclarationNode
     {
         AST_TYPE(VariableDeclarationNode, DeclarationNode)
-        TokenNode* varKeyword; // Optional, can be null
-        TypeNameNode* type; // Optional, can be null
+        AstPtr<TokenNode> varKeyword = nullptr; // Optional, can be null
+        AstPtr<TypeNameNode> type = nullptr; // Optional, can be null
         // either the var keyword or type must be present
         SizedArray<IdentifierNode*> names; // if only one name then use name otherwise use names
-        TokenNode* equalsToken; // Optional, can be null
-        ExpressionNode* initializer; // Optional, can be null
-        TokenNode* semicolon;
+        AstPtr<TokenNode> equalsToken = nullptr; // Optional, can be null
+        AstPtr<ExpressionNode> initializer = nullptr; // Optional, can be null
+        AstPtr<TokenNode> semicolon = nullptr;
     };
 
     struct MemberDeclarationNode : DeclarationNode
@@ -626,61 +753,63 @@ namespace Mycelium::Scripting::Lang
     struct FunctionDeclarationNode : MemberDeclarationNode
     {
         AST_TYPE(FunctionDeclarationNode, MemberDeclarationNode)
-        TokenNode* fnKeyword;
+        AstPtr<TokenNode> fnKeyword = nullptr;
         // name inherited from DeclarationNode
-        TokenNode* openParen;
+        AstPtr<TokenNode> openParen = nullptr;
         SizedArray<AstNode*> parameters;  // Can contain ParameterNodes or ErrorNodes
-        TokenNode* closeParen;
+        AstPtr<TokenNode> closeParen = nullptr;
         // modifiers inherited from DeclarationNode
-        TokenNode* arrow; // optional -> for return type
-        TypeNameNode* returnType; // optional, after arrow
-        BlockStatementNode* body; // can be null for abstract
-        TokenNode* semicolon; // for abstract functions
+        AstPtr<TokenNode> arrow = nullptr; // optional -> for return type
+        AstPtr<TypeNameNode> returnType = nullptr; // optional, after arrow
+        AstPtr<BlockStatementNode> body = nullptr; // can be null for abstract
+        AstPtr<TokenNode> semicolon = nullptr; // for abstract functions
+        uint64_t structuralHash; // See ast_hash.hpp
     };
 
     struct TypeDeclarationNode : DeclarationNode
     {
         AST_TYPE(TypeDeclarationNode, DeclarationNode)
-        TokenNode* typeKeyword; // always "type"
-        TokenNode* openBrace;
+        AstPtr<TokenNode> typeKeyword = nullptr; // always "type"
+        AstPtr<TokenNode> openBrace = nullptr;
         SizedArray<AstNode*> members;  // Can contain MemberDeclarationNodes or ErrorNodes
-        TokenNode* closeBrace;
+        AstPtr<TokenNode> closeBrace = nullptr;
+        uint64_t structuralHash; // See ast_hash.hpp
     };
 
     struct InterfaceDeclarationNode : DeclarationNode
     {
         AST_TYPE(InterfaceDeclarationNode, DeclarationNode)
-        TokenNode* interfaceKeyword;
+        AstPtr<TokenNode> interfaceKeyword = nullptr;
         // name inherited from DeclarationNode
-        TokenNode* openBrace;
+        AstPtr<TokenNode> openBrace = nullptr;
         SizedArray<MemberDeclarationNode*> members;
-        TokenNode* closeBrace;
+        AstPtr<TokenNode> closeBrace = nullptr;
     };
 
     struct EnumDeclarationNode : DeclarationNode
     {
         AST_TYPE(EnumDeclarationNode, DeclarationNode)
-        TokenNode* enumKeyword;
+        AstPtr<TokenNode> enumKeyword = nullptr;
         // name inherited from DeclarationNode
-        TokenNode* openBrace;
+        AstPtr<TokenNode> openBrace = nullptr;
         SizedArray<EnumCaseNode*> cases;
         SizedArray<FunctionDeclarationNode*> methods; // enums can have methods
-        TokenNode* closeBrace;
+        AstPtr<TokenNode> closeBrace = nullptr;
     };
 
     struct UsingDirectiveNode : StatementNode
     {
         AST_TYPE(UsingDirectiveNode, StatementNode)
-        TokenNode* usingKeyword;
-        TypeNameNode* namespaceName;
-        TokenNode* semicolon;
+        AstPtr<TokenNode> usingKeyword = nullptr;
+        AstPtr<TypeNameNode> namespaceName = nullptr;
+        AstPtr<TokenNode> semicolon = nullptr;
     };
 
     struct NamespaceDeclarationNode : DeclarationNode
     {
         AST_TYPE(NamespaceDeclarationNode, DeclarationNode)
-        TokenNode* namespaceKeyword;
-        BlockStatementNode* body; // File-scoped namespaces might not have braces
+        AstPtr<TokenNode> namespaceKeyword = nullptr;
+        AstPtr<BlockStatementNode> body = nullptr; // File-scoped namespaces might not have braces
     };
 
     // The root of a parsed file
@@ -694,10 +823,10 @@ namespace Mycelium::Scripting::Lang
     struct MatchArmNode : AstNode
     {
         AST_TYPE(MatchArmNode, AstNode)
-        MatchPatternNode* pattern;
-        TokenNode* arrow; // =>
-        ExpressionNode* result; // can be expression or block
-        TokenNode* comma; // optional trailing comma
+        AstPtr<MatchPatternNode> pattern = nullptr;
+        AstPtr<TokenNode> arrow = nullptr; // =>
+        AstPtr<ExpressionNode> result = nullptr; // can be expression or block
+        AstPtr<TokenNode> comma = nullptr; // optional trailing comma
     };
 
     struct MatchPatternNode : AstNode
@@ -708,35 +837,35 @@ namespace Mycelium::Scripting::Lang
     struct EnumPatternNode : MatchPatternNode
     {
         AST_TYPE(EnumPatternNode, MatchPatternNode)
-        TokenNode* dot;
-        IdentifierNode* enumCase;
+        AstPtr<TokenNode> dot = nullptr;
+        AstPtr<IdentifierNode> enumCase = nullptr;
     };
 
     struct RangePatternNode : MatchPatternNode
     {
         AST_TYPE(RangePatternNode, MatchPatternNode)
-        ExpressionNode* start; // optional for open ranges
-        TokenNode* rangeOp; // .. or ..=
-        ExpressionNode* end; // optional for open ranges
+        AstPtr<ExpressionNode> start = nullptr; // optional for open ranges
+        AstPtr<TokenNode> rangeOp = nullptr; // .. or ..=
+        AstPtr<ExpressionNode> end = nullptr; // optional for open ranges
     };
 
     struct ComparisonPatternNode : MatchPatternNode
     {
         AST_TYPE(ComparisonPatternNode, MatchPatternNode)
-        TokenNode* comparisonOp; // <=, >=, <, >
-        ExpressionNode* value;
+        AstPtr<TokenNode> comparisonOp = nullptr; // <=, >=, <, >
+        AstPtr<ExpressionNode> value = nullptr;
     };
 
     struct WildcardPatternNode : MatchPatternNode
     {
         AST_TYPE(WildcardPatternNode, MatchPatternNode)
-        TokenNode* underscore;
+        AstPtr<TokenNode> underscore = nullptr;
     };
 
     struct LiteralPatternNode : MatchPatternNode
     {
         AST_TYPE(LiteralPatternNode, MatchPatternNode)
-        LiteralExpressionNode* literal;
+        AstPtr<LiteralExpressionNode> literal = nullptr;
     };
 
     // --- Properties ---
@@ -744,46 +873,46 @@ namespace Mycelium::Scripting::Lang
     {
         AST_TYPE(PropertyDeclarationNode, MemberDeclarationNode)
         // name inherited from DeclarationNode
-        TokenNode* colon;
-        TokenNode* propKeyword; // optional for full syntax
-        TypeNameNode* type;
-        TokenNode* arrow; // optional for expression-bodied getter
-        ExpressionNode* getterExpression; // for => syntax
-        TokenNode* openBrace; // optional for accessor block
+        AstPtr<TokenNode> colon = nullptr;
+        AstPtr<TokenNode> propKeyword = nullptr; // optional for full syntax
+        AstPtr<TypeNameNode> type = nullptr;
+        AstPtr<TokenNode> arrow = nullptr; // optional for expression-bodied getter
+        AstPtr<ExpressionNode> getterExpression = nullptr; // for => syntax
+        AstPtr<TokenNode> openBrace = nullptr; // optional for accessor block
         SizedArray<PropertyAccessorNode*> accessors;
-        TokenNode* closeBrace; // optional
+        AstPtr<TokenNode> closeBrace = nullptr; // optional
     };
 
     struct PropertyAccessorNode : AstNode
     {
         AST_TYPE(PropertyAccessorNode, AstNode)
         SizedArray<ModifierKind> modifiers; // public, protected, etc.
-        TokenNode* accessorKeyword; // "get" or "set"
-        TokenNode* arrow; // optional =>
-        ExpressionNode* expression; // for => field
-        BlockStatementNode* body; // for { } syntax
+        AstPtr<TokenNode> accessorKeyword = nullptr; // "get" or "set"
+        AstPtr<TokenNode> arrow = nullptr; // optional =>
+        AstPtr<ExpressionNode> expression = nullptr; // for => field
+        AstPtr<BlockStatementNode> body = nullptr; // for { } syntax
     };
 
     // --- Constructor ---
     struct ConstructorDeclarationNode : MemberDeclarationNode
     {
         AST_TYPE(ConstructorDeclarationNode, MemberDeclarationNode)
-        TokenNode* newKeyword;
-        TokenNode* openParen;
+        AstPtr<TokenNode> newKeyword = nullptr;
+        AstPtr<TokenNode> openParen = nullptr;
         SizedArray<ParameterNode*> parameters;
-        TokenNode* closeParen;
-        BlockStatementNode* body;
+        AstPtr<TokenNode> closeParen = nullptr;
+        AstPtr<BlockStatementNode> body = nullptr;
     };
 
     // --- Enum Cases ---
     struct EnumCaseNode : MemberDeclarationNode
     {
         AST_TYPE(EnumCaseNode, MemberDeclarationNode)
-        TokenNode* caseKeyword;
+        AstPtr<TokenNode> caseKeyword = nullptr;
         // name inherited from DeclarationNode
-        TokenNode* openParen; // optional
+        AstPtr<TokenNode> openParen = nullptr; // optional
         SizedArray<ParameterNode*> associatedData; // for Square(x, y, w, h)
-        TokenNode* closeParen; // optional
+        AstPtr<TokenNode> closeParen = nullptr; // optional
     };
 
 
@@ -798,7 +927,7 @@ namespace Mycelium::Scripting::Lang
             return false;
         // This is the core of the fast RTTI check. A node's type ID will be within the
         // range of a base type's ID and its highest-ID derived type.
-        return (static_cast<uint32_t>(node->typeId) - static_cast<uint32_t>(T::sTypeInfo.typeId) <= static_cast<uint32_t>(T::sTypeInfo.fullDerivedCount));
+        return (static_cast<uint32_t>(node->typeId) - static_cast<uint32_t>(T::sTypeId) <= static_cast<uint32_t>(T::sFullDerivedCount));
     }
 
     template <typename T>
@@ -806,7 +935,7 @@ namespace Mycelium::Scripting::Lang
     {
         if (node == nullptr)
             return false;
-        return node->typeId == T::sTypeInfo.typeId;
+        return node->typeId == T::sTypeId;
     }
 
     template <typename T>
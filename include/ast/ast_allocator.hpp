@@ -4,13 +4,17 @@
 #include <cstddef>
 #include <vector>
 #include <cstring> // Include for memset
+#include <type_traits>
+#include "ast_handle.hpp"
 
 namespace Mycelium::Scripting::Lang
 {
     class AstAllocator;
+    struct AstNode;
 
     // A single page of memory for the allocator.
-    // It's a plain data structure managed by the AstAllocator.
+    // It's a plain data structure managed by the AstAllocator. In compressed-handle
+    // builds pages come from the AstArena instead of malloc.
     class AstPage
     {
     public:
@@ -33,6 +37,7 @@ namespace Mycelium::Scripting::Lang
         AstPage* headPage;
         AstPage* currentPage;
         std::vector<AstPage*> allPages; // For easy cleanup
+        uint32_t nextNodeId;            // Dense ids handed out to AST nodes, see NodeSideTable
 
         void new_page();
 
@@ -56,12 +61,16 @@ namespace Mycelium::Scripting::Lang
         {
             void* mem = alloc_bytes(sizeof(T), alignof(T));
             
-            // FIX: Zero-initialize the allocated memory before construction.
-            // This ensures all pointer members are nullptr by default, preventing
-            // crashes from uninitialized pointers.
+            // Zero the padding too. Fields are not left to this: an optimizing
+            // compiler may drop stores made before the constructor runs, so every
+            // node field has its own default initializer.
             memset(mem, 0, sizeof(T));
             
-            return new (mem) T();
+            T* result = new (mem) T();
+            if constexpr (std::is_base_of_v<AstNode, T>) {
+                result->nodeId = nextNodeId++;
+            }
+            return result;
         }
         
         // Allocates an array of T objects (for SizedArray support)
@@ -77,7 +86,16 @@ namespace Mycelium::Scripting::Lang
             // For complex types, we'd need to call constructors
             return static_cast<T*>(mem);
         }
-        
+
+        // Hands out the next node id, for nodes placed with alloc_bytes() instead of alloc<T>().
+        uint32_t next_node_id() { return nextNodeId++; }
+
+        // Number of node ids handed out so far. Every node from this allocator has
+        // an id below this, so it is the size a side table needs.
+        uint32_t node_count() const { return nextNodeId; }
+
+        // Pages in use, for measuring the size of a tree.
+        size_t page_count() const { return allPages.size(); }
     };
 
 } // namespace Mycelium::Scripting::Lang
\ No newline at end of file
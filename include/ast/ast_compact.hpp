@@ -0,0 +1,27 @@
+#pragma once
+
+#include "ast.hpp"
+#include "ast_allocator.hpp"
+
+namespace Mycelium::Scripting::Lang
+{
+    // --- Post-Parse Compaction ---
+    // The parser allocates children before their parents and interleaves token
+    // nodes, error recovery and abandoned speculative parses, so a finished tree
+    // is scattered across its pages. Compaction copies the nodes reachable from
+    // root into a fresh allocator in depth-first pre-order. Each node's child
+    // arrays are placed right after it. Later passes then read memory mostly
+    // front to back.
+    //
+    // Unreachable nodes are left behind. Node ids are reassigned densely in
+    // pre-order. Spans, hashes and source text views are kept as they are.
+    // The original tree is untouched and stays valid as long as its allocator.
+    AstNode* ast_compact_node(AstNode* root, AstAllocator& target);
+
+    template <typename T>
+    T* ast_compact(T* root, AstAllocator& target)
+    {
+        return static_cast<T*>(ast_compact_node(root, target));
+    }
+
+} // namespace Mycelium::Scripting::Lang
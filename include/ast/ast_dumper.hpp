@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include "ast.hpp"
+
+namespace Mycelium::Scripting::Lang
+{
+    class AstTaskPool;
+
+    enum class AstDumpFormat
+    {
+        PseudoCode,  // Source-like listing, as printed by AstPrinterVisitor
+        SExpression, // (NodeType "text" :attr value children...)
+        Json         // {"type": ..., "span": [start, length], "children": [...]}
+    };
+
+    // Accepts "pseudo", "sexpr" or "json". Returns false for anything else.
+    bool parse_ast_dump_format(std::string_view name, AstDumpFormat& out);
+
+    // --- Buffered Dump Output ---
+    // Collects output in one reusable buffer and hands it to the stream or file
+    // descriptor in large writes, so a dump costs one write per block instead of
+    // one logger call per line. Flushes when the buffer fills and on destruction.
+    // A writer without a stream or descriptor keeps everything in the buffer.
+    class AstDumpWriter
+    {
+    private:
+        static constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+        std::string buffer_;
+        std::ostream* stream_ = nullptr;
+        int fd_ = -1;
+
+    public:
+        explicit AstDumpWriter(std::ostream& stream);
+        explicit AstDumpWriter(int fd);
+        AstDumpWriter() = default;
+        ~AstDumpWriter() { flush(); }
+
+        AstDumpWriter(const AstDumpWriter&) = delete;
+        AstDumpWriter& operator=(const AstDumpWriter&) = delete;
+
+        void write(std::string_view text)
+        {
+            buffer_.append(text.data(), text.size());
+            if (buffer_.size() >= FLUSH_THRESHOLD) flush();
+        }
+
+        void put(char c)
+        {
+            buffer_.push_back(c);
+            if (buffer_.size() >= FLUSH_THRESHOLD) flush();
+        }
+
+        void write_int(long long value);
+        void write_indent(int level) { buffer_.append(static_cast<size_t>(level) * 2, ' '); }
+        void flush();
+
+        // Output not yet flushed; everything written, for an in-memory writer.
+        const std::string& buffer() const { return buffer_; }
+    };
+
+    void ast_dump(AstNode* root, AstDumpFormat format, AstDumpWriter& out);
+    void ast_dump(AstNode* root, AstDumpFormat format, std::ostream& out);
+    void ast_dump(AstNode* root, AstDumpFormat format, int fd);
+
+    // Dumps each top-level statement of a compilation unit in parallel and writes
+    // the pieces in order. The output is byte-identical to the serial dump.
+    void ast_dump(AstNode* root, AstDumpFormat format, AstDumpWriter& out, AstTaskPool& pool);
+
+} // namespace Mycelium::Scripting::Lang
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Build with MYCELIUM_AST_COMPRESSED_HANDLES (CMake option of the same name) to
+// store AST child references as 32-bit offsets instead of 8-byte pointers. Node
+// code is written against AstPtr<T> and compiles unchanged either way.
+
+namespace Mycelium::Scripting::Lang
+{
+    // --- AST Arena ---
+    // With compressed handles, every AstAllocator takes its pages from one
+    // process-wide address range reserved up front, so any node or node array can
+    // be named by its 32-bit offset from the start of that range. Pages are
+    // committed as the range fills and recycled when an allocator is destroyed.
+    // The first page is never handed out, so offset 0 can stand for null.
+    class AstArena
+    {
+    public:
+        static constexpr size_t RESERVED_BYTES = size_t(1) << 32;
+        static constexpr size_t PAGE_BYTES = 4096;
+
+        // Start of the reserved range; null until the first page is allocated.
+        static inline uint8_t* base = nullptr;
+
+        static void* allocate_page();
+        static void release_page(void* page);
+
+        // Bytes currently committed, including recycled pages.
+        static size_t committed_bytes();
+    };
+
+    // --- Compressed Handle ---
+    // A 32-bit reference into the AstArena that behaves like T*: it converts to and
+    // from T*, supports ->, * and [], compares against pointers and nullptr, and
+    // static_casts to derived types. Code that needs the pointer itself, for
+    // example to deduce a template argument, calls get().
+    template <typename T>
+    class AstHandle
+    {
+    private:
+        uint32_t offset_ = 0;
+
+        static uint32_t encode(const T* ptr)
+        {
+            if (!ptr) return 0;
+            return static_cast<uint32_t>(reinterpret_cast<const uint8_t*>(ptr) - AstArena::base);
+        }
+
+    public:
+        AstHandle() = default;  // Null
+        AstHandle(std::nullptr_t) : offset_(0) {}
+        AstHandle(T* ptr) : offset_(encode(ptr)) {}
+
+        T* get() const { return offset_ ? reinterpret_cast<T*>(AstArena::base + offset_) : nullptr; }
+        uint32_t offset() const { return offset_; }
+
+        operator T*() const { return get(); }
+        T* operator->() const { return get(); }
+        T& operator*() const { return *get(); }
+        T& operator[](size_t index) const { return get()[index]; }
+
+        template <typename U, typename = std::enable_if_t<!std::is_same_v<U, T>>>
+        explicit operator U*() const { return static_cast<U*>(get()); }
+    };
+
+    // Pointer storage for AST fields: a plain pointer by default, a 32-bit handle
+    // in compressed builds.
+    #ifdef MYCELIUM_AST_COMPRESSED_HANDLES
+    template <typename T> using AstPtr = AstHandle<T>;
+    #else
+    template <typename T> using AstPtr = T*;
+    #endif
+
+    // The raw pointer behind either representation.
+    template <typename T> inline T* ast_ptr_get(T* ptr) { return ptr; }
+    template <typename T> inline T* ast_ptr_get(AstHandle<T> handle) { return handle.get(); }
+
+} // namespace Mycelium::Scripting::Lang
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include "ast.hpp"
+
+namespace Mycelium::Scripting::Lang
+{
+    class AstTaskPool;
+
+    // --- Structural Hashing ---
+    // A 64-bit Merkle hash of a subtree. It covers node kinds, token kinds, names,
+    // literal text, operator kinds and modifiers, and folds in each child's hash in
+    // field order. Source offsets, trivia, node ids and error flags are left out.
+    // Re-parsing unchanged text, or moving a declaration within the file, gives
+    // the same hash. The hash is stable across runs and builds that share the
+    // node layout.
+
+    // Hashes the subtree rooted at node. Null hashes to a fixed value.
+    uint64_t ast_structural_hash(AstNode* node);
+
+    // Hashes the whole tree in one bottom-up pass. Stores the result in
+    // structuralHash on every FunctionDeclarationNode and TypeDeclarationNode, so
+    // a host can compare declarations between edits. Called by Parser::parse().
+    void ast_compute_structural_hashes(CompilationUnitNode* root);
+
+    // Same result, with the top-level statements hashed in parallel on the pool.
+    void ast_compute_structural_hashes(CompilationUnitNode* root, AstTaskPool& pool);
+
+} // namespace Mycelium::Scripting::Lang
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ast.hpp"
+#include "ast_allocator.hpp"
+
+namespace Mycelium::Scripting::Lang
+{
+    // --- Task Pool ---
+    // A fixed set of worker threads that runs batches of independent tasks. Each
+    // worker starts with a contiguous block of task indices in its own queue. It
+    // takes tasks from the front of that block, and when it runs out it steals
+    // from the back of another worker's block. Uneven subtrees therefore balance
+    // out without a shared queue. The thread calling run() works as worker 0.
+    //
+    // run() is not reentrant: a task must not call run() on the same pool.
+    class AstTaskPool
+    {
+    public:
+        using Task = std::function<void(size_t index, unsigned worker)>;
+
+        // 0 picks one worker per hardware thread. 1 runs every task on the caller.
+        explicit AstTaskPool(unsigned worker_count = 0);
+        ~AstTaskPool();
+
+        AstTaskPool(const AstTaskPool&) = delete;
+        AstTaskPool& operator=(const AstTaskPool&) = delete;
+
+        // Workers including the calling thread.
+        unsigned worker_count() const { return workerCount_; }
+
+        // Runs task(i, worker) for every i in [0, count) and returns when all have
+        // finished. If tasks throw, the exception from the lowest index is
+        // rethrown here after the rest of the batch completes.
+        void run(size_t count, const Task& task);
+
+    private:
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<size_t> tasks;
+        };
+
+        unsigned workerCount_;
+        std::vector<std::unique_ptr<WorkerQueue>> queues_;
+        std::vector<std::thread> threads_;
+
+        std::mutex jobMutex_;
+        std::condition_variable jobReady_;
+        std::condition_variable jobDone_;
+        const Task* job_ = nullptr;
+        uint64_t jobGeneration_ = 0;
+        unsigned activeHelpers_ = 0;
+        bool stopping_ = false;
+
+        std::mutex errorMutex_;
+        std::exception_ptr error_;
+        size_t errorIndex_ = 0;
+
+        bool take_local(unsigned worker, size_t& index);
+        bool steal(unsigned worker, size_t& index);
+        void work(unsigned worker);
+        void helper_main(unsigned worker);
+    };
+
+
+    // --- Parallel Passes ---
+    // A pass that can run over sibling subtrees independently opts in by
+    // implementing AstParallelPass. The driver splits the tree into units at
+    // the pass's granularity and calls run() for each unit on the task pool.
+    // Then it calls merge() for each unit on the calling thread, in source order.
+    // Diagnostics are returned in unit order, so the output does not depend on
+    // the number of threads or on scheduling.
+    //
+    // While run() is executing, a pass may only:
+    // - read the tree and any shared state that is not being modified;
+    // - write to nodes inside its own unit;
+    // - write to per-unit slots it sized in begin();
+    // - write side-table entries for nodes inside its unit. NodeSideTable grows
+    //   on demand, so reserve the table in begin().
+
+    enum class AstPassGranularity
+    {
+        TopLevel,      // Each statement of the compilation unit
+        Members,       // Each member of a type, interface or enum, and each other top-level declaration
+        FunctionBodies // The body of each function, constructor and property accessor outside other bodies
+    };
+
+    // One subtree handed to a pass
+    struct AstPassUnit
+    {
+        AstNode* node = nullptr;
+        AstNode* owner = nullptr;     // Declaration the body belongs to (FunctionBodies only)
+        AstNode* ownerType = nullptr; // Enclosing type, interface or enum, if any
+    };
+
+    struct AstPassDiagnostic
+    {
+        AstNode* node = nullptr;
+        std::string message;
+    };
+
+    class AstParallelPass;
+
+    // Per-unit state handed to run() and then to merge()
+    class AstPassContext
+    {
+    private:
+        size_t unitIndex_;
+        unsigned worker_ = 0;
+        std::unique_ptr<AstAllocator> scratch_;
+        std::vector<AstPassDiagnostic> diagnostics_;
+
+        friend std::vector<AstPassDiagnostic> ast_run_parallel_pass(CompilationUnitNode*, AstParallelPass&, AstTaskPool&);
+
+    public:
+        explicit AstPassContext(size_t unit_index) : unitIndex_(unit_index) {}
+
+        // Position of the unit in source order.
+        size_t unit_index() const { return unitIndex_; }
+
+        // Worker that ran the unit. Only meaningful inside run().
+        unsigned worker() const { return worker_; }
+
+        // Allocator private to this unit. It is created on first use and freed
+        // after the unit is merged.
+        AstAllocator& scratch()
+        {
+            if (!scratch_) scratch_ = std::make_unique<AstAllocator>();
+            return *scratch_;
+        }
+
+        void report(AstNode* node, std::string message) { diagnostics_.push_back({ node, std::move(message) }); }
+        const std::vector<AstPassDiagnostic>& diagnostics() const { return diagnostics_; }
+    };
+
+    class AstParallelPass
+    {
+    public:
+        virtual ~AstParallelPass() = default;
+
+        virtual AstPassGranularity granularity() const { return AstPassGranularity::TopLevel; }
+
+        // Runs once before any unit. Size per-unit results and reserve side tables here.
+        virtual void begin(CompilationUnitNode* /*root*/, const std::vector<AstPassUnit>& /*units*/) {}
+
+        // Runs once per unit, possibly on several threads at once.
+        virtual void run(const AstPassUnit& unit, AstPassContext& context) = 0;
+
+        // Runs on the calling thread for each unit in source order, after every run() returned.
+        virtual void merge(const AstPassUnit& /*unit*/, AstPassContext& /*context*/) {}
+    };
+
+    // Splits the tree into disjoint units. The units appear in source order.
+    std::vector<AstPassUnit> ast_collect_pass_units(CompilationUnitNode* root, AstPassGranularity granularity);
+
+    // Runs the pass over the tree and returns the diagnostics of all units in unit order.
+    std::vector<AstPassDiagnostic> ast_run_parallel_pass(CompilationUnitNode* root, AstParallelPass& pass, AstTaskPool& pool);
+
+} // namespace Mycelium::Scripting::Lang
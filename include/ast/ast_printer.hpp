@@ -3,6 +3,7 @@
 #include "ast/ast.hpp"
 #include "ast/ast_allocator.hpp"
 #include "ast/ast_rtti.hpp"
+#include "ast/ast_dumper.hpp"
 #include "common/logger.hpp"
 #include <iostream>
 #include <sstream>
@@ -12,12 +13,14 @@ using namespace Mycelium::Scripting::Common;
 using namespace Mycelium::Scripting;
 using namespace Mycelium;
 
-// A code-like visitor to print AST nodes as pseudo-code
+// A code-like visitor to print AST nodes as pseudo-code. Lines go to the logger
+// by default, or straight into an AstDumpWriter when one is given.
 class AstPrinterVisitor : public StructuralVisitor
 {
 private:
     int indentLevel = 0;
-    std::ostringstream output;
+    std::string output;
+    AstDumpWriter* writer = nullptr;
 
     std::string get_indent() {
         std::string indent;
@@ -26,28 +29,37 @@ private:
     }
 
     void print_line(const std::string& text) {
+        if (writer) {
+            writer->write_indent(indentLevel);
+            writer->write(text);
+            writer->put('\n');
+            return;
+        }
         std::string line = get_indent() + text;
         LOG_INFO(line, LogCategory::AST);
     }
 
     void print_inline(const std::string& text) {
-        output << text;
+        output += text;
     }
 
     void print_modifiers(const SizedArray<ModifierKind>& modifiers) {
         for (int i = 0; i < modifiers.size; i++) {
-            output << to_string(modifiers[i]) << " ";
+            output += to_string(modifiers[i]);
+            output += ' ';
         }
     }
 
     std::string get_node_content() {
-        std::string result = output.str();
-        output.str(""); // Clear the stream
-        output.clear();
+        std::string result = output;
+        output.clear(); // Keeps the capacity for the next line
         return result;
     }
 
 public:
+    AstPrinterVisitor() = default;
+    explicit AstPrinterVisitor(AstDumpWriter& out) : writer(&out) {}
+
     // --- Base Node Types ---
     
     void visit(AstNode* node) override {
@@ -838,10 +850,14 @@ public:
     void visit(CompilationUnitNode* node) override {
         print_line("// Compilation Unit");
         for (auto stmt : node->statements) {
-            if (stmt) {
-                stmt->accept(this);
-                print_line(get_node_content());
-            }
+            if (stmt) print_statement(stmt);
         }
     }
+
+    // Prints one top-level statement as visit(CompilationUnitNode*) does, so
+    // statements can be printed separately and joined (see the parallel ast_dump)
+    void print_statement(AstNode* stmt) {
+        stmt->accept(this);
+        print_line(get_node_content());
+    }
 };
\ No newline at end of file
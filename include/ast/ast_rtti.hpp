@@ -1,6 +1,5 @@
 #pragma once
 
-#include <vector>
 #include <string>
 #include <cstdint>
 
@@ -16,50 +15,55 @@ namespace Mycelium::Scripting::Lang
     typedef void (*AstAcceptFunc)(AstNode* node, StructuralVisitor* visitor);
 
     // RTTI metadata for each AST node type.
-    // An instance of this class is created statically for each node type.
+    // Type ids and derived counts are computed at compile time from AST_NODE_LIST
+    // (see ast.hpp), so every instance is constant-initialized and there is no
+    // startup registration step.
     class AstTypeInfo
     {
     public:
         const char* name;
-        AstTypeInfo* baseType;
-        std::vector<AstTypeInfo*> derivedTypes;
+        const AstTypeInfo* baseType;
         uint8_t typeId;
         uint8_t fullDerivedCount; // The total number of types that inherit from this one.
         AstAcceptFunc acceptFunc;
 
-        AstTypeInfo(const char* name, AstTypeInfo* base_type, AstAcceptFunc accept_func);
-
-        // Initializes the entire RTTI system after all types have been registered.
-        // This crucial step calculates the unique typeId and fullDerivedCount for each type.
-        static void initialize();
+        constexpr AstTypeInfo(const char* name, const AstTypeInfo* base_type, uint8_t type_id, uint8_t full_derived_count, AstAcceptFunc accept_func)
+            : name(name), baseType(base_type), typeId(type_id), fullDerivedCount(full_derived_count), acceptFunc(accept_func) {}
     };
     
-    // Make the ordered type info array globally accessible for tools like the AST printer.
-    extern std::vector<AstTypeInfo*> g_ordered_type_infos;
+    // Type info for every node type, indexed by typeId. Globally accessible for tools like the AST printer.
+    extern const AstTypeInfo* const g_ordered_type_infos[];
 
 
     // This macro is placed inside the declaration of an AST node class/struct.
     // It injects the necessary static members and helper methods for RTTI.
+    // sTypeId and sFullDerivedCount are compile-time constants, so node_is<T> and
+    // switch statements over typeId need no lookups.
     #define AST_TYPE(NodeType, BaseType) \
+        static constexpr uint8_t sTypeId = static_cast<uint8_t>(AstTypeId::NodeType); \
+        static constexpr uint8_t sFullDerivedCount = ast_full_derived_count(sTypeId); \
         static AstTypeInfo sTypeInfo; \
         static void class_accept(AstNode* node, StructuralVisitor* visitor); \
         BaseType* to_base() { return static_cast<BaseType*>(this); } \
-        NodeType() { init_with_type_id(sTypeInfo.typeId); }
+        NodeType() { init_with_type_id(sTypeId); }
 
     // Special macro for the root node (AstNode) which has no base type
     #define AST_ROOT_TYPE(NodeType) \
+        static constexpr uint8_t sTypeId = static_cast<uint8_t>(AstTypeId::NodeType); \
+        static constexpr uint8_t sFullDerivedCount = ast_full_derived_count(sTypeId); \
         static AstTypeInfo sTypeInfo; \
         static void class_accept(AstNode* node, StructuralVisitor* visitor); \
-        NodeType() { init_with_type_id(sTypeInfo.typeId); }
+        NodeType() { init_with_type_id(sTypeId); }
 
     // This macro is placed in the corresponding .cpp file to define the static
-    // sTypeInfo member for an AST node, effectively registering it with the RTTI system.
+    // sTypeInfo member for an AST node. All arguments are constants, so the
+    // definition is constant-initialized.
     #define AST_DECL_IMPL(NodeType, BaseType) \
-        AstTypeInfo NodeType::sTypeInfo(#NodeType, &BaseType::sTypeInfo, &NodeType::class_accept);
+        AstTypeInfo NodeType::sTypeInfo(#NodeType, &BaseType::sTypeInfo, NodeType::sTypeId, NodeType::sFullDerivedCount, &NodeType::class_accept);
 
     // Special macro for the root node (AstNode) which has no base type
     #define AST_DECL_ROOT_IMPL(NodeType) \
-        AstTypeInfo NodeType::sTypeInfo(#NodeType, nullptr, &NodeType::class_accept);
+        AstTypeInfo NodeType::sTypeInfo(#NodeType, nullptr, NodeType::sTypeId, NodeType::sFullDerivedCount, &NodeType::class_accept);
 
     // --- RTTI Helper Functions ---
 
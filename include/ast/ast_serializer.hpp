@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ast.hpp"
+#include "ast_allocator.hpp"
+
+namespace Mycelium::Scripting::Lang
+{
+    // --- Binary AST Format ---
+    // A parsed CompilationUnitNode tree stored as a relocatable image:
+    //
+    //   [AstBinaryHeader][node records + inline arrays][string table]
+    //
+    // Node records are raw node structs whose pointer fields hold (file offset + 1),
+    // with 0 meaning null. SizedArray values point at inline arrays laid out the same
+    // way. string_view fields hold (string index + 1) and keep their length; the
+    // string table is a count, an offset per string and the character data.
+    //
+    // The image is only valid for the same compiler build: the header records a
+    // layout hash over every node type's size and alignment, and the hash of the
+    // source text it was parsed from so stale caches can be rejected.
+
+    // Bump whenever the encoding changes in a way the layout hash cannot detect.
+    constexpr uint32_t AST_BINARY_VERSION = 1;
+
+    struct AstBinaryHeader
+    {
+        char magic[4];           // "MAST"
+        uint32_t version;        // AST_BINARY_VERSION
+        uint64_t layoutHash;     // ast_binary_layout_hash() of the writer
+        uint64_t sourceHash;     // ast_hash_source() of the parsed text
+        uint64_t totalSize;      // Size of the whole image in bytes
+        uint64_t rootOffset;     // Encoded offset of the CompilationUnitNode
+        uint64_t stringsOffset;  // Start of the string table
+        uint32_t nodeCount;      // Node ids in the image run from 0 to nodeCount - 1
+        uint32_t stringCount;
+    };
+
+    // Hash of the source text, stored in the header to invalidate stale caches.
+    uint64_t ast_hash_source(std::string_view source);
+
+    // Hash of the node layouts this build was compiled with.
+    uint64_t ast_binary_layout_hash();
+
+    // Serializes the tree into a binary image. Trees containing ErrorNodes are
+    // rejected, since failed parses should not be cached.
+    bool ast_serialize(CompilationUnitNode* root, std::string_view source, std::vector<uint8_t>& out);
+
+    // Serializes the tree and writes it to disk.
+    bool ast_save_binary(CompilationUnitNode* root, std::string_view source, const std::string& path);
+
+    // A binary AST image, memory-mapped from disk (copy-on-write) or held in memory.
+    class AstBinaryFile
+    {
+    private:
+        uint8_t* data_;
+        size_t size_;
+        bool mapped_;
+        std::vector<uint8_t> buffer_;
+        CompilationUnitNode* relocatedRoot_; // Set once the image has been relocated in place
+
+    public:
+        AstBinaryFile();
+        ~AstBinaryFile();
+
+        AstBinaryFile(const AstBinaryFile&) = delete;
+        AstBinaryFile& operator=(const AstBinaryFile&) = delete;
+
+        bool open(const std::string& path);
+        bool open_memory(std::vector<uint8_t> bytes);
+        void close();
+
+        uint8_t* data() const { return data_; }
+        size_t size() const { return size_; }
+        const AstBinaryHeader* header() const { return reinterpret_cast<const AstBinaryHeader*>(data_); }
+
+        // Checks magic, version, layout and source hashes and the recorded size.
+        bool is_valid(uint64_t expected_source_hash) const;
+
+        // Rewrites the offsets in the image into pointers and returns the root.
+        // The nodes live inside the mapping, so they stay valid until close().
+        // Not available with compressed handles; returns null there.
+        CompilationUnitNode* load_in_place(uint64_t expected_source_hash);
+
+        // Copies the tree into the allocator in one pass, fixing up pointers as it
+        // goes. The returned tree does not reference the file.
+        CompilationUnitNode* load_into(AstAllocator& allocator, uint64_t expected_source_hash);
+    };
+
+} // namespace Mycelium::Scripting::Lang
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "ast.hpp"
+#include "ast_allocator.hpp"
+
+namespace Mycelium::Scripting::Lang
+{
+    // --- Node Side Tables ---
+    // Per-node data kept outside the nodes, in a flat vector indexed by
+    // AstNode::nodeId. A lookup is a bounds check and an array index instead of a
+    // hash of the node pointer. The table grows on demand, so a pass can create one
+    // without knowing the node count; reserve_for() sizes it in one step.
+    //
+    // Ids are only unique within one AstAllocator, so a table must only be used
+    // with nodes from a single tree.
+    template <typename T>
+    class NodeSideTable
+    {
+    private:
+        std::vector<T> values_;
+        T defaultValue_;
+
+    public:
+        using reference = typename std::vector<T>::reference;
+
+        explicit NodeSideTable(T default_value = T()) : defaultValue_(default_value) {}
+
+        void reserve(uint32_t node_count)
+        {
+            if (values_.size() < node_count) values_.resize(node_count, defaultValue_);
+        }
+
+        void reserve_for(const AstAllocator& allocator) { reserve(allocator.node_count()); }
+
+        // Returns the slot for the node, growing the table if needed.
+        reference operator[](const AstNode* node)
+        {
+            reserve(node->nodeId + 1);
+            return values_[node->nodeId];
+        }
+
+        // Returns the stored value, or the default if the node was never set.
+        T get(const AstNode* node) const
+        {
+            return node->nodeId < values_.size() ? values_[node->nodeId] : defaultValue_;
+        }
+
+        void set(const AstNode* node, T value) { (*this)[node] = std::move(value); }
+
+        size_t size() const { return values_.size(); }
+        void clear() { values_.clear(); }
+    };
+
+
+    // --- Parent Index ---
+    // Maps each node to its parent. The index is built by one walk of the tree the
+    // first time a parent is requested, so code that never asks pays nothing.
+    class AstParentIndex
+    {
+    private:
+        AstNode* root_;
+        NodeSideTable<AstNode*> parents_;
+        bool built_;
+
+        void build();
+
+    public:
+        explicit AstParentIndex(AstNode* root);
+
+        // Returns the parent of the node, or null for the root.
+        AstNode* parent_of(const AstNode* node);
+
+        // Returns the nearest ancestor of type T, or null.
+        template <typename T>
+        T* find_ancestor(const AstNode* node)
+        {
+            for (AstNode* current = parent_of(node); current; current = parent_of(current)) {
+                if (T* match = node_cast<T>(current)) return match;
+            }
+            return nullptr;
+        }
+
+        // Drops the index after the tree has been edited; it is rebuilt on the next query.
+        void invalidate();
+    };
+
+} // namespace Mycelium::Scripting::Lang
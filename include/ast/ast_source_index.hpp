@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "ast.hpp"
+
+namespace Mycelium::Scripting::Lang
+{
+    // --- Source Interval Index ---
+    // Answers "which nodes cover source offset X" from the sourceStart/sourceLength
+    // spans recorded by the parser, for editor queries like hover and go-to-definition.
+    //
+    // Entries are sorted by start, with outer spans before inner ones at the same
+    // start, and each entry links to the nearest span that contains it. A query
+    // binary-searches for the last entry starting at or before X, then climbs the
+    // containment links to the first span that still covers X. The climb follows
+    // skew-binary jump pointers, so both steps are O(log n).
+    //
+    // Spans are half-open: [sourceStart, sourceStart + sourceLength). Nodes with an
+    // empty span are left out. The index is built on request only; a parse that
+    // nobody queries does not pay for it.
+    class AstSourceIndex
+    {
+    public:
+        struct Entry
+        {
+            int start;
+            int end;
+            AstNode* node;
+            int parent;    // Nearest containing entry, or -1
+            int jump;      // Skip-ahead ancestor for the climb; the entry itself for roots
+            int depth;     // Depth in the containment tree
+            int treeDepth; // Depth in the AST, orders nodes that share a span
+        };
+
+    private:
+        std::vector<Entry> entries_;
+
+        static void collect(AstNode* root, std::vector<Entry>& out);
+        void link(int from = 0, int open_parent = -1);
+        int find_entry(const AstNode* node) const;
+        int innermost_entry(int offset) const;
+
+    public:
+        AstSourceIndex() = default;
+        explicit AstSourceIndex(AstNode* root) { build(root); }
+
+        void build(AstNode* root);
+        void clear() { entries_.clear(); }
+
+        // Returns the innermost node whose span contains the offset, or null.
+        AstNode* innermost_at(int offset) const;
+
+        // Returns every node whose span contains the offset, innermost first.
+        std::vector<AstNode*> enclosing_at(int offset) const;
+
+        // Swaps the entries of old_node's subtree for new_node's after the caller
+        // has replaced the subtree in the tree. new_node's spans must already be in
+        // the coordinates of the edited text. Ancestors and later nodes are shifted
+        // by the change in length, both in the index and in their own span fields.
+        // Only the new subtree is walked and sorted, and only entries from the edit
+        // on are re-linked. Entries after the edit still shift, so the cost is
+        // linear in them rather than in the whole tree. Returns false if old_node
+        // is not in the index.
+        bool replace_subtree(AstNode* old_node, AstNode* new_node);
+
+        size_t size() const { return entries_.size(); }
+        const std::vector<Entry>& entries() const { return entries_; }
+    };
+
+} // namespace Mycelium::Scripting::Lang
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <type_traits>
+#include "ast.hpp"
+#include "ast_rtti.hpp"
+
+namespace Mycelium::Scripting::Lang
+{
+    // --- Child Field Reflection ---
+    // One overload per node type listing every field that holds child nodes, in
+    // source order. The callback receives each field by reference, either as a
+    // node pointer (ExpressionNode*&, TokenNode*&, ...) or as a SizedArray of node
+    // pointers, so the same description serves read-only walks and passes that
+    // rewrite child pointers.
+    //
+    // VariableDeclarationNode::name is skipped whenever names is populated, since it
+    // is then an alias of names[0]; see ast_visit_aliases below.
+
+    template <typename F> inline void ast_visit_fields(AstNode*, F&&) {}
+    template <typename F> inline void ast_visit_fields(ErrorNode*, F&&) {}
+    template <typename F> inline void ast_visit_fields(TokenNode*, F&&) {}
+    template <typename F> inline void ast_visit_fields(IdentifierNode*, F&&) {}
+
+    // Expressions
+    template <typename F> inline void ast_visit_fields(ExpressionNode*, F&&) {}
+    template <typename F> inline void ast_visit_fields(LiteralExpressionNode* node, F&& f) { f(node->token); }
+    template <typename F> inline void ast_visit_fields(IdentifierExpressionNode* node, F&& f) { f(node->identifier); }
+    template <typename F> inline void ast_visit_fields(ParenthesizedExpressionNode* node, F&& f) { f(node->openParen); f(node->expression); f(node->closeParen); }
+    template <typename F> inline void ast_visit_fields(UnaryExpressionNode* node, F&& f)
+    {
+        if (node->isPostfix) { f(node->operand); f(node->operatorToken); }
+        else { f(node->operatorToken); f(node->operand); }
+    }
+    template <typename F> inline void ast_visit_fields(BinaryExpressionNode* node, F&& f) { f(node->left); f(node->operatorToken); f(node->right); }
+    template <typename F> inline void ast_visit_fields(AssignmentExpressionNode* node, F&& f) { f(node->target); f(node->operatorToken); f(node->source); }
+    template <typename F> inline void ast_visit_fields(CallExpressionNode* node, F&& f) { f(node->target); f(node->openParen); f(node->arguments); f(node->commas); f(node->closeParen); }
+    template <typename F> inline void ast_visit_fields(MemberAccessExpressionNode* node, F&& f) { f(node->target); f(node->dotToken); f(node->member); }
+    template <typename F> inline void ast_visit_fields(NewExpressionNode* node, F&& f) { f(node->newKeyword); f(node->type); f(node->constructorCall); }
+    template <typename F> inline void ast_visit_fields(ThisExpressionNode* node, F&& f) { f(node->thisKeyword); }
+    template <typename F> inline void ast_visit_fields(CastExpressionNode* node, F&& f) { f(node->openParen); f(node->targetType); f(node->closeParen); f(node->expression); }
+    template <typename F> inline void ast_visit_fields(IndexerExpressionNode* node, F&& f) { f(node->target); f(node->openBracket); f(node->index); f(node->closeBracket); }
+    template <typename F> inline void ast_visit_fields(TypeOfExpressionNode* node, F&& f) { f(node->typeOfKeyword); f(node->openParen); f(node->type); f(node->closeParen); }
+    template <typename F> inline void ast_visit_fields(SizeOfExpressionNode* node, F&& f) { f(node->sizeOfKeyword); f(node->openParen); f(node->type); f(node->closeParen); }
+    template <typename F> inline void ast_visit_fields(MatchExpressionNode* node, F&& f)
+    {
+        f(node->matchKeyword); f(node->openParen); f(node->expression); f(node->closeParen);
+        f(node->openBrace); f(node->arms); f(node->closeBrace);
+    }
+    template <typename F> inline void ast_visit_fields(ConditionalExpressionNode* node, F&& f) { f(node->condition); f(node->question); f(node->whenTrue); f(node->colon); f(node->whenFalse); }
+    template <typename F> inline void ast_visit_fields(RangeExpressionNode* node, F&& f) { f(node->start); f(node->rangeOp); f(node->end); }
+    template <typename F> inline void ast_visit_fields(EnumMemberExpressionNode* node, F&& f) { f(node->dot); f(node->memberName); }
+    template <typename F> inline void ast_visit_fields(FieldKeywordExpressionNode* node, F&& f) { f(node->fieldKeyword); }
+    template <typename F> inline void ast_visit_fields(ValueKeywordExpressionNode* node, F&& f) { f(node->valueKeyword); }
+
+    // Statements
+    template <typename F> inline void ast_visit_fields(StatementNode*, F&&) {}
+    template <typename F> inline void ast_visit_fields(EmptyStatementNode* node, F&& f) { f(node->semicolon); }
+    template <typename F> inline void ast_visit_fields(BlockStatementNode* node, F&& f) { f(node->openBrace); f(node->statements); f(node->closeBrace); }
+    template <typename F> inline void ast_visit_fields(ExpressionStatementNode* node, F&& f) { f(node->expression); f(node->semicolon); }
+    template <typename F> inline void ast_visit_fields(IfStatementNode* node, F&& f)
+    {
+        f(node->ifKeyword); f(node->openParen); f(node->condition); f(node->closeParen);
+        f(node->thenStatement); f(node->elseKeyword); f(node->elseStatement);
+    }
+    template <typename F> inline void ast_visit_fields(WhileStatementNode* node, F&& f) { f(node->whileKeyword); f(node->openParen); f(node->condition); f(node->closeParen); f(node->body); }
+    template <typename F> inline void ast_visit_fields(ForStatementNode* node, F&& f)
+    {
+        f(node->forKeyword); f(node->openParen); f(node->initializer); f(node->condition); f(node->firstSemicolon);
+        f(node->incrementors); f(node->secondSemicolon); f(node->closeParen); f(node->body);
+    }
+    template <typename F> inline void ast_visit_fields(ForInStatementNode* node, F&& f)
+    {
+        f(node->forKeyword); f(node->openParen); f(node->mainVariable); f(node->inKeyword); f(node->iterable);
+        f(node->atKeyword); f(node->indexVariable); f(node->closeParen); f(node->body);
+    }
+    template <typename F> inline void ast_visit_fields(ReturnStatementNode* node, F&& f) { f(node->returnKeyword); f(node->expression); f(node->semicolon); }
+    template <typename F> inline void ast_visit_fields(BreakStatementNode* node, F&& f) { f(node->breakKeyword); f(node->semicolon); }
+    template <typename F> inline void ast_visit_fields(ContinueStatementNode* node, F&& f) { f(node->continueKeyword); f(node->semicolon); }
+    template <typename F> inline void ast_visit_fields(UsingDirectiveNode* node, F&& f) { f(node->usingKeyword); f(node->namespaceName); f(node->semicolon); }
+
+    // Declarations
+    template <typename F> inline void ast_visit_fields(DeclarationNode* node, F&& f) { f(node->name); }
+    template <typename F> inline void ast_visit_fields(ParameterNode* node, F&& f) { f(node->type); f(node->name); f(node->equalsToken); f(node->defaultValue); }
+    template <typename F> inline void ast_visit_fields(VariableDeclarationNode* node, F&& f)
+    {
+        f(node->varKeyword); f(node->type);
+        if (node->names.empty()) f(node->name);
+        else f(node->names);
+        f(node->equalsToken); f(node->initializer); f(node->semicolon);
+    }
+    template <typename F> inline void ast_visit_fields(GenericParameterNode* node, F&& f) { f(node->name); }
+    template <typename F> inline void ast_visit_fields(MemberDeclarationNode* node, F&& f) { f(node->name); }
+    template <typename F> inline void ast_visit_fields(FunctionDeclarationNode* node, F&& f)
+    {
+        f(node->fnKeyword); f(node->name); f(node->openParen); f(node->parameters); f(node->closeParen);
+        f(node->arrow); f(node->returnType); f(node->body); f(node->semicolon);
+    }
+    template <typename F> inline void ast_visit_fields(PropertyDeclarationNode* node, F&& f)
+    {
+        f(node->name); f(node->colon); f(node->propKeyword); f(node->type); f(node->arrow);
+        f(node->getterExpression); f(node->openBrace); f(node->accessors); f(node->closeBrace);
+    }
+    template <typename F> inline void ast_visit_fields(ConstructorDeclarationNode* node, F&& f)
+    {
+        f(node->newKeyword); f(node->name); f(node->openParen); f(node->parameters); f(node->closeParen); f(node->body);
+    }
+    template <typename F> inline void ast_visit_fields(EnumCaseNode* node, F&& f) { f(node->caseKeyword); f(node->name); f(node->openParen); f(node->associatedData); f(node->closeParen); }
+    template <typename F> inline void ast_visit_fields(TypeDeclarationNode* node, F&& f) { f(node->typeKeyword); f(node->name); f(node->openBrace); f(node->members); f(node->closeBrace); }
+    template <typename F> inline void ast_visit_fields(InterfaceDeclarationNode* node, F&& f) { f(node->interfaceKeyword); f(node->name); f(node->openBrace); f(node->members); f(node->closeBrace); }
+    template <typename F> inline void ast_visit_fields(EnumDeclarationNode* node, F&& f)
+    {
+        f(node->enumKeyword); f(node->name); f(node->openBrace); f(node->cases); f(node->methods); f(node->closeBrace);
+    }
+    template <typename F> inline void ast_visit_fields(NamespaceDeclarationNode* node, F&& f) { f(node->namespaceKeyword); f(node->name); f(node->body); }
+
+    // Types
+    template <typename F> inline void ast_visit_fields(TypeNameNode* node, F&& f) { f(node->identifier); }
+    // The derived type names leave the inherited identifier null; it is still listed
+    // so that passes copying or relocating nodes never miss a pointer.
+    template <typename F> inline void ast_visit_fields(QualifiedTypeNameNode* node, F&& f) { f(node->identifier); f(node->left); f(node->dotToken); f(node->right); }
+    template <typename F> inline void ast_visit_fields(ArrayTypeNameNode* node, F&& f) { f(node->identifier); f(node->elementType); f(node->openBracket); f(node->closeBracket); }
+    template <typename F> inline void ast_visit_fields(GenericTypeNameNode* node, F&& f)
+    {
+        f(node->identifier); f(node->baseType); f(node->openAngle); f(node->arguments); f(node->commas); f(node->closeAngle);
+    }
+
+    // Match patterns
+    template <typename F> inline void ast_visit_fields(MatchArmNode* node, F&& f) { f(node->pattern); f(node->arrow); f(node->result); f(node->comma); }
+    template <typename F> inline void ast_visit_fields(MatchPatternNode*, F&&) {}
+    template <typename F> inline void ast_visit_fields(EnumPatternNode* node, F&& f) { f(node->dot); f(node->enumCase); }
+    template <typename F> inline void ast_visit_fields(RangePatternNode* node, F&& f) { f(node->start); f(node->rangeOp); f(node->end); }
+    template <typename F> inline void ast_visit_fields(ComparisonPatternNode* node, F&& f) { f(node->comparisonOp); f(node->value); }
+    template <typename F> inline void ast_visit_fields(WildcardPatternNode* node, F&& f) { f(node->underscore); }
+    template <typename F> inline void ast_visit_fields(LiteralPatternNode* node, F&& f) { f(node->literal); }
+
+    // Property accessor
+    template <typename F> inline void ast_visit_fields(PropertyAccessorNode* node, F&& f) { f(node->accessorKeyword); f(node->arrow); f(node->expression); f(node->body); }
+
+    // Root
+    template <typename F> inline void ast_visit_fields(CompilationUnitNode* node, F&& f) { f(node->statements); }
+
+
+    // --- Data Field Reflection ---
+    // Non-child fields that reference memory outside the node: source text views,
+    // modifier arrays and error messages. Passes that copy or relocate nodes must
+    // handle these alongside the child fields.
+    template <typename T, typename F>
+    inline void ast_visit_data_fields(T* node, F&& f)
+    {
+        if constexpr (std::is_base_of_v<TokenNode, T>) f(node->text);
+        if constexpr (std::is_base_of_v<IdentifierNode, T>) f(node->name);
+        if constexpr (std::is_base_of_v<DeclarationNode, T>) f(node->modifiers);
+        if constexpr (std::is_base_of_v<PropertyAccessorNode, T>) f(node->modifiers);
+        if constexpr (std::is_base_of_v<ErrorNode, T>) f(node->error_message);
+    }
+
+    // Plain value fields that carry meaning: token, operator and literal kinds and
+    // flags. Bookkeeping such as spans, node ids and error flags is left out.
+    template <typename T, typename F>
+    inline void ast_visit_value_fields(T* node, F&& f)
+    {
+        f(node->tokenKind);
+        if constexpr (std::is_base_of_v<LiteralExpressionNode, T>) f(node->kind);
+        if constexpr (std::is_base_of_v<UnaryExpressionNode, T>) { f(node->opKind); f(node->isPostfix); }
+        if constexpr (std::is_base_of_v<BinaryExpressionNode, T>) f(node->opKind);
+        if constexpr (std::is_base_of_v<AssignmentExpressionNode, T>) f(node->opKind);
+        if constexpr (std::is_base_of_v<ErrorNode, T>) f(node->kind);
+    }
+
+    // Pointer fields that must refer to the same node as another child field.
+    // Called as f(alias, target); a copy or relocation re-points alias at target
+    // once the children have been handled.
+    template <typename T, typename F>
+    inline void ast_visit_aliases(T* node, F&& f)
+    {
+        if constexpr (std::is_base_of_v<VariableDeclarationNode, T>) {
+            if (!node->names.empty()) f(node->name, node->names.values[0]);
+        }
+    }
+
+    // --- Typed Dispatch ---
+    // Calls f with the node cast to its exact type and returns the result.
+    template <typename F>
+    inline decltype(auto) ast_dispatch(AstNode* node, F&& f)
+    {
+        switch (node->typeId) {
+            #define AST_DISPATCH_CASE(NodeType, BaseType) \
+                case NodeType::sTypeId: return f(static_cast<NodeType*>(node));
+            AST_NODE_LIST(AST_DISPATCH_CASE)
+            #undef AST_DISPATCH_CASE
+            default: return f(node);
+        }
+    }
+
+
+    // --- Static AST Walker ---
+    // A CRTP alternative to StructuralVisitor. walk() switches on the node's
+    // compile-time typeId and calls Derived::visit(T*) directly, so the handler can
+    // be inlined into the dispatch; there is no virtual call and no std::function
+    // in between.
+    //
+    // Every node type has a default visit that walks the node's children. A derived
+    // walker overrides the node types it cares about and pulls in the defaults for
+    // the rest:
+    //
+    //     class MyPass : public AstWalker<MyPass>
+    //     {
+    //     public:
+    //         using AstWalker<MyPass>::visit;
+    //         void visit(CallExpressionNode* node) { ...; walk_children(node); }
+    //     };
+    //
+    // Unlike StructuralVisitor, dispatch is on the exact node type; a visit(ExpressionNode*)
+    // override is not a catch-all for the expressions that have no handler of their own.
+    template <typename Derived>
+    class AstWalker
+    {
+    public:
+        void walk(AstNode* node)
+        {
+            if (!node) return;
+            Derived* self = static_cast<Derived*>(this);
+            switch (node->typeId) {
+                #define AST_WALKER_DISPATCH_CASE(NodeType, BaseType) \
+                    case NodeType::sTypeId: self->visit(static_cast<NodeType*>(node)); break;
+                AST_NODE_LIST(AST_WALKER_DISPATCH_CASE)
+                #undef AST_WALKER_DISPATCH_CASE
+                default: break; // AstNode itself is never instantiated
+            }
+        }
+
+        template <typename T>
+        void walk(const SizedArray<T*>& nodes)
+        {
+            for (int i = 0; i < nodes.size; ++i) {
+                walk(nodes.values[i]);
+            }
+        }
+
+        // Walks every child of the node using the field reflection above.
+        template <typename T>
+        void walk_children(T* node)
+        {
+            ast_visit_fields(node, [this](auto& field) { walk(field); });
+        }
+
+        // --- Default Visits ---
+        // One per node type; each simply descends into the node's children.
+        #define AST_WALKER_DEFAULT_VISIT(NodeType, BaseType) \
+            void visit(NodeType* node) { walk_children(node); }
+        AST_NODE_LIST(AST_WALKER_DEFAULT_VISIT)
+        #undef AST_WALKER_DEFAULT_VISIT
+    };
+
+} // namespace Mycelium::Scripting::Lang
@@ -1,11 +1,15 @@
 #pragma once
 
 #include "ast/ast.hpp"
+#include "ast/ast_walker.hpp"
 #include "semantic/symbol_table.hpp"
 #include "codegen/ir_builder.hpp"
 #include "codegen/ir_command.hpp"
 #include <memory>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace Mycelium::Scripting::Lang {
@@ -15,50 +19,108 @@ struct VariableInfo {
     IRType type;
 };
 
-class CodeGenerator : public StructuralVisitor {
+class CodeGenerator : public AstWalker<CodeGenerator> {
 private:
     SymbolTable& symbol_table_;
     std::unique_ptr<IRBuilder> ir_builder_;
-    std::unordered_map<std::string, VariableInfo> local_vars_;
+    // Locals of the function being generated, indexed by the SymbolId their
+    // declaration was bound to. A slot is live only while its stamp matches
+    // current_function_, so starting a function clears nothing.
+    std::vector<VariableInfo> local_slots_;
+    std::vector<uint32_t> local_slot_function_;
+    uint32_t current_function_ = 0;
+    SymbolId this_symbol_ = INVALID_SYMBOL_ID;
     ValueRef current_value_;  // Result of last expression
+    
+    // Layout of one declared type. Built on first use and kept until the
+    // symbol table reports a change to the type's scope.
+    struct StructInfo {
+        int scope_id = -1;
+        uint64_t scope_version = 0;
+        const StructLayout* layout = nullptr;                     // Owned by the type context
+        std::unordered_map<std::string_view, int> field_indices;  // Name -> index, for members without a binding
+    };
+    std::vector<StructInfo> struct_infos_;  // By type scope id
+    std::vector<int> field_indices_;        // Layout index of each field, by SymbolId; read only through a current StructInfo
+    std::unordered_set<std::string> declared_callees_;  // Functions already given a FunctionDeclare
 
 public:
     CodeGenerator(SymbolTable& table);
     ~CodeGenerator() = default;
 
+    // Expressions with a constant recorded in the symbol table are emitted as
+    // that value; everything else dispatches to the visits below
+    using AstWalker<CodeGenerator>::walk;
+    void walk(AstNode* node);
+
+    // Node types without a handler below generate no code
+    template <typename T> void visit(T*) {}
+
     // Basic visitor overrides for initial implementation
-    void visit(CompilationUnitNode* node) override;
-    void visit(LiteralExpressionNode* node) override;
-    void visit(BinaryExpressionNode* node) override;
-    void visit(UnaryExpressionNode* node) override;
-    void visit(VariableDeclarationNode* node) override;
-    void visit(IdentifierExpressionNode* node) override;
-    void visit(ReturnStatementNode* node) override;
-    void visit(FunctionDeclarationNode* node) override;
-    void visit(TypeDeclarationNode* node) override;
-    void visit(BlockStatementNode* node) override;
-    void visit(AssignmentExpressionNode* node) override;
-    void visit(IfStatementNode* node) override;
-    void visit(WhileStatementNode* node) override;
-    void visit(ForStatementNode* node) override;
-    void visit(ExpressionStatementNode* node) override;
-    void visit(CallExpressionNode* node) override;
-    void visit(MemberAccessExpressionNode* node) override;
-    void visit(IndexerExpressionNode* node) override;
-    void visit(NewExpressionNode* node) override;
+    void visit(CompilationUnitNode* node);
+    void visit(LiteralExpressionNode* node);
+    void visit(BinaryExpressionNode* node);
+    void visit(UnaryExpressionNode* node);
+    void visit(VariableDeclarationNode* node);
+    void visit(IdentifierExpressionNode* node);
+    void visit(ReturnStatementNode* node);
+    void visit(FunctionDeclarationNode* node);
+    void visit(TypeDeclarationNode* node);
+    void visit(BlockStatementNode* node);
+    void visit(AssignmentExpressionNode* node);
+    void visit(IfStatementNode* node);
+    void visit(WhileStatementNode* node);
+    void visit(ForStatementNode* node);
+    void visit(ExpressionStatementNode* node);
+    void visit(CallExpressionNode* node);
+    void visit(MemberAccessExpressionNode* node);
+    void visit(IndexerExpressionNode* node);
+    void visit(NewExpressionNode* node);
 
     // Generate code from AST and return command list
     std::vector<Command> generate_code(CompilationUnitNode* root);
 
 private:
-    // Helper to build struct layout from symbol table
-    std::shared_ptr<StructLayout> build_struct_layout(const std::string& struct_name);
+    // Cached layout of a type scope, rebuilt if the scope changed; null if the id is not a type
+    const StructInfo* struct_info(int type_scope_id);
     
     // Pre-generate all struct types from symbol table
     void pre_generate_struct_types();
     
-    // Helper to find field index in struct layout
-    int find_field_index(const StructLayout& layout, const std::string& field_name);
+    // Type scope of a member access target: the type the type pass recorded for
+    // the expression, else the pointee layout carried by its value. -1 if neither.
+    int struct_scope_of(ExpressionNode* target, const ValueRef& value);
+    
+    // Emits the callee's signature from its symbol and parameters, once per
+    // name, so calls and the definition are checked against the declaration
+    void declare_callee(const std::string& name, const Symbol* function);
+    
+    // LLVM attributes for what analyze_effects() recorded; none for a null or unanalyzed function
+    FunctionAttributes function_attributes(const Symbol* function) const;
+    
+    // Local slots: bound when a declaration allocates, found from a use's binding
+    void begin_function_locals(SymbolId this_symbol = INVALID_SYMBOL_ID);
+    void bind_local(SymbolId symbol, const VariableInfo& info);
+    const VariableInfo* find_local(SymbolId symbol) const;
+    
+    // True for a symbol declared directly in a type scope
+    bool is_field(const Symbol* symbol) const;
+    
+    // 'this' for a field of the enclosing type used without `this.`, with the
+    // type's layout and the field's index; invalid on error
+    ValueRef this_for_field(const Symbol* field, const StructInfo*& struct_info, int& field_index);
+    
+    // Fields of the struct at struct_ptr. Packed fields are read and written
+    // through their word with shifts and masks; field_address is for unpacked ones.
+    ValueRef field_address(ValueRef struct_ptr, const StructLayout& layout, int field_index);
+    ValueRef load_field(ValueRef struct_ptr, const StructLayout& layout, int field_index);
+    void store_field(ValueRef struct_ptr, const StructLayout& layout, int field_index, ValueRef value);
+    ValueRef word_constant(IRType word_type, uint64_t bits);  // Truncated to the word's width
+    ValueRef resize_int(ValueRef value, IRType type);          // zext or trunc between integer widths
+    
+    // Index of a field in a layout: from the field symbol a member was bound to,
+    // else by name for unbound members. -1 if the type has no such field.
+    int find_field_index(const StructInfo& info, const Symbol* field, std::string_view field_name) const;
     
     // Helper to generate member functions with implicit 'this' parameter
     void visit_member_function(FunctionDeclarationNode* node, const std::string& owner_type);
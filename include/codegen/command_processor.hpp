@@ -15,6 +15,7 @@ namespace llvm {
     class Type;
     class StructType;
     class Function;
+    class FunctionType;
     class BasicBlock;
 }
 
@@ -44,12 +45,19 @@ private:
     int param_count_ = 0;
     int current_alloca_index_ = 0;
     
+    // Set by report_error; a module with errors does not verify
+    bool has_errors_ = false;
+    
     // Type conversion
     llvm::Type* to_llvm_type(IRType type);
     
     // Command processing
     void create_basic_blocks(const std::vector<Command>& commands);  // Pass 1: Create all BasicBlocks
     void create_function_basic_blocks();                             // Create BasicBlocks for current function
+    void add_function_attributes(llvm::Function* function, const std::string& attributes);  // From FunctionBegin's ";a,b"
+    // Type of a "name:return_type:params;attributes" signature, with its name and attributes; null if malformed
+    llvm::FunctionType* parse_function_type(const std::string& signature, std::string& name, std::string& attributes);
+    void report_error(const std::string& message);
     void process_command(const Command& cmd);                        // Pass 2: Process individual commands
     llvm::Value* get_value(int id);
     
@@ -26,6 +26,7 @@ public:
     ValueRef const_f32(float value);
     ValueRef const_f64(double value);
     ValueRef const_null(IRType ptr_type);
+    ValueRef const_int(IRType type, int64_t value);  // Any integer width, e.g. a packed word's mask
     
     // Binary operations
     ValueRef add(ValueRef lhs, ValueRef rhs);
@@ -41,6 +42,14 @@ public:
     ValueRef logical_or(ValueRef lhs, ValueRef rhs);
     ValueRef logical_not(ValueRef operand);
     
+    // Bitwise operations and width conversions on integers
+    ValueRef bit_and(ValueRef lhs, ValueRef rhs);
+    ValueRef bit_or(ValueRef lhs, ValueRef rhs);
+    ValueRef shl(ValueRef value, ValueRef amount);
+    ValueRef lshr(ValueRef value, ValueRef amount);
+    ValueRef zext(ValueRef value, IRType type);
+    ValueRef trunc(ValueRef value, IRType type);
+    
     // Memory operations
     ValueRef alloca(IRType type);
     void store(ValueRef value, ValueRef ptr);
@@ -56,8 +65,11 @@ public:
     bool has_terminator() const;
     
     // Function management
-    void function_begin(const std::string& name, IRType return_type, const std::vector<IRType>& param_types = {});
+    void function_begin(const std::string& name, IRType return_type, const std::vector<IRType>& param_types = {},
+                        FunctionAttributes attributes = {});
     void function_end();
+    // Declares a function ahead of calls to it; the processor checks calls and the definition against it
+    void function_declare(const std::string& name, IRType return_type, const std::vector<IRType>& param_types);
     ValueRef call(const std::string& function_name, IRType return_type, const std::vector<ValueRef>& args);
 
     
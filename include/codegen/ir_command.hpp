@@ -18,11 +18,17 @@ enum class Op {
     Mul,
     Div,
     
-    // Logical operations
+    // Logical operations; And and Or are bitwise on wider integers
     And,
     Or,
     Not,
     
+    // Shifts and integer width conversions, for packed fields
+    Shl,
+    LShr,
+    ZExt,
+    Trunc,
+    
     // Comparison operations
     ICmp,           // Integer comparison (takes comparison predicate)
     
@@ -42,6 +48,7 @@ enum class Op {
     // Functions
     FunctionBegin,
     FunctionEnd,
+    FunctionDeclare,  // Signature of a callee, "name:return_type:param1,param2,..."
     Call
 };
 
@@ -59,10 +66,26 @@ enum class ICmpPredicate {
     Uge     // >= (unsigned greater than or equal)
 };
 
+// LLVM attributes a function is defined with. FunctionBegin carries them after
+// its signature as ";name,name", using the LLVM spelling of each.
+struct FunctionAttributes {
+    bool read_none = false;    // readnone: touches no memory but its own stack
+    bool read_only = false;    // readonly: reads memory but never writes it
+    bool no_unwind = false;    // nounwind
+    bool will_return = false;  // willreturn
+    
+    std::string to_string() const;  // "readnone,nounwind", empty without attributes
+};
+
 // Forward declaration
 struct StructLayout;
 
-// Simple type representation (opaque pointers)
+// Canonical id of a type in TypeContext::global(). Each bare kind is its own id.
+using TypeId = uint32_t;
+
+// Simple type representation (opaque pointers). A handle into the type
+// context: copying is free and equal types have equal ids, so comparison is
+// an integer compare. Pointees and struct layouts live in the context.
 struct IRType {
     enum Kind : uint8_t {
         Void, 
@@ -77,13 +100,10 @@ struct IRType {
         Struct
     } kind;
     
-    // For struct types, contains layout information
-    std::shared_ptr<StructLayout> struct_layout;
-    
-    // For pointer types, the pointee type
-    std::shared_ptr<IRType> pointee_type;
+    TypeId id;
     
-    IRType(Kind k = Kind::Void) : kind(k) {}
+    IRType(Kind k = Kind::Void) : kind(k), id(k) {}
+    IRType(Kind k, TypeId type_id) : kind(k), id(type_id) {}
     
     // Factory methods
     static IRType i32() { return {Kind::I32}; }
@@ -96,10 +116,16 @@ struct IRType {
     static IRType void_() { return {Kind::Void}; }
     static IRType ptr() { return {Kind::Ptr}; }
     static IRType ptr_to(IRType pointee);
-    static IRType struct_(std::shared_ptr<StructLayout> layout);
+    static IRType struct_(const StructLayout& layout);  // Offsets are computed once per distinct struct
+    
+    bool operator==(const IRType& other) const { return id == other.id; }
+    bool operator!=(const IRType& other) const { return id != other.id; }
     
-    bool operator==(const IRType& other) const;
-    bool operator!=(const IRType& other) const { return !(*this == other); }
+    // The pointee of a typed pointer, null otherwise
+    const IRType* pointee() const;
+    
+    // The layout of a struct type, null for other types and bare Struct
+    const StructLayout* struct_layout() const;
     
     // Get size of type in bytes
     size_t size_in_bytes() const;
@@ -111,20 +137,39 @@ struct IRType {
     std::string to_string() const;
 };
 
-// Struct layout information
+// Order in which a struct's fields are placed in memory
+enum class FieldOrder : uint8_t {
+    Declared,          // Source order, as a C compiler would lay the struct out
+    MinimizePadding,   // Strictest alignment first, then larger fields; ties keep source order
+};
+
+// Struct layout information. Fields given a bit width are packed into shared
+// integer words; every other field is an element of its own. GEP addresses
+// elements, so a packed field is read by loading its word and masking.
 struct StructLayout {
     struct Field {
         std::string name;
         IRType type;
-        size_t offset;  // Byte offset from struct start
+        size_t offset;           // Byte offset from struct start (of the word, when packed)
+        uint8_t bit_width = 0;   // Set before layout to pack the field; 0 keeps it unpacked
+        uint8_t bit_offset = 0;  // Packed fields: lowest bit within the word
+        int element = 0;         // Index of the element holding the field
+        
+        bool packed() const { return bit_width != 0; }
     };
     
+    static constexpr unsigned PACKED_WORD_BITS = 32;  // Packed fields never straddle words
+    
+    // Reorder fields for a layout policy, before the layout is calculated
+    static void order_fields(std::vector<Field>& fields, FieldOrder order);
+    
     std::string name;  // Struct type name
     std::vector<Field> fields;
+    std::vector<IRType> elements;  // Storage in memory order: unpacked fields and packed words
     size_t total_size;
     size_t alignment;
     
-    // Calculate layout from fields (sets offsets, total_size, alignment)
+    // Calculate layout from fields (sets offsets, elements, total_size, alignment)
     void calculate_layout();
 };
 
@@ -0,0 +1,69 @@
+#pragma once
+#include "codegen/ir_command.hpp"
+#include <deque>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Mycelium::Scripting::Lang {
+
+// Hash-conses every IRType into a TypeId. Each bare kind is preassigned the id
+// equal to its Kind. Pointers, structs and generic instances are added on first
+// use and found again by their parts, so equal types always share an id and a
+// struct's layout is computed once. Entries stay until reset(), so pointees and
+// layouts handed out stay valid for a whole compilation. One context serves the
+// whole process and may be used from several threads; a host that compiles again
+// and again resets it between compilations, or it grows with every edited struct.
+class TypeContext {
+public:
+    static TypeContext& global();
+    
+    TypeContext();
+    TypeContext(const TypeContext&) = delete;
+    TypeContext& operator=(const TypeContext&) = delete;
+    
+    IRType pointer_to(IRType pointee);
+    
+    // A struct is identified by its name and its fields' names and types, in order.
+    // Offsets in the given fields are ignored and computed here.
+    IRType struct_type(const std::string& name, const std::vector<StructLayout::Field>& fields);
+    
+    // An instantiated generic such as List<i32>. Instances are references, so their kind is Ptr.
+    IRType generic_instance(const std::string& base, const std::vector<IRType>& arguments);
+    
+    // Type named by a primitive keyword: i32, bool, string, ...; nullopt for any other name
+    std::optional<IRType> builtin(std::string_view name) const;
+    
+    const IRType* pointee(TypeId id) const;               // Null unless a typed pointer
+    const StructLayout* struct_layout(TypeId id) const;   // Null unless a struct with fields
+    size_t size() const;                                  // Distinct types so far
+    
+    // Forgets every type but the bare kinds. Only call it between compilations:
+    // the ids, pointees and layouts handed out before are invalid afterwards.
+    void reset();
+    
+private:
+    struct Entry {
+        IRType type;
+        bool has_pointee = false;
+        IRType pointee;              // Typed pointers
+        bool has_layout = false;
+        StructLayout layout;         // Structs
+        std::vector<TypeId> arguments;  // Generic instances, after the base in their key
+    };
+    
+    mutable std::shared_mutex mutex_;
+    std::deque<Entry> entries_;                      // By TypeId; a deque so entries never move
+    std::unordered_map<TypeId, TypeId> pointers_;    // Pointee -> pointer to it
+    std::unordered_map<std::string, TypeId> keyed_;  // Structs and generic instances, by their parts
+    std::unordered_map<std::string_view, IRType> builtins_;  // Filled once by the constructor
+    
+    void add_bare_kinds();
+    std::optional<IRType> find_keyed(const std::string& key) const;
+    IRType add_keyed(const std::string& key, Entry entry);
+};
+
+} // namespace Mycelium::Scripting::Lang
@@ -36,9 +36,9 @@ public:
     ParseResult<DeclarationNode> parse_declaration();
     
     // Specific declaration type parsers
-    ParseResult<DeclarationNode> parse_function_declaration();
-    ParseResult<DeclarationNode> parse_type_declaration();
-    ParseResult<DeclarationNode> parse_enum_declaration();
+    ParseResult<DeclarationNode> parse_function_declaration(const std::vector<ModifierKind>& modifiers = {});
+    ParseResult<DeclarationNode> parse_type_declaration(const std::vector<ModifierKind>& modifiers = {});
+    ParseResult<DeclarationNode> parse_enum_declaration(const std::vector<ModifierKind>& modifiers = {});
     ParseResult<StatementNode> parse_using_directive();
     ParseResult<DeclarationNode> parse_namespace_declaration();
     
@@ -60,6 +60,7 @@ private:
     // Helper methods
     ModifierKind parse_access_modifiers();
     std::vector<ModifierKind> parse_all_modifiers();
+    void store_modifiers(DeclarationNode* declaration, const std::vector<ModifierKind>& modifiers);
     bool is_declaration_start();
     ParseResult<AstNode> parse_member_declaration();
 };
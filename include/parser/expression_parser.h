@@ -64,6 +64,7 @@ private:
     ParseResult<ExpressionNode> parse_call_expression();
     ParseResult<ExpressionNode> parse_member_access();
     ParseResult<ExpressionNode> parse_new_expression();
+    ParseResult<ExpressionNode> parse_type_query_expression();  // sizeof(T) and typeof(T)
     ParseResult<ExpressionNode> parse_match_expression();
     ParseResult<ExpressionNode> parse_enum_variant();
 };
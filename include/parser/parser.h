@@ -98,6 +98,24 @@ public:
         return position >= tokens_.size() || (position < tokens_.size() && current().kind == TokenKind::EndOfFile); 
     }
 
+    // Source spans - a node covers the tokens consumed since start_position
+    void set_span(AstNode* node, size_t start_position) const {
+        if (!node || start_position >= tokens_.size()) return;
+        uint32_t start = tokens_[start_position].location.offset;
+        uint32_t end = start;
+        if (position > start_position) {
+            const Token& last = tokens_[std::min(position, tokens_.size()) - 1];
+            end = last.location.offset + last.width;
+        }
+        node->sourceStart = static_cast<int>(start);
+        node->sourceLength = static_cast<int>(end - start);
+    }
+
+    void set_token_span(AstNode* node, const Token& token) const {
+        node->sourceStart = static_cast<int>(token.location.offset);
+        node->sourceLength = static_cast<int>(token.width);
+    }
+
 private:
     // Static EOF token to avoid repeated allocation
     static const Token& eof_token() {
@@ -220,16 +238,19 @@ public:
                 create_error(ErrorKind::MissingToken, "Expected type name"));
         }
         
+        size_t type_start = context_.position;
         const Token& type_token = context_.current();
         context_.advance();
         
         auto* type_name = allocator_.alloc<TypeNameNode>();
         type_name->tokenKind = type_token.kind;
         type_name->contains_errors = false;
+        context_.set_token_span(type_name, type_token);
         auto* identifier = allocator_.alloc<IdentifierNode>();
         identifier->tokenKind = TokenKind::Identifier;
         identifier->name = type_token.text;
         identifier->contains_errors = false;
+        context_.set_token_span(identifier, type_token);
         type_name->identifier = identifier;
         
         // Check for array type suffix []
@@ -253,7 +274,8 @@ public:
                 array_type->tokenKind = TokenKind::Identifier;
                 array_type->contains_errors = false;
                 array_type->elementType = type_name;
-                
+                context_.set_span(array_type, type_start);
+
                 return ParseResult<TypeNameNode>::success(array_type);
             } else {
                 return ParseResult<TypeNameNode>::error(
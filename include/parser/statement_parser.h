@@ -48,6 +48,7 @@ public:
     
 private:
     // Helper methods
+    ParseResult<StatementNode> parse_any_statement();
     bool is_for_in_loop();
     ParseResult<AstNode> parse_for_variable();
 };
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "semantic/symbol_table.hpp"
+
+namespace Mycelium::Scripting::Lang {
+
+// The functions a tree declares and the calls between them, read through name
+// bindings after build_symbol_table(). Member functions and enum methods are
+// functions like any other; a call is an edge when its target is bound to one.
+// Entry points are where calls come from outside the tree: main, functions
+// marked public, extern, virtual, override or abstract, and functions called
+// from code outside every function body.
+class CallGraph {
+public:
+    static constexpr uint32_t NO_FUNCTION = UINT32_MAX;
+
+    struct Function {
+        SymbolId symbol = INVALID_SYMBOL_ID;
+        FunctionDeclarationNode* declaration = nullptr;
+        std::vector<uint32_t> callees;  // Indices of functions called, ascending and distinct
+        bool calls_unknown = false;     // Some call has a target declared nowhere in the tree
+        bool recursive = false;         // Can reach itself through its callees
+        bool entry = false;
+    };
+
+    CallGraph(SymbolTable& table, CompilationUnitNode* ast);
+
+    size_t size() const { return functions.size(); }
+    const Function& function(uint32_t index) const { return functions[index]; }
+    uint32_t index_of(SymbolId symbol) const;  // NO_FUNCTION if the symbol declares no function here
+
+    // Strongly connected components, each a set of mutually recursive
+    // functions, ordered so every component comes after all it calls
+    const std::vector<std::vector<uint32_t>>& components() const { return sccs; }
+
+    // Whether each function, by index, can be called from an entry point
+    std::vector<bool> reachable() const;
+
+private:
+    std::vector<Function> functions;  // In declaration order
+    std::unordered_map<SymbolId, uint32_t> indices;
+    std::vector<std::vector<uint32_t>> sccs;
+
+    void find_components();
+};
+
+struct DeadFunctionReport {
+    std::vector<std::string> removed;  // "name", or "Type::name" for members, in declaration order
+    size_t kept = 0;
+};
+
+// Marks every function no entry point can reach with
+// SymbolTable::mark_dead_function(), so codegen skips it. A tree without entry
+// points is a library on its own and keeps everything.
+DeadFunctionReport eliminate_dead_functions(SymbolTable& table, const CallGraph& graph);
+DeadFunctionReport eliminate_dead_functions(SymbolTable& table, CompilationUnitNode* ast);
+
+} // namespace Mycelium::Scripting::Lang
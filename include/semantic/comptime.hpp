@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "semantic/symbol_table.hpp"
+#include "ast/ast_parallel.hpp"
+
+namespace Mycelium::Scripting::Lang {
+
+// A value during compile-time evaluation. Integers are i32 and wrap the way the
+// generated code does. A type is what typeof() yields; it exists only at compile
+// time, so it can be compared but never folded into generated code.
+struct ComptimeValue {
+    enum class Kind : uint8_t { None, Int, Bool, Type };
+    Kind kind = Kind::None;
+    int32_t int_value = 0;       // Int, and Bool as 0 or 1
+    std::string_view type_name;  // Type; interned in the table
+};
+
+// Why an evaluation stopped. NotConstant means the expression needs something
+// only known at run time and is not an error; the other failures are reported.
+enum class ComptimeStatus {
+    Ok,
+    NotConstant,
+    BudgetExhausted,
+    DivisionByZero,
+    Overflow,       // An i32 literal out of range, or INT_MIN / -1
+    CallTooDeep,
+    UnknownType,    // sizeof or typeof of a name that is not a type
+};
+
+struct ComptimeResult {
+    ComptimeStatus status = ComptimeStatus::Ok;
+    ComptimeValue value;
+    AstNode* node = nullptr;  // Where evaluation stopped, unless Ok
+    std::string message;      // Why it stopped, unless Ok
+    uint64_t steps = 0;
+
+    bool ok() const { return status == ComptimeStatus::Ok; }
+};
+
+// Interprets pure code over a built symbol table, reading names through their
+// bindings: i32 and bool arithmetic, locals, if/while/for/return, calls to
+// functions outside types, sizeof/typeof, cases of data-less enums, and static
+// fields that nothing assigns. Anything else, such as instance fields, globals,
+// member calls or functions without a body, is NotConstant.
+//
+// Each evaluate() gets step_budget steps, one per statement and expression
+// evaluated, so loops that never end come back as BudgetExhausted. Outcomes of
+// expressions evaluated on their own are remembered: a constant is reused
+// wherever it appears, and an error is reported once.
+class ComptimeEvaluator {
+public:
+    static constexpr uint64_t DEFAULT_STEP_BUDGET = 100000;
+    static constexpr int MAX_CALL_DEPTH = 64;
+
+    ComptimeEvaluator(SymbolTable& table, CompilationUnitNode* ast, uint64_t step_budget = DEFAULT_STEP_BUDGET);
+
+    ComptimeResult evaluate(ExpressionNode* expr);
+
+private:
+    enum class Flow { Next, Return, Break, Continue, Stop };
+    enum Outcome : uint8_t { Unknown, Constant, NotConstant, Failed };
+
+    SymbolTable& table;
+    uint64_t step_budget;
+
+    // Gathered from the tree once
+    std::unordered_map<SymbolId, FunctionDeclarationNode*> functions;  // Functions outside types, with a body
+    std::unordered_map<SymbolId, ExpressionNode*> static_initializers;  // Static fields never assigned
+    std::unordered_map<SymbolId, int32_t> enum_values;                  // Case index, filled on first use
+
+    // Outcome and value of each expression evaluate() was called on
+    NodeSideTable<uint8_t> outcomes{Unknown};
+    NodeSideTable<ComptimeValue> values;
+
+    // State of the running evaluation
+    std::vector<std::pair<SymbolId, ComptimeValue>> locals;  // Frames are contiguous; the top one starts at frame_base
+    size_t frame_base = 0;
+    int depth = 0;
+    uint64_t steps = 0;
+    ComptimeValue return_value;
+    std::unordered_set<SymbolId> initializing;  // Static fields being evaluated, to catch cycles
+    ComptimeResult failure;
+
+    bool fail(ComptimeStatus status, AstNode* node, std::string message);
+    bool step(AstNode* node);
+    bool eval(ExpressionNode* expr, ComptimeValue& out);
+    bool eval_binary(BinaryExpressionNode* node, ComptimeValue& out);
+    bool eval_unary(UnaryExpressionNode* node, ComptimeValue& out);
+    bool eval_assignment(AssignmentExpressionNode* node, ComptimeValue& out);
+    bool eval_call(CallExpressionNode* node, ComptimeValue& out);
+    bool eval_symbol(Symbol* symbol, AstNode* use, ComptimeValue& out);
+    bool eval_type_query(ExpressionNode* node, TypeNameNode* type, bool size, ComptimeValue& out);
+    bool eval_condition(ExpressionNode* condition, bool& out);
+    Flow exec(AstNode* statement);
+    ComptimeValue* find_local(SymbolId symbol);
+    void declare_local(SymbolId symbol, ComptimeValue value);
+};
+
+// Evaluates every expression of the tree that does not depend on run-time
+// values and records each i32 or bool result with SymbolTable::set_constant(),
+// so codegen emits the value instead of the code. Literals are left alone.
+// Returns the evaluations that failed with an error, in source order.
+std::vector<AstPassDiagnostic> fold_constants(SymbolTable& table, CompilationUnitNode* ast,
+                                              uint64_t step_budget = ComptimeEvaluator::DEFAULT_STEP_BUDGET);
+
+} // namespace Mycelium::Scripting::Lang
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "semantic/call_graph.hpp"
+
+namespace Mycelium::Scripting::Lang {
+
+// Works out what calling each function of the tree can do and records it with
+// SymbolTable::set_function_effects(). A body's own effects come from what its
+// names are bound to: parameters and locals are free, fields and globals are
+// read or written memory, and a call to something not declared in the tree can
+// do anything. Callers then take on the effects of their callees, one strongly
+// connected component at a time, so mutually recursive functions share theirs.
+void analyze_effects(SymbolTable& table, const CallGraph& graph);
+void analyze_effects(SymbolTable& table, CompilationUnitNode* ast);
+
+} // namespace Mycelium::Scripting::Lang
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "semantic/symbol_table.hpp"
+#include "ast/ast_parallel.hpp"
+
+namespace Mycelium::Scripting::Lang {
+
+// --- Module Interface Format ---
+// What a script exports, so a script that names it in a `using` directive can
+// be analyzed against its declarations without parsing its source:
+//
+//   [ModuleInterfaceHeader][string table][declarations]
+//
+// Every count, index and size after the header is an unsigned LEB128 varint,
+// and every name or type name is an index into the string table. The string
+// table is a count, then each string as its length and its characters.
+// Declarations are in source order, since a type can only name types declared
+// before it:
+//
+//   type:     kind, name, type kind, pinned, fields, methods, layout, size, alignment
+//   enum:     kind, name, cases carry data, cases, methods
+//   function: kind, name, return type, parameters
+//
+// A layout lists the fields in memory order, each as its declaration index and
+// its bit width, so an importer uses the exporter's layout under any policy.
+// The header records the hash of the source the interface was emitted from, so
+// drivers can tell when it is stale.
+
+// Bump whenever the encoding changes.
+constexpr uint32_t MODULE_INTERFACE_VERSION = 1;
+
+struct ModuleInterfaceHeader {
+    char magic[4];        // "MMOD"
+    uint32_t version;     // MODULE_INTERFACE_VERSION
+    uint64_t sourceHash;  // ast_hash_source() of the exporting script
+    uint64_t totalSize;   // Size of the whole file in bytes
+};
+
+class ModuleInterface {
+public:
+    struct Member {
+        std::string name;
+        std::string type_name;  // Empty for enum cases
+    };
+
+    struct LayoutSlot {
+        uint32_t field = 0;     // Index into the type's fields
+        uint8_t bit_width = 0;  // Nonzero when packed into a shared word
+    };
+
+    struct Declaration {
+        enum class Kind : uint8_t { Type, Enum, Function };
+        Kind kind = Kind::Function;
+        std::string name;
+        std::string type_name;              // Functions: return type. Types: "type", "ref type" or "interface"
+        bool flag = false;                  // Types: field order pinned. Enums: some case carries data
+        std::vector<Member> members;        // Fields, enum cases, or parameters without 'this'
+        std::vector<Declaration> methods;   // Types and enums
+        std::vector<LayoutSlot> layout;     // Types with fields
+        uint64_t size = 0;                  // Types with fields: the laid out struct
+        uint64_t alignment = 0;
+    };
+
+    std::string name;  // As a `using` directive spells it
+    uint64_t source_hash = 0;
+    std::vector<Declaration> declarations;
+
+    // The public types, enums and functions the script declares at global
+    // scope, from its built table. 'main' is never exported.
+    static ModuleInterface extract(SymbolTable& table, CompilationUnitNode* ast, std::string module_name, uint64_t source_hash = 0);
+
+    void serialize(std::vector<uint8_t>& out) const;
+    bool save(const std::string& path) const;
+
+    // False, leaving the interface empty, for a file that is truncated, from
+    // another format version or written for different source than expected.
+    // An expected hash of 0 accepts any source.
+    bool deserialize(const uint8_t* data, size_t size, uint64_t expected_source_hash = 0);
+    bool load(const std::string& path, uint64_t expected_source_hash = 0);
+};
+
+// Loads "<directory>/<name>.mmi" for every top-level `using <name>;` of the
+// tree and adds it to the table's imports, so the next build declares it.
+// Returns a diagnostic for each directive without a usable interface.
+std::vector<AstPassDiagnostic> import_modules(SymbolTable& table, CompilationUnitNode* ast, const std::string& directory);
+
+} // namespace Mycelium::Scripting::Lang
@@ -1,16 +1,23 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <memory>
 #include <vector>
 #include "codegen/ir_command.hpp"
 #include "ast/ast.hpp"
+#include "ast/ast_side_table.hpp"
 
 namespace Mycelium::Scripting::Lang {
 
 // Forward declaration
 class SymbolTable;
+class ModuleInterface;
 
 enum class SymbolType {
     VARIABLE,
@@ -26,36 +33,158 @@ enum class TypeResolutionState {
     RESOLVED       // Type fully resolved
 };
 
+// Interned identifier; equal names get equal ids within one SymbolTable.
+using NameId = uint32_t;
+
+// Index of a symbol in its table's arena, stable for the table's lifetime.
+using SymbolId = uint32_t;
+
+constexpr NameId INVALID_NAME_ID = UINT32_MAX;
+constexpr SymbolId INVALID_SYMBOL_ID = UINT32_MAX;
+
+// Stores each distinct name once, so symbols and scopes compare ids instead of
+// strings. Views returned by str() stay valid until clear().
+class NameInterner {
+private:
+    std::deque<std::string> names;  // Deque keeps each string, and its SSO buffer, in place
+    std::unordered_map<std::string_view, NameId> ids;
+
+public:
+    NameId intern(std::string_view name);
+    NameId find(std::string_view name) const;  // INVALID_NAME_ID if never interned
+    std::string_view str(NameId id) const { return names[id]; }
+    size_t size() const { return names.size(); }
+    void clear();
+};
+
 struct Symbol {
-    std::string name;
+    SymbolId id;
+    NameId name_id;
+    std::string_view name;       // Interned in the owning table
     SymbolType type;
     IRType data_type;
-    std::string type_name;  // Original type name (e.g., "Shape", "string")
+    std::string_view type_name;  // Original type name (e.g., "Shape", "string"), interned or a literal
     int scope_level;
     
     // Type resolution support
     TypeResolutionState resolution_state = TypeResolutionState::UNRESOLVED;
     ExpressionNode* initializer_expression = nullptr;  // For type inference
-    std::vector<std::string> dependencies;  // Variables this symbol's type depends on
-    
-    Symbol(const std::string& n, SymbolType t, const IRType& dt, const std::string& tn, int level)
-        : name(n), type(t), data_type(dt), type_name(tn), scope_level(level) {}
+    std::vector<NameId> dependencies;  // Variables this symbol's type depends on
+    bool removed = false;              // Dropped by an incremental update; the id is not reused
+};
+
+// Name-to-symbol map for one scope. Most scopes hold a handful of names, so
+// entries live inline and are scanned linearly. Past INLINE_CAPACITY they move
+// to the heap and an open-addressing index over them is kept as well. Entries
+// stay in declaration order.
+class ScopeSymbols {
+public:
+    static constexpr size_t INLINE_CAPACITY = 8;
+
+    struct Entry {
+        NameId name;
+        SymbolId symbol;
+    };
+
+    SymbolId find(NameId name) const;
+    bool insert(NameId name, SymbolId symbol);  // False if the name is already present
+    void truncate(size_t count);                 // Keeps only the first count entries
+
+    std::span<const Entry> entries() const {
+        return heap.empty() ? std::span<const Entry>(inline_entries.data(), inline_count) : std::span<const Entry>(heap);
+    }
+    size_t size() const { return heap.empty() ? inline_count : heap.size(); }
+    bool empty() const { return size() == 0; }
+
+private:
+    std::array<Entry, INLINE_CAPACITY> inline_entries;
+    uint32_t inline_count = 0;
+    std::vector<Entry> heap;
+    std::vector<uint32_t> index;  // Entry position + 1 per slot, 0 when empty; size is a power of two
+
+    void add_to_index(uint32_t position);
+    void rebuild_index(size_t slot_count);
 };
 
+enum class ScopeKind {
+    GLOBAL,
+    NAMESPACE,
+    TYPE,       // Type, interface or enum body
+    FUNCTION,   // Function or member function, including its parameters
+    BLOCK
+};
+
+// Scopes form a tree linked by id. Each scope also records the nearest
+// enclosing type scope, so code inside a member function reaches the type's
+// fields in one step instead of parsing "Type::function" out of a name.
 struct Scope {
-    std::unordered_map<std::string, std::shared_ptr<Symbol>> symbols;
+    ScopeSymbols symbols;
     int parent_scope_id = -1;
-    std::string scope_name;
+    int owner_type_scope_id = -1;       // Nearest enclosing TYPE scope, -1 outside types
+    ScopeKind kind = ScopeKind::BLOCK;
+    NameId name_id = INVALID_NAME_ID;   // Unqualified name; INVALID_NAME_ID for anonymous scopes
+    std::string scope_name;             // Display name, qualified for member functions
+    bool removed = false;               // Opened in a body an incremental update dropped
+    uint64_t version = 0;               // Table-wide change stamp of the last declaration change here
+    bool pinned_field_order = false;    // 'extern type': fields keep declaration order under any policy
+    int8_t enum_bits = -1;              // Enum scopes: bits a case value needs, 0 if a case carries data; -1 otherwise
+    IRType imported_struct;             // Types from a module interface: the exporter's layout, used under any policy
     
-    Scope(const std::string& name = "", int parent = -1) 
-        : scope_name(name), parent_scope_id(parent) {}
+    Scope(const std::string& name = "", int parent = -1, ScopeKind scope_kind = ScopeKind::BLOCK)
+        : parent_scope_id(parent), kind(scope_kind), scope_name(name) {}
+};
+
+// Size of one type's struct laid out in declaration order and under the table's field order
+struct LayoutSavings {
+    std::string type_name;
+    size_t declared_size = 0;
+    size_t size = 0;
+    bool pinned = false;
+};
+
+// An i32 or bool an expression was evaluated to before codegen; Void type when the
+// expression was not folded
+struct ConstantValue {
+    IRType type;
+    int64_t value = 0;
+    
+    bool is_constant() const { return type.kind != IRType::Void; }
+};
+
+// What a call to a function can do to memory the caller sees
+enum class Purity : uint8_t {
+    Pure,           // Reads and writes only its parameters and locals
+    ReadOnly,       // Also reads fields or globals
+    SideEffecting,  // Writes memory, or calls code that may
+};
+
+// What analyze_effects() found a function does. The defaults assume the worst,
+// which is also what a function that was never analyzed gets.
+struct FunctionEffects {
+    Purity purity = Purity::SideEffecting;
+    bool no_unwind = false;    // Reaches no code outside the module
+    bool will_return = false;  // Every call returns: no loops and no recursion on the way
+};
+
+// What one function put in the table beyond its own symbol, so an edit can drop
+// and redo just that function. Its parameters and locals live in the function
+// scope after 'this'; the scopes opened in its body have consecutive ids.
+struct BodyExtent {
+    AstNode* owner = nullptr;        // The function
+    int first_scope = 0;             // Scopes opened in the body are [first_scope, end_scope)
+    int end_scope = 0;
+    std::vector<SymbolId> uses;      // Symbols declared outside every body that the body reads, ascending
 };
 
 class SymbolTable {
 private:
     // Persistent storage of all scopes
     std::vector<Scope> all_scopes;
+    // Symbol arena, indexed by SymbolId; a deque so Symbol pointers stay valid as it grows
+    std::deque<Symbol> symbol_arena;
+    NameInterner names;
     std::unordered_map<std::string, int> scope_name_to_id;
+    std::unordered_map<uint64_t, int> child_scope_ids;  // (parent id, NameId) -> named child scope
     int next_scope_id = 0;
     
     // Navigation stack for traversal
@@ -64,26 +193,170 @@ private:
     // Building state (used during symbol table construction)
     int building_scope_level = 0;
 
+    // Dependency cycles found by the last resolve_all_types(), members in declaration order
+    std::vector<std::vector<SymbolId>> type_cycles;
+
+    // Memoized expression types and the scope each scope-owning node opened, by node id
+    NodeSideTable<std::string_view> expression_types;
+    NodeSideTable<int> node_scopes{-1};
+    bool expression_types_final = false;  // Set once resolve_all_types() or freeze_declarations() has run
+
+    // Symbol each declared name, identifier use and member access refers to, by node id
+    NodeSideTable<SymbolId> name_bindings{INVALID_SYMBOL_ID};
+
+    // Values of expressions folded at compile time, by node id
+    NodeSideTable<ConstantValue> constants;
+
+    // Effects of each analyzed function, by SymbolId
+    std::vector<FunctionEffects> function_effects;
+
+    // Functions no entry point reaches, by SymbolId
+    std::vector<bool> dead_functions;
+
+    // Incremental update bookkeeping: each function scope's extent, and what code outside bodies reads
+    std::unordered_map<int, BodyExtent> body_extents;
+    std::vector<SymbolId> declaration_uses;  // Ascending
+
+    // Stamps scope versions; survives clear() so a stamp never repeats in one table
+    uint64_t scope_changes = 0;
+    
+    // Layout policy for types that are not pinned; survives clear()
+    FieldOrder field_order = FieldOrder::Declared;
+    bool bit_packing = false;
+
+    // Module interfaces declared ahead of the tree by every build; survive clear()
+    std::vector<std::shared_ptr<const ModuleInterface>> imports;
+
+    void touch_scope(int scope_id) { all_scopes[scope_id].version = ++scope_changes; }
+    // Variables of a type scope in source order, with bit widths set on packable ones if pack is set
+    std::vector<StructLayout::Field> declared_fields(int type_scope_id, bool pack);
+    void remove_scope(int scope_id);
+
+    void create_scope(const std::string& display_name, NameId name, ScopeKind kind);
+    Symbol* create_symbol(NameId name, SymbolType type, const IRType& data_type, std::string_view type_name);
+    SymbolId lookup_symbol_id_in_context(int scope_id, NameId name) const;
+    bool infer_symbol_type(Symbol& symbol);
+    std::string_view compute_expression_type(ExpressionNode* expr, int context_scope_id);
+    std::string_view intern_view(std::string_view text) { return names.str(names.intern(text)); }
+
 public:
     SymbolTable();
     ~SymbolTable() = default;
     
     // === BUILDING PHASE API ===
     // Used during initial symbol table construction
-    void enter_scope();  // For building phase
-    void enter_named_scope(const std::string& scope_name);  // For building phase with name
+    void enter_scope(ScopeKind kind = ScopeKind::BLOCK);  // For building phase
+    void enter_named_scope(const std::string& scope_name, ScopeKind kind = ScopeKind::BLOCK);  // For building phase with name
     void exit_scope();   // For building phase
+    void resume_scope(int scope_id) { building_scope_level = scope_id; }  // Build inside an existing scope, e.g. a body declared after its signature
     bool declare_symbol(const std::string& name, SymbolType type, const IRType& data_type, const std::string& type_name = "");
     bool declare_unresolved_symbol(const std::string& name, SymbolType type, ExpressionNode* initializer = nullptr);
     
     // === TYPE RESOLUTION API ===
-    bool resolve_all_types();  // Resolve all unresolved types
+    bool resolve_all_types();  // Resolve all unresolved types, dependencies first
+    const std::vector<std::vector<SymbolId>>& get_type_cycles() const { return type_cycles; }
+    
+    // Resolves the unresolved symbols with ids in [first, end), dependencies first.
+    // Cycles and symbols that could not be inferred are appended rather than
+    // logged. Once freeze_declarations() has run and the node tables are reserved,
+    // ranges holding different function bodies may be resolved concurrently.
+    bool resolve_symbol_range(SymbolId first, SymbolId end, std::vector<std::vector<SymbolId>>& cycles, std::vector<SymbolId>& failed);
+    void freeze_declarations() { expression_types_final = true; }  // Every symbol is declared; inferred types are final
+    void add_type_cycle(std::vector<SymbolId> cycle) { type_cycles.push_back(std::move(cycle)); }
     bool resolve_symbol_type(const std::string& name);  // Resolve specific symbol type
     bool resolve_symbol_type_in_context(const std::string& name, int context_scope_id);  // Resolve in specific scope context
     std::string infer_type_from_expression(ExpressionNode* expr);  // Type inference from expression
     std::string infer_type_from_expression_in_context(ExpressionNode* expr, int context_scope_id);  // Type inference with scope context
     std::vector<std::string> extract_dependencies(ExpressionNode* expr);  // Extract variable dependencies
-    std::shared_ptr<Symbol> lookup_symbol_in_context(const std::string& name, int context_scope_id);  // Lookup with scope context
+    Symbol* lookup_symbol_in_context(std::string_view name, int context_scope_id);  // Lookup with scope context
+
+    // === EXPRESSION TYPES ===
+    // Each expression is inferred once and its type name kept in a side table
+    // indexed by node id. Before resolve_all_types() has run only resolved types
+    // are kept, since an identifier may still resolve; afterwards every result
+    // is final. Until then declaring a symbol drops the table; afterwards so does
+    // declaring a global, type member or namespace member, while body locals are
+    // invisible to anything typed outside their body. The views stay valid until clear().
+    std::string_view infer_expression_type(ExpressionNode* expr, int context_scope_id);
+    std::string_view get_expression_type(const ExpressionNode* expr) const;  // Empty if never inferred
+    void set_node_scope(const AstNode* node, int scope_id);  // Scope opened by a function, type, block or loop
+    int get_node_scope(const AstNode* node) const;           // -1 for nodes that open no scope
+    void reserve_expression_types(uint32_t node_count) { expression_types.reserve(node_count); }  // Before inferring from several threads
+
+    // === NAME BINDINGS ===
+    // The builder binds each declaration's name node to the symbol it declared;
+    // bind_names() binds identifier uses and member accesses. Reading a binding
+    // is an array index. Declaring symbols later does not rebind existing uses.
+    void bind_name(const AstNode* node, SymbolId symbol) { name_bindings[node] = symbol; }
+    void reserve_name_bindings(uint32_t node_count) { name_bindings.reserve(node_count); }  // Before binding from several threads
+    SymbolId get_binding(const AstNode* node) const { return node ? name_bindings.get(node) : INVALID_SYMBOL_ID; }
+    Symbol* get_bound_symbol(const AstNode* node) { return get_symbol(get_binding(node)); }
+
+    // === CONSTANTS ===
+    // fold_constants() records the value of each expression it evaluated, and
+    // codegen emits the value in place of the expression. A folded call depends
+    // on its callee's body, so update_function() drops them all.
+    void set_constant(const AstNode* node, ConstantValue value) { constants.set(node, value); }
+    ConstantValue get_constant(const AstNode* node) const { return node ? constants.get(node) : ConstantValue(); }
+    void clear_constants() { constants.clear(); }
+
+    // === FUNCTION EFFECTS ===
+    // analyze_effects() records what each function does, and codegen turns it
+    // into LLVM attributes. An edited body can change what its callers do, so
+    // update_function() drops them all.
+    void set_function_effects(SymbolId function, FunctionEffects effects);
+    FunctionEffects get_function_effects(SymbolId function) const;
+    void clear_function_effects() { function_effects.clear(); }
+
+    // === IMPORTED MODULES ===
+    // Each build declares the types, enums and functions of every imported
+    // interface in the global scope before the tree's own declarations, in the
+    // order they were added. Imported declarations have no nodes.
+    void add_import(std::shared_ptr<const ModuleInterface> module) { imports.push_back(std::move(module)); }
+    const std::vector<std::shared_ptr<const ModuleInterface>>& get_imports() const { return imports; }
+    void clear_imports() { imports.clear(); }
+
+    // === DEAD FUNCTIONS ===
+    // eliminate_dead_functions() marks the functions nothing can call, and
+    // codegen leaves them out. An edited body may call one of them, so
+    // update_function() drops the marks.
+    void mark_dead_function(SymbolId function);
+    bool is_dead_function(SymbolId function) const { return function < dead_functions.size() && dead_functions[function]; }
+    void clear_dead_functions() { dead_functions.clear(); }
+
+    // === INCREMENTAL UPDATES ===
+    // The build keeps a BodyExtent per function scope. Removing a function's
+    // declarations marks its parameters, its locals and the scopes opened in its
+    // body as removed and drops their cycles; the function's own symbol and scope
+    // stay. Ids are never reused, so removed entries keep their arena slots until
+    // clear(). Dependents are found from the uses each body recorded.
+    void set_body_extent(int function_scope_id, BodyExtent extent) { body_extents[function_scope_id] = std::move(extent); }
+    const BodyExtent* get_body_extent(int function_scope_id) const;
+    void set_declaration_uses(std::vector<SymbolId> uses) { declaration_uses = std::move(uses); }
+    bool is_read_outside_bodies(SymbolId symbol) const;             // By an initializer or a top-level statement
+    std::vector<int> find_dependent_bodies(SymbolId symbol) const;  // Function scopes whose bodies read symbol, ascending
+    void remove_function_declarations(int function_scope_id);
+    void forget_node(const AstNode* node);                          // Drops the node's expression type, binding and scope
+    void set_symbol_type(SymbolId id, const std::string& type_name);  // Changes an explicit type in place
+    
+    // === STRUCT LAYOUT ===
+    // Every struct type for a declared type is built here, so symbol types and
+    // codegen agree on field order. Set the policy before building the table:
+    // symbol types computed earlier keep the layout they were given.
+    // Bit packing puts bool fields and fields of small data-less enums into
+    // shared words; pinned types are never packed.
+    static constexpr int SMALL_ENUM_BITS = 8;
+    void set_field_order(FieldOrder order);
+    FieldOrder get_field_order() const { return field_order; }
+    void set_bit_packing(bool enabled);
+    bool get_bit_packing() const { return bit_packing; }
+    void pin_field_order(int type_scope_id);         // Keep declaration order, e.g. to match a C struct
+    bool is_field_order_pinned(int type_scope_id) const;
+    void mark_enum_scope(int enum_scope_id, bool cases_carry_data);  // After its cases are declared
+    int get_enum_bits(int scope_id) const;           // Bits an enum value needs; 0 with payloads, -1 if not an enum
+    IRType struct_type_of_scope(int type_scope_id);  // Fields ordered and packed by the policy unless pinned or imported
+    void set_imported_layout(int type_scope_id, IRType struct_type);
+    std::vector<LayoutSavings> get_layout_savings(); // One entry per type with fields, in scope order
     
     // === NAVIGATION API ===
     // Used during code generation/analysis phases
@@ -93,20 +366,42 @@ public:
     void reset_navigation();                        // Reset to global scope
     
     // === QUERY API ===
-    // Works with current navigation state
-    std::shared_ptr<Symbol> lookup_symbol(const std::string& name);
-    std::shared_ptr<Symbol> lookup_symbol_current_scope(const std::string& name);
-    std::shared_ptr<Symbol> lookup_symbol_in_scope(int scope_id, const std::string& name);
-    std::vector<std::shared_ptr<Symbol>> get_all_symbols_in_scope(int scope_id);
+    // Works with current navigation state. Returned pointers stay valid until clear().
+    Symbol* lookup_symbol(std::string_view name);
+    Symbol* lookup_symbol_current_scope(std::string_view name);
+    Symbol* lookup_symbol_in_scope(int scope_id, std::string_view name);
+    std::vector<Symbol*> get_all_symbols_in_scope(int scope_id);  // In declaration order
     
-    bool symbol_exists(const std::string& name);
-    bool symbol_exists_current_scope(const std::string& name);
+    bool symbol_exists(std::string_view name);
+    bool symbol_exists_current_scope(std::string_view name);
+
+    // === ID API ===
+    // For passes that keep symbols in their own tables. Names that were never
+    // declared have no NameId, so find_name() doubles as a cheap miss check.
+    NameId find_name(std::string_view name) const { return names.find(name); }
+    NameId intern_name(std::string_view name) { return names.intern(name); }
+    std::string_view name_of(NameId name) const { return names.str(name); }
+    SymbolId lookup_symbol_id_in_scope(int scope_id, NameId name) const;
+    Symbol* get_symbol(SymbolId id) { return id < symbol_arena.size() ? &symbol_arena[id] : nullptr; }
+    size_t symbol_count() const { return symbol_arena.size(); }
     
     // === SCOPE MANAGEMENT ===
-    int find_scope_by_name(const std::string& scope_name);
+    int find_scope_by_name(const std::string& scope_name) const;
+    int find_type_scope(std::string_view type_name) const;  // Scope of a type, pointer suffixes ignored; -1 if not a type
+    int find_child_scope(int parent_scope_id, std::string_view name) const;  // Named child, e.g. a member function of a type
     int get_current_scope_id() const;
     int get_current_scope_level() const { return building_scope_level; }
     std::string get_current_scope_name() const;
+
+    // Scope tree links, recorded when each scope is created. Out-of-range ids give -1.
+    int get_parent_scope(int scope_id) const;
+    int get_owner_type_scope(int scope_id) const;
+    ScopeKind get_scope_kind(int scope_id) const;
+    const std::string& get_scope_name(int scope_id) const;
+    size_t scope_count() const { return all_scopes.size(); }
+    // Changes whenever a symbol is declared in, removed from or retyped in the scope; 0 for unknown ids.
+    // Caches derived from a scope's contents (e.g. struct layouts) compare it to know they are stale.
+    uint64_t get_scope_version(int scope_id) const;
     
     void clear();
     void print_symbol_table() const;
@@ -118,7 +413,47 @@ public:
 
 // Forward declaration
 struct CompilationUnitNode;
+class AstTaskPool;
+struct AstPassDiagnostic;
 
+// Builds the table in two phases. A serial pass declares every type, field,
+// enum case and function signature and resolves their types. Then each function
+// body is declared, resolved, typed and bound as one task on the pool, reading
+// the settled declarations; results merge in source order, so the table and the
+// diagnostics are the same for any worker count. Diagnostics come back body by
+// body, then for names outside bodies.
+std::vector<AstPassDiagnostic> build_symbol_table(SymbolTable& table, CompilationUnitNode* ast, AstTaskPool& pool);
+
+// Builds on the calling thread and logs the diagnostics. For callers without a
+// pool of their own; the driver passes one so bodies are analyzed in parallel.
 void build_symbol_table(SymbolTable& table, CompilationUnitNode* ast);
 
+// Redoes one function after its parameters, return type or body were replaced
+// in place with nodes from the tree's own allocator. Its parameters and body are
+// declared, resolved, typed and bound again. If the signature changed, so is
+// every body that reads the function. Everything else is left as it was, except
+// folded constants, function effects and dead functions, which are dropped.
+// Returns false, leaving the table untouched, when the edit reaches past
+// function bodies: a renamed function, or a changed signature read outside any
+// body. The table then has to be rebuilt. Diagnostics for the redone bodies
+// replace those they reported before.
+bool update_function(SymbolTable& table, FunctionDeclarationNode* function, std::vector<AstPassDiagnostic>& diagnostics);
+
+// Infers the type of every expression in the tree once, each in the scope that
+// encloses it. build_symbol_table() runs this after resolving symbol types, so
+// later passes read types with get_expression_type().
+void check_expression_types(SymbolTable& table, CompilationUnitNode* ast);
+
+// Binds every identifier use and member access to the symbol it names, looked
+// up from the scope that encloses it; a member is looked up in its target's
+// type. Needs expression types, so build_symbol_table() runs it last and logs
+// what it returns: the names that bound to nothing, in source order.
+std::vector<AstNode*> bind_names(SymbolTable& table, CompilationUnitNode* ast);
+
+// Infers the type name of every expression inside function, constructor and
+// accessor bodies, one body per task on the pool. Each expression is inferred in
+// the scope of the function that contains it. The table must be fully built
+// and is only read. Expressions outside bodies are left unset.
+void infer_expression_types(SymbolTable& table, CompilationUnitNode* ast, NodeSideTable<std::string>& types, AstTaskPool& pool);
+
 } // namespace Mycelium::Scripting::Lang
\ No newline at end of file
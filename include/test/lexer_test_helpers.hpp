@@ -0,0 +1,29 @@
+#pragma once
+
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include <string>
+#include <vector>
+
+namespace Mycelium::Testing {
+
+using namespace Mycelium::Scripting::Lang;
+
+// Lexer sink that keeps every diagnostic it is given
+class CollectingLexerDiagnosticSink : public LexerDiagnosticSink {
+public:
+    std::vector<LexerDiagnostic> diagnostics;
+
+    void report_diagnostic(const LexerDiagnostic& diagnostic) override {
+        diagnostics.push_back(diagnostic);
+    }
+};
+
+// Tokenizes a test script with the default lexer options
+inline TokenStream tokenize_test_source(const std::string& source) {
+    CollectingLexerDiagnosticSink sink;
+    Lexer lexer(source, {}, &sink);
+    return lexer.tokenize_all();
+}
+
+} // namespace Mycelium::Testing
@@ -12,7 +12,7 @@ namespace Mycelium::Testing {
 using namespace Mycelium::Scripting::Lang;
 using namespace Mycelium::Scripting::Common;
 
-// Helper function to generate AST debug information using logger string capture
+// Helper function to generate AST debug information
 inline std::string get_ast_debug_info(AstNode* node, const std::string& label = "AST") {
     if (!node) {
         return label + ": <null>";
@@ -24,14 +24,9 @@ inline std::string get_ast_debug_info(AstNode* node, const std::string& label =
     ss << "  Type ID: " << static_cast<int>(node->typeId) << "\n";
     ss << "  AST Structure:\n";
     
-    // Use logger string capture to get AST printer output
-    Logger& logger = Logger::get_instance();
-    logger.begin_string_capture();
-    
-    AstPrinterVisitor printer;
-    node->accept(&printer);
-    
-    std::string ast_output = logger.end_string_capture();
+    std::ostringstream printed;
+    ast_dump(node, AstDumpFormat::PseudoCode, printed);
+    std::string ast_output = printed.str();
     
     // Indent each line of the AST output
     std::istringstream iss(ast_output);
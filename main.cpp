@@ -4,15 +4,22 @@
 #include "codegen/codegen.hpp"
 #include "codegen/command_processor.hpp"
 #include "codegen/jit_engine.hpp"
+#include "codegen/type_context.hpp"
 #include "semantic/symbol_table.hpp"
+#include "semantic/comptime.hpp"
+#include "semantic/effects.hpp"
+#include "semantic/module_interface.hpp"
 #include "common/logger.hpp"
 #include "ast/ast_rtti.hpp"
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <filesystem>
+#include <memory>
 
-#include "ast/ast_printer.hpp"
+#include "ast/ast_dumper.hpp"
+#include "ast/ast_compact.hpp"
+#include "ast/ast_serializer.hpp"
 
 using namespace Mycelium::Scripting::Lang;
 using namespace Mycelium;
@@ -38,49 +45,137 @@ std::string read_file(const std::string& filepath) {
     return content;
 }
 
+// How the AST is dumped after parsing; set from the command line
+struct AstDumpOptions {
+    bool enabled = true;
+    AstDumpFormat format = AstDumpFormat::PseudoCode;
+    std::string output_path; // Empty for stdout
+};
+
 // Main scripting engine function
-int run_script(const std::string& filepath) {
+int run_script(const std::string& filepath, const AstDumpOptions& dump_options, bool compact_ast, const std::string& interface_path,
+               const std::string& ast_cache_path) {
     try {
 
+        // Types from an earlier compilation are not used again
+        TypeContext::global().reset();
+        
         // Read the script file
         std::string source_code = read_file(filepath);
         std::cout << "Executing script: " << filepath << std::endl;
         
-        // Step 1: Lexical analysis
-        ConsoleLexerDiagnosticSink diagnostic_sink;
-        Lexer lexer(source_code, {}, &diagnostic_sink);
-        TokenStream token_stream = lexer.tokenize_all();
-        
-        if (token_stream.size() == 0) {
-            std::cerr << "Error: No tokens generated from source file" << std::endl;
-            return 1;
+        // A tree cached from the same source text skips lexing and parsing
+        uint64_t source_hash = ast_hash_source(source_code);
+        AstAllocator cache_allocator;
+        CompilationUnitNode* compilation_unit = nullptr;
+        if (!ast_cache_path.empty()) {
+            AstBinaryFile cache;
+            if (cache.open(ast_cache_path)) {
+                compilation_unit = cache.load_into(cache_allocator, source_hash);
+            }
+            if (compilation_unit) {
+                LOG_INFO("Loaded the AST from " + ast_cache_path, LogCategory::PARSER);
+            }
         }
+        
+        TokenStream token_stream;
+        std::unique_ptr<Parser> parser;
+        if (!compilation_unit) {
+            // Step 1: Lexical analysis
+            ConsoleLexerDiagnosticSink diagnostic_sink;
+            Lexer lexer(source_code, {}, &diagnostic_sink);
+            token_stream = lexer.tokenize_all();
+            
+            if (token_stream.size() == 0) {
+                std::cerr << "Error: No tokens generated from source file" << std::endl;
+                return 1;
+            }
 
-        // LOG_INFO(token_stream.to_string(), LogCategory::PARSER);
+            // LOG_INFO(token_stream.to_string(), LogCategory::PARSER);
 
-        // Step 2: Parse the source code
-        Parser parser(token_stream);
-        auto parse_result = parser.parse();
-        
-        if (!parse_result.is_success()) {
-            std::cerr << "Parse Error: Failed to parse " << filepath << std::endl;
-            return 1;
+            // Step 2: Parse the source code
+            parser = std::make_unique<Parser>(token_stream);
+            auto parse_result = parser->parse();
+            
+            if (!parse_result.is_success()) {
+                std::cerr << "Parse Error: Failed to parse " << filepath << std::endl;
+                return 1;
+            }
+
+            parser->get_diagnostics().print();
+            
+            compilation_unit = parse_result.get_node();
+            if (!compilation_unit) {
+                std::cerr << "Error: No AST generated" << std::endl;
+                return 1;
+            }
+            
+            // Trees with parse errors are not cached
+            if (!ast_cache_path.empty() && !ast_save_binary(compilation_unit, source_code, ast_cache_path)) {
+                LOG_WARN("Could not write the AST cache: " + ast_cache_path, LogCategory::PARSER);
+            }
         }
 
-        parser.get_diagnostics().print();
-        
-        auto* compilation_unit = parse_result.get_node();
-        if (!compilation_unit) {
-            std::cerr << "Error: No AST generated" << std::endl;
-            return 1;
+        // Optionally relocate the tree into traversal order for the passes below
+        AstAllocator compact_allocator;
+        if (compact_ast) {
+            compilation_unit = ast_compact(compilation_unit, compact_allocator);
         }
 
-        AstPrinterVisitor printer;
-        compilation_unit->accept(&printer);
+        if (dump_options.enabled) {
+            if (dump_options.output_path.empty()) {
+                ast_dump(compilation_unit, dump_options.format, std::cout);
+            } else {
+                std::ofstream dump_file(dump_options.output_path, std::ios::binary);
+                if (!dump_file.is_open()) {
+                    std::cerr << "Error: Could not open AST dump file: " << dump_options.output_path << std::endl;
+                    return 1;
+                }
+                ast_dump(compilation_unit, dump_options.format, dump_file);
+            }
+        }
         
-        // Step 3: Build symbol table
+        // Step 3: Build symbol table, starting from the interfaces of the modules
+        // the script is using, which are looked for next to it
         SymbolTable symbol_table;
-        build_symbol_table(symbol_table, compilation_unit);
+        std::string script_directory = std::filesystem::path(filepath).parent_path().string();
+        for (const AstPassDiagnostic& diagnostic : import_modules(symbol_table, compilation_unit, script_directory)) {
+            LOG_WARN(diagnostic.message, LogCategory::SEMANTIC);
+        }
+        // Declarations are built serially, then function bodies are analyzed on
+        // one worker per hardware thread
+        AstTaskPool pool;
+        for (const AstPassDiagnostic& diagnostic : build_symbol_table(symbol_table, compilation_unit, pool)) {
+            LOG_ERROR(diagnostic.message, LogCategory::SEMANTIC);
+        }
+        
+        if (!interface_path.empty()) {
+            std::string module_name = std::filesystem::path(filepath).stem().string();
+            ModuleInterface module = ModuleInterface::extract(symbol_table, compilation_unit, module_name, source_hash);
+            if (!module.save(interface_path)) {
+                std::cerr << "Error: Could not write module interface: " << interface_path << std::endl;
+                return 1;
+            }
+            LOG_INFO("Wrote " + std::to_string(module.declarations.size()) + " declarations of module '" + module_name +
+                     "' to " + interface_path, LogCategory::SEMANTIC);
+        }
+        
+        // Step 3b: Evaluate what does not depend on run-time values
+        for (const AstPassDiagnostic& diagnostic : fold_constants(symbol_table, compilation_unit)) {
+            LOG_WARN(diagnostic.message, LogCategory::SEMANTIC);
+        }
+        
+        // Step 3c: Leave out functions nothing can call, then find which of the
+        // rest are pure, so LLVM may merge and hoist their calls
+        CallGraph call_graph(symbol_table, compilation_unit);
+        DeadFunctionReport dead_functions = eliminate_dead_functions(symbol_table, call_graph);
+        if (!dead_functions.removed.empty()) {
+            std::string removed;
+            for (const std::string& name : dead_functions.removed) removed += (removed.empty() ? "" : ", ") + name;
+            LOG_INFO("Removed " + std::to_string(dead_functions.removed.size()) + " unreachable functions, kept " +
+                     std::to_string(dead_functions.kept) + ": " + removed, LogCategory::SEMANTIC);
+        }
+        analyze_effects(symbol_table, call_graph);
         
         // Debug: Print symbol table
         LOG_HEADER("Symbol Table", LogCategory::SEMANTIC);
@@ -140,8 +235,14 @@ int run_script(const std::string& filepath) {
 
 void print_usage(const std::string& program_name) {
     std::cout << "Myre Scripting Engine" << std::endl;
-    std::cout << "Usage: " << program_name << " <script.myre>" << std::endl;
-    std::cout << "Example: " << program_name << " test.myre" << std::endl;
+    std::cout << "Usage: " << program_name << " [options] <script.myre>" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --dump-ast=<pseudo|sexpr|json|none>  AST dump format (default: pseudo)" << std::endl;
+    std::cout << "  --dump-ast-file=<path>               Write the AST dump to a file instead of stdout" << std::endl;
+    std::cout << "  --compact-ast                        Copy the AST into traversal order after parsing" << std::endl;
+    std::cout << "  --emit-interface=<path>              Write the script's module interface, for `using` it elsewhere" << std::endl;
+    std::cout << "  --ast-cache=<path>                   Load the AST from this binary cache, or parse and write it" << std::endl;
+    std::cout << "Example: " << program_name << " --dump-ast=json test.myre" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -150,17 +251,42 @@ int main(int argc, char* argv[]) {
     logger.initialize();
     logger.set_console_level(LogLevel::TRACE); // Only show errors for cleaner output
     
-    // Initialize RTTI system
-    AstTypeInfo::initialize();
-    
     // Check command line arguments
-    if (argc != 2) {
+    AstDumpOptions dump_options;
+    bool compact_ast = false;
+    std::string interface_path;
+    std::string ast_cache_path;
+    std::string script_path;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg.starts_with("--dump-ast=")) {
+            std::string_view format = arg.substr(std::string_view("--dump-ast=").size());
+            dump_options.enabled = format != "none";
+            if (dump_options.enabled && !parse_ast_dump_format(format, dump_options.format)) {
+                std::cerr << "Error: Unknown AST dump format: " << format << std::endl;
+                return 1;
+            }
+        } else if (arg.starts_with("--dump-ast-file=")) {
+            dump_options.output_path = std::string(arg.substr(std::string_view("--dump-ast-file=").size()));
+        } else if (arg == "--compact-ast") {
+            compact_ast = true;
+        } else if (arg.starts_with("--emit-interface=")) {
+            interface_path = std::string(arg.substr(std::string_view("--emit-interface=").size()));
+        } else if (arg.starts_with("--ast-cache=")) {
+            ast_cache_path = std::string(arg.substr(std::string_view("--ast-cache=").size()));
+        } else if (script_path.empty() && !arg.starts_with("--")) {
+            script_path = std::string(arg);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    
+    if (script_path.empty()) {
         print_usage(argv[0]);
         return 1;
     }
     
-    std::string script_path = argv[1];
-    
     // Check if file exists
     if (!std::filesystem::exists(script_path)) {
         std::cerr << "Error: File does not exist: " << script_path << std::endl;
@@ -173,5 +299,5 @@ int main(int argc, char* argv[]) {
     }
     
     // Run the script
-    return run_script(script_path);
+    return run_script(script_path, dump_options, compact_ast, interface_path, ast_cache_path);
 }
\ No newline at end of file
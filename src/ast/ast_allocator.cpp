@@ -8,6 +8,7 @@ namespace Mycelium::Scripting::Lang
     {
         headPage = nullptr;
         currentPage = nullptr;
+        nextNodeId = 0;
         new_page();
     }
 
@@ -15,15 +16,24 @@ namespace Mycelium::Scripting::Lang
     {
         for (auto page : allPages)
         {
+#ifdef MYCELIUM_AST_COMPRESSED_HANDLES
+            AstArena::release_page(page);
+#else
             // Using free since pages are allocated with malloc.
             free(page);
+#endif
         }
     }
 
     void AstAllocator::new_page()
     {
         // Allocate memory for a new page struct.
+#ifdef MYCELIUM_AST_COMPRESSED_HANDLES
+        static_assert(sizeof(AstPage) <= AstArena::PAGE_BYTES, "AstPage must fit in an arena page");
+        AstPage* new_page_ptr = (AstPage*)AstArena::allocate_page();
+#else
         AstPage* new_page_ptr = (AstPage*)malloc(sizeof(AstPage));
+#endif
         if (!new_page_ptr)
         {
             // In a real-world compiler, you might throw an exception or
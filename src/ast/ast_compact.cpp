@@ -0,0 +1,68 @@
+#include "ast/ast_compact.hpp"
+#include "ast/ast_walker.hpp"
+#include <cstring>
+#include <new>
+
+namespace Mycelium::Scripting::Lang
+{
+    class AstCompactor
+    {
+    private:
+        AstAllocator& target_;
+
+        template <typename T>
+        void copy_array(SizedArray<T>& array)
+        {
+            if (array.size <= 0) {
+                array.values = nullptr;
+                return;
+            }
+            T* values = target_.alloc_array<T>(array.size);
+            memcpy(static_cast<void*>(values), array.begin(), sizeof(T) * array.size);
+            array.values = values;
+        }
+
+    public:
+        explicit AstCompactor(AstAllocator& target) : target_(target) {}
+
+        AstNode* copy(AstNode* node)
+        {
+            if (!node) return nullptr;
+
+            return ast_dispatch(node, [this](auto* typed) -> AstNode* {
+                using T = std::remove_pointer_t<decltype(typed)>;
+                T* copy = new (target_.alloc_bytes(sizeof(T), alignof(T))) T(*typed);
+                copy->nodeId = target_.next_node_id();
+
+                // Arrays first, so they sit next to the node that owns them
+                ast_visit_fields(copy, [this](auto& field) {
+                    if constexpr (!std::is_convertible_v<decltype(field), AstNode*>) copy_array(field);
+                });
+                ast_visit_data_fields(copy, [this](auto& field) {
+                    using Field = std::decay_t<decltype(field)>;
+                    if constexpr (!std::is_same_v<Field, std::string_view> && !std::is_same_v<Field, std::string>) copy_array(field);
+                });
+
+                ast_visit_fields(copy, [this](auto& field) {
+                    if constexpr (std::is_convertible_v<decltype(field), AstNode*>) {
+                        field = static_cast<decltype(ast_ptr_get(field))>(this->copy(field));
+                    } else {
+                        using Element = std::remove_reference_t<decltype(field.values[0])>;
+                        for (int i = 0; i < field.size; ++i) {
+                            field.values[i] = static_cast<Element>(this->copy(field.values[i]));
+                        }
+                    }
+                });
+                ast_visit_aliases(copy, [](auto& alias, auto* target) { alias = target; });
+                return copy;
+            });
+        }
+    };
+
+    AstNode* ast_compact_node(AstNode* root, AstAllocator& target)
+    {
+        AstCompactor compactor(target);
+        return compactor.copy(root);
+    }
+
+} // namespace Mycelium::Scripting::Lang
@@ -0,0 +1,360 @@
+#include "ast/ast_dumper.hpp"
+#include "ast/ast_printer.hpp"
+#include "ast/ast_parallel.hpp"
+#include "ast/ast_walker.hpp"
+#include <charconv>
+#include <ostream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace Mycelium::Scripting::Lang
+{
+    bool parse_ast_dump_format(std::string_view name, AstDumpFormat& out)
+    {
+        if (name == "pseudo") out = AstDumpFormat::PseudoCode;
+        else if (name == "sexpr") out = AstDumpFormat::SExpression;
+        else if (name == "json") out = AstDumpFormat::Json;
+        else return false;
+        return true;
+    }
+
+    // --- AstDumpWriter ---
+
+    AstDumpWriter::AstDumpWriter(std::ostream& stream) : stream_(&stream)
+    {
+        buffer_.reserve(FLUSH_THRESHOLD + 4096);
+    }
+
+    AstDumpWriter::AstDumpWriter(int fd) : fd_(fd)
+    {
+        buffer_.reserve(FLUSH_THRESHOLD + 4096);
+    }
+
+    void AstDumpWriter::write_int(long long value)
+    {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        write(std::string_view(digits, result.ptr - digits));
+    }
+
+    void AstDumpWriter::flush()
+    {
+        if (buffer_.empty() || (!stream_ && fd_ < 0)) return;
+
+        if (stream_) {
+            stream_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        } else if (fd_ >= 0) {
+            const char* data = buffer_.data();
+            size_t remaining = buffer_.size();
+            while (remaining > 0) {
+#ifdef _WIN32
+                int written = _write(fd_, data, static_cast<unsigned int>(remaining));
+#else
+                ssize_t written = ::write(fd_, data, remaining);
+#endif
+                if (written <= 0) break;
+                data += written;
+                remaining -= static_cast<size_t>(written);
+            }
+        }
+        buffer_.clear();
+    }
+
+    // --- Node Attributes ---
+    // The non-child content of a node, shared by the S-expression and JSON
+    // dumpers. Punctuation and keywords appear as TokenNode children instead.
+
+    template <typename T, typename Out>
+    static void dump_attributes(T* node, Out& out)
+    {
+        if constexpr (std::is_base_of_v<TokenNode, T>) out.text("text", node->text);
+        if constexpr (std::is_base_of_v<IdentifierNode, T>) out.text("name", node->name);
+        if constexpr (std::is_base_of_v<LiteralExpressionNode, T>) out.symbol("kind", to_string(node->kind));
+        if constexpr (std::is_base_of_v<UnaryExpressionNode, T>) {
+            out.symbol("op", to_string(node->opKind));
+            if (node->isPostfix) out.symbol("postfix", "true");
+        }
+        if constexpr (std::is_base_of_v<BinaryExpressionNode, T>) out.symbol("op", to_string(node->opKind));
+        if constexpr (std::is_base_of_v<AssignmentExpressionNode, T>) out.symbol("op", to_string(node->opKind));
+        if constexpr (std::is_base_of_v<DeclarationNode, T> || std::is_base_of_v<PropertyAccessorNode, T>) {
+            if (!node->modifiers.empty()) out.modifiers(node->modifiers);
+        }
+        if constexpr (std::is_base_of_v<ErrorNode, T>) out.text("error", node->error_message);
+    }
+
+    template <typename F>
+    static void for_each_child(AstNode* node, F&& f)
+    {
+        ast_dispatch(node, [&](auto* typed) {
+            ast_visit_fields(typed, [&](auto& field) {
+                if constexpr (std::is_convertible_v<decltype(field), AstNode*>) {
+                    if (field) f(static_cast<AstNode*>(field));
+                } else {
+                    for (int i = 0; i < field.size; ++i) {
+                        if (field.values[i]) f(static_cast<AstNode*>(field.values[i]));
+                    }
+                }
+            });
+        });
+    }
+
+    // --- S-Expression ---
+
+    class SExpressionDumper
+    {
+    private:
+        AstDumpWriter& out_;
+
+        void quoted(std::string_view text)
+        {
+            out_.put('"');
+            for (char c : text) {
+                if (c == '"' || c == '\\') out_.put('\\');
+                if (c == '\n') { out_.write("\\n"); continue; }
+                out_.put(c);
+            }
+            out_.put('"');
+        }
+
+    public:
+        explicit SExpressionDumper(AstDumpWriter& out) : out_(out) {}
+
+        void text(std::string_view key, std::string_view value) { out_.write(" :"); out_.write(key); out_.put(' '); quoted(value); }
+        void symbol(std::string_view key, std::string_view value) { out_.write(" :"); out_.write(key); out_.put(' '); out_.write(value); }
+        void modifiers(const SizedArray<ModifierKind>& modifiers)
+        {
+            out_.write(" :modifiers (");
+            for (int i = 0; i < modifiers.size; ++i) {
+                if (i > 0) out_.put(' ');
+                out_.write(to_string(modifiers.values[i]));
+            }
+            out_.put(')');
+        }
+
+        void dump(AstNode* node, int depth)
+        {
+            if (depth > 0) {
+                out_.put('\n');
+                out_.write_indent(depth);
+            }
+            out_.put('(');
+            out_.write(g_ordered_type_infos[node->typeId]->name);
+            ast_dispatch(node, [&](auto* typed) { dump_attributes(typed, *this); });
+            for_each_child(node, [&](AstNode* child) { dump(child, depth + 1); });
+            out_.put(')');
+        }
+    };
+
+    // --- JSON ---
+
+    class JsonDumper
+    {
+    private:
+        AstDumpWriter& out_;
+
+        void string(std::string_view text)
+        {
+            static const char HEX[] = "0123456789abcdef";
+            out_.put('"');
+            for (char c : text) {
+                unsigned char byte = static_cast<unsigned char>(c);
+                if (c == '"' || c == '\\') { out_.put('\\'); out_.put(c); }
+                else if (c == '\n') out_.write("\\n");
+                else if (c == '\r') out_.write("\\r");
+                else if (c == '\t') out_.write("\\t");
+                else if (byte < 0x20) { out_.write("\\u00"); out_.put(HEX[byte >> 4]); out_.put(HEX[byte & 0xF]); }
+                else out_.put(c);
+            }
+            out_.put('"');
+        }
+
+        void key(std::string_view name)
+        {
+            out_.write(",\"");
+            out_.write(name);
+            out_.write("\":");
+        }
+
+    public:
+        explicit JsonDumper(AstDumpWriter& out) : out_(out) {}
+
+        void text(std::string_view name, std::string_view value) { key(name); string(value); }
+        void symbol(std::string_view name, std::string_view value) { key(name); string(value); }
+        void modifiers(const SizedArray<ModifierKind>& modifiers)
+        {
+            key("modifiers");
+            out_.put('[');
+            for (int i = 0; i < modifiers.size; ++i) {
+                if (i > 0) out_.put(',');
+                string(to_string(modifiers.values[i]));
+            }
+            out_.put(']');
+        }
+
+        void dump(AstNode* node, int depth)
+        {
+            out_.write("{\"type\":\"");
+            out_.write(g_ordered_type_infos[node->typeId]->name);
+            out_.write("\",\"span\":[");
+            out_.write_int(node->sourceStart);
+            out_.put(',');
+            out_.write_int(node->sourceLength);
+            out_.put(']');
+            ast_dispatch(node, [&](auto* typed) { dump_attributes(typed, *this); });
+
+            bool first = true;
+            for_each_child(node, [&](AstNode* child) {
+                out_.write(first ? ",\"children\":[\n" : ",\n");
+                first = false;
+                out_.write_indent(depth + 1);
+                dump(child, depth + 1);
+            });
+            if (!first) out_.put(']');
+            out_.put('}');
+        }
+    };
+
+    // --- Entry Points ---
+
+    void ast_dump(AstNode* root, AstDumpFormat format, AstDumpWriter& out)
+    {
+        if (!root) return;
+
+        switch (format) {
+            case AstDumpFormat::PseudoCode: {
+                AstPrinterVisitor printer(out);
+                root->accept(&printer);
+                break;
+            }
+            case AstDumpFormat::SExpression: {
+                SExpressionDumper dumper(out);
+                dumper.dump(root, 0);
+                out.put('\n');
+                break;
+            }
+            case AstDumpFormat::Json: {
+                JsonDumper dumper(out);
+                dumper.dump(root, 0);
+                out.put('\n');
+                break;
+            }
+        }
+        out.flush();
+    }
+
+    void ast_dump(AstNode* root, AstDumpFormat format, std::ostream& out)
+    {
+        AstDumpWriter writer(out);
+        ast_dump(root, format, writer);
+    }
+
+    void ast_dump(AstNode* root, AstDumpFormat format, int fd)
+    {
+        AstDumpWriter writer(fd);
+        ast_dump(root, format, writer);
+    }
+
+    // --- Parallel Dump ---
+    // Each statement is dumped into its own in-memory writer at the depth it has
+    // under the root. merge() then adds the separators the serial dumpers write
+    // between children.
+
+    class AstDumpPass : public AstParallelPass
+    {
+    private:
+        AstDumpFormat format_;
+        AstDumpWriter& out_;
+        std::vector<std::unique_ptr<AstDumpWriter>> pieces_;
+        bool first_ = true;
+
+    public:
+        AstDumpPass(AstDumpFormat format, AstDumpWriter& out) : format_(format), out_(out) {}
+
+        void begin(CompilationUnitNode* root, const std::vector<AstPassUnit>& units) override
+        {
+            pieces_.resize(units.size());
+            switch (format_) {
+                case AstDumpFormat::PseudoCode:
+                    out_.write("// Compilation Unit\n");
+                    break;
+                case AstDumpFormat::SExpression:
+                    out_.put('(');
+                    out_.write(g_ordered_type_infos[root->typeId]->name);
+                    break;
+                case AstDumpFormat::Json:
+                    out_.write("{\"type\":\"");
+                    out_.write(g_ordered_type_infos[root->typeId]->name);
+                    out_.write("\",\"span\":[");
+                    out_.write_int(root->sourceStart);
+                    out_.put(',');
+                    out_.write_int(root->sourceLength);
+                    out_.put(']');
+                    break;
+            }
+        }
+
+        void run(const AstPassUnit& unit, AstPassContext& context) override
+        {
+            auto piece = std::make_unique<AstDumpWriter>();
+            switch (format_) {
+                case AstDumpFormat::PseudoCode: {
+                    AstPrinterVisitor printer(*piece);
+                    printer.print_statement(unit.node);
+                    break;
+                }
+                case AstDumpFormat::SExpression:
+                    SExpressionDumper(*piece).dump(unit.node, 1);
+                    break;
+                case AstDumpFormat::Json:
+                    JsonDumper(*piece).dump(unit.node, 1);
+                    break;
+            }
+            pieces_[context.unit_index()] = std::move(piece);
+        }
+
+        void merge(const AstPassUnit&, AstPassContext& context) override
+        {
+            if (format_ == AstDumpFormat::Json) {
+                out_.write(first_ ? ",\"children\":[\n" : ",\n");
+                out_.write_indent(1);
+            }
+            first_ = false;
+            out_.write(pieces_[context.unit_index()]->buffer());
+            pieces_[context.unit_index()].reset();
+        }
+
+        void end()
+        {
+            switch (format_) {
+                case AstDumpFormat::PseudoCode:
+                    break;
+                case AstDumpFormat::SExpression:
+                    out_.write(")\n");
+                    break;
+                case AstDumpFormat::Json:
+                    if (!first_) out_.put(']');
+                    out_.write("}\n");
+                    break;
+            }
+        }
+    };
+
+    void ast_dump(AstNode* root, AstDumpFormat format, AstDumpWriter& out, AstTaskPool& pool)
+    {
+        auto* unit = root ? node_cast<CompilationUnitNode>(root) : nullptr;
+        if (!unit || pool.worker_count() == 1) {
+            ast_dump(root, format, out);
+            return;
+        }
+
+        AstDumpPass pass(format, out);
+        ast_run_parallel_pass(unit, pass, pool);
+        pass.end();
+        out.flush();
+    }
+
+} // namespace Mycelium::Scripting::Lang
@@ -0,0 +1,84 @@
+#include "ast/ast_handle.hpp"
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace Mycelium::Scripting::Lang
+{
+    // Commit in larger steps than a page to keep system calls off the allocation path
+    static constexpr size_t COMMIT_STEP = 1024 * 1024;
+
+    static std::mutex arena_mutex;
+    static size_t arena_used = 0;      // Bytes handed out from the front of the range
+    static size_t arena_committed = 0; // Bytes backed by memory
+    static std::vector<void*> arena_free_pages;
+
+    static uint8_t* reserve_range()
+    {
+#ifdef _WIN32
+        void* range = VirtualAlloc(nullptr, AstArena::RESERVED_BYTES, MEM_RESERVE, PAGE_NOACCESS);
+        return static_cast<uint8_t*>(range);
+#else
+        void* range = mmap(nullptr, AstArena::RESERVED_BYTES, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        return range == MAP_FAILED ? nullptr : static_cast<uint8_t*>(range);
+#endif
+    }
+
+    static bool commit_range(uint8_t* start, size_t size)
+    {
+#ifdef _WIN32
+        return VirtualAlloc(start, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+        return mprotect(start, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+    }
+
+    void* AstArena::allocate_page()
+    {
+        std::lock_guard<std::mutex> lock(arena_mutex);
+
+        if (!arena_free_pages.empty()) {
+            void* page = arena_free_pages.back();
+            arena_free_pages.pop_back();
+            return page;
+        }
+
+        if (!base) {
+            base = reserve_range();
+            if (!base) abort();
+            arena_used = PAGE_BYTES; // Offset 0 is the null handle
+        }
+
+        if (arena_used + PAGE_BYTES > RESERVED_BYTES) abort();
+        if (arena_used + PAGE_BYTES > arena_committed) {
+            size_t step = COMMIT_STEP;
+            if (arena_committed + step > RESERVED_BYTES) step = RESERVED_BYTES - arena_committed;
+            if (!commit_range(base + arena_committed, step)) abort();
+            arena_committed += step;
+        }
+
+        void* page = base + arena_used;
+        arena_used += PAGE_BYTES;
+        return page;
+    }
+
+    void AstArena::release_page(void* page)
+    {
+        std::lock_guard<std::mutex> lock(arena_mutex);
+        arena_free_pages.push_back(page);
+    }
+
+    size_t AstArena::committed_bytes()
+    {
+        std::lock_guard<std::mutex> lock(arena_mutex);
+        return arena_committed;
+    }
+
+} // namespace Mycelium::Scripting::Lang
@@ -0,0 +1,101 @@
+#include "ast/ast_hash.hpp"
+#include "ast/ast_parallel.hpp"
+#include "ast/ast_walker.hpp"
+#include <string>
+#include <string_view>
+
+namespace Mycelium::Scripting::Lang
+{
+    static constexpr uint64_t NULL_CHILD_HASH = 0x6e756c6c6e6f6465ull;
+
+    // splitmix64 finalizer; spreads every input bit over the whole word
+    static uint64_t mix(uint64_t value)
+    {
+        value += 0x9e3779b97f4a7c15ull;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+    }
+
+    static uint64_t combine(uint64_t hash, uint64_t value)
+    {
+        return mix(hash ^ mix(value));
+    }
+
+    static uint64_t hash_text(std::string_view text)
+    {
+        uint64_t hash = 1469598103934665603ull;
+        for (char c : text) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+        return combine(hash, text.size());
+    }
+
+    static uint64_t hash_node(AstNode* node)
+    {
+        if (!node) return NULL_CHILD_HASH;
+
+        return ast_dispatch(node, [](auto* typed) -> uint64_t {
+            using T = std::remove_pointer_t<decltype(typed)>;
+            uint64_t hash = mix(typed->typeId);
+
+            ast_visit_value_fields(typed, [&](auto value) {
+                hash = combine(hash, static_cast<uint64_t>(value));
+            });
+
+            ast_visit_data_fields(typed, [&](auto& field) {
+                using Field = std::decay_t<decltype(field)>;
+                if constexpr (std::is_same_v<Field, std::string_view> || std::is_same_v<Field, std::string>) {
+                    hash = combine(hash, hash_text(field));
+                } else {
+                    hash = combine(hash, static_cast<uint64_t>(field.size));
+                    for (int i = 0; i < field.size; ++i) {
+                        hash = combine(hash, static_cast<uint64_t>(field.values[i]));
+                    }
+                }
+            });
+
+            ast_visit_fields(typed, [&](auto& field) {
+                if constexpr (std::is_convertible_v<decltype(field), AstNode*>) {
+                    hash = combine(hash, hash_node(field));
+                } else {
+                    hash = combine(hash, static_cast<uint64_t>(field.size));
+                    for (int i = 0; i < field.size; ++i) {
+                        hash = combine(hash, hash_node(field.values[i]));
+                    }
+                }
+            });
+
+            if constexpr (std::is_same_v<T, FunctionDeclarationNode> || std::is_same_v<T, TypeDeclarationNode>) {
+                typed->structuralHash = hash;
+            }
+            return hash;
+        });
+    }
+
+    uint64_t ast_structural_hash(AstNode* node)
+    {
+        return hash_node(node);
+    }
+
+    void ast_compute_structural_hashes(CompilationUnitNode* root)
+    {
+        hash_node(root);
+    }
+
+    // Every declaration stores its own hash, so top-level statements can be
+    // hashed independently. Only the root's hash is skipped, and it is never stored.
+    class StructuralHashPass : public AstParallelPass
+    {
+    public:
+        void run(const AstPassUnit& unit, AstPassContext&) override { hash_node(unit.node); }
+    };
+
+    void ast_compute_structural_hashes(CompilationUnitNode* root, AstTaskPool& pool)
+    {
+        StructuralHashPass pass;
+        ast_run_parallel_pass(root, pass, pool);
+    }
+
+} // namespace Mycelium::Scripting::Lang
@@ -0,0 +1,232 @@
+#include "ast/ast_parallel.hpp"
+#include <algorithm>
+
+namespace Mycelium::Scripting::Lang
+{
+    // --- AstTaskPool ---
+
+    AstTaskPool::AstTaskPool(unsigned worker_count)
+    {
+        if (worker_count == 0) worker_count = std::max(1u, std::thread::hardware_concurrency());
+        workerCount_ = worker_count;
+
+        for (unsigned i = 0; i < workerCount_; ++i) {
+            queues_.push_back(std::make_unique<WorkerQueue>());
+        }
+        for (unsigned i = 1; i < workerCount_; ++i) {
+            threads_.emplace_back(&AstTaskPool::helper_main, this, i);
+        }
+    }
+
+    AstTaskPool::~AstTaskPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(jobMutex_);
+            stopping_ = true;
+        }
+        jobReady_.notify_all();
+        for (auto& thread : threads_) thread.join();
+    }
+
+    void AstTaskPool::run(size_t count, const Task& task)
+    {
+        if (count == 0) return;
+
+        job_ = &task;
+        error_ = nullptr;
+        errorIndex_ = count;
+
+        // Deal out contiguous blocks so each worker starts on neighbouring subtrees
+        unsigned workers = count < workerCount_ ? static_cast<unsigned>(count) : workerCount_;
+        for (unsigned w = 0; w < workers; ++w) {
+            std::lock_guard<std::mutex> lock(queues_[w]->mutex);
+            for (size_t i = count * w / workers; i < count * (w + 1) / workers; ++i) {
+                queues_[w]->tasks.push_back(i);
+            }
+        }
+
+        bool use_helpers = workers > 1;
+        if (use_helpers) {
+            {
+                std::lock_guard<std::mutex> lock(jobMutex_);
+                activeHelpers_ = static_cast<unsigned>(threads_.size());
+                ++jobGeneration_;
+            }
+            jobReady_.notify_all();
+        }
+
+        work(0);
+
+        if (use_helpers) {
+            std::unique_lock<std::mutex> lock(jobMutex_);
+            jobDone_.wait(lock, [this] { return activeHelpers_ == 0; });
+        }
+        job_ = nullptr;
+
+        if (error_) {
+            std::exception_ptr error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    bool AstTaskPool::take_local(unsigned worker, size_t& index)
+    {
+        WorkerQueue& queue = *queues_[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) return false;
+        index = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+    }
+
+    bool AstTaskPool::steal(unsigned worker, size_t& index)
+    {
+        for (unsigned offset = 1; offset < workerCount_; ++offset) {
+            WorkerQueue& victim = *queues_[(worker + offset) % workerCount_];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.tasks.empty()) continue;
+            // Take from the far end, away from where the owner is working
+            index = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+        return false;
+    }
+
+    void AstTaskPool::work(unsigned worker)
+    {
+        size_t index;
+        while (take_local(worker, index) || steal(worker, index)) {
+            try {
+                (*job_)(index, worker);
+            } catch (...) {
+                // Keep the failure of the lowest task, so the error does not depend on timing
+                std::lock_guard<std::mutex> lock(errorMutex_);
+                if (index < errorIndex_) {
+                    errorIndex_ = index;
+                    error_ = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void AstTaskPool::helper_main(unsigned worker)
+    {
+        uint64_t seen_generation = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(jobMutex_);
+                jobReady_.wait(lock, [&] { return stopping_ || jobGeneration_ != seen_generation; });
+                if (stopping_) return;
+                seen_generation = jobGeneration_;
+            }
+
+            work(worker);
+
+            std::lock_guard<std::mutex> lock(jobMutex_);
+            if (--activeHelpers_ == 0) jobDone_.notify_one();
+        }
+    }
+
+
+    // --- Unit Collection ---
+
+    static void collect_members(AstNode* node, std::vector<AstPassUnit>& units)
+    {
+        if (!node) return;
+
+        if (auto* type = node_cast<TypeDeclarationNode>(node)) {
+            for (AstNode* member : type->members) {
+                if (member) units.push_back({ member, nullptr, type });
+            }
+        } else if (auto* interface_decl = node_cast<InterfaceDeclarationNode>(node)) {
+            for (MemberDeclarationNode* member : interface_decl->members) {
+                if (member) units.push_back({ member, nullptr, interface_decl });
+            }
+        } else if (auto* enum_decl = node_cast<EnumDeclarationNode>(node)) {
+            // Cases and methods are separate arrays; interleave them back into source order
+            size_t first = units.size();
+            for (EnumCaseNode* enum_case : enum_decl->cases) {
+                if (enum_case) units.push_back({ enum_case, nullptr, enum_decl });
+            }
+            for (FunctionDeclarationNode* method : enum_decl->methods) {
+                if (method) units.push_back({ method, nullptr, enum_decl });
+            }
+            std::stable_sort(units.begin() + first, units.end(), [](const AstPassUnit& a, const AstPassUnit& b) {
+                return a.node->sourceStart < b.node->sourceStart;
+            });
+        } else if (auto* namespace_decl = node_cast<NamespaceDeclarationNode>(node); namespace_decl && namespace_decl->body) {
+            for (AstNode* statement : namespace_decl->body->statements) {
+                collect_members(statement, units);
+            }
+        } else {
+            units.push_back({ node, nullptr, nullptr });
+        }
+    }
+
+    static void collect_body(AstNode* body, AstNode* owner, AstNode* owner_type, std::vector<AstPassUnit>& units)
+    {
+        if (body) units.push_back({ body, owner, owner_type });
+    }
+
+    std::vector<AstPassUnit> ast_collect_pass_units(CompilationUnitNode* root, AstPassGranularity granularity)
+    {
+        std::vector<AstPassUnit> units;
+        if (!root) return units;
+
+        if (granularity == AstPassGranularity::TopLevel) {
+            for (AstNode* statement : root->statements) {
+                if (statement) units.push_back({ statement, nullptr, nullptr });
+            }
+            return units;
+        }
+
+        for (AstNode* statement : root->statements) {
+            collect_members(statement, units);
+        }
+        if (granularity == AstPassGranularity::Members) return units;
+
+        std::vector<AstPassUnit> bodies;
+        for (const AstPassUnit& member : units) {
+            if (auto* function = node_cast<FunctionDeclarationNode>(member.node)) {
+                collect_body(function->body, function, member.ownerType, bodies);
+            } else if (auto* constructor = node_cast<ConstructorDeclarationNode>(member.node)) {
+                collect_body(constructor->body, constructor, member.ownerType, bodies);
+            } else if (auto* property = node_cast<PropertyDeclarationNode>(member.node)) {
+                for (PropertyAccessorNode* accessor : property->accessors) {
+                    if (accessor) collect_body(accessor->body, accessor, member.ownerType, bodies);
+                }
+            }
+        }
+        return bodies;
+    }
+
+
+    // --- Pass Driver ---
+
+    std::vector<AstPassDiagnostic> ast_run_parallel_pass(CompilationUnitNode* root, AstParallelPass& pass, AstTaskPool& pool)
+    {
+        std::vector<AstPassDiagnostic> diagnostics;
+        if (!root) return diagnostics;
+
+        std::vector<AstPassUnit> units = ast_collect_pass_units(root, pass.granularity());
+        std::vector<AstPassContext> contexts;
+        contexts.reserve(units.size());
+        for (size_t i = 0; i < units.size(); ++i) contexts.emplace_back(i);
+
+        pass.begin(root, units);
+        pool.run(units.size(), [&](size_t index, unsigned worker) {
+            contexts[index].worker_ = worker;
+            pass.run(units[index], contexts[index]);
+        });
+
+        for (size_t i = 0; i < units.size(); ++i) {
+            pass.merge(units[i], contexts[i]);
+            for (auto& diagnostic : contexts[i].diagnostics_) diagnostics.push_back(std::move(diagnostic));
+            contexts[i].scratch_.reset();
+        }
+        return diagnostics;
+    }
+
+} // namespace Mycelium::Scripting::Lang
@@ -0,0 +1,543 @@
+#include "ast/ast_serializer.hpp"
+#include "ast/ast_walker.hpp"
+#include "common/logger.hpp"
+#include <cstring>
+#include <limits>
+#include <fstream>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Mycelium::Scripting::Lang
+{
+    using namespace Mycelium::Scripting::Common;
+
+    static const char AST_BINARY_MAGIC[4] = { 'M', 'A', 'S', 'T' };
+
+    // --- Hashing ---
+
+    static uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 1469598103934665603ull)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t ast_hash_source(std::string_view source)
+    {
+        return fnv1a(source.data(), source.size());
+    }
+
+    uint64_t ast_binary_layout_hash()
+    {
+        static const uint64_t hash = [] {
+            uint64_t h = fnv1a(&AST_BINARY_VERSION, sizeof(AST_BINARY_VERSION));
+            uint32_t pointer_size = sizeof(void*);
+            uint32_t type_count = AST_TYPE_COUNT;
+            h = fnv1a(&pointer_size, sizeof(pointer_size), h);
+            h = fnv1a(&type_count, sizeof(type_count), h);
+            #define AST_LAYOUT_HASH_ENTRY(NodeType, BaseType) \
+                { uint32_t layout[2] = { sizeof(NodeType), alignof(NodeType) }; h = fnv1a(layout, sizeof(layout), h); }
+            AST_NODE_LIST(AST_LAYOUT_HASH_ENTRY)
+            #undef AST_LAYOUT_HASH_ENTRY
+            return h;
+        }();
+        return hash;
+    }
+
+    // Encoded offsets are stored in the field itself, so a slot is as wide as AstPtr:
+    // 8 bytes normally, 4 with compressed handles.
+    using AstSlot = std::conditional_t<sizeof(AstPtr<AstNode>) == sizeof(uint32_t), uint32_t, uintptr_t>;
+
+    template <typename T> static uint64_t encoded_slot(T* value) { return reinterpret_cast<uintptr_t>(value); }
+    template <typename T> static uint64_t encoded_slot(AstHandle<T> value) { return value.offset(); }
+
+    // --- Writer ---
+
+    class AstBinaryWriter
+    {
+    private:
+        std::vector<uint8_t>& buffer;
+        std::unordered_map<std::string_view, uint64_t> string_ids;
+        std::vector<std::string_view> strings;
+        uint32_t node_count = 0;
+        bool ok = true;
+
+        size_t append(const void* data, size_t size, size_t alignment)
+        {
+            size_t offset = (buffer.size() + alignment - 1) & ~(alignment - 1);
+            buffer.resize(offset + size);
+            if (data) memcpy(buffer.data() + offset, data, size);
+            return offset;
+        }
+
+        template <typename T>
+        void store(size_t offset, const T& value)
+        {
+            memcpy(buffer.data() + offset, &value, sizeof(T));
+        }
+
+        uint64_t intern(std::string_view text)
+        {
+            auto it = string_ids.find(text);
+            if (it != string_ids.end()) return it->second;
+            strings.push_back(text);
+            uint64_t id = strings.size(); // Encoded as index + 1
+            string_ids.emplace(text, id);
+            return id;
+        }
+
+        void store_slot(size_t slot, uint64_t encoded)
+        {
+            if (encoded > std::numeric_limits<AstSlot>::max()) ok = false;
+            store<AstSlot>(slot, static_cast<AstSlot>(encoded));
+        }
+
+        template <typename T>
+        void write_field(size_t slot, T* node)
+        {
+            store_slot(slot, write_node(node));
+        }
+
+        template <typename T>
+        void write_field(size_t slot, AstHandle<T> node)
+        {
+            store_slot(slot, write_node(node.get()));
+        }
+
+        template <typename T>
+        void write_field(size_t slot, const SizedArray<T*>& array)
+        {
+            if (array.empty()) {
+                store_slot(slot, 0);
+                return;
+            }
+            size_t values = append(nullptr, sizeof(T*) * array.size, alignof(T*));
+            for (int i = 0; i < array.size; ++i) {
+                store<uintptr_t>(values + i * sizeof(T*), write_node(array.values[i]));
+            }
+            store_slot(slot, values + 1);
+        }
+
+        void write_field(size_t slot, const SizedArray<ModifierKind>& array)
+        {
+            if (array.empty()) {
+                store_slot(slot, 0);
+                return;
+            }
+            size_t values = append(array.begin(), sizeof(ModifierKind) * array.size, alignof(ModifierKind));
+            store_slot(slot, values + 1);
+        }
+
+        void write_field(size_t slot, std::string_view text)
+        {
+            uint64_t id = text.empty() ? 0 : intern(text);
+            store(slot, std::string_view(reinterpret_cast<const char*>(id), text.size()));
+        }
+
+        void write_field(size_t, const std::string&)
+        {
+            // Only ErrorNodes own strings, and those are rejected in write_node
+            ok = false;
+        }
+
+    public:
+        AstBinaryWriter(std::vector<uint8_t>& out) : buffer(out) {}
+
+        // Appends the node and its subtree; returns the encoded offset.
+        uint64_t write_node(AstNode* node)
+        {
+            if (!node) return 0;
+            if (node->typeId >= AST_TYPE_COUNT || node_is<ErrorNode>(node)) {
+                ok = false;
+                return 0;
+            }
+
+            return ast_dispatch(node, [this](auto* typed) -> uint64_t {
+                using T = std::remove_pointer_t<decltype(typed)>;
+                size_t offset = append(typed, sizeof(T), alignof(T));
+                const uint8_t* source = reinterpret_cast<const uint8_t*>(typed);
+
+                // Renumber densely so a mapped image's ids stay below header.nodeCount
+                store<uint32_t>(offset + (reinterpret_cast<const uint8_t*>(&typed->nodeId) - source), node_count);
+                node_count++;
+
+                auto write = [&](auto& field) {
+                    write_field(offset + (reinterpret_cast<const uint8_t*>(&field) - source), field);
+                };
+                ast_visit_fields(typed, write);
+                ast_visit_data_fields(typed, write);
+                ast_visit_aliases(typed, [&](auto& alias, auto*) {
+                    // Restored from the target on load
+                    store_slot(offset + (reinterpret_cast<const uint8_t*>(&alias) - source), 0);
+                });
+                return offset + 1;
+            });
+        }
+
+        bool write(CompilationUnitNode* root, std::string_view source)
+        {
+            buffer.clear();
+            append(nullptr, sizeof(AstBinaryHeader), alignof(AstBinaryHeader));
+
+            uint64_t root_offset = write_node(root);
+            if (!ok || root_offset == 0) return false;
+
+            // String table: count, per-string offsets into the character data, characters.
+            size_t strings_offset = append(nullptr, sizeof(uint64_t) * (strings.size() + 1), alignof(uint64_t));
+            store<uint64_t>(strings_offset, strings.size());
+            size_t chars_start = buffer.size();
+            for (size_t i = 0; i < strings.size(); ++i) {
+                size_t chars = append(strings[i].data(), strings[i].size(), 1);
+                store<uint64_t>(strings_offset + (i + 1) * sizeof(uint64_t), chars - chars_start);
+            }
+
+            AstBinaryHeader header = {};
+            memcpy(header.magic, AST_BINARY_MAGIC, sizeof(header.magic));
+            header.version = AST_BINARY_VERSION;
+            header.layoutHash = ast_binary_layout_hash();
+            header.sourceHash = ast_hash_source(source);
+            header.totalSize = buffer.size();
+            header.rootOffset = root_offset;
+            header.stringsOffset = strings_offset;
+            header.nodeCount = node_count;
+            header.stringCount = static_cast<uint32_t>(strings.size());
+            store(0, header);
+            return true;
+        }
+    };
+
+    bool ast_serialize(CompilationUnitNode* root, std::string_view source, std::vector<uint8_t>& out)
+    {
+        if (!root) return false;
+        AstBinaryWriter writer(out);
+        if (root->contains_errors || !writer.write(root, source)) {
+            LOG_DEBUG("AST serialization skipped: tree is empty or contains errors", LogCategory::AST);
+            return false;
+        }
+        return true;
+    }
+
+    bool ast_save_binary(CompilationUnitNode* root, std::string_view source, const std::string& path)
+    {
+        std::vector<uint8_t> bytes;
+        if (!ast_serialize(root, source, bytes)) return false;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            LOG_ERROR("Cannot open AST cache file for writing: " + path, LogCategory::AST);
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        return file.good();
+    }
+
+    // --- Loader ---
+
+    // Decodes offsets in an image into pointers, either rewriting the image itself
+    // or copying each node into an allocator.
+    class AstBinaryReader
+    {
+    private:
+        uint8_t* base;
+        size_t size;
+        const uint64_t* string_offsets;
+        const char* string_chars;
+        uint64_t string_count;
+        AstAllocator* allocator; // Null when relocating in place
+        std::vector<const char*> copied_strings;
+        uint64_t parent = 0; // Encoded offset of the node whose fields are being read
+        bool ok = true;
+
+        // Returns the address of an encoded range inside the image, or null if out of bounds.
+        uint8_t* resolve(uint64_t encoded, size_t length)
+        {
+            if (encoded == 0 || encoded - 1 > size || length > size - (encoded - 1)) {
+                ok = false;
+                return nullptr;
+            }
+            return base + encoded - 1;
+        }
+
+        template <typename T>
+        void read_field(T*& field)
+        {
+            field = static_cast<T*>(read_node(encoded_slot(field)));
+        }
+
+        template <typename T>
+        void read_field(AstHandle<T>& field)
+        {
+            field = static_cast<T*>(read_node(encoded_slot(field)));
+        }
+
+        template <typename T>
+        void read_field(SizedArray<T*>& array)
+        {
+            if (array.size <= 0) {
+                array.values = nullptr;
+                return;
+            }
+            T** values = reinterpret_cast<T**>(resolve(encoded_slot(array.values), sizeof(T*) * array.size));
+            if (!values) {
+                array = SizedArray<T*>();
+                return;
+            }
+            if (allocator) {
+                T** copy = allocator->alloc_array<T*>(array.size);
+                memcpy(copy, values, sizeof(T*) * array.size);
+                values = copy;
+            }
+            for (int i = 0; i < array.size; ++i) {
+                values[i] = static_cast<T*>(read_node(reinterpret_cast<uintptr_t>(values[i])));
+            }
+            array.values = values;
+        }
+
+        void read_field(SizedArray<ModifierKind>& array)
+        {
+            if (array.size <= 0) {
+                array.values = nullptr;
+                return;
+            }
+            ModifierKind* values = reinterpret_cast<ModifierKind*>(resolve(encoded_slot(array.values), sizeof(ModifierKind) * array.size));
+            if (values && allocator) {
+                ModifierKind* copy = allocator->alloc_array<ModifierKind>(array.size);
+                memcpy(copy, values, sizeof(ModifierKind) * array.size);
+                values = copy;
+            }
+            array.values = values;
+            if (!values) array.size = 0;
+        }
+
+        void read_field(std::string_view& text)
+        {
+            uint64_t id = reinterpret_cast<uintptr_t>(text.data());
+            if (id == 0 || id > string_count) {
+                if (id != 0) ok = false;
+                text = std::string_view();
+                return;
+            }
+
+            const char* chars = string_chars + string_offsets[id - 1];
+            if (chars < string_chars || chars + text.size() > reinterpret_cast<const char*>(base + size)) {
+                ok = false;
+                text = std::string_view();
+                return;
+            }
+            if (allocator) {
+                if (!copied_strings[id - 1]) {
+                    if (text.size() > AstPage::PAGE_SIZE) {
+                        ok = false;
+                        text = std::string_view();
+                        return;
+                    }
+                    char* copy = static_cast<char*>(allocator->alloc_bytes(text.size(), 1));
+                    memcpy(copy, chars, text.size());
+                    copied_strings[id - 1] = copy;
+                }
+                chars = copied_strings[id - 1];
+            }
+            text = std::string_view(chars, text.size());
+        }
+
+        void read_field(std::string&)
+        {
+            ok = false; // Never written
+        }
+
+    public:
+        AstBinaryReader(uint8_t* data, AstAllocator* target) : base(data), allocator(target)
+        {
+            auto* header = reinterpret_cast<const AstBinaryHeader*>(data);
+            size = header->totalSize;
+            string_offsets = reinterpret_cast<const uint64_t*>(data + header->stringsOffset) + 1;
+            string_count = header->stringCount;
+            string_chars = reinterpret_cast<const char*>(string_offsets + string_count);
+            if (allocator) copied_strings.assign(string_count, nullptr);
+        }
+
+        AstNode* read_node(uint64_t encoded)
+        {
+            if (encoded == 0 || !ok) return nullptr;
+            // Nodes are written in pre-order, so a child always follows its parent.
+            // Anything else is corrupt, and a cycle would recurse without end.
+            if (encoded <= parent || (encoded - 1) % alignof(AstNode) != 0) {
+                ok = false;
+                return nullptr;
+            }
+            AstNode* source = reinterpret_cast<AstNode*>(resolve(encoded, sizeof(AstNode)));
+            if (!source || source->typeId == 0 || source->typeId >= AST_TYPE_COUNT) {
+                ok = false;
+                return nullptr;
+            }
+
+            return ast_dispatch(source, [this, encoded](auto* typed) -> AstNode* {
+                using T = std::remove_pointer_t<decltype(typed)>;
+                if ((encoded - 1) % alignof(T) != 0) {
+                    ok = false;
+                    return nullptr;
+                }
+                if (!resolve(encoded, sizeof(T))) return nullptr;
+
+                T* node = typed;
+                if (allocator) {
+                    node = static_cast<T*>(allocator->alloc_bytes(sizeof(T), alignof(T)));
+                    memcpy(static_cast<void*>(node), typed, sizeof(T));
+                    node->nodeId = allocator->next_node_id();
+                }
+
+                uint64_t outer = parent;
+                parent = encoded;
+                auto read = [this](auto& field) { read_field(field); };
+                ast_visit_fields(node, read);
+                ast_visit_data_fields(node, read);
+                ast_visit_aliases(node, [](auto& alias, auto* target) { alias = target; });
+                parent = outer;
+                return node;
+            });
+        }
+
+        bool succeeded() const { return ok; }
+    };
+
+    // --- AstBinaryFile ---
+
+    AstBinaryFile::AstBinaryFile() : data_(nullptr), size_(0), mapped_(false), relocatedRoot_(nullptr) {}
+
+    AstBinaryFile::~AstBinaryFile()
+    {
+        close();
+    }
+
+    bool AstBinaryFile::open(const std::string& path)
+    {
+        close();
+
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(AstBinaryHeader)) {
+            ::close(fd);
+            return false;
+        }
+
+        // Private, writable mapping: relocating in place only dirties the pages it touches
+        // and never writes back to the file.
+        void* mapping = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) return false;
+
+        data_ = static_cast<uint8_t*>(mapping);
+        size_ = info.st_size;
+        mapped_ = true;
+        return true;
+#else
+        // No mmap on Windows; read the image into memory instead
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return false;
+        std::vector<uint8_t> bytes(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+        return file.good() && open_memory(std::move(bytes));
+#endif
+    }
+
+    bool AstBinaryFile::open_memory(std::vector<uint8_t> bytes)
+    {
+        close();
+        if (bytes.size() < sizeof(AstBinaryHeader)) return false;
+        buffer_ = std::move(bytes);
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        return true;
+    }
+
+    void AstBinaryFile::close()
+    {
+#ifndef _WIN32
+        if (mapped_ && data_) {
+            munmap(data_, size_);
+        }
+#endif
+        buffer_.clear();
+        data_ = nullptr;
+        size_ = 0;
+        mapped_ = false;
+        relocatedRoot_ = nullptr;
+    }
+
+    bool AstBinaryFile::is_valid(uint64_t expected_source_hash) const
+    {
+        if (!data_ || size_ < sizeof(AstBinaryHeader)) return false;
+
+        const AstBinaryHeader* h = header();
+        if (memcmp(h->magic, AST_BINARY_MAGIC, sizeof(h->magic)) != 0) {
+            LOG_DEBUG("AST cache rejected: bad magic", LogCategory::AST);
+            return false;
+        }
+        if (h->version != AST_BINARY_VERSION || h->layoutHash != ast_binary_layout_hash()) {
+            LOG_DEBUG("AST cache rejected: written by a different compiler build", LogCategory::AST);
+            return false;
+        }
+        if (h->sourceHash != expected_source_hash) {
+            LOG_DEBUG("AST cache rejected: source has changed", LogCategory::AST);
+            return false;
+        }
+        if (h->totalSize != size_ || h->stringsOffset % alignof(uint64_t) != 0 ||
+            h->stringsOffset + sizeof(uint64_t) * (uint64_t(h->stringCount) + 1) > size_) {
+            LOG_DEBUG("AST cache rejected: truncated or corrupt image", LogCategory::AST);
+            return false;
+        }
+        return true;
+    }
+
+    CompilationUnitNode* AstBinaryFile::load_in_place(uint64_t expected_source_hash)
+    {
+        if (relocatedRoot_) return relocatedRoot_;
+        if (!is_valid(expected_source_hash)) return nullptr;
+
+#ifdef MYCELIUM_AST_COMPRESSED_HANDLES
+        // Handles can only name memory inside the AstArena, which the image is not
+        LOG_DEBUG("AST cache cannot be relocated in place with compressed handles; use load_into", LogCategory::AST);
+        return nullptr;
+#endif
+
+        AstBinaryReader reader(data_, nullptr);
+        AstNode* root = reader.read_node(header()->rootOffset);
+        if (!reader.succeeded() || !node_is<CompilationUnitNode>(root)) {
+            // The image is partially rewritten now; it cannot be used again
+            LOG_ERROR("Corrupt AST cache image", LogCategory::AST);
+            close();
+            return nullptr;
+        }
+
+        relocatedRoot_ = static_cast<CompilationUnitNode*>(root);
+        return relocatedRoot_;
+    }
+
+    CompilationUnitNode* AstBinaryFile::load_into(AstAllocator& allocator, uint64_t expected_source_hash)
+    {
+        // Once relocated, the image no longer holds offsets
+        if (relocatedRoot_ || !is_valid(expected_source_hash)) return nullptr;
+
+        AstBinaryReader reader(data_, &allocator);
+        AstNode* root = reader.read_node(header()->rootOffset);
+        if (!reader.succeeded() || !node_is<CompilationUnitNode>(root)) {
+            LOG_ERROR("Corrupt AST cache image", LogCategory::AST);
+            return nullptr;
+        }
+        return static_cast<CompilationUnitNode*>(root);
+    }
+
+} // namespace Mycelium::Scripting::Lang
@@ -0,0 +1,54 @@
+#include "ast/ast_side_table.hpp"
+#include "ast/ast_walker.hpp"
+
+namespace Mycelium::Scripting::Lang
+{
+    AstParentIndex::AstParentIndex(AstNode* root) : root_(root), parents_(nullptr), built_(false) {}
+
+    void AstParentIndex::build()
+    {
+        built_ = true;
+        parents_.clear();
+        if (!root_) return;
+
+        // Explicit stack so deeply nested expressions cannot overflow the call stack
+        std::vector<AstNode*> pending;
+        pending.push_back(root_);
+        parents_[root_] = nullptr;
+
+        while (!pending.empty()) {
+            AstNode* node = pending.back();
+            pending.pop_back();
+
+            auto record = [&](AstNode* child) {
+                if (!child) return;
+                parents_[child] = node;
+                pending.push_back(child);
+            };
+
+            ast_dispatch(node, [&](auto* typed) {
+                ast_visit_fields(typed, [&](auto& field) {
+                    if constexpr (std::is_convertible_v<decltype(field), AstNode*>) {
+                        record(field);
+                    } else {
+                        for (int i = 0; i < field.size; ++i) record(field.values[i]);
+                    }
+                });
+            });
+        }
+    }
+
+    AstNode* AstParentIndex::parent_of(const AstNode* node)
+    {
+        if (!node) return nullptr;
+        if (!built_) build();
+        return parents_.get(node);
+    }
+
+    void AstParentIndex::invalidate()
+    {
+        built_ = false;
+        parents_.clear();
+    }
+
+} // namespace Mycelium::Scripting::Lang
@@ -0,0 +1,159 @@
+#include "ast/ast_source_index.hpp"
+#include "ast/ast_walker.hpp"
+#include <algorithm>
+
+namespace Mycelium::Scripting::Lang
+{
+    void AstSourceIndex::collect(AstNode* root, std::vector<Entry>& out)
+    {
+        if (!root) return;
+        size_t first = out.size();
+
+        std::vector<std::pair<AstNode*, int>> pending;
+        pending.push_back({root, 0});
+        while (!pending.empty()) {
+            auto [node, depth] = pending.back();
+            pending.pop_back();
+
+            if (node->sourceLength > 0) {
+                out.push_back({node->sourceStart, node->sourceStart + node->sourceLength, node, -1, 0, 0, depth});
+            }
+
+            ast_dispatch(node, [&, depth = depth](auto* typed) {
+                ast_visit_fields(typed, [&](auto& field) {
+                    if constexpr (std::is_convertible_v<decltype(field), AstNode*>) {
+                        if (field) pending.push_back({field, depth + 1});
+                    } else {
+                        for (int i = 0; i < field.size; ++i) {
+                            if (field.values[i]) pending.push_back({field.values[i], depth + 1});
+                        }
+                    }
+                });
+            });
+        }
+
+        std::stable_sort(out.begin() + first, out.end(), [](const Entry& a, const Entry& b) {
+            if (a.start != b.start) return a.start < b.start;
+            if (a.end != b.end) return a.end > b.end;
+            return a.treeDepth < b.treeDepth;
+        });
+    }
+
+    void AstSourceIndex::link(int from, int open_parent)
+    {
+        // Entries are in start order, so the containing spans of each entry are
+        // exactly the ones left on the stack once spans that end before it are popped.
+        // Entries ahead of from keep their links; the spans still open there are
+        // open_parent and its ancestors.
+        std::vector<int> open;
+        for (int index = open_parent; index >= 0; index = entries_[index].parent) {
+            open.push_back(index);
+        }
+        std::reverse(open.begin(), open.end());
+        for (int i = from; i < static_cast<int>(entries_.size()); ++i) {
+            Entry& entry = entries_[i];
+            while (!open.empty()) {
+                const Entry& top = entries_[open.back()];
+                if (top.start <= entry.start && entry.end <= top.end) break;
+                open.pop_back();
+            }
+
+            if (open.empty()) {
+                entry.parent = -1;
+                entry.depth = 0;
+                entry.jump = i;
+            } else {
+                entry.parent = open.back();
+                const Entry& parent = entries_[entry.parent];
+                const Entry& parent_jump = entries_[parent.jump];
+                entry.depth = parent.depth + 1;
+                entry.jump = (parent.depth - parent_jump.depth == parent_jump.depth - entries_[parent_jump.jump].depth)
+                    ? parent_jump.jump
+                    : entry.parent;
+            }
+            open.push_back(i);
+        }
+    }
+
+    void AstSourceIndex::build(AstNode* root)
+    {
+        entries_.clear();
+        collect(root, entries_);
+        link();
+    }
+
+    int AstSourceIndex::find_entry(const AstNode* node) const
+    {
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), node->sourceStart,
+            [](const Entry& entry, int start) { return entry.start < start; });
+        for (; it != entries_.end() && it->start == node->sourceStart; ++it) {
+            if (it->node == node) return static_cast<int>(it - entries_.begin());
+        }
+        return -1;
+    }
+
+    int AstSourceIndex::innermost_entry(int offset) const
+    {
+        auto it = std::upper_bound(entries_.begin(), entries_.end(), offset,
+            [](int value, const Entry& entry) { return value < entry.start; });
+        if (it == entries_.begin()) return -1;
+
+        // Every ancestor starts at or before the offset, so "contains the offset"
+        // only depends on the end and holds for all ancestors above the answer.
+        auto contains = [&](int index) { return offset < entries_[index].end; };
+        int current = static_cast<int>(it - entries_.begin()) - 1;
+        while (current >= 0 && !contains(current)) {
+            int jump = entries_[current].jump;
+            current = (jump != current && !contains(jump)) ? jump : entries_[current].parent;
+        }
+        return current;
+    }
+
+    AstNode* AstSourceIndex::innermost_at(int offset) const
+    {
+        int index = innermost_entry(offset);
+        return index >= 0 ? entries_[index].node : nullptr;
+    }
+
+    std::vector<AstNode*> AstSourceIndex::enclosing_at(int offset) const
+    {
+        std::vector<AstNode*> nodes;
+        for (int index = innermost_entry(offset); index >= 0; index = entries_[index].parent) {
+            nodes.push_back(entries_[index].node);
+        }
+        return nodes;
+    }
+
+    bool AstSourceIndex::replace_subtree(AstNode* old_node, AstNode* new_node)
+    {
+        int first = old_node ? find_entry(old_node) : -1;
+        if (first < 0 || !new_node) return false;
+
+        int last = first + 1;
+        while (last < static_cast<int>(entries_.size()) && entries_[last].depth > entries_[first].depth) {
+            last++;
+        }
+
+        int delta = (new_node->sourceStart + new_node->sourceLength) - entries_[first].end;
+        if (delta != 0) {
+            for (int index = entries_[first].parent; index >= 0; index = entries_[index].parent) {
+                entries_[index].end += delta;
+                entries_[index].node->sourceLength += delta;
+            }
+            for (size_t index = last; index < entries_.size(); ++index) {
+                entries_[index].start += delta;
+                entries_[index].end += delta;
+                entries_[index].node->sourceStart += delta;
+            }
+        }
+
+        std::vector<Entry> replacement;
+        collect(new_node, replacement);
+        int parent = entries_[first].parent;
+        entries_.erase(entries_.begin() + first, entries_.begin() + last);
+        entries_.insert(entries_.begin() + first, replacement.begin(), replacement.end());
+        link(first, parent);
+        return true;
+    }
+
+} // namespace Mycelium::Scripting::Lang
@@ -1,4 +1,5 @@
 #include "codegen/codegen.hpp"
+#include "codegen/type_context.hpp"
 #include "ast/ast_rtti.hpp"
 #include "common/logger.hpp"
 #include <iostream>
@@ -12,6 +13,16 @@ CodeGenerator::CodeGenerator(SymbolTable& table)
 
 
 
+void CodeGenerator::walk(AstNode* node) {
+    ConstantValue constant = symbol_table_.get_constant(node);
+    if (constant.is_constant() && ir_builder_) {
+        current_value_ = constant.type == IRType::bool_() ? ir_builder_->const_bool(constant.value != 0)
+                                                          : ir_builder_->const_i32(static_cast<int32_t>(constant.value));
+        return;
+    }
+    AstWalker<CodeGenerator>::walk(node);
+}
+
 void CodeGenerator::visit(CompilationUnitNode* node) {
     if (!node) return;
     
@@ -26,13 +37,13 @@ void CodeGenerator::visit(CompilationUnitNode* node) {
         // Process function declarations and type declarations
         if (stmt->is_a<FunctionDeclarationNode>()) {
             LOG_DEBUG("Found FunctionDeclarationNode at index " + std::to_string(i), LogCategory::CODEGEN);
-            stmt->accept(this);
+            walk(stmt);
         } else if (stmt->is_a<TypeDeclarationNode>()) {
             LOG_DEBUG("Found TypeDeclarationNode at index " + std::to_string(i), LogCategory::CODEGEN);
-            stmt->accept(this);
+            walk(stmt);
         } else {
             LOG_DEBUG("Processing other statement type at index " + std::to_string(i), LogCategory::CODEGEN);
-            stmt->accept(this);
+            walk(stmt);
         }
     }
 }
@@ -65,11 +76,11 @@ void CodeGenerator::visit(BinaryExpressionNode* node) {
     if (!node || !ir_builder_) return;
     
     // Visit left operand
-    node->left->accept(this);
+    walk(node->left);
     ValueRef lhs = current_value_;
     
     // Visit right operand
-    node->right->accept(this);
+    walk(node->right);
     ValueRef rhs = current_value_;
     
     // Generate the binary operation
@@ -125,7 +136,7 @@ void CodeGenerator::visit(UnaryExpressionNode* node) {
     if (!node || !ir_builder_) return;
     
     // Visit the operand
-    node->operand->accept(this);
+    walk(node->operand);
     ValueRef operand = current_value_;
     
     // Generate the unary operation
@@ -155,7 +166,7 @@ void CodeGenerator::visit(VariableDeclarationNode* node) {
     // Generate initializer value once if present
     ValueRef init_value = ValueRef::invalid();
     if (node->initializer) {
-        node->initializer->accept(this);
+        walk(node->initializer);
         init_value = current_value_;
     }
     
@@ -164,8 +175,14 @@ void CodeGenerator::visit(VariableDeclarationNode* node) {
         auto* name_node = node->names[i];
         if (!name_node) continue;
         
+        // The builder bound the name to the symbol it declared
+        SymbolId symbol_id = symbol_table_.get_binding(name_node);
+        if (symbol_id == INVALID_SYMBOL_ID) {
+            std::cerr << "Error: Variable '" << name_node->name << "' was not declared in the symbol table" << std::endl;
+            continue;
+        }
+        
         // Get the variable's type - prefer initializer type over symbol table
-        std::string var_name = std::string(name_node->name);
         IRType value_type = IRType::i32(); // Default fallback
         
         if (init_value.is_valid()) {
@@ -173,7 +190,7 @@ void CodeGenerator::visit(VariableDeclarationNode* node) {
             value_type = init_value.type;
         } else {
             // Fall back to symbol table type if no initializer
-            auto symbol = symbol_table_.lookup_symbol(var_name);
+            auto symbol = symbol_table_.get_symbol(symbol_id);
             if (symbol && symbol->type == SymbolType::VARIABLE) {
                 value_type = symbol->data_type;
             }
@@ -182,8 +199,8 @@ void CodeGenerator::visit(VariableDeclarationNode* node) {
         // Allocate space for the variable with correct type
         ValueRef alloca_ref = ir_builder_->alloca(value_type);
         
-        // Store the variable and its type in our local variables map
-        local_vars_[var_name] = {alloca_ref, value_type};
+        // Store the variable and its type in its local slot
+        bind_local(symbol_id, {alloca_ref, value_type});
         
         // If there's an initializer, store the value to this variable
         if (init_value.is_valid()) {
@@ -195,73 +212,26 @@ void CodeGenerator::visit(VariableDeclarationNode* node) {
 void CodeGenerator::visit(IdentifierExpressionNode* node) {
     if (!node || !ir_builder_ || !node->identifier) return;
     
-    // Look up the variable in our local variables
-    std::string var_name = std::string(node->identifier->name);
-    auto it = local_vars_.find(var_name);
-    if (it != local_vars_.end()) {
-        // Use the stored type information
-        const VariableInfo& var_info = it->second;
-        
+    // The binding pass resolved the name; locals are read from their slot
+    SymbolId symbol_id = symbol_table_.get_binding(node);
+    if (const VariableInfo* var_info = find_local(symbol_id)) {
         // Load the value from the variable with correct type
-        current_value_ = ir_builder_->load(var_info.value_ref, var_info.type);
+        current_value_ = ir_builder_->load(var_info->value_ref, var_info->type);
         return;
     }
     
-    // Check if we're in a member function and the identifier refers to a field
-    std::string current_scope = symbol_table_.get_current_scope_name();
-    if (current_scope.find("::") != std::string::npos) {
-        // We're in a member function scope (Type::function)
-        std::string type_name = current_scope.substr(0, current_scope.find("::"));
-        
-        // Check if this identifier is a field of the current type
-        int type_scope_id = symbol_table_.find_scope_by_name(type_name);
-        if (type_scope_id != -1) {
-            auto field_symbol = symbol_table_.lookup_symbol_in_scope(type_scope_id, var_name);
-            if (field_symbol && field_symbol->type == SymbolType::VARIABLE) {
-                // This is an unqualified field access - generate `this.field`
-                LOG_DEBUG("Generating unqualified field access for: " + var_name, LogCategory::CODEGEN);
-                
-                // Get the 'this' pointer from local variables
-                auto this_it = local_vars_.find("this");
-                if (this_it == local_vars_.end()) {
-                    std::cerr << "Error: Cannot access field '" << var_name << "' - 'this' pointer not found" << std::endl;
-                    current_value_ = ValueRef::invalid();
-                    return;
-                }
-                
-                ValueRef this_ptr = this_it->second.value_ref;
-                
-                // Generate member access: this.field
-                auto struct_layout = build_struct_layout(type_name);
-                if (!struct_layout) {
-                    std::cerr << "Error: Could not build struct layout for unqualified field access" << std::endl;
-                    current_value_ = ValueRef::invalid();
-                    return;
-                }
-                
-                // Find the field index
-                int field_index = find_field_index(*struct_layout, var_name);
-                if (field_index == -1) {
-                    std::cerr << "Error: Field '" << var_name << "' not found in struct layout" << std::endl;
-                    current_value_ = ValueRef::invalid();
-                    return;
-                }
-                
-                // Load 'this' pointer
-                ValueRef this_value = ir_builder_->load(this_ptr, this_it->second.type);
-                
-                // Generate GEP instruction to get field address
-                std::vector<int> indices = {field_index};
-                ValueRef field_ptr = ir_builder_->gep(this_value, indices, IRType::ptr_to(field_symbol->data_type));
-                
-                // Load the field value
-                current_value_ = ir_builder_->load(field_ptr, field_symbol->data_type);
-                return;
-            }
-        }
+    // A name bound to a field of the enclosing type is an unqualified `this.field`
+    Symbol* symbol = symbol_table_.get_symbol(symbol_id);
+    if (is_field(symbol)) {
+        LOG_DEBUG("Generating unqualified field access for: " + std::string(symbol->name), LogCategory::CODEGEN);
+        const StructInfo* struct_info = nullptr;
+        int field_index = -1;
+        ValueRef this_value = this_for_field(symbol, struct_info, field_index);
+        current_value_ = this_value.is_valid() ? load_field(this_value, *struct_info->layout, field_index) : ValueRef::invalid();
+        return;
     }
     
-    std::cerr << "Unknown variable: " << var_name << std::endl;
+    std::cerr << "Unknown variable: " << node->identifier->name << std::endl;
     current_value_ = ValueRef::invalid();
 }
 
@@ -270,7 +240,7 @@ void CodeGenerator::visit(ReturnStatementNode* node) {
     
     if (node->expression) {
         // Generate code for the return expression
-        node->expression->accept(this);
+        walk(node->expression);
         if (current_value_.is_valid()) {
             ir_builder_->ret(current_value_);
         }
@@ -291,6 +261,11 @@ void CodeGenerator::visit(FunctionDeclarationNode* node) {
         return;
     }
     
+    if (symbol_table_.is_dead_function(symbol_table_.get_binding(node->name))) {
+        LOG_DEBUG("Skipping unreachable function: '" + std::string(node->name->name) + "'", LogCategory::CODEGEN);
+        return;
+    }
+    
     // Look up function in symbol table
     std::string func_name = std::string(node->name->name);
     auto func_symbol = symbol_table_.lookup_symbol(func_name);
@@ -315,7 +290,7 @@ void CodeGenerator::visit(FunctionDeclarationNode* node) {
     for (int i = 0; i < node->parameters.size; ++i) {
         if (auto* param = ast_cast_or_error<ParameterNode>(node->parameters.values[i])) {
             std::string param_name = std::string(param->name->name);
-            auto param_symbol = symbol_table_.lookup_symbol_in_scope(function_scope_id, param_name);
+            auto param_symbol = symbol_table_.get_bound_symbol(param->name);
             if (param_symbol && param_symbol->type == SymbolType::PARAMETER) {
                 param_types.push_back(param_symbol->data_type);
             } else {
@@ -327,26 +302,26 @@ void CodeGenerator::visit(FunctionDeclarationNode* node) {
     
     // Begin the function
     LOG_INFO("Processing function: '" + func_name + "'", LogCategory::CODEGEN);
-    ir_builder_->function_begin(func_name, return_type, param_types);
+    ir_builder_->function_begin(func_name, return_type, param_types, function_attributes(func_symbol));
     
     // Navigate to the function scope in the symbol table
-    symbol_table_.push_scope(func_name);
+    symbol_table_.push_scope(function_scope_id);
     
-    // Clear local variables for this function
-    local_vars_.clear();
+    // Start with no live locals for this function
+    begin_function_locals();
     
     // Process function parameters - allocate space for each parameter
     for (int i = 0; i < node->parameters.size; ++i) {
         if (auto* param = ast_cast_or_error<ParameterNode>(node->parameters.values[i])) {
             std::string param_name = std::string(param->name->name);
-            auto param_symbol = symbol_table_.lookup_symbol(param_name);
+            auto param_symbol = symbol_table_.get_bound_symbol(param->name);
             
             if (param_symbol && param_symbol->type == SymbolType::PARAMETER) {
                 // Allocate space for the parameter
                 ValueRef param_alloca = ir_builder_->alloca(param_symbol->data_type);
-                local_vars_[param_name] = {param_alloca, param_symbol->data_type};
+                bind_local(param_symbol->id, {param_alloca, param_symbol->data_type});
                 
-                LOG_DEBUG("Added parameter '" + param_name + "' of type " + param_symbol->type_name, LogCategory::CODEGEN);
+                LOG_DEBUG("Added parameter '" + param_name + "' of type " + std::string(param_symbol->type_name), LogCategory::CODEGEN);
             } else {
                 LOG_ERROR("Parameter '" + param_name + "' not found in current scope", LogCategory::CODEGEN);
             }
@@ -356,7 +331,7 @@ void CodeGenerator::visit(FunctionDeclarationNode* node) {
     // Process the function body
     if (node->body) {
         LOG_DEBUG("Processing function body for: " + func_name, LogCategory::CODEGEN);
-        node->body->accept(this);
+        walk(node->body);
     } else {
         LOG_WARN("No body for function: " + func_name, LogCategory::CODEGEN);
     }
@@ -395,7 +370,7 @@ void CodeGenerator::visit(TypeDeclarationNode* node) {
         return;
     }
     
-    symbol_table_.push_scope(type_name);
+    symbol_table_.push_scope(type_scope_id);
     
     // Process all member functions in the type
     for (int i = 0; i < node->members.size; ++i) {
@@ -419,7 +394,7 @@ void CodeGenerator::visit(BlockStatementNode* node) {
     
     // Visit all statements in the block
     for (int i = 0; i < node->statements.size; ++i) {
-        node->statements[i]->accept(this);
+        walk(node->statements[i]);
     }
 }
 
@@ -427,7 +402,7 @@ void CodeGenerator::visit(AssignmentExpressionNode* node) {
     if (!node || !ir_builder_) return;
     
     // Generate code for the source expression first
-    node->source->accept(this);
+    walk(node->source);
     ValueRef source_value = current_value_;
     
     if (!source_value.is_valid()) {
@@ -445,76 +420,27 @@ void CodeGenerator::visit(AssignmentExpressionNode* node) {
             current_value_ = ValueRef::invalid();
             return;
         }
-        std::string var_name = std::string(target_ident->identifier->name);
+        SymbolId symbol_id = symbol_table_.get_binding(target_ident);
+        Symbol* symbol = symbol_table_.get_symbol(symbol_id);
         
-        // Look up the variable in local variables first
-        auto it = local_vars_.find(var_name);
-        if (it != local_vars_.end()) {
+        if (const VariableInfo* var_info = find_local(symbol_id)) {
             // Store the new value in local variable
-            ir_builder_->store(source_value, it->second.value_ref);
-        } else {
-            // Check if we're in a member function and this is an unqualified field assignment
-            std::string current_scope = symbol_table_.get_current_scope_name();
-            if (current_scope.find("::") != std::string::npos) {
-                // We're in a member function scope (Type::function)
-                std::string type_name = current_scope.substr(0, current_scope.find("::"));
-                
-                // Check if this identifier is a field of the current type
-                int type_scope_id = symbol_table_.find_scope_by_name(type_name);
-                if (type_scope_id != -1) {
-                    auto field_symbol = symbol_table_.lookup_symbol_in_scope(type_scope_id, var_name);
-                    if (field_symbol && field_symbol->type == SymbolType::VARIABLE) {
-                        // This is an unqualified field assignment - generate `this.field = value`
-                        LOG_DEBUG("Generating unqualified field assignment for: " + var_name, LogCategory::CODEGEN);
-                        
-                        // Get the 'this' pointer from local variables
-                        auto this_it = local_vars_.find("this");
-                        if (this_it == local_vars_.end()) {
-                            std::cerr << "Error: Cannot assign to field '" << var_name << "' - 'this' pointer not found" << std::endl;
-                            current_value_ = ValueRef::invalid();
-                            return;
-                        }
-                        
-                        // Generate member access: this.field = value
-                        auto struct_layout = build_struct_layout(type_name);
-                        if (!struct_layout) {
-                            std::cerr << "Error: Could not build struct layout for unqualified field assignment" << std::endl;
-                            current_value_ = ValueRef::invalid();
-                            return;
-                        }
-                        
-                        // Find the field index
-                        int field_index = find_field_index(*struct_layout, var_name);
-                        if (field_index == -1) {
-                            std::cerr << "Error: Field '" << var_name << "' not found in struct layout for assignment" << std::endl;
-                            current_value_ = ValueRef::invalid();
-                            return;
-                        }
-                        
-                        // Load 'this' pointer
-                        ValueRef this_value = ir_builder_->load(this_it->second.value_ref, this_it->second.type);
-                        
-                        // Generate GEP instruction to get field address
-                        std::vector<int> indices = {field_index};
-                        ValueRef field_ptr = ir_builder_->gep(this_value, indices, IRType::ptr_to(field_symbol->data_type));
-                        
-                        // Store the new value in the field
-                        ir_builder_->store(source_value, field_ptr);
-                    } else {
-                        std::cerr << "Error: Unknown variable in assignment: '" << var_name << "'" << std::endl;
-                        current_value_ = ValueRef::invalid();
-                        return;
-                    }
-                } else {
-                    std::cerr << "Error: Unknown variable in assignment: '" << var_name << "'" << std::endl;
-                    current_value_ = ValueRef::invalid();
-                    return;
-                }
-            } else {
-                std::cerr << "Error: Unknown variable in assignment: '" << var_name << "'" << std::endl;
+            ir_builder_->store(source_value, var_info->value_ref);
+        } else if (is_field(symbol)) {
+            // A name bound to a field of the enclosing type is an unqualified `this.field = value`
+            LOG_DEBUG("Generating unqualified field assignment for: " + std::string(symbol->name), LogCategory::CODEGEN);
+            const StructInfo* struct_info = nullptr;
+            int field_index = -1;
+            ValueRef this_value = this_for_field(symbol, struct_info, field_index);
+            if (!this_value.is_valid()) {
                 current_value_ = ValueRef::invalid();
                 return;
             }
+            store_field(this_value, *struct_info->layout, field_index, source_value);
+        } else {
+            std::cerr << "Error: Unknown variable in assignment: '" << target_ident->identifier->name << "'" << std::endl;
+            current_value_ = ValueRef::invalid();
+            return;
         }
         
     } else if (node->target->is_a<MemberAccessExpressionNode>()) {
@@ -527,7 +453,7 @@ void CodeGenerator::visit(AssignmentExpressionNode* node) {
         }
         
         // Generate code for the target object to get struct pointer
-        member_access->target->accept(this);
+        walk(member_access->target);
         ValueRef struct_ptr = current_value_;
         
         if (!struct_ptr.is_valid() || struct_ptr.type.kind != IRType::Kind::Ptr) {
@@ -537,57 +463,34 @@ void CodeGenerator::visit(AssignmentExpressionNode* node) {
         }
         
         // Get the member name
-        std::string member_name = std::string(member_access->member->name);
+        std::string_view member_name = member_access->member->name;
         
-        // Get the actual struct type from the pointer's pointee type
-        std::string struct_type_name;
-        if (struct_ptr.type.pointee_type && struct_ptr.type.pointee_type->kind == IRType::Kind::Struct 
-            && struct_ptr.type.pointee_type->struct_layout) {
-            struct_type_name = struct_ptr.type.pointee_type->struct_layout->name;
-        } else {
+        // Get the actual struct type of the target
+        int struct_scope_id = struct_scope_of(member_access->target, struct_ptr);
+        if (struct_scope_id == -1) {
             std::cerr << "Error: Cannot determine struct type for member assignment - pointer lacks type information" << std::endl;
             current_value_ = ValueRef::invalid();
             return;
         }
         
-        // Build struct layout to find the field
-        auto struct_layout = build_struct_layout(struct_type_name);
-        if (!struct_layout) {
+        // Cached struct layout to find the field
+        const StructInfo* struct_info = this->struct_info(struct_scope_id);
+        if (!struct_info) {
             std::cerr << "Error: Could not determine struct layout for member assignment" << std::endl;
             current_value_ = ValueRef::invalid();
             return;
         }
         
         // Find the field in the layout
-        int field_index = -1;
-        IRType field_type = IRType::i32();
-        
-        for (size_t i = 0; i < struct_layout->fields.size(); ++i) {
-            if (struct_layout->fields[i].name == member_name) {
-                field_index = static_cast<int>(i);
-                field_type = struct_layout->fields[i].type;
-                break;
-            }
-        }
-        
+        int field_index = find_field_index(*struct_info, symbol_table_.get_bound_symbol(member_access), member_name);
         if (field_index == -1) {
             std::cerr << "Error: Field '" << member_name << "' not found in struct for assignment" << std::endl;
             current_value_ = ValueRef::invalid();
             return;
         }
         
-        // Generate GEP instruction to get field address
-        std::vector<int> indices = {field_index};
-        ValueRef field_ptr = ir_builder_->gep(struct_ptr, indices, IRType::ptr_to(field_type));
-        
-        if (!field_ptr.is_valid()) {
-            std::cerr << "Error: Failed to generate field access for assignment" << std::endl;
-            current_value_ = ValueRef::invalid();
-            return;
-        }
-        
         // Store the value in the field
-        ir_builder_->store(source_value, field_ptr);
+        store_field(struct_ptr, *struct_info->layout, field_index, source_value);
         
     } else {
         std::cerr << "Error: Unsupported assignment target type" << std::endl;
@@ -627,7 +530,7 @@ void CodeGenerator::visit(IfStatementNode* node) {
     
     // Evaluate the condition
     if (node->condition) {
-        node->condition->accept(this);
+        walk(node->condition);
         if (current_value_.is_valid()) {
             // Branch based on condition
             if (node->elseStatement) {
@@ -648,7 +551,7 @@ void CodeGenerator::visit(IfStatementNode* node) {
     // Then block
     ir_builder_->label(then_label);
     if (node->thenStatement) {
-        node->thenStatement->accept(this);
+        walk(node->thenStatement);
     }
     // Only branch to end if the block doesn't already have a terminator (like return)
     if (!ir_builder_->has_terminator()) {
@@ -658,7 +561,7 @@ void CodeGenerator::visit(IfStatementNode* node) {
     // Else block (if present)
     if (node->elseStatement) {
         ir_builder_->label(else_label);
-        node->elseStatement->accept(this);
+        walk(node->elseStatement);
         // Only branch to end if the block doesn't already have a terminator
         if (!ir_builder_->has_terminator()) {
             ir_builder_->br(end_label);
@@ -700,7 +603,7 @@ void CodeGenerator::visit(WhileStatementNode* node) {
     // While header: check condition
     ir_builder_->label(header_label);
     if (node->condition) {
-        node->condition->accept(this);
+        walk(node->condition);
         if (current_value_.is_valid()) {
             ir_builder_->br_cond(current_value_, body_label, exit_label);
         } else {
@@ -715,7 +618,7 @@ void CodeGenerator::visit(WhileStatementNode* node) {
     // While body
     ir_builder_->label(body_label);
     if (node->body) {
-        node->body->accept(this);
+        walk(node->body);
     }
     
     // Branch back to header
@@ -747,7 +650,7 @@ void CodeGenerator::visit(ForStatementNode* node) {
     
     // Process the initializer
     if (node->initializer) {
-        node->initializer->accept(this);
+        walk(node->initializer);
     }
     
     // Create basic block labels (use global counter for unique names across all functions)
@@ -763,7 +666,7 @@ void CodeGenerator::visit(ForStatementNode* node) {
     // Loop header: check condition
     ir_builder_->label(header_label);
     if (node->condition) {
-        node->condition->accept(this);
+        walk(node->condition);
         if (current_value_.is_valid()) {
             ir_builder_->br_cond(current_value_, body_label, exit_label);
         } else {
@@ -778,12 +681,12 @@ void CodeGenerator::visit(ForStatementNode* node) {
     // Loop body
     ir_builder_->label(body_label);
     if (node->body) {
-        node->body->accept(this);
+        walk(node->body);
     }
     
     // Execute incrementors
     for (int i = 0; i < node->incrementors.size; ++i) {
-        node->incrementors[i]->accept(this);
+        walk(node->incrementors[i]);
     }
     
     // Branch back to header
@@ -798,7 +701,7 @@ void CodeGenerator::visit(ExpressionStatementNode* node) {
     
     // Just visit the expression - the result will be in current_value_
     if (node->expression) {
-        node->expression->accept(this);
+        walk(node->expression);
     }
 }
 
@@ -809,7 +712,7 @@ void CodeGenerator::visit(CallExpressionNode* node) {
     std::vector<ValueRef> arg_values;
     LOG_DEBUG("Generating arguments for call expression", LogCategory::CODEGEN);
     for (int i = 0; i < node->arguments.size; ++i) {
-        node->arguments[i]->accept(this);
+        walk(node->arguments[i]);
         if (!current_value_.is_valid()) {
             std::cerr << "Error: Invalid expression for argument " << i << " in function call." << std::endl;
             current_value_ = ValueRef::invalid();
@@ -824,7 +727,7 @@ void CodeGenerator::visit(CallExpressionNode* node) {
         LOG_DEBUG("Generating member function call", LogCategory::CODEGEN);
         
         // Generate code for the target object to get 'this' pointer
-        member_access->target->accept(this);
+        walk(member_access->target);
         ValueRef this_ptr = current_value_;
         
         if (!this_ptr.is_valid() || this_ptr.type.kind != IRType::Kind::Ptr) {
@@ -833,16 +736,14 @@ void CodeGenerator::visit(CallExpressionNode* node) {
             return;
         }
         
-        // Get the struct type name from the 'this' pointer
-        std::string struct_type_name;
-        if (this_ptr.type.pointee_type && this_ptr.type.pointee_type->kind == IRType::Kind::Struct 
-            && this_ptr.type.pointee_type->struct_layout) {
-            struct_type_name = this_ptr.type.pointee_type->struct_layout->name;
-        } else {
+        // Get the struct type name of the 'this' object
+        int struct_scope_id = struct_scope_of(member_access->target, this_ptr);
+        if (struct_scope_id == -1) {
             std::cerr << "Error: Cannot determine struct type for member function call" << std::endl;
             current_value_ = ValueRef::invalid();
             return;
         }
+        const std::string& struct_type_name = symbol_table_.get_scope_name(struct_scope_id);
         
         // Get the method name
         std::string method_name = std::string(member_access->member->name);
@@ -851,20 +752,14 @@ void CodeGenerator::visit(CallExpressionNode* node) {
         std::string mangled_name = struct_type_name + "::" + method_name;
         LOG_DEBUG("Calling member function: '" + mangled_name + "'", LogCategory::CODEGEN);
         
-        // Look up the member function in the type scope to get return type
-        int type_scope_id = symbol_table_.find_scope_by_name(struct_type_name);
+        // The binding pass resolved the method in the target's type; it carries the return type
         IRType return_type = IRType::void_(); // Default to void
-        
-        if (type_scope_id != -1) {
-            auto method_symbol = symbol_table_.lookup_symbol_in_scope(type_scope_id, method_name);
-            if (method_symbol && method_symbol->type == SymbolType::FUNCTION) {
-                return_type = method_symbol->data_type;
-                LOG_DEBUG("Found member function '" + method_name + "' with return type: " + method_symbol->type_name, LogCategory::CODEGEN);
-            } else {
-                LOG_ERROR("Member function '" + method_name + "' not found in type '" + struct_type_name + "'", LogCategory::CODEGEN);
-            }
+        auto method_symbol = symbol_table_.get_bound_symbol(member_access);
+        if (method_symbol && method_symbol->type == SymbolType::FUNCTION) {
+            return_type = method_symbol->data_type;
+            LOG_DEBUG("Found member function '" + method_name + "' with return type: " + std::string(method_symbol->type_name), LogCategory::CODEGEN);
         } else {
-            LOG_ERROR("Type scope '" + struct_type_name + "' not found for member function call", LogCategory::CODEGEN);
+            LOG_ERROR("Member function '" + method_name + "' not found in type '" + struct_type_name + "'", LogCategory::CODEGEN);
         }
         
         // Prepend 'this' pointer to argument list
@@ -874,6 +769,7 @@ void CodeGenerator::visit(CallExpressionNode* node) {
         
         // Call the mangled member function
         // Generate call with proper return type
+        declare_callee(mangled_name, method_symbol);
         current_value_ = ir_builder_->call(mangled_name, return_type, member_func_args);
         
     } else if (auto ident = node->target->as<IdentifierExpressionNode>()) {
@@ -884,15 +780,16 @@ void CodeGenerator::visit(CallExpressionNode* node) {
         // Look up the function in the symbol table to get its return type
         IRType return_type = IRType::void_(); // Default to void if not found
         
-        auto symbol = symbol_table_.lookup_symbol(func_name);
+        auto symbol = symbol_table_.get_bound_symbol(ident);
         if (symbol && symbol->type == SymbolType::FUNCTION) {
             // The data_type field contains the return type for functions
             return_type = symbol->data_type;
-            LOG_DEBUG("Found function '" + func_name + "' with return type: " + symbol->type_name, LogCategory::CODEGEN);
+            LOG_DEBUG("Found function '" + func_name + "' with return type: " + std::string(symbol->type_name), LogCategory::CODEGEN);
         } else {
             LOG_WARN("Function '" + func_name + "' not found in symbol table, assuming void return type", LogCategory::CODEGEN);
         }
         
+        declare_callee(func_name, symbol);
         current_value_ = ir_builder_->call(func_name, return_type, arg_values);
         
     } else {
@@ -901,6 +798,20 @@ void CodeGenerator::visit(CallExpressionNode* node) {
     }
 }
 
+void CodeGenerator::declare_callee(const std::string& name, const Symbol* function) {
+    if (!function || function->type != SymbolType::FUNCTION || declared_callees_.count(name)) return;
+    int function_scope_id = symbol_table_.find_child_scope(function->scope_level, function->name);
+    if (function_scope_id == -1) return;
+    
+    // Parameters are declared in order, a method's 'this' first
+    std::vector<IRType> param_types;
+    for (Symbol* param : symbol_table_.get_all_symbols_in_scope(function_scope_id)) {
+        if (param->type == SymbolType::PARAMETER) param_types.push_back(param->data_type);
+    }
+    ir_builder_->function_declare(name, function->data_type, param_types);
+    declared_callees_.insert(name);
+}
+
 void CodeGenerator::visit(MemberAccessExpressionNode* node) {
     if (!node || !ir_builder_ || !node->target || !node->member || node->member->name.empty()) {
         std::cerr << "Error: Invalid member access node structure" << std::endl;
@@ -909,7 +820,7 @@ void CodeGenerator::visit(MemberAccessExpressionNode* node) {
     }
     
     // Generate code for the target object (should result in a pointer to the struct)
-    node->target->accept(this);
+    walk(node->target);
     ValueRef struct_ptr = current_value_;
     
     if (!struct_ptr.is_valid()) {
@@ -919,7 +830,7 @@ void CodeGenerator::visit(MemberAccessExpressionNode* node) {
     }
     
     // Get the member name
-    std::string member_name = std::string(node->member->name);
+    std::string_view member_name = node->member->name;
     
     // We need to determine the struct type from the target
     // For now, we'll assume it's a pointer to a struct type
@@ -929,72 +840,50 @@ void CodeGenerator::visit(MemberAccessExpressionNode* node) {
         return;
     }
     
-    // Get the actual struct type from the pointer's pointee type
-    std::string struct_type_name;
-    if (struct_ptr.type.pointee_type && struct_ptr.type.pointee_type->kind == IRType::Kind::Struct 
-        && struct_ptr.type.pointee_type->struct_layout) {
-        struct_type_name = struct_ptr.type.pointee_type->struct_layout->name;
-    } else {
+    // Get the actual struct type of the target
+    int struct_scope_id = struct_scope_of(node->target, struct_ptr);
+    if (struct_scope_id == -1) {
         std::cerr << "Error: Cannot determine struct type for member access - pointer lacks type information" << std::endl;
         current_value_ = ValueRef::invalid();
         return;
     }
     
     // First, check if this is a member function - accessing a method without calling it is an error
-    int type_scope_id = symbol_table_.find_scope_by_name(struct_type_name);
-    if (type_scope_id != -1) {
-        auto member_symbol = symbol_table_.lookup_symbol_in_scope(type_scope_id, member_name);
-        if (member_symbol && member_symbol->type == SymbolType::FUNCTION) {
-            std::cerr << "Error: Cannot access member function '" << member_name << "' without calling it. Use obj." 
-                      << member_name << "() to call the method." << std::endl;
-            current_value_ = ValueRef::invalid();
-            return;
-        }
-    }
-    
-    // Build the struct layout to find the field
-    auto struct_layout = build_struct_layout(struct_type_name);
-    if (!struct_layout) {
-        std::cerr << "Error: Could not determine struct layout for member access" << std::endl;
+    auto member_symbol = symbol_table_.get_bound_symbol(node);
+    if (member_symbol && member_symbol->type == SymbolType::FUNCTION) {
+        std::cerr << "Error: Cannot access member function '" << member_name << "' without calling it. Use obj." 
+                  << member_name << "() to call the method." << std::endl;
         current_value_ = ValueRef::invalid();
         return;
     }
     
-    // Find the field in the layout
-    int field_index = -1;
-    IRType field_type = IRType::i32(); // Default
-    
-    for (size_t i = 0; i < struct_layout->fields.size(); ++i) {
-        if (struct_layout->fields[i].name == member_name) {
-            field_index = static_cast<int>(i);
-            field_type = struct_layout->fields[i].type;
-            break;
-        }
-    }
-    
-    if (field_index == -1) {
-        std::cerr << "Error: Field '" << member_name << "' not found in struct '" << struct_type_name << "'" << std::endl;
+    // Cached struct layout to find the field
+    const StructInfo* struct_info = this->struct_info(struct_scope_id);
+    if (!struct_info) {
+        std::cerr << "Error: Could not determine struct layout for member access" << std::endl;
         current_value_ = ValueRef::invalid();
         return;
     }
     
-    // Generate GEP instruction to get field address
-    std::vector<int> indices = {field_index};
-    ValueRef field_ptr = ir_builder_->gep(struct_ptr, indices, IRType::ptr_to(field_type));
-    
-    if (!field_ptr.is_valid()) {
-        std::cerr << "Error: Failed to generate field access" << std::endl;
+    // Find the field in the layout, through the member's binding when it has one
+    int field_index = find_field_index(*struct_info, member_symbol, member_name);
+    if (field_index == -1) {
+        std::cerr << "Error: Field '" << member_name << "' not found in struct '" << struct_info->layout->name << "'" << std::endl;
         current_value_ = ValueRef::invalid();
         return;
     }
     
     // For struct types, return the pointer. For primitive types, load the value.
-    if (field_type.kind == IRType::Kind::Struct) {
+    if (struct_info->layout->fields[field_index].type.kind == IRType::Kind::Struct) {
         // For struct fields, return the pointer so further member access can work
-        current_value_ = field_ptr;
+        current_value_ = field_address(struct_ptr, *struct_info->layout, field_index);
     } else {
         // For primitive fields, load the value
-        current_value_ = ir_builder_->load(field_ptr, field_type);
+        current_value_ = load_field(struct_ptr, *struct_info->layout, field_index);
+    }
+    
+    if (!current_value_.is_valid()) {
+        std::cerr << "Error: Failed to generate field access" << std::endl;
     }
 }
 
@@ -1018,48 +907,42 @@ void CodeGenerator::visit(NewExpressionNode* node) {
     // Look up the type in the symbol table
     auto type_symbol = symbol_table_.lookup_symbol(type_name);
     if (type_symbol && type_symbol->type == SymbolType::CLASS) {
-        // Build struct layout from symbol table
-        auto struct_layout = build_struct_layout(type_name);
-        if (struct_layout) {
+        // Cached struct layout of the type
+        int struct_scope_id = symbol_table_.find_type_scope(type_name);
+        const StructInfo* struct_info = this->struct_info(struct_scope_id);
+        if (struct_info) {
             // Create struct type
-            IRType struct_type = IRType::struct_(struct_layout);
+            IRType struct_type = IRType::struct_(*struct_info->layout);
             
             // Allocate struct on stack
             ValueRef struct_alloca = ir_builder_->alloca(struct_type);
             
             // Initialize fields with default values
-            int struct_scope_id = symbol_table_.find_scope_by_name(type_name);
-            if (struct_scope_id != -1) {
-                auto field_symbols = symbol_table_.get_all_symbols_in_scope(struct_scope_id);
-                
-                // Process each field that has an initializer expression
-                for (const auto& field_symbol : field_symbols) {
-                    if (field_symbol && field_symbol->type == SymbolType::VARIABLE && 
-                        field_symbol->initializer_expression) {
-                        
-                        // Generate code for the initializer expression
-                        field_symbol->initializer_expression->accept(this);
-                        ValueRef init_value = current_value_;
-                        
-                        // Find field index in struct layout
-                        int field_index = find_field_index(*struct_layout, field_symbol->name);
-                        if (field_index >= 0) {
-                            // Generate GEP to field location
-                            ValueRef field_ptr = ir_builder_->gep(struct_alloca, {field_index}, 
-                                                                   IRType::ptr_to(field_symbol->data_type));
-                            
-                            // For struct types, we need to load the value from the pointer and store the struct value
-                            if (field_symbol->data_type.kind == IRType::Kind::Struct) {
-                                // Load the struct value from the pointer
-                                ValueRef struct_value = ir_builder_->load(init_value, field_symbol->data_type);
-                                ir_builder_->store(struct_value, field_ptr);
-                            } else {
-                                // For primitive types, store the value directly
-                                ir_builder_->store(init_value, field_ptr);
-                            }
+            auto field_symbols = symbol_table_.get_all_symbols_in_scope(struct_scope_id);
+            
+            // Process each field that has an initializer expression
+            for (const auto& field_symbol : field_symbols) {
+                if (field_symbol && field_symbol->type == SymbolType::VARIABLE && 
+                    field_symbol->initializer_expression) {
+                    
+                    // Generate code for the initializer expression
+                    walk(field_symbol->initializer_expression);
+                    ValueRef init_value = current_value_;
+                    
+                    // Find field index in struct layout
+                    int field_index = find_field_index(*struct_info, field_symbol, field_symbol->name);
+                    if (field_index >= 0) {
+                        // For struct types, we need to load the value from the pointer and store the struct value
+                        if (field_symbol->data_type.kind == IRType::Kind::Struct) {
+                            // Load the struct value from the pointer
+                            ValueRef struct_value = ir_builder_->load(init_value, field_symbol->data_type);
+                            store_field(struct_alloca, *struct_info->layout, field_index, struct_value);
                         } else {
-                            std::cerr << "Error: Could not find field index for: " << field_symbol->name << std::endl;
+                            // For primitive types, store the value directly
+                            store_field(struct_alloca, *struct_info->layout, field_index, init_value);
                         }
+                    } else {
+                        std::cerr << "Error: Could not find field index for: " << field_symbol->name << std::endl;
                     }
                 }
             }
@@ -1089,12 +972,13 @@ std::vector<Command> CodeGenerator::generate_code(CompilationUnitNode* root) {
     
     // Create the IR builder
     ir_builder_ = std::make_unique<IRBuilder>();
+    declared_callees_.clear();
     
     // Pre-generate all struct types to ensure LLVM type definitions exist
     pre_generate_struct_types();
     
     // Visit the compilation unit to generate commands
-    root->accept(this);
+    walk(root);
     
     // Debug: dump the command stream
     // LOG_DEBUG("Generated command stream:", LogCategory::CODEGEN);
@@ -1106,37 +990,30 @@ std::vector<Command> CodeGenerator::generate_code(CompilationUnitNode* root) {
     return ir_builder_->commands();
 }
 
-std::shared_ptr<StructLayout> CodeGenerator::build_struct_layout(const std::string& struct_name) {
-    // Look up the struct/class scope in the symbol table
-    int struct_scope_id = symbol_table_.find_scope_by_name(struct_name);
-    if (struct_scope_id == -1) {
-        std::cerr << "Error: Could not find scope for struct: " << struct_name << std::endl;
-        return nullptr;
-    }
+const CodeGenerator::StructInfo* CodeGenerator::struct_info(int type_scope_id) {
+    if (symbol_table_.get_scope_kind(type_scope_id) != ScopeKind::TYPE) return nullptr;
     
-    // Create the struct layout
-    auto layout = std::make_shared<StructLayout>();
-    layout->name = struct_name;
+    if (static_cast<size_t>(type_scope_id) >= struct_infos_.size()) struct_infos_.resize(symbol_table_.scope_count());
+    StructInfo& info = struct_infos_[type_scope_id];
+    uint64_t version = symbol_table_.get_scope_version(type_scope_id);
+    if (info.layout && info.scope_version == version) return &info;
     
-    // Get all symbols in the struct scope
-    auto symbols = symbol_table_.get_all_symbols_in_scope(struct_scope_id);
+    // The table orders the fields by its layout policy; the context keeps the layout
+    info.layout = symbol_table_.struct_type_of_scope(type_scope_id).struct_layout();
+    if (!info.layout) return nullptr;
     
-    // Process all variable symbols (struct fields)
-    for (const auto& symbol : symbols) {
-        if (symbol && symbol->type == SymbolType::VARIABLE) {
-            StructLayout::Field field;
-            field.name = symbol->name;
-            field.type = symbol->data_type;
-            field.offset = 0; // Will be calculated by calculate_layout()
-            
-            layout->fields.push_back(field);
-        }
+    info.field_indices.clear();
+    for (size_t i = 0; i < info.layout->fields.size(); ++i) {
+        info.field_indices[info.layout->fields[i].name] = static_cast<int>(i);
     }
-    
-    // Calculate field offsets and total size
-    layout->calculate_layout();
-    
-    return layout;
+    for (Symbol* symbol : symbol_table_.get_all_symbols_in_scope(type_scope_id)) {
+        if (!symbol || symbol->type != SymbolType::VARIABLE) continue;
+        if (symbol->id >= field_indices_.size()) field_indices_.resize(symbol_table_.symbol_count(), -1);
+        field_indices_[symbol->id] = info.field_indices.at(symbol->name);
+    }
+    info.scope_id = type_scope_id;
+    info.scope_version = version;
+    return &info;
 }
 
 void CodeGenerator::pre_generate_struct_types() {
@@ -1148,30 +1025,168 @@ void CodeGenerator::pre_generate_struct_types() {
     // Process all CLASS symbols
     for (const auto& symbol : global_symbols) {
         if (symbol && symbol->type == SymbolType::CLASS) {
-            LOG_DEBUG("Pre-generating struct type: " + symbol->name, LogCategory::CODEGEN);
+            LOG_DEBUG("Pre-generating struct type: " + std::string(symbol->name), LogCategory::CODEGEN);
             
             // Build struct layout - this will create the LLVM type definition
-            auto struct_layout = build_struct_layout(symbol->name);
-            if (struct_layout) {
+            const StructInfo* struct_info = this->struct_info(symbol_table_.find_type_scope(symbol->name));
+            if (struct_info) {
                 // Create the IR type to ensure it's registered in the type system
-                IRType struct_type = IRType::struct_(struct_layout);
-                LOG_DEBUG("Successfully pre-generated type: " + symbol->name, LogCategory::CODEGEN);
+                IRType struct_type = IRType::struct_(*struct_info->layout);
+                LOG_DEBUG("Successfully pre-generated type: " + std::string(symbol->name), LogCategory::CODEGEN);
             } else {
                 std::cerr << "Error: Failed to pre-generate struct layout for: " << symbol->name << std::endl;
             }
         }
     }
     
+    // Report what reordering and packing saved, per instance of each type
+    if (symbol_table_.get_field_order() != FieldOrder::Declared || symbol_table_.get_bit_packing()) {
+        for (const LayoutSavings& savings : symbol_table_.get_layout_savings()) {
+            LOG_INFO("Layout of '" + savings.type_name + "': " + std::to_string(savings.declared_size) + " -> " +
+                     std::to_string(savings.size) + " bytes" + (savings.pinned ? " (extern, declaration order)" : ""),
+                     LogCategory::CODEGEN);
+        }
+    }
+    
     LOG_DEBUG("Struct type pre-generation complete", LogCategory::CODEGEN);
 }
 
-int CodeGenerator::find_field_index(const StructLayout& layout, const std::string& field_name) {
-    for (size_t i = 0; i < layout.fields.size(); ++i) {
-        if (layout.fields[i].name == field_name) {
-            return static_cast<int>(i);
-        }
+int CodeGenerator::struct_scope_of(ExpressionNode* target, const ValueRef& value) {
+    std::string_view checked = symbol_table_.get_expression_type(target);
+    if (!checked.empty() && checked.back() != '*') {
+        int type_scope_id = symbol_table_.find_type_scope(checked);
+        if (type_scope_id != -1) return type_scope_id;
+    }
+    
+    const IRType* pointee = value.type.pointee();
+    if (pointee && pointee->kind == IRType::Kind::Struct && pointee->struct_layout()) {
+        return symbol_table_.find_type_scope(pointee->struct_layout()->name);
+    }
+    return -1;
+}
+
+int CodeGenerator::find_field_index(const StructInfo& info, const Symbol* field, std::string_view field_name) const {
+    // A field of this very type maps straight to its index; the info being current keeps the entry fresh
+    if (field && field->type == SymbolType::VARIABLE && field->scope_level == info.scope_id && field->id < field_indices_.size()) {
+        return field_indices_[field->id];
+    }
+    auto found = info.field_indices.find(field_name);
+    return found != info.field_indices.end() ? found->second : -1;
+}
+
+FunctionAttributes CodeGenerator::function_attributes(const Symbol* function) const {
+    FunctionAttributes attributes;
+    if (!function) return attributes;
+    FunctionEffects effects = symbol_table_.get_function_effects(function->id);
+    attributes.read_none = effects.purity == Purity::Pure;
+    attributes.read_only = effects.purity == Purity::ReadOnly;
+    attributes.no_unwind = effects.no_unwind;
+    attributes.will_return = effects.will_return;
+    return attributes;
+}
+
+void CodeGenerator::begin_function_locals(SymbolId this_symbol) {
+    ++current_function_;
+    this_symbol_ = this_symbol;
+}
+
+void CodeGenerator::bind_local(SymbolId symbol, const VariableInfo& info) {
+    if (symbol >= local_slots_.size()) {
+        local_slots_.resize(symbol_table_.symbol_count());
+        local_slot_function_.resize(symbol_table_.symbol_count(), 0);
+    }
+    local_slots_[symbol] = info;
+    local_slot_function_[symbol] = current_function_;
+}
+
+const VariableInfo* CodeGenerator::find_local(SymbolId symbol) const {
+    if (symbol >= local_slots_.size() || local_slot_function_[symbol] != current_function_) return nullptr;
+    return &local_slots_[symbol];
+}
+
+bool CodeGenerator::is_field(const Symbol* symbol) const {
+    return symbol && symbol->type == SymbolType::VARIABLE &&
+           symbol_table_.get_scope_kind(symbol->scope_level) == ScopeKind::TYPE;
+}
+
+ValueRef CodeGenerator::this_for_field(const Symbol* field, const StructInfo*& struct_info, int& field_index) {
+    const VariableInfo* this_info = find_local(this_symbol_);
+    if (!this_info) {
+        std::cerr << "Error: Cannot access field '" << field->name << "' - 'this' pointer not found" << std::endl;
+        return ValueRef::invalid();
+    }
+    
+    // Fields live in their type's scope
+    struct_info = this->struct_info(field->scope_level);
+    if (!struct_info) {
+        std::cerr << "Error: Could not build struct layout for unqualified field access" << std::endl;
+        return ValueRef::invalid();
+    }
+    
+    field_index = find_field_index(*struct_info, field, field->name);
+    if (field_index == -1) {
+        std::cerr << "Error: Field '" << field->name << "' not found in struct layout" << std::endl;
+        return ValueRef::invalid();
+    }
+    
+    // The field is addressed through the loaded 'this'
+    return ir_builder_->load(this_info->value_ref, this_info->type);
+}
+
+static unsigned int_bits(IRType type) {
+    return type.kind == IRType::Kind::Bool ? 1 : static_cast<unsigned>(type.size_in_bytes() * 8);
+}
+
+ValueRef CodeGenerator::field_address(ValueRef struct_ptr, const StructLayout& layout, int field_index) {
+    const StructLayout::Field& field = layout.fields[field_index];
+    IRType storage = field.packed() ? layout.elements[field.element] : field.type;
+    return ir_builder_->gep(struct_ptr, {field.element}, IRType::ptr_to(storage));
+}
+
+ValueRef CodeGenerator::load_field(ValueRef struct_ptr, const StructLayout& layout, int field_index) {
+    const StructLayout::Field& field = layout.fields[field_index];
+    ValueRef address = field_address(struct_ptr, layout, field_index);
+    if (!address.is_valid()) return ValueRef::invalid();
+    if (!field.packed()) return ir_builder_->load(address, field.type);
+    
+    // Shift the field down to bit 0 of its word and mask off its neighbours
+    IRType word_type = layout.elements[field.element];
+    ValueRef bits = ir_builder_->load(address, word_type);
+    if (field.bit_offset != 0) bits = ir_builder_->lshr(bits, word_constant(word_type, field.bit_offset));
+    bits = ir_builder_->bit_and(bits, word_constant(word_type, (1ull << field.bit_width) - 1));
+    return resize_int(bits, field.type);
+}
+
+void CodeGenerator::store_field(ValueRef struct_ptr, const StructLayout& layout, int field_index, ValueRef value) {
+    const StructLayout::Field& field = layout.fields[field_index];
+    ValueRef address = field_address(struct_ptr, layout, field_index);
+    if (!address.is_valid() || !value.is_valid()) return;
+    if (!field.packed()) {
+        ir_builder_->store(value, address);
+        return;
     }
-    return -1; // Field not found
+    
+    // Clear the field's bits in the word and or the new value in
+    IRType word_type = layout.elements[field.element];
+    uint64_t mask = (1ull << field.bit_width) - 1;
+    ValueRef bits = ir_builder_->bit_and(resize_int(value, word_type), word_constant(word_type, mask));
+    if (field.bit_offset != 0) bits = ir_builder_->shl(bits, word_constant(word_type, field.bit_offset));
+    ValueRef word = ir_builder_->load(address, word_type);
+    ValueRef kept = ir_builder_->bit_and(word, word_constant(word_type, ~(mask << field.bit_offset)));
+    ir_builder_->store(ir_builder_->bit_or(kept, bits), address);
+}
+
+ValueRef CodeGenerator::word_constant(IRType word_type, uint64_t bits) {
+    // Sign-extend from the word's width, so the constant is in range for it
+    unsigned shift = 64 - int_bits(word_type);
+    return ir_builder_->const_int(word_type, static_cast<int64_t>(bits << shift) >> shift);
+}
+
+ValueRef CodeGenerator::resize_int(ValueRef value, IRType type) {
+    unsigned from = int_bits(value.type), to = int_bits(type);
+    if (from < to) return ir_builder_->zext(value, type);
+    if (from > to) return ir_builder_->trunc(value, type);
+    return value;
 }
 
 void CodeGenerator::visit_member_function(FunctionDeclarationNode* node, const std::string& owner_type) {
@@ -1185,21 +1200,26 @@ void CodeGenerator::visit_member_function(FunctionDeclarationNode* node, const s
         return;
     }
     
+    if (symbol_table_.is_dead_function(symbol_table_.get_binding(node->name))) {
+        LOG_DEBUG("Skipping unreachable member function: '" + owner_type + "::" + std::string(node->name->name) + "'", LogCategory::CODEGEN);
+        return;
+    }
+    
     std::string func_name = std::string(node->name->name);
     
     // Create mangled name for member function to avoid conflicts with global functions
     std::string mangled_name = owner_type + "::" + func_name;
     
-    // Look up member function in symbol table using the qualified scope name
-    std::string member_func_scope_name = owner_type + "::" + func_name;
-    int member_func_scope_id = symbol_table_.find_scope_by_name(member_func_scope_name);
+    // The member function's scope is a child of its type's scope
+    int owner_scope_id = symbol_table_.find_scope_by_name(owner_type);
+    int member_func_scope_id = symbol_table_.find_child_scope(owner_scope_id, func_name);
     if (member_func_scope_id == -1) {
         LOG_ERROR("Could not find member function scope for: " + mangled_name, LogCategory::CODEGEN);
         return;
     }
     
     // Get function return type from symbol table
-    auto func_symbol = symbol_table_.lookup_symbol_in_scope(symbol_table_.find_scope_by_name(owner_type), func_name);
+    auto func_symbol = symbol_table_.lookup_symbol_in_scope(owner_scope_id, func_name);
     IRType return_type = IRType::void_(); // Default to void
     if (func_symbol && func_symbol->type == SymbolType::FUNCTION) {
         return_type = func_symbol->data_type;
@@ -1219,7 +1239,7 @@ void CodeGenerator::visit_member_function(FunctionDeclarationNode* node, const s
     for (int i = 0; i < node->parameters.size; ++i) {
         if (auto* param = ast_cast_or_error<ParameterNode>(node->parameters.values[i])) {
             std::string param_name = std::string(param->name->name);
-            auto param_symbol = symbol_table_.lookup_symbol_in_scope(member_func_scope_id, param_name);
+            auto param_symbol = symbol_table_.get_bound_symbol(param->name);
             if (param_symbol && param_symbol->type == SymbolType::PARAMETER) {
                 param_types.push_back(param_symbol->data_type);
             } else {
@@ -1231,34 +1251,32 @@ void CodeGenerator::visit_member_function(FunctionDeclarationNode* node, const s
     
     // Begin the member function with mangled name
     LOG_INFO("Processing member function: '" + mangled_name + "'", LogCategory::CODEGEN);
-    ir_builder_->function_begin(mangled_name, return_type, param_types);
+    ir_builder_->function_begin(mangled_name, return_type, param_types, function_attributes(func_symbol));
     
     // Navigate to the member function scope in the symbol table
-    symbol_table_.push_scope(member_func_scope_name);
-    
-    // Clear local variables for this function
-    local_vars_.clear();
+    symbol_table_.push_scope(member_func_scope_id);
     
-    // Allocate space for 'this' parameter
-    auto this_symbol = symbol_table_.lookup_symbol("this");
+    // Allocate space for 'this' parameter; unqualified fields load through it
+    auto this_symbol = symbol_table_.lookup_symbol_in_scope(member_func_scope_id, "this");
+    begin_function_locals(this_symbol ? this_symbol->id : INVALID_SYMBOL_ID);
     if (this_symbol && this_symbol->type == SymbolType::PARAMETER) {
         ValueRef this_alloca = ir_builder_->alloca(this_symbol->data_type);
-        local_vars_["this"] = {this_alloca, this_symbol->data_type};
-        LOG_DEBUG("Added 'this' parameter of type " + this_symbol->type_name, LogCategory::CODEGEN);
+        bind_local(this_symbol->id, {this_alloca, this_symbol->data_type});
+        LOG_DEBUG("Added 'this' parameter of type " + std::string(this_symbol->type_name), LogCategory::CODEGEN);
     }
     
     // Process explicit function parameters - allocate space for each parameter
     for (int i = 0; i < node->parameters.size; ++i) {
         if (auto* param = ast_cast_or_error<ParameterNode>(node->parameters.values[i])) {
             std::string param_name = std::string(param->name->name);
-            auto param_symbol = symbol_table_.lookup_symbol(param_name);
+            auto param_symbol = symbol_table_.get_bound_symbol(param->name);
             
             if (param_symbol && param_symbol->type == SymbolType::PARAMETER) {
                 // Allocate space for the parameter
                 ValueRef param_alloca = ir_builder_->alloca(param_symbol->data_type);
-                local_vars_[param_name] = {param_alloca, param_symbol->data_type};
+                bind_local(param_symbol->id, {param_alloca, param_symbol->data_type});
                 
-                LOG_DEBUG("Added parameter '" + param_name + "' of type " + param_symbol->type_name, LogCategory::CODEGEN);
+                LOG_DEBUG("Added parameter '" + param_name + "' of type " + std::string(param_symbol->type_name), LogCategory::CODEGEN);
             } else {
                 LOG_ERROR("Parameter '" + param_name + "' not found in current scope", LogCategory::CODEGEN);
             }
@@ -1268,7 +1286,7 @@ void CodeGenerator::visit_member_function(FunctionDeclarationNode* node, const s
     // Process the function body
     if (node->body) {
         LOG_DEBUG("Processing member function body for: " + mangled_name, LogCategory::CODEGEN);
-        node->body->accept(this);
+        walk(node->body);
     } else {
         LOG_WARN("No body for member function: " + mangled_name, LogCategory::CODEGEN);
     }
@@ -45,25 +45,25 @@ llvm::Type* CommandProcessor::to_llvm_type(IRType type) {
         case IRType::Kind::Ptr:
             return llvm::PointerType::getUnqual(*context_);
         case IRType::Kind::Struct:
-            if (type.struct_layout) {
+            if (const StructLayout* layout = type.struct_layout()) {
                 // Check if we already have this struct type cached
-                auto cache_it = struct_type_cache_.find(type.struct_layout->name);
+                auto cache_it = struct_type_cache_.find(layout->name);
                 if (cache_it != struct_type_cache_.end()) {
                     return cache_it->second;
                 }
                 
-                // Convert struct fields to LLVM types
+                // Convert struct elements to LLVM types; packed fields share an integer word
                 std::vector<llvm::Type*> field_types;
-                for (const auto& field : type.struct_layout->fields) {
-                    llvm::Type* field_type = to_llvm_type(field.type);
+                for (const IRType& element : layout->elements) {
+                    llvm::Type* field_type = to_llvm_type(element);
                     if (field_type) {
                         field_types.push_back(field_type);
                     }
                 }
                 
                 // Create struct type and cache it
-                llvm::StructType* struct_type = llvm::StructType::create(*context_, field_types, type.struct_layout->name);
-                struct_type_cache_[type.struct_layout->name] = struct_type;
+                llvm::StructType* struct_type = llvm::StructType::create(*context_, field_types, layout->name);
+                struct_type_cache_[layout->name] = struct_type;
                 return struct_type;
             }
             return nullptr;
@@ -87,6 +87,116 @@ void CommandProcessor::create_basic_blocks(const std::vector<Command>& commands)
     // when we encounter FunctionBegin
 }
 
+void CommandProcessor::add_function_attributes(llvm::Function* function, const std::string& attributes) {
+    size_t start = 0;
+    while (start < attributes.size()) {
+        size_t end = attributes.find(',', start);
+        if (end == std::string::npos) end = attributes.size();
+        std::string attribute = attributes.substr(start, end - start);
+        start = end + 1;
+        
+        if (attribute == "readnone") {
+            function->setDoesNotAccessMemory();
+        } else if (attribute == "readonly") {
+            function->setOnlyReadsMemory();
+        } else if (attribute == "nounwind") {
+            function->setDoesNotThrow();
+        } else if (attribute == "willreturn") {
+            function->addFnAttr(llvm::Attribute::WillReturn);
+        } else {
+            std::cerr << "Warning: Unknown function attribute '" << attribute << "'" << std::endl;
+        }
+    }
+}
+
+llvm::FunctionType* CommandProcessor::parse_function_type(const std::string& signature, std::string& name, std::string& attributes) {
+    // Parse "name:returntype" or "name:returntype:param1,param2,..."
+    // Handle member functions like "Type::method:returntype:params"
+    
+    // Split by finding the first ':' that's not part of '::'
+    size_t name_end = std::string::npos;
+    for (size_t i = 0; i < signature.length(); ++i) {
+        if (signature[i] == ':') {
+            // Check if it's part of '::'
+            if (i + 1 < signature.length() && signature[i + 1] == ':') {
+                i++; // Skip the second ':'
+                continue;
+            }
+            // Found a single ':'
+            name_end = i;
+            break;
+        }
+    }
+    if (name_end == std::string::npos) return nullptr;
+    
+    name = signature.substr(0, name_end);
+    std::string remainder = signature.substr(name_end + 1);
+    
+    // Attributes follow the signature as ";readnone,nounwind,..."
+    if (size_t semicolon = remainder.find(';'); semicolon != std::string::npos) {
+        attributes = remainder.substr(semicolon + 1);
+        remainder.resize(semicolon);
+    }
+    
+    size_t second_colon = remainder.find(':');
+    std::string return_type_str;
+    std::string param_types_str;
+    
+    if (second_colon != std::string::npos) {
+        return_type_str = remainder.substr(0, second_colon);
+        param_types_str = remainder.substr(second_colon + 1);
+    } else {
+        return_type_str = remainder;
+    }
+    
+    // Create return type
+    llvm::Type* return_type = to_llvm_type(IRType::void_());
+    if (return_type_str == "i32") {
+        return_type = llvm::Type::getInt32Ty(*context_);
+    } else if (return_type_str == "void") {
+        return_type = llvm::Type::getVoidTy(*context_);
+    } else if (return_type_str == "bool") {
+        return_type = llvm::Type::getInt1Ty(*context_);
+    } else if (return_type_str == "i1") {
+        return_type = llvm::Type::getInt1Ty(*context_);
+    } else if (!return_type_str.empty()) {
+        std::cerr << "Warning: Unknown return type '" << return_type_str << "', using default void" << std::endl;
+    }
+    
+    // Parse parameter types
+    std::vector<llvm::Type*> param_types;
+    auto add_param = [&](const std::string& param) {
+        if (param == "i32") {
+            param_types.push_back(llvm::Type::getInt32Ty(*context_));
+        } else if (param == "bool") {
+            param_types.push_back(llvm::Type::getInt1Ty(*context_));
+        } else if (param == "ptr") {
+            // For now, use opaque pointer type (i8*)
+            param_types.push_back(llvm::PointerType::get(*context_, 0));
+        } else {
+            std::cerr << "Unknown parameter type: " << param << std::endl;
+        }
+    };
+    std::string current_param;
+    for (char c : param_types_str) {
+        if (c == ',') {
+            if (!current_param.empty()) add_param(current_param);
+            current_param.clear();
+        } else {
+            current_param += c;
+        }
+    }
+    // Handle last parameter
+    if (!current_param.empty()) add_param(current_param);
+    
+    return llvm::FunctionType::get(return_type, param_types, false);
+}
+
+void CommandProcessor::report_error(const std::string& message) {
+    std::cerr << "Error: " << message << std::endl;
+    has_errors_ = true;
+}
+
 void CommandProcessor::create_function_basic_blocks() {
     // Create all BasicBlocks for the current function to handle forward references
     if (!current_function_ || !commands_) return;
@@ -151,6 +261,9 @@ void CommandProcessor::process_command(const Command& cmd) {
                     constant = llvm::ConstantInt::get(to_llvm_type(cmd.result.type), *int_val, true);
                 } else if (cmd.result.type.kind == IRType::Kind::I64) {
                     constant = llvm::ConstantInt::get(to_llvm_type(cmd.result.type), *int_val, true);
+                } else if (cmd.result.type.kind == IRType::Kind::I8 || cmd.result.type.kind == IRType::Kind::I16) {
+                    // Masks for packed words, sign-extended from their width
+                    constant = llvm::ConstantInt::get(to_llvm_type(cmd.result.type), *int_val, true);
                 }
             } else if (auto* bool_val = std::get_if<bool>(&cmd.data)) {
                 constant = llvm::ConstantInt::get(to_llvm_type(cmd.result.type), *bool_val ? 1 : 0);
@@ -265,6 +378,40 @@ void CommandProcessor::process_command(const Command& cmd) {
             break;
         }
         
+        case Op::Shl: {
+            llvm::Value* lhs = get_value(cmd.args[0].id);
+            llvm::Value* rhs = get_value(cmd.args[1].id);
+            if (lhs && rhs && cmd.result.is_valid()) {
+                value_map_[cmd.result.id] = builder_->CreateShl(lhs, rhs);
+            }
+            break;
+        }
+        
+        case Op::LShr: {
+            llvm::Value* lhs = get_value(cmd.args[0].id);
+            llvm::Value* rhs = get_value(cmd.args[1].id);
+            if (lhs && rhs && cmd.result.is_valid()) {
+                value_map_[cmd.result.id] = builder_->CreateLShr(lhs, rhs);
+            }
+            break;
+        }
+        
+        case Op::ZExt: {
+            llvm::Value* operand = get_value(cmd.args[0].id);
+            if (operand && cmd.result.is_valid()) {
+                value_map_[cmd.result.id] = builder_->CreateZExt(operand, to_llvm_type(cmd.result.type));
+            }
+            break;
+        }
+        
+        case Op::Trunc: {
+            llvm::Value* operand = get_value(cmd.args[0].id);
+            if (operand && cmd.result.is_valid()) {
+                value_map_[cmd.result.id] = builder_->CreateTrunc(operand, to_llvm_type(cmd.result.type));
+            }
+            break;
+        }
+        
         case Op::Alloca: {
             if (auto* type_str = std::get_if<std::string>(&cmd.data)) {
                 // Parse the type string to get the actual type
@@ -289,8 +436,9 @@ void CommandProcessor::process_command(const Command& cmd) {
                         // The struct type hasn't been created yet - we need to create it
                         // This can happen when 'new StructName()' is processed before any member access
                         // For now, we'll defer this by using the result type of the command
-                        if (cmd.result.type.pointee_type && cmd.result.type.pointee_type->kind == IRType::Kind::Struct) {
-                            alloca_type = to_llvm_type(*cmd.result.type.pointee_type);
+                        const IRType* pointee = cmd.result.type.pointee();
+                        if (pointee && pointee->kind == IRType::Kind::Struct) {
+                            alloca_type = to_llvm_type(*pointee);
                         }
                         
                         if (!alloca_type) {
@@ -362,8 +510,8 @@ void CommandProcessor::process_command(const Command& cmd) {
                 // Get the pointee type from the pointer argument type
                 // For GEP with opaque pointers, we need the struct type that the pointer points to
                 llvm::Type* struct_type = nullptr;
-                if (cmd.args.size() > 0 && cmd.args[0].type.pointee_type) {
-                    struct_type = to_llvm_type(*cmd.args[0].type.pointee_type);
+                if (cmd.args.size() > 0 && cmd.args[0].type.pointee()) {
+                    struct_type = to_llvm_type(*cmd.args[0].type.pointee());
                     if (!struct_type) {
                         std::cerr << "Error: Failed to convert pointee type to LLVM type in GEP\n";
                         break;
@@ -451,114 +599,62 @@ void CommandProcessor::process_command(const Command& cmd) {
         
         case Op::FunctionBegin: {
             if (auto* func_info = std::get_if<std::string>(&cmd.data)) {
-                // Parse "name:returntype" or "name:returntype:param1,param2,..."
-                // Handle member functions like "Type::method:returntype:params"
-                
-                // Split by finding the first ':' that's not part of '::'
-                size_t name_end = std::string::npos;
-                for (size_t i = 0; i < func_info->length(); ++i) {
-                    if ((*func_info)[i] == ':') {
-                        // Check if it's part of '::'
-                        if (i + 1 < func_info->length() && (*func_info)[i + 1] == ':') {
-                            i++; // Skip the second ':'
-                            continue;
-                        }
-                        // Found a single ':'
-                        name_end = i;
-                        break;
+                std::string name;
+                std::string attributes;
+                llvm::FunctionType* func_type = parse_function_type(*func_info, name, attributes);
+                if (func_type) {
+                    // A declaration ahead of the definition is reused if the definition matches it
+                    llvm::Function* declared = module_->getFunction(name);
+                    if (declared && !declared->isDeclaration()) {
+                        report_error("Function '" + name + "' is defined more than once");
+                        declared = nullptr;
+                    } else if (declared && declared->getFunctionType() != func_type) {
+                        report_error("Definition of '" + name + "' does not match its declaration");
+                        declared = nullptr;
                     }
-                }
-                
-                if (name_end != std::string::npos) {
-                    std::string name = func_info->substr(0, name_end);
-                    std::string remainder = func_info->substr(name_end + 1);
-                    
-                    size_t second_colon = remainder.find(':');
-                    std::string return_type_str;
-                    std::string param_types_str;
-                    
-                    if (second_colon != std::string::npos) {
-                        return_type_str = remainder.substr(0, second_colon);
-                        param_types_str = remainder.substr(second_colon + 1);
+                    if (declared) {
+                        current_function_ = declared;
                     } else {
-                        return_type_str = remainder;
-                    }
-                    
-                    // Create return type
-                    llvm::Type* return_type = to_llvm_type(IRType::void_());
-                    if (return_type_str == "i32") {
-                        return_type = llvm::Type::getInt32Ty(*context_);
-                    } else if (return_type_str == "void") {
-                        return_type = llvm::Type::getVoidTy(*context_);
-                    } else if (return_type_str == "bool") {
-                        return_type = llvm::Type::getInt1Ty(*context_);
-                    } else if (return_type_str == "i1") {
-                        return_type = llvm::Type::getInt1Ty(*context_);
-                    } else if (!return_type_str.empty()) {
-                        std::cerr << "Warning: Unknown return type '" << return_type_str << "', using default void" << std::endl;
-                    }
-                    
-                    // Parse parameter types
-                    std::vector<llvm::Type*> param_types;
-                    if (!param_types_str.empty()) {
-                        std::string current_param;
-                        for (char c : param_types_str) {
-                            if (c == ',') {
-                                if (!current_param.empty()) {
-                                    if (current_param == "i32") {
-                                        param_types.push_back(llvm::Type::getInt32Ty(*context_));
-                                    } else if (current_param == "bool") {
-                                        param_types.push_back(llvm::Type::getInt1Ty(*context_));
-                                    } else if (current_param == "ptr") {
-                                        // For now, use opaque pointer type (i8*)
-                                        param_types.push_back(llvm::PointerType::get(*context_, 0));
-                                    } else {
-                                        std::cerr << "Unknown parameter type: " << current_param << std::endl;
-                                    }
-                                    current_param.clear();
-                                }
-                            } else {
-                                current_param += c;
-                            }
-                        }
-                        // Handle last parameter
-                        if (!current_param.empty()) {
-                            if (current_param == "i32") {
-                                param_types.push_back(llvm::Type::getInt32Ty(*context_));
-                            } else if (current_param == "bool") {
-                                param_types.push_back(llvm::Type::getInt1Ty(*context_));
-                            } else if (current_param == "ptr") {
-                                // For now, use opaque pointer type (i8*)
-                                param_types.push_back(llvm::PointerType::get(*context_, 0));
-                            } else {
-                                std::cerr << "Unknown parameter type: " << current_param << std::endl;
-                            }
-                        }
-                    }
-                    
-                    if (return_type) {
-                        llvm::FunctionType* func_type = llvm::FunctionType::get(return_type, param_types, false);
                         current_function_ = llvm::Function::Create(
                             func_type, 
                             llvm::Function::ExternalLinkage,
                             name,
                             module_.get()
                         );
-                        LOG_DEBUG("Created LLVM function: '" + name + "' with " + std::to_string(param_types.size()) + " parameters", LogCategory::CODEGEN);
-                        
-                        // Create entry block
-                        current_block_ = llvm::BasicBlock::Create(*context_, "entry", current_function_);
-                        builder_->SetInsertPoint(current_block_);
-                        
-                        // Store function arguments for access by parameter allocations
-                        // The first few allocations in the function will be for parameters
-                        param_count_ = param_types.size();
-                        current_alloca_index_ = 0;
-                        
-                        // Create all BasicBlocks for this function to handle forward references
-                        create_function_basic_blocks();
                     }
+                    LOG_DEBUG("Created LLVM function: '" + name + "' with " + std::to_string(func_type->getNumParams()) + " parameters", LogCategory::CODEGEN);
+                    add_function_attributes(current_function_, attributes);
+                    
+                    // Create entry block
+                    current_block_ = llvm::BasicBlock::Create(*context_, "entry", current_function_);
+                    builder_->SetInsertPoint(current_block_);
+                    
+                    // Store function arguments for access by parameter allocations
+                    // The first few allocations in the function will be for parameters
+                    param_count_ = func_type->getNumParams();
+                    current_alloca_index_ = 0;
+                    
+                    // Create all BasicBlocks for this function to handle forward references
+                    create_function_basic_blocks();
+                }
+            }
+            break;
+        }
+        
+        case Op::FunctionDeclare: {
+            if (auto* func_info = std::get_if<std::string>(&cmd.data)) {
+                std::string name;
+                std::string attributes;
+                llvm::FunctionType* func_type = parse_function_type(*func_info, name, attributes);
+                if (!func_type) break;
+                if (llvm::Function* existing = module_->getFunction(name)) {
+                    if (existing->getFunctionType() != func_type) {
+                        report_error("Declaration of '" + name + "' does not match its earlier signature");
+                    }
+                    break;
                 }
+                llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, name, module_.get());
+                LOG_DEBUG("Declared function '" + name + "'", LogCategory::CODEGEN);
             }
             break;
         }
@@ -572,13 +668,6 @@ void CommandProcessor::process_command(const Command& cmd) {
         
         case Op::Call: {
             if (auto* func_name = std::get_if<std::string>(&cmd.data)) {
-                // Look up the function in the module
-                llvm::Function* callee = module_->getFunction(*func_name);
-                if (!callee) {
-                    std::cerr << "Error: Function '" << *func_name << "' not found\n";
-                    break;
-                }
-                
                 // Collect argument values
                 std::vector<llvm::Value*> args;
                 for (const auto& arg : cmd.args) {
@@ -589,6 +678,30 @@ void CommandProcessor::process_command(const Command& cmd) {
                     }
                     args.push_back(arg_val);
                 }
+                if (args.size() != cmd.args.size()) break;
+                
+                // Look up the function in the module. Code generation declares callees
+                // ahead of their calls; a stream without declarations has one made
+                // from the call's arguments, linked by name.
+                llvm::Function* callee = module_->getFunction(*func_name);
+                if (!callee) {
+                    std::vector<llvm::Type*> param_types;
+                    for (llvm::Value* arg : args) param_types.push_back(arg->getType());
+                    llvm::Type* return_type = cmd.result.is_valid() ? to_llvm_type(cmd.result.type) : llvm::Type::getVoidTy(*context_);
+                    callee = llvm::Function::Create(llvm::FunctionType::get(return_type, param_types, false),
+                                                    llvm::Function::ExternalLinkage, *func_name, module_.get());
+                    LOG_DEBUG("Declared external function '" + *func_name + "'", LogCategory::CODEGEN);
+                }
+                
+                llvm::FunctionType* callee_type = callee->getFunctionType();
+                bool matches = callee_type->getNumParams() == args.size();
+                for (size_t i = 0; matches && i < args.size(); ++i) {
+                    matches = callee_type->getParamType(i) == args[i]->getType();
+                }
+                if (!matches) {
+                    report_error("Call to '" + *func_name + "' does not match its signature");
+                    break;
+                }
                 
                 // Create the call instruction
                 llvm::Value* call_result = builder_->CreateCall(callee, args);
@@ -650,7 +763,8 @@ bool CommandProcessor::verify_module() {
         std::cerr << "Module verification failed:\n" << error_msg << std::endl;
     }
     
-    return is_valid;
+    // Signature mismatches were reported as they were found
+    return is_valid && !has_errors_;
 }
 
 std::unique_ptr<llvm::LLVMContext> CommandProcessor::take_context() {
@@ -70,6 +70,10 @@ ValueRef IRBuilder::const_null(IRType ptr_type) {
     return emit_with_data(Op::Const, ptr_type, {}, static_cast<int64_t>(0));
 }
 
+ValueRef IRBuilder::const_int(IRType type, int64_t value) {
+    return emit_with_data(Op::Const, type, {}, value);
+}
+
 // Binary operations
 ValueRef IRBuilder::add(ValueRef lhs, ValueRef rhs) {
     // Basic type checking
@@ -146,6 +150,61 @@ ValueRef IRBuilder::logical_not(ValueRef operand) {
     return emit(Op::Not, IRType::bool_(), {operand});
 }
 
+// Bitwise operations
+ValueRef IRBuilder::bit_and(ValueRef lhs, ValueRef rhs) {
+    if (lhs.type != rhs.type) {
+        std::cerr << "Type mismatch in bitwise and\n";
+        return ValueRef::invalid();
+    }
+    
+    return emit(Op::And, lhs.type, {lhs, rhs});
+}
+
+ValueRef IRBuilder::bit_or(ValueRef lhs, ValueRef rhs) {
+    if (lhs.type != rhs.type) {
+        std::cerr << "Type mismatch in bitwise or\n";
+        return ValueRef::invalid();
+    }
+    
+    return emit(Op::Or, lhs.type, {lhs, rhs});
+}
+
+ValueRef IRBuilder::shl(ValueRef value, ValueRef amount) {
+    if (value.type != amount.type) {
+        std::cerr << "Type mismatch in shl operation\n";
+        return ValueRef::invalid();
+    }
+    
+    return emit(Op::Shl, value.type, {value, amount});
+}
+
+ValueRef IRBuilder::lshr(ValueRef value, ValueRef amount) {
+    if (value.type != amount.type) {
+        std::cerr << "Type mismatch in lshr operation\n";
+        return ValueRef::invalid();
+    }
+    
+    return emit(Op::LShr, value.type, {value, amount});
+}
+
+ValueRef IRBuilder::zext(ValueRef value, IRType type) {
+    if (value.type.size_in_bytes() > type.size_in_bytes()) {
+        std::cerr << "zext cannot narrow " << value.type.to_string() << " to " << type.to_string() << "\n";
+        return ValueRef::invalid();
+    }
+    
+    return emit(Op::ZExt, type, {value});
+}
+
+ValueRef IRBuilder::trunc(ValueRef value, IRType type) {
+    if (value.type.size_in_bytes() < type.size_in_bytes()) {
+        std::cerr << "trunc cannot widen " << value.type.to_string() << " to " << type.to_string() << "\n";
+        return ValueRef::invalid();
+    }
+    
+    return emit(Op::Trunc, type, {value});
+}
+
 // Memory operations
 ValueRef IRBuilder::alloca(IRType type) {
     return emit_with_data(Op::Alloca, IRType::ptr_to(type), {}, type.to_string());
@@ -241,8 +300,9 @@ bool IRBuilder::has_terminator() const {
 
 
 // Function management
-void IRBuilder::function_begin(const std::string& name, IRType return_type, const std::vector<IRType>& param_types) {
-    // Encode function signature as "name:return_type:param1,param2,..."
+
+// Encodes a function signature as "name:return_type:param1,param2,..."
+static std::string function_signature(const std::string& name, IRType return_type, const std::vector<IRType>& param_types) {
     std::string signature = name + ":" + return_type.to_string();
     if (!param_types.empty()) {
         signature += ":";
@@ -251,6 +311,15 @@ void IRBuilder::function_begin(const std::string& name, IRType return_type, cons
             signature += param_types[i].to_string();
         }
     }
+    return signature;
+}
+
+void IRBuilder::function_begin(const std::string& name, IRType return_type, const std::vector<IRType>& param_types,
+                               FunctionAttributes attributes) {
+    // Attributes follow the signature as ";attribute,..."
+    std::string signature = function_signature(name, return_type, param_types);
+    std::string attribute_list = attributes.to_string();
+    if (!attribute_list.empty()) signature += ";" + attribute_list;
     emit_with_data(Op::FunctionBegin, IRType::void_(), {}, signature);
 }
 
@@ -258,6 +327,10 @@ void IRBuilder::function_end() {
     emit(Op::FunctionEnd, IRType::void_(), {});
 }
 
+void IRBuilder::function_declare(const std::string& name, IRType return_type, const std::vector<IRType>& param_types) {
+    emit_with_data(Op::FunctionDeclare, IRType::void_(), {}, function_signature(name, return_type, param_types));
+}
+
 ValueRef IRBuilder::call(const std::string& function_name, IRType return_type, const std::vector<ValueRef>& args) {
     return emit_with_data(Op::Call, return_type, args, function_name);
 }
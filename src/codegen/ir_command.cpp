@@ -1,4 +1,6 @@
 #include "codegen/ir_command.hpp"
+#include "codegen/type_context.hpp"
+#include <algorithm>
 #include <sstream>
 
 namespace Mycelium::Scripting::Lang {
@@ -52,6 +54,22 @@ std::string Command::to_string() const {
             ss << "xor " << args[0].type.to_string() << " %" << args[0].id << ", 1";
             break;
             
+        case Op::Shl:
+            ss << "shl " << args[0].type.to_string() << " %" << args[0].id << ", %" << args[1].id;
+            break;
+            
+        case Op::LShr:
+            ss << "lshr " << args[0].type.to_string() << " %" << args[0].id << ", %" << args[1].id;
+            break;
+            
+        case Op::ZExt:
+            ss << "zext " << args[0].type.to_string() << " %" << args[0].id << " to " << result.type.to_string();
+            break;
+            
+        case Op::Trunc:
+            ss << "trunc " << args[0].type.to_string() << " %" << args[0].id << " to " << result.type.to_string();
+            break;
+            
         case Op::ICmp: {
             ss << "icmp ";
             if (std::holds_alternative<ICmpPredicate>(data)) {
@@ -132,9 +150,16 @@ std::string Command::to_string() const {
             break;
             
         case Op::FunctionBegin:
+        case Op::FunctionDeclare:
             if (std::holds_alternative<std::string>(data)) {
                 // Parse the function signature: "name:returntype" or "name:returntype:param1,param2,..."
                 std::string func_info = std::get<std::string>(data);
+                std::string attributes;
+                if (size_t semicolon = func_info.find(';'); semicolon != std::string::npos) {
+                    attributes = func_info.substr(semicolon + 1);
+                    func_info.resize(semicolon);
+                    std::replace(attributes.begin(), attributes.end(), ',', ' ');
+                }
                 size_t first_colon = func_info.find(':');
                 if (first_colon != std::string::npos) {
                     std::string name = func_info.substr(0, first_colon);
@@ -152,7 +177,7 @@ std::string Command::to_string() const {
                     }
                     
                     // Format the function signature properly
-                    ss << "define " << return_type_str << " @" << name << "(";
+                    ss << (op == Op::FunctionDeclare ? "declare " : "define ") << return_type_str << " @" << name << "(";
                     
                     // Add parameter types
                     if (!param_types_str.empty()) {
@@ -177,7 +202,11 @@ std::string Command::to_string() const {
                         }
                     }
                     
-                    ss << ") {";
+                    ss << ")";
+                    if (!attributes.empty()) ss << " " << attributes;
+                    if (op == Op::FunctionBegin) ss << " {";
+                } else if (op == Op::FunctionDeclare) {
+                    ss << "declare void @" << func_info << "()";
                 } else {
                     // Fallback for invalid signature
                     ss << "define void @" << func_info << "() {";
@@ -208,6 +237,20 @@ std::string Command::to_string() const {
     return ss.str();
 }
 
+std::string FunctionAttributes::to_string() const {
+    std::string list;
+    auto add = [&](bool present, const char* name) {
+        if (!present) return;
+        if (!list.empty()) list += ",";
+        list += name;
+    };
+    add(read_none, "readnone");
+    add(read_only, "readonly");
+    add(no_unwind, "nounwind");
+    add(will_return, "willreturn");
+    return list;
+}
+
 // IRType implementation
 std::string IRType::to_string() const {
     switch (kind) {
@@ -221,8 +264,8 @@ std::string IRType::to_string() const {
         case Kind::F64: return "f64";
         case Kind::Ptr: return "ptr";
         case Kind::Struct: 
-            if (struct_layout && !struct_layout->name.empty()) {
-                return "struct." + struct_layout->name;
+            if (const StructLayout* layout = struct_layout(); layout && !layout->name.empty()) {
+                return "struct." + layout->name;
             }
             return "struct";
         default: return "unknown";
@@ -230,15 +273,20 @@ std::string IRType::to_string() const {
 }
 
 IRType IRType::ptr_to(IRType pointee) {
-    IRType result(Kind::Ptr);
-    result.pointee_type = std::make_shared<IRType>(pointee);
-    return result;
+    return TypeContext::global().pointer_to(pointee);
+}
+
+IRType IRType::struct_(const StructLayout& layout) {
+    return TypeContext::global().struct_type(layout.name, layout.fields);
+}
+
+const IRType* IRType::pointee() const {
+    // Bare kinds have nothing to look up
+    return kind == Kind::Ptr && id != Kind::Ptr ? TypeContext::global().pointee(id) : nullptr;
 }
 
-IRType IRType::struct_(std::shared_ptr<StructLayout> layout) {
-    IRType result(Kind::Struct);
-    result.struct_layout = layout;
-    return result;
+const StructLayout* IRType::struct_layout() const {
+    return kind == Kind::Struct && id != Kind::Struct ? TypeContext::global().struct_layout(id) : nullptr;
 }
 
 size_t IRType::size_in_bytes() const {
@@ -253,7 +301,8 @@ size_t IRType::size_in_bytes() const {
         case Kind::F64: return 8;
         case Kind::Ptr: return 8;  // 64-bit pointers
         case Kind::Struct:
-            return struct_layout ? struct_layout->total_size : 0;
+            if (const StructLayout* layout = struct_layout()) return layout->total_size;
+            return 0;
         default: return 0;
     }
 }
@@ -270,55 +319,82 @@ size_t IRType::alignment() const {
         case Kind::F64: return 8;
         case Kind::Ptr: return 8;  // 64-bit alignment
         case Kind::Struct:
-            return struct_layout ? struct_layout->alignment : 1;
+            if (const StructLayout* layout = struct_layout()) return layout->alignment;
+            return 1;
         default: return 1;
     }
 }
 
-bool IRType::operator==(const IRType& other) const {
-    if (kind != other.kind) return false;
-    
-    // Compare pointee types for pointer types
-    if (kind == Kind::Ptr) {
-        if (!pointee_type && !other.pointee_type) return true;
-        if (!pointee_type || !other.pointee_type) return false;
-        return *pointee_type == *other.pointee_type;
-    }
-    
-    // Compare struct layouts for struct types
-    if (kind == Kind::Struct) {
-        if (!struct_layout && !other.struct_layout) return true;
-        if (!struct_layout || !other.struct_layout) return false;
-        return struct_layout->name == other.struct_layout->name;
-    }
+// StructLayout implementation
+void StructLayout::order_fields(std::vector<Field>& fields, FieldOrder order) {
+    if (order == FieldOrder::Declared) return;
     
-    return true;
+    // Sizes are multiples of alignment, so descending alignment leaves no gaps between fields.
+    // Packed fields go last, where their words need the least padding.
+    std::stable_sort(fields.begin(), fields.end(), [](const Field& a, const Field& b) {
+        if (a.packed() != b.packed()) return b.packed();
+        if (a.packed()) return false;
+        size_t a_align = a.type.alignment(), b_align = b.type.alignment();
+        if (a_align != b_align) return a_align > b_align;
+        return a.type.size_in_bytes() > b.type.size_in_bytes();
+    });
 }
 
-// StructLayout implementation
 void StructLayout::calculate_layout() {
+    // Fill packed words in field order; a field that does not fit starts the next word
+    std::vector<unsigned> word_bits;
+    std::vector<int> word_of(fields.size(), -1);
+    for (size_t i = 0; i < fields.size(); ++i) {
+        if (!fields[i].packed()) continue;
+        if (word_bits.empty() || word_bits.back() + fields[i].bit_width > PACKED_WORD_BITS) {
+            word_bits.push_back(0);
+        }
+        word_of[i] = static_cast<int>(word_bits.size() - 1);
+        fields[i].bit_offset = static_cast<uint8_t>(word_bits.back());
+        word_bits.back() += fields[i].bit_width;
+    }
+    
     size_t current_offset = 0;
     alignment = 1;
+    elements.clear();
+    std::vector<size_t> element_offsets;
+    std::vector<int> word_element(word_bits.size(), -1);
     
-    for (auto& field : fields) {
-        // Get field alignment requirement
-        size_t field_align = field.type.alignment();
+    auto place = [&](IRType type) {
+        // Get element alignment requirement
+        size_t element_align = type.alignment();
         
-        // Update struct alignment to be at least as strict as field
-        if (field_align > alignment) {
-            alignment = field_align;
+        // Update struct alignment to be at least as strict as the element
+        if (element_align > alignment) {
+            alignment = element_align;
         }
         
-        // Align current offset to field alignment
-        if (current_offset % field_align != 0) {
-            current_offset = ((current_offset / field_align) + 1) * field_align;
+        // Align current offset to element alignment
+        if (current_offset % element_align != 0) {
+            current_offset = ((current_offset / element_align) + 1) * element_align;
         }
         
-        // Set field offset
-        field.offset = current_offset;
-        
-        // Advance offset by field size
-        current_offset += field.type.size_in_bytes();
+        elements.push_back(type);
+        element_offsets.push_back(current_offset);
+        current_offset += type.size_in_bytes();
+        return static_cast<int>(elements.size() - 1);
+    };
+    
+    for (size_t i = 0; i < fields.size(); ++i) {
+        Field& field = fields[i];
+        if (field.packed()) {
+            // A word takes the place of the first field packed into it, sized to its bits
+            int& element = word_element[word_of[i]];
+            if (element == -1) {
+                unsigned bits = word_bits[word_of[i]];
+                element = place(bits <= 8 ? IRType::i8() : bits <= 16 ? IRType::i16() : IRType::i32());
+            }
+            field.element = element;
+        } else {
+            field.bit_offset = 0;
+            field.element = place(field.type);
+        }
+        field.offset = element_offsets[field.element];
     }
     
     // Pad struct to its alignment
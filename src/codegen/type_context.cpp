@@ -0,0 +1,133 @@
+#include "codegen/type_context.hpp"
+#include <mutex>
+
+namespace Mycelium::Scripting::Lang {
+
+TypeContext& TypeContext::global() {
+    static TypeContext context;
+    return context;
+}
+
+TypeContext::TypeContext() {
+    add_bare_kinds();
+    
+    builtins_ = {
+        {"i32", IRType::i32()}, {"i64", IRType::i64()}, {"i8", IRType::i8()}, {"i16", IRType::i16()},
+        {"bool", IRType::bool_()}, {"f32", IRType::f32()}, {"f64", IRType::f64()}, {"void", IRType::void_()},
+        {"ptr", IRType::ptr()},
+        {"string", IRType::ptr()},  // Strings are represented as pointers in LLVM
+    };
+}
+
+// Bare kinds first, so IRType(kind) needs no lookup
+void TypeContext::add_bare_kinds() {
+    for (int kind = IRType::Kind::Void; kind <= IRType::Kind::Struct; kind++) {
+        Entry entry;
+        entry.type = IRType(static_cast<IRType::Kind>(kind));
+        entries_.push_back(std::move(entry));
+    }
+}
+
+void TypeContext::reset() {
+    std::unique_lock lock(mutex_);
+    entries_.clear();
+    pointers_.clear();
+    keyed_.clear();
+    add_bare_kinds();
+}
+
+IRType TypeContext::pointer_to(IRType pointee) {
+    {
+        std::shared_lock lock(mutex_);
+        auto found = pointers_.find(pointee.id);
+        if (found != pointers_.end()) return entries_[found->second].type;
+    }
+    
+    std::unique_lock lock(mutex_);
+    auto [slot, inserted] = pointers_.try_emplace(pointee.id, static_cast<TypeId>(entries_.size()));
+    if (inserted) {
+        Entry& entry = entries_.emplace_back();
+        entry.type = IRType(IRType::Kind::Ptr, slot->second);
+        entry.has_pointee = true;
+        entry.pointee = pointee;
+    }
+    return entries_[slot->second].type;
+}
+
+std::optional<IRType> TypeContext::find_keyed(const std::string& key) const {
+    std::shared_lock lock(mutex_);
+    auto found = keyed_.find(key);
+    if (found == keyed_.end()) return std::nullopt;
+    return entries_[found->second].type;
+}
+
+IRType TypeContext::add_keyed(const std::string& key, Entry entry) {
+    std::unique_lock lock(mutex_);
+    auto [slot, inserted] = keyed_.try_emplace(key, static_cast<TypeId>(entries_.size()));
+    if (inserted) {
+        entry.type.id = slot->second;
+        entries_.push_back(std::move(entry));
+    }
+    return entries_[slot->second].type;
+}
+
+IRType TypeContext::struct_type(const std::string& name, const std::vector<StructLayout::Field>& fields) {
+    std::string key = "struct " + name + "{";
+    for (const auto& field : fields) {
+        key += field.name + ":" + std::to_string(field.type.id);
+        if (field.packed()) key += "/" + std::to_string(field.bit_width);
+        key += ";";
+    }
+    key += "}";
+    if (auto found = find_keyed(key)) return *found;
+    
+    // Lay the struct out before locking: field sizes read nested layouts through the context
+    Entry entry;
+    entry.type = IRType(IRType::Kind::Struct);
+    entry.has_layout = true;
+    entry.layout.name = name;
+    entry.layout.fields = fields;
+    entry.layout.calculate_layout();
+    return add_keyed(key, std::move(entry));
+}
+
+IRType TypeContext::generic_instance(const std::string& base, const std::vector<IRType>& arguments) {
+    std::string key = "generic " + base + "<";
+    for (const IRType& argument : arguments) {
+        key += std::to_string(argument.id) + ",";
+    }
+    key += ">";
+    if (auto found = find_keyed(key)) return *found;
+    
+    Entry entry;
+    entry.type = IRType(IRType::Kind::Ptr);
+    for (const IRType& argument : arguments) entry.arguments.push_back(argument.id);
+    return add_keyed(key, std::move(entry));
+}
+
+std::optional<IRType> TypeContext::builtin(std::string_view name) const {
+    auto found = builtins_.find(name);
+    if (found == builtins_.end()) return std::nullopt;
+    return found->second;
+}
+
+const IRType* TypeContext::pointee(TypeId id) const {
+    std::shared_lock lock(mutex_);
+    if (id >= entries_.size()) return nullptr;  // From before a reset
+    const Entry& entry = entries_[id];
+    return entry.has_pointee ? &entry.pointee : nullptr;
+}
+
+const StructLayout* TypeContext::struct_layout(TypeId id) const {
+    std::shared_lock lock(mutex_);
+    if (id >= entries_.size()) return nullptr;  // From before a reset
+    const Entry& entry = entries_[id];
+    return entry.has_layout ? &entry.layout : nullptr;
+}
+
+size_t TypeContext::size() const {
+    std::shared_lock lock(mutex_);
+    return entries_.size();
+}
+
+} // namespace Mycelium::Scripting::Lang
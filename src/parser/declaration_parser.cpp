@@ -34,15 +34,15 @@ ParseResult<DeclarationNode> DeclarationParser::parse_declaration() {
     }
     
     if (ctx.check(TokenKind::Fn)) {
-        return parse_function_declaration();
+        return parse_function_declaration(modifiers);
     }
     
     if (ctx.check(TokenKind::Type)) {
-        return parse_type_declaration();
+        return parse_type_declaration(modifiers);
     }
     
     if (ctx.check(TokenKind::Enum)) {
-        return parse_enum_declaration();
+        return parse_enum_declaration(modifiers);
     }
     
     return ParseResult<DeclarationNode>::error(
@@ -50,7 +50,7 @@ ParseResult<DeclarationNode> DeclarationParser::parse_declaration() {
 }
 
 // Function declaration parsing
-ParseResult<DeclarationNode> DeclarationParser::parse_function_declaration() {
+ParseResult<DeclarationNode> DeclarationParser::parse_function_declaration(const std::vector<ModifierKind>& modifiers) {
     auto& ctx = context();
     
     ctx.advance(); // consume 'fn'
@@ -66,6 +66,9 @@ ParseResult<DeclarationNode> DeclarationParser::parse_function_declaration() {
     auto* func_decl = parser_->get_allocator().alloc<FunctionDeclarationNode>();
     func_decl->contains_errors = false;
     
+    // Modifiers mark exported, host-bound and virtual functions
+    store_modifiers(func_decl, modifiers);
+    
     // Set up name
     auto* name_node = parser_->get_allocator().alloc<IdentifierNode>();
     name_node->name = name_token.text;
@@ -150,7 +153,7 @@ ParseResult<DeclarationNode> DeclarationParser::parse_function_declaration() {
 }
 
 // Type declaration parsing
-ParseResult<DeclarationNode> DeclarationParser::parse_type_declaration() {
+ParseResult<DeclarationNode> DeclarationParser::parse_type_declaration(const std::vector<ModifierKind>& modifiers) {
     auto& ctx = context();
     
     // Store the type keyword token
@@ -173,6 +176,9 @@ ParseResult<DeclarationNode> DeclarationParser::parse_type_declaration() {
     type_decl->contains_errors = false;
     type_decl->typeKeyword = type_keyword;
     
+    // Modifiers decide value or ref semantics and whether the layout is pinned
+    store_modifiers(type_decl, modifiers);
+    
     // Set up name
     auto* name_node = parser_->get_allocator().alloc<IdentifierNode>();
     name_node->name = name_token.text;
@@ -195,9 +201,11 @@ ParseResult<DeclarationNode> DeclarationParser::parse_type_declaration() {
     std::vector<AstNode*> members;
     
     while (!ctx.check(TokenKind::RightBrace) && !ctx.at_end()) {
+        size_t member_start = ctx.position;
         auto member_result = parse_type_member();
         
         if (member_result.is_success()) {
+            ctx.set_span(member_result.get_node(), member_start);
             members.push_back(member_result.get_node());
         } else if (member_result.is_error()) {
             // Add error node and continue
@@ -239,7 +247,7 @@ ParseResult<DeclarationNode> DeclarationParser::parse_type_declaration() {
 }
 
 // Enum declaration parsing
-ParseResult<DeclarationNode> DeclarationParser::parse_enum_declaration() {
+ParseResult<DeclarationNode> DeclarationParser::parse_enum_declaration(const std::vector<ModifierKind>& modifiers) {
     auto& ctx = context();
     
     ctx.advance(); // consume 'enum'
@@ -254,6 +262,7 @@ ParseResult<DeclarationNode> DeclarationParser::parse_enum_declaration() {
     
     auto* enum_decl = parser_->get_allocator().alloc<EnumDeclarationNode>();
     enum_decl->contains_errors = false;
+    store_modifiers(enum_decl, modifiers);
     
     // Set up name
     auto* name_node = parser_->get_allocator().alloc<IdentifierNode>();
@@ -363,7 +372,7 @@ ParseResult<AstNode> DeclarationParser::parse_type_member() {
     
     // Handle function declarations as type members
     if (ctx.check(TokenKind::Fn)) {
-        auto func_result = parse_function_declaration();
+        auto func_result = parse_function_declaration(modifiers);
         if (func_result.is_success()) {
             return ParseResult<AstNode>::success(func_result.get_node());
         } else {
@@ -373,7 +382,7 @@ ParseResult<AstNode> DeclarationParser::parse_type_member() {
     
     // Handle nested type declarations
     if (ctx.check(TokenKind::Type)) {
-        auto type_result = parse_type_declaration();
+        auto type_result = parse_type_declaration(modifiers);
         if (type_result.is_success()) {
             return ParseResult<AstNode>::success(type_result.get_node());
         } else {
@@ -383,7 +392,7 @@ ParseResult<AstNode> DeclarationParser::parse_type_member() {
     
     // Handle nested enum declarations
     if (ctx.check(TokenKind::Enum)) {
-        auto enum_result = parse_enum_declaration();
+        auto enum_result = parse_enum_declaration(modifiers);
         if (enum_result.is_success()) {
             return ParseResult<AstNode>::success(enum_result.get_node());
         } else {
@@ -406,6 +415,7 @@ ParseResult<AstNode> DeclarationParser::parse_type_member() {
     }
     
     auto* var_decl = typed_result.get_node();
+    store_modifiers(var_decl, modifiers);
     
     // Handle semicolon
     if (context().check(TokenKind::Semicolon)) {
@@ -426,6 +436,7 @@ ParseResult<AstNode> DeclarationParser::parse_type_member() {
 
 ParseResult<EnumCaseNode> DeclarationParser::parse_enum_case() {
     auto& ctx = context();
+    size_t start = ctx.position;
     
     if (!ctx.check(TokenKind::Identifier)) {
         return ParseResult<EnumCaseNode>::error(
@@ -484,11 +495,13 @@ ParseResult<EnumCaseNode> DeclarationParser::parse_enum_case() {
         }
     }
     
+    ctx.set_span(case_node, start);
     return ParseResult<EnumCaseNode>::success(case_node);
 }
 
 ParseResult<ParameterNode> DeclarationParser::parse_parameter() {
     auto& ctx = context();
+    size_t start = ctx.position;
     
     // Myre syntax: Type name (not name: Type)
     // First parse the type
@@ -529,11 +542,13 @@ ParseResult<ParameterNode> DeclarationParser::parse_parameter() {
         }
     }
     
+    ctx.set_span(param, start);
     return ParseResult<ParameterNode>::success(param);
 }
 
 ParseResult<ParameterNode> DeclarationParser::parse_enum_parameter() {
     auto& ctx = context();
+    size_t start = ctx.position;
     
     // Parse type first
     auto type_result = parser_->parse_type_expression();
@@ -562,10 +577,21 @@ ParseResult<ParameterNode> DeclarationParser::parse_enum_parameter() {
         param->name = nullptr;
     }
     
+    ctx.set_span(param, start);
     return ParseResult<ParameterNode>::success(param);
 }
 
 // Helper method implementations
+void DeclarationParser::store_modifiers(DeclarationNode* declaration, const std::vector<ModifierKind>& modifiers) {
+    if (modifiers.empty()) return;
+    auto* modifier_array = parser_->get_allocator().alloc_array<ModifierKind>(modifiers.size());
+    for (size_t i = 0; i < modifiers.size(); ++i) {
+        modifier_array[i] = modifiers[i];
+    }
+    declaration->modifiers.values = modifier_array;
+    declaration->modifiers.size = static_cast<int>(modifiers.size());
+}
+
 std::vector<ModifierKind> DeclarationParser::parse_all_modifiers() {
     std::vector<ModifierKind> modifiers;
     auto& ctx = context();
@@ -586,6 +612,18 @@ std::vector<ModifierKind> DeclarationParser::parse_all_modifiers() {
         } else if (ctx.check(TokenKind::Ref)) {
             modifiers.push_back(ModifierKind::Ref);
             ctx.advance();
+        } else if (ctx.check(TokenKind::Extern)) {
+            modifiers.push_back(ModifierKind::Extern);
+            ctx.advance();
+        } else if (ctx.check(TokenKind::Virtual)) {
+            modifiers.push_back(ModifierKind::Virtual);
+            ctx.advance();
+        } else if (ctx.check(TokenKind::Override)) {
+            modifiers.push_back(ModifierKind::Override);
+            ctx.advance();
+        } else if (ctx.check(TokenKind::Abstract)) {
+            modifiers.push_back(ModifierKind::Abstract);
+            ctx.advance();
         } else {
             break;
         }
@@ -821,6 +859,7 @@ ParseResult<AstNode> DeclarationParser::parse_var_field_declaration(const std::v
     }
     
     auto* var_decl = var_result.get_node();
+    store_modifiers(var_decl, modifiers);
     
     // For field declarations, initializer is required for var declarations
     if (!var_decl->initializer) {
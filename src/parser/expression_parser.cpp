@@ -17,6 +17,8 @@ ErrorNode* ExpressionParser::create_error(ErrorKind kind, const char* msg) {
 
 // Main expression parsing entry point
 ParseResult<ExpressionNode> ExpressionParser::parse_expression(int min_precedence) {
+    size_t start = context().position;
+
     // Handle assignment expressions first (right-associative, lowest precedence)
     auto left_result = parse_binary_expression(min_precedence);
     if (!left_result.is_success()) {
@@ -43,6 +45,7 @@ ParseResult<ExpressionNode> ExpressionParser::parse_expression(int min_precedenc
         assign_expr->source = right_result.get_node();
         assign_expr->opKind = assign_token.to_assignment_operator_kind();
         assign_expr->contains_errors = ast_has_errors(left) || ast_has_errors(right_result.get_node());
+        context().set_span(assign_expr, start);
         
         return ParseResult<ExpressionNode>::success(assign_expr);
     }
@@ -52,6 +55,7 @@ ParseResult<ExpressionNode> ExpressionParser::parse_expression(int min_precedenc
 
 // Pratt parser implementation for binary expressions
 ParseResult<ExpressionNode> ExpressionParser::parse_binary_expression(int min_precedence) {
+    size_t start = context().position;
     auto left_result = parse_primary();
     if (!left_result.is_success()) {
         return left_result;
@@ -77,6 +81,7 @@ ParseResult<ExpressionNode> ExpressionParser::parse_binary_expression(int min_pr
             binary->right = error; // Use AstNode* directly for error integration
             binary->opKind = op_token.to_binary_operator_kind();
             binary->contains_errors = true;
+            context().set_span(binary, start);
             return ParseResult<ExpressionNode>::success(binary);
         }
         
@@ -85,6 +90,7 @@ ParseResult<ExpressionNode> ExpressionParser::parse_binary_expression(int min_pr
         binary->right = right_result.get_node();
         binary->opKind = op_token.to_binary_operator_kind();
         binary->contains_errors = ast_has_errors(left) || ast_has_errors(right_result.get_node());
+        context().set_span(binary, start);
         
         left = binary;
     }
@@ -134,6 +140,10 @@ ParseResult<ExpressionNode> ExpressionParser::parse_primary() {
         return parse_new_expression();
     }
     
+    if (ctx.check(TokenKind::Sizeof) || ctx.check(TokenKind::Typeof)) {
+        return parse_type_query_expression();
+    }
+    
     return ParseResult<ExpressionNode>::error(
         create_error(ErrorKind::UnexpectedToken, "Expected expression"));
 }
@@ -146,10 +156,12 @@ ParseResult<ExpressionNode> ExpressionParser::parse_integer_literal() {
     auto* literal = parser_->get_allocator().alloc<LiteralExpressionNode>();
     literal->kind = LiteralKind::Integer;
     literal->contains_errors = false;
+    context().set_token_span(literal, token);
     
     auto* token_node = parser_->get_allocator().alloc<TokenNode>();
     token_node->text = token.text;
     token_node->contains_errors = false;
+    context().set_token_span(token_node, token);
     literal->token = token_node;
     
     return ParseResult<ExpressionNode>::success(literal);
@@ -162,10 +174,12 @@ ParseResult<ExpressionNode> ExpressionParser::parse_string_literal() {
     auto* literal = parser_->get_allocator().alloc<LiteralExpressionNode>();
     literal->kind = LiteralKind::String;
     literal->contains_errors = false;
+    context().set_token_span(literal, token);
     
     auto* token_node = parser_->get_allocator().alloc<TokenNode>();
     token_node->text = token.text;
     token_node->contains_errors = false;
+    context().set_token_span(token_node, token);
     literal->token = token_node;
     
     return ParseResult<ExpressionNode>::success(literal);
@@ -178,10 +192,12 @@ ParseResult<ExpressionNode> ExpressionParser::parse_boolean_literal() {
     auto* literal = parser_->get_allocator().alloc<LiteralExpressionNode>();
     literal->kind = LiteralKind::Boolean;
     literal->contains_errors = false;
+    context().set_token_span(literal, token);
     
     auto* token_node = parser_->get_allocator().alloc<TokenNode>();
     token_node->text = token.text;
     token_node->contains_errors = false;
+    context().set_token_span(token_node, token);
     literal->token = token_node;
     
     return ParseResult<ExpressionNode>::success(literal);
@@ -194,10 +210,12 @@ ParseResult<ExpressionNode> ExpressionParser::parse_float_literal() {
     auto* literal = parser_->get_allocator().alloc<LiteralExpressionNode>();
     literal->kind = LiteralKind::Float;
     literal->contains_errors = false;
+    context().set_token_span(literal, token);
     
     auto* token_node = parser_->get_allocator().alloc<TokenNode>();
     token_node->text = token.text;
     token_node->contains_errors = false;
+    context().set_token_span(token_node, token);
     literal->token = token_node;
     
     return ParseResult<ExpressionNode>::success(literal);
@@ -210,16 +228,19 @@ ParseResult<ExpressionNode> ExpressionParser::parse_double_literal() {
     auto* literal = parser_->get_allocator().alloc<LiteralExpressionNode>();
     literal->kind = LiteralKind::Double;
     literal->contains_errors = false;
+    context().set_token_span(literal, token);
     
     auto* token_node = parser_->get_allocator().alloc<TokenNode>();
     token_node->text = token.text;
     token_node->contains_errors = false;
+    context().set_token_span(token_node, token);
     literal->token = token_node;
     
     return ParseResult<ExpressionNode>::success(literal);
 }
 
 ParseResult<ExpressionNode> ExpressionParser::parse_unary_expression() {
+    size_t start = context().position;
     const Token& op_token = context().current();
     context().advance(); // consume unary operator
     
@@ -234,19 +255,23 @@ ParseResult<ExpressionNode> ExpressionParser::parse_unary_expression() {
     unary_expr->opKind = op_token.to_unary_operator_kind();
     unary_expr->isPostfix = false;
     unary_expr->contains_errors = ast_has_errors(operand_result.get_node());
+    context().set_span(unary_expr, start);
     
     return ParseResult<ExpressionNode>::success(unary_expr);
 }
 
 ParseResult<ExpressionNode> ExpressionParser::parse_identifier_or_call() {
+    size_t start = context().position;
     const Token& token = context().current();
     context().advance();
     
     auto* identifier_expr = parser_->get_allocator().alloc<IdentifierExpressionNode>();
     identifier_expr->contains_errors = false;
+    context().set_token_span(identifier_expr, token);
     auto* identifier = parser_->get_allocator().alloc<IdentifierNode>();
     identifier->name = token.text;
     identifier->contains_errors = false;
+    context().set_token_span(identifier, token);
     identifier_expr->identifier = identifier;
     
     // Start with the identifier, then handle postfix operations
@@ -284,6 +309,9 @@ ParseResult<ExpressionNode> ExpressionParser::parse_identifier_or_call() {
         } else {
             break; // No more postfix operations
         }
+        
+        // Each postfix node spans from the start of the identifier
+        context().set_span(current, start);
     }
     
     return ParseResult<ExpressionNode>::success(current);
@@ -398,6 +426,7 @@ ParseResult<ExpressionNode> ExpressionParser::parse_member_access_suffix(Express
     auto* member_identifier = parser_->get_allocator().alloc<IdentifierNode>();
     member_identifier->name = member_token.text;
     member_identifier->contains_errors = false;
+    context().set_token_span(member_identifier, member_token);
     member_expr->member = member_identifier;
     
     member_expr->contains_errors = ast_has_errors(target);
@@ -426,6 +455,7 @@ ParseResult<ExpressionNode> ExpressionParser::parse_indexer_suffix(ExpressionNod
 
 // Parse new expressions: new TypeName() or new TypeName
 ParseResult<ExpressionNode> ExpressionParser::parse_new_expression() {
+    size_t start = context().position;
     const Token& new_token = context().current();
     context().advance(); // consume 'new'
     
@@ -444,6 +474,7 @@ ParseResult<ExpressionNode> ExpressionParser::parse_new_expression() {
     new_keyword->text = new_token.text;
     new_keyword->tokenKind = new_token.kind;
     new_keyword->contains_errors = false;
+    context().set_token_span(new_keyword, new_token);
     new_expr->newKeyword = new_keyword;
     
     new_expr->type = type_result.get_node();
@@ -452,9 +483,11 @@ ParseResult<ExpressionNode> ExpressionParser::parse_new_expression() {
     if (context().check(TokenKind::LeftParen)) {
         // Parse constructor call as a call expression with the type as target
         // For now, we'll create a simple call expression
+        size_t call_start = context().position;
         auto call_result = parse_call_suffix(nullptr); // We'll fix the target afterwards
         if (call_result.is_success()) {
             auto* call_expr = static_cast<CallExpressionNode*>(call_result.get_node());
+            context().set_span(call_expr, call_start);
             call_expr->target = nullptr; // Constructor calls don't have a target expression
             new_expr->constructorCall = call_expr;
             if (ast_has_errors(call_expr)) {
@@ -470,9 +503,50 @@ ParseResult<ExpressionNode> ExpressionParser::parse_new_expression() {
         new_expr->constructorCall = nullptr;
     }
     
+    context().set_span(new_expr, start);
     return ParseResult<ExpressionNode>::success(new_expr);
 }
 
+// Parse type queries: sizeof(TypeName) or typeof(TypeName)
+ParseResult<ExpressionNode> ExpressionParser::parse_type_query_expression() {
+    size_t start = context().position;
+    const Token& keyword_token = context().current();
+    bool is_sizeof = keyword_token.kind == TokenKind::Sizeof;
+    context().advance(); // consume 'sizeof' or 'typeof'
+    
+    auto* keyword = parser_->get_allocator().alloc<TokenNode>();
+    keyword->text = keyword_token.text;
+    keyword->tokenKind = keyword_token.kind;
+    keyword->contains_errors = false;
+    context().set_token_span(keyword, keyword_token);
+    
+    bool has_errors = !parser_->expect(TokenKind::LeftParen, is_sizeof ? "Expected '(' after 'sizeof'" : "Expected '(' after 'typeof'");
+    
+    auto type_result = parser_->parse_type_expression();
+    if (!type_result.is_success()) {
+        auto* error = create_error(ErrorKind::MissingToken, is_sizeof ? "Expected type name in 'sizeof'" : "Expected type name in 'typeof'");
+        return ParseResult<ExpressionNode>::error(error);
+    }
+    has_errors = !parser_->expect(TokenKind::RightParen, "Expected ')' after type name") || has_errors;
+    has_errors = has_errors || ast_has_errors(type_result.get_node());
+    
+    ExpressionNode* query = nullptr;
+    if (is_sizeof) {
+        auto* size_of = parser_->get_allocator().alloc<SizeOfExpressionNode>();
+        size_of->sizeOfKeyword = keyword;
+        size_of->type = type_result.get_node();
+        query = size_of;
+    } else {
+        auto* type_of = parser_->get_allocator().alloc<TypeOfExpressionNode>();
+        type_of->typeOfKeyword = keyword;
+        type_of->type = type_result.get_node();
+        query = type_of;
+    }
+    query->contains_errors = has_errors;
+    context().set_span(query, start);
+    return ParseResult<ExpressionNode>::success(query);
+}
+
 ParseResult<ExpressionNode> ExpressionParser::parse_match_expression() {
     return ParseResult<ExpressionNode>::error(
         create_error(ErrorKind::UnexpectedToken, "Match expressions not implemented yet"));
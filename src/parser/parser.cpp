@@ -3,9 +3,55 @@
 #include "parser/statement_parser.h"
 #include "parser/declaration_parser.h"
 #include "ast/ast_allocator.hpp"
+#include "ast/ast_walker.hpp"
+#include "ast/ast_hash.hpp"
+#include <algorithm>
+#include <climits>
 
 namespace Mycelium::Scripting::Lang {
 
+// Nodes the parser does not stamp directly (names, keyword tokens, for-loop
+// clauses, ...) take their span from the source text they reference, or else
+// from the union of their children. Children are filled in first.
+static void fill_missing_spans(AstNode* node, std::string_view source) {
+    int start = INT_MAX;
+    int end = INT_MIN;
+    auto include = [&](int from, int length) {
+        if (length <= 0) return;
+        start = std::min(start, from);
+        end = std::max(end, from + length);
+    };
+
+    ast_dispatch(node, [&](auto* typed) {
+        auto visit_child = [&](AstNode* child) {
+            if (!child) return;
+            fill_missing_spans(child, source);
+            include(child->sourceStart, child->sourceLength);
+        };
+        ast_visit_fields(typed, [&](auto& field) {
+            if constexpr (std::is_convertible_v<decltype(field), AstNode*>) {
+                visit_child(field);
+            } else {
+                for (int i = 0; i < field.size; ++i) visit_child(field.values[i]);
+            }
+        });
+
+        if (node->sourceLength > 0) return;
+        ast_visit_data_fields(typed, [&](auto& field) {
+            if constexpr (std::is_same_v<std::decay_t<decltype(field)>, std::string_view>) {
+                if (!field.empty() && field.data() >= source.data() &&
+                    field.data() + field.size() <= source.data() + source.size()) {
+                    include(static_cast<int>(field.data() - source.data()), static_cast<int>(field.size()));
+                }
+            }
+        });
+        if (start < end) {
+            node->sourceStart = start;
+            node->sourceLength = end - start;
+        }
+    });
+}
+
 Parser::Parser(TokenStream& tokens) 
     : context_(tokens), 
       expr_parser_(std::make_unique<ExpressionParser>(this)),
@@ -21,9 +67,11 @@ ParseResult<CompilationUnitNode> Parser::parse() {
     std::vector<AstNode*> statements;  // Changed to AstNode* for error integration
     
     while (!context_.at_end()) {
+        size_t start = context_.position;
         auto stmt_result = parse_top_level_construct();
         
         if (stmt_result.is_success()) {
+            context_.set_span(stmt_result.get_node(), start);
             statements.push_back(stmt_result.get_node());
         } else if (stmt_result.is_error()) {
             // Add error node and continue
@@ -66,6 +114,18 @@ ParseResult<CompilationUnitNode> Parser::parse() {
         unit->contains_errors = false;
     }
     
+    // The unit covers the whole source; recover the buffer from the token views
+    TokenStream& tokens = context_.tokens();
+    if (tokens.size() > 0 && !tokens[0].text.empty()) {
+        const Token& last = tokens[tokens.size() - 1];
+        std::string_view source(tokens[0].text.data() - tokens[0].location.offset, last.location.offset + last.width);
+        unit->sourceStart = 0;
+        unit->sourceLength = static_cast<int>(source.size());
+        fill_missing_spans(unit, source);
+    }
+    
+    ast_compute_structural_hashes(unit);
+    
     return ParseResult<CompilationUnitNode>::success(unit);
 }
 
@@ -82,7 +142,8 @@ ParseResult<StatementNode> Parser::parse_top_level_construct() {
         ctx.check(TokenKind::Private) ||
         ctx.check(TokenKind::Protected) ||
         ctx.check(TokenKind::Static) ||
-        ctx.check(TokenKind::Ref)) {
+        ctx.check(TokenKind::Ref) ||
+        ctx.check(TokenKind::Extern)) {
         
         // Handle using directive specially since it's a StatementNode
         if (ctx.check(TokenKind::Using)) {
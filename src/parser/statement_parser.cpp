@@ -21,6 +21,13 @@ ErrorNode* StatementParser::create_error(ErrorKind kind, const char* msg) {
 
 // Main statement parsing entry point
 ParseResult<StatementNode> StatementParser::parse_statement() {
+    size_t start = context().position;
+    auto result = parse_any_statement();
+    context().set_span(result.get_node(), start);
+    return result;
+}
+
+ParseResult<StatementNode> StatementParser::parse_any_statement() {
     auto& ctx = context();
     
     // Handle variable declarations as statements
@@ -138,6 +145,7 @@ ParseResult<StatementNode> StatementParser::parse_expression_statement() {
 // Block statement parsing
 ParseResult<StatementNode> StatementParser::parse_block_statement() {
     auto& ctx = context();
+    size_t start = ctx.position;
     
     if (!parser_->match(TokenKind::LeftBrace)) {
         return ParseResult<StatementNode>::error(
@@ -183,6 +191,7 @@ ParseResult<StatementNode> StatementParser::parse_block_statement() {
         block->contains_errors = false;
     }
     
+    ctx.set_span(block, start);
     return ParseResult<StatementNode>::success(block);
 }
 
@@ -0,0 +1,199 @@
+#include "semantic/call_graph.hpp"
+#include "ast/ast_walker.hpp"
+#include <algorithm>
+
+namespace Mycelium::Scripting::Lang {
+
+static bool is_entry_point(SymbolTable& table, FunctionDeclarationNode* node, Symbol* symbol) {
+    if (symbol->name == "main" && table.get_scope_kind(symbol->scope_level) == ScopeKind::GLOBAL) return true;
+    for (int i = 0; i < node->modifiers.size; ++i) {
+        switch (node->modifiers.values[i]) {
+            case ModifierKind::Public:
+            case ModifierKind::Extern:
+            case ModifierKind::Virtual:
+            case ModifierKind::Override:
+            case ModifierKind::Abstract:
+                return true;
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
+// Declares a node per function, then records the call targets of each body
+class CallGraphBuilder : public AstWalker<CallGraphBuilder> {
+public:
+    using AstWalker<CallGraphBuilder>::visit;
+    SymbolTable& table;
+    std::vector<CallGraph::Function>& functions;
+    std::unordered_map<SymbolId, uint32_t>& indices;
+    bool declaring = true;
+    uint32_t current = CallGraph::NO_FUNCTION;
+
+    CallGraphBuilder(SymbolTable& symbol_table, std::vector<CallGraph::Function>& graph_functions,
+                     std::unordered_map<SymbolId, uint32_t>& graph_indices)
+        : table(symbol_table), functions(graph_functions), indices(graph_indices) {}
+
+    void visit(FunctionDeclarationNode* node) {
+        SymbolId symbol = table.get_binding(node->name);
+        if (declaring) {
+            if (symbol != INVALID_SYMBOL_ID && indices.emplace(symbol, (uint32_t)functions.size()).second) {
+                CallGraph::Function function;
+                function.symbol = symbol;
+                function.declaration = node;
+                function.entry = is_entry_point(table, node, table.get_symbol(symbol));
+                functions.push_back(std::move(function));
+            }
+            return;
+        }
+        auto found = indices.find(symbol);
+        uint32_t outer = current;
+        current = found != indices.end() ? found->second : CallGraph::NO_FUNCTION;
+        walk_children(node);
+        current = outer;
+    }
+
+    void visit(CallExpressionNode* node) {
+        // A folded call is emitted as its value, so neither it nor its arguments call anything
+        if (table.get_constant(node).is_constant()) return;
+        if (!declaring) {
+            auto found = indices.find(table.get_binding(node->target));
+            if (current == CallGraph::NO_FUNCTION) {
+                if (found != indices.end()) functions[found->second].entry = true;
+            } else if (found != indices.end()) {
+                functions[current].callees.push_back(found->second);
+            } else {
+                functions[current].calls_unknown = true;
+            }
+        }
+        walk_children(node);
+    }
+};
+
+CallGraph::CallGraph(SymbolTable& table, CompilationUnitNode* ast) {
+    CallGraphBuilder builder(table, functions, indices);
+    builder.walk(ast);
+    builder.declaring = false;
+    builder.walk(ast);
+
+    for (Function& function : functions) {
+        std::sort(function.callees.begin(), function.callees.end());
+        function.callees.erase(std::unique(function.callees.begin(), function.callees.end()), function.callees.end());
+    }
+    find_components();
+}
+
+uint32_t CallGraph::index_of(SymbolId symbol) const {
+    auto found = indices.find(symbol);
+    return found != indices.end() ? found->second : NO_FUNCTION;
+}
+
+std::vector<bool> CallGraph::reachable() const {
+    std::vector<bool> reached(functions.size(), false);
+    std::vector<uint32_t> pending;
+    for (uint32_t index = 0; index < functions.size(); ++index) {
+        if (functions[index].entry) {
+            reached[index] = true;
+            pending.push_back(index);
+        }
+    }
+    while (!pending.empty()) {
+        uint32_t index = pending.back();
+        pending.pop_back();
+        for (uint32_t callee : functions[index].callees) {
+            if (reached[callee]) continue;
+            reached[callee] = true;
+            pending.push_back(callee);
+        }
+    }
+    return reached;
+}
+
+// Tarjan's algorithm with an explicit stack, so long call chains cannot
+// overflow the native one. It completes a component only after every
+// component reachable from it, which is the order components() promises.
+void CallGraph::find_components() {
+    const uint32_t unvisited = NO_FUNCTION;
+    std::vector<uint32_t> order(functions.size(), unvisited);  // Discovery index
+    std::vector<uint32_t> low(functions.size(), 0);
+    std::vector<bool> on_stack(functions.size(), false);
+    std::vector<uint32_t> stack;
+    std::vector<std::pair<uint32_t, size_t>> frames;  // Function and the next callee to look at
+    uint32_t next_order = 0;
+
+    for (uint32_t root = 0; root < functions.size(); ++root) {
+        if (order[root] != unvisited) continue;
+        frames.emplace_back(root, 0);
+        order[root] = low[root] = next_order++;
+        stack.push_back(root);
+        on_stack[root] = true;
+
+        while (!frames.empty()) {
+            auto& [index, next] = frames.back();
+            const std::vector<uint32_t>& callees = functions[index].callees;
+            if (next < callees.size()) {
+                uint32_t callee = callees[next++];
+                if (callee == index) functions[index].recursive = true;
+                if (order[callee] == unvisited) {
+                    order[callee] = low[callee] = next_order++;
+                    stack.push_back(callee);
+                    on_stack[callee] = true;
+                    frames.emplace_back(callee, 0);
+                } else if (on_stack[callee]) {
+                    low[index] = std::min(low[index], order[callee]);
+                }
+                continue;
+            }
+
+            uint32_t finished = index;
+            frames.pop_back();
+            if (!frames.empty()) low[frames.back().first] = std::min(low[frames.back().first], low[finished]);
+            if (low[finished] != order[finished]) continue;
+
+            std::vector<uint32_t> component;
+            uint32_t member;
+            do {
+                member = stack.back();
+                stack.pop_back();
+                on_stack[member] = false;
+                component.push_back(member);
+            } while (member != finished);
+            std::sort(component.begin(), component.end());
+            if (component.size() > 1) {
+                for (uint32_t recursive : component) functions[recursive].recursive = true;
+            }
+            sccs.push_back(std::move(component));
+        }
+    }
+}
+
+DeadFunctionReport eliminate_dead_functions(SymbolTable& table, const CallGraph& graph) {
+    DeadFunctionReport report;
+    std::vector<bool> reached = graph.reachable();
+    if (std::find(reached.begin(), reached.end(), true) == reached.end()) {
+        report.kept = graph.size();
+        return report;
+    }
+
+    for (uint32_t index = 0; index < graph.size(); ++index) {
+        if (reached[index]) {
+            report.kept++;
+            continue;
+        }
+        Symbol* symbol = table.get_symbol(graph.function(index).symbol);
+        table.mark_dead_function(symbol->id);
+        std::string name(symbol->name);
+        if (table.get_scope_kind(symbol->scope_level) == ScopeKind::TYPE) {
+            name = table.get_scope_name(symbol->scope_level) + "::" + name;
+        }
+        report.removed.push_back(std::move(name));
+    }
+    return report;
+}
+
+DeadFunctionReport eliminate_dead_functions(SymbolTable& table, CompilationUnitNode* ast) {
+    return eliminate_dead_functions(table, CallGraph(table, ast));
+}
+
+} // namespace Mycelium::Scripting::Lang
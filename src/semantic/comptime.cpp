@@ -0,0 +1,561 @@
+#include "semantic/comptime.hpp"
+#include "ast/ast_rtti.hpp"
+#include "ast/ast_walker.hpp"
+#include "codegen/type_context.hpp"
+#include <charconv>
+#include <climits>
+
+namespace Mycelium::Scripting::Lang {
+
+static bool has_modifier(const DeclarationNode* node, ModifierKind modifier) {
+    for (int i = 0; i < node->modifiers.size; ++i) {
+        if (node->modifiers.values[i] == modifier) return true;
+    }
+    return false;
+}
+
+static ComptimeValue int_value(int64_t value) {
+    ComptimeValue result;
+    result.kind = ComptimeValue::Kind::Int;
+    result.int_value = static_cast<int32_t>(static_cast<uint32_t>(value));  // Wraps like i32 arithmetic
+    return result;
+}
+
+static ComptimeValue bool_value(bool value) {
+    ComptimeValue result;
+    result.kind = ComptimeValue::Kind::Bool;
+    result.int_value = value ? 1 : 0;
+    return result;
+}
+
+// Value kind a declared i32 or bool holds; None for types the evaluator does not model
+static ComptimeValue::Kind kind_of(IRType type) {
+    if (type.kind == IRType::I32) return ComptimeValue::Kind::Int;
+    if (type.kind == IRType::Bool) return ComptimeValue::Kind::Bool;
+    return ComptimeValue::Kind::None;
+}
+
+// Finds the functions that can be called, the static fields that are never
+// assigned and so keep their initializer, and everything that is assigned
+class ComptimeCollector : public AstWalker<ComptimeCollector> {
+public:
+    using AstWalker<ComptimeCollector>::visit;
+    SymbolTable& table;
+    std::unordered_map<SymbolId, FunctionDeclarationNode*> functions;
+    std::unordered_map<SymbolId, ExpressionNode*> static_initializers;
+    std::unordered_set<SymbolId> assigned;
+
+    explicit ComptimeCollector(SymbolTable& symbol_table) : table(symbol_table) {}
+
+    void visit(FunctionDeclarationNode* node) {
+        Symbol* symbol = table.get_bound_symbol(node->name);
+        if (symbol && node->body && table.get_scope_kind(symbol->scope_level) != ScopeKind::TYPE) {
+            functions[symbol->id] = node;
+        }
+        walk_children(node);
+    }
+
+    void visit(VariableDeclarationNode* node) {
+        if (node->initializer && has_modifier(node, ModifierKind::Static)) {
+            for (int i = 0; i < node->names.size; ++i) {
+                Symbol* symbol = table.get_bound_symbol(node->names.values[i]);
+                if (symbol && table.get_scope_kind(symbol->scope_level) == ScopeKind::TYPE) {
+                    static_initializers[symbol->id] = node->initializer;
+                }
+            }
+        }
+        walk_children(node);
+    }
+
+    void visit(AssignmentExpressionNode* node) {
+        assigned.insert(table.get_binding(node->target));
+        walk_children(node);
+    }
+
+    void visit(UnaryExpressionNode* node) {
+        switch (node->opKind) {
+            case UnaryOperatorKind::PreIncrement:
+            case UnaryOperatorKind::PreDecrement:
+            case UnaryOperatorKind::PostIncrement:
+            case UnaryOperatorKind::PostDecrement:
+                assigned.insert(table.get_binding(node->operand));
+                break;
+            default:
+                break;
+        }
+        walk_children(node);
+    }
+};
+
+ComptimeEvaluator::ComptimeEvaluator(SymbolTable& table, CompilationUnitNode* ast, uint64_t step_budget)
+    : table(table), step_budget(step_budget) {
+    ComptimeCollector collector(table);
+    collector.walk(ast);
+    functions = std::move(collector.functions);
+    for (auto& [symbol, initializer] : collector.static_initializers) {
+        if (!collector.assigned.count(symbol)) static_initializers[symbol] = initializer;
+    }
+}
+
+ComptimeResult ComptimeEvaluator::evaluate(ExpressionNode* expr) {
+    locals.clear();
+    frame_base = 0;
+    depth = 0;
+    steps = 0;
+    initializing.clear();
+    failure = ComptimeResult();
+
+    ComptimeResult result;
+    if (eval(expr, result.value)) {
+        outcomes[expr] = Constant;
+        values[expr] = result.value;
+    } else {
+        result = std::move(failure);
+        outcomes[expr] = result.status == ComptimeStatus::NotConstant ? NotConstant : Failed;
+    }
+    result.steps = steps;
+    return result;
+}
+
+bool ComptimeEvaluator::fail(ComptimeStatus status, AstNode* node, std::string message) {
+    failure.status = status;
+    failure.node = node;
+    failure.message = std::move(message);
+    return false;
+}
+
+bool ComptimeEvaluator::step(AstNode* node) {
+    if (++steps <= step_budget) return true;
+    return fail(ComptimeStatus::BudgetExhausted, node, "evaluation ran past its budget of " + std::to_string(step_budget) + " steps");
+}
+
+bool ComptimeEvaluator::eval(ExpressionNode* expr, ComptimeValue& out) {
+    if (!expr) return fail(ComptimeStatus::NotConstant, nullptr, "missing expression");
+
+    // A constant is the same in any frame, and so is an error found outside one.
+    // Not being constant outside a call says nothing about inside one.
+    switch (outcomes.get(expr)) {
+        case Constant: out = values.get(expr); return true;
+        case Failed: return fail(ComptimeStatus::NotConstant, expr, "depends on an evaluation that failed");
+        case NotConstant:
+            if (depth == 0) return fail(ComptimeStatus::NotConstant, expr, "depends on run-time values");
+            break;
+        default: break;
+    }
+    if (!step(expr)) return false;
+
+    if (auto* literal = expr->as<LiteralExpressionNode>()) {
+        std::string_view text = literal->token ? literal->token->text : std::string_view();
+        if (literal->kind == LiteralKind::Boolean) {
+            out = bool_value(text == "true");
+            return true;
+        }
+        if (literal->kind != LiteralKind::Integer) return fail(ComptimeStatus::NotConstant, expr, "only i32 and bool literals are evaluated");
+        int64_t value = 0;
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc() || value > INT32_MAX) {
+            return fail(ComptimeStatus::Overflow, expr, "integer literal " + std::string(text) + " does not fit in i32");
+        }
+        out = int_value(value);
+        return true;
+    }
+    if (auto* binary = expr->as<BinaryExpressionNode>()) return eval_binary(binary, out);
+    if (auto* unary = expr->as<UnaryExpressionNode>()) return eval_unary(unary, out);
+    if (auto* assignment = expr->as<AssignmentExpressionNode>()) return eval_assignment(assignment, out);
+    if (auto* call = expr->as<CallExpressionNode>()) return eval_call(call, out);
+    if (auto* parenthesized = expr->as<ParenthesizedExpressionNode>()) return eval(parenthesized->expression, out);
+    if (expr->is_a<IdentifierExpressionNode>()) return eval_symbol(table.get_bound_symbol(expr), expr, out);
+    if (auto* member_access = expr->as<MemberAccessExpressionNode>()) {
+        // Only Enum.Case and Type.staticField; members of values need the value
+        Symbol* target = table.get_bound_symbol(member_access->target);
+        if (!target || (target->type != SymbolType::CLASS && target->type != SymbolType::ENUM)) {
+            return fail(ComptimeStatus::NotConstant, expr, "reads a member of a run-time value");
+        }
+        return eval_symbol(table.get_bound_symbol(expr), expr, out);
+    }
+    if (auto* conditional = expr->as<ConditionalExpressionNode>()) {
+        bool condition = false;
+        if (!eval_condition(conditional->condition, condition)) return false;
+        return eval(condition ? conditional->whenTrue : conditional->whenFalse, out);
+    }
+    if (auto* size_of = expr->as<SizeOfExpressionNode>()) return eval_type_query(expr, size_of->type, true, out);
+    if (auto* type_of = expr->as<TypeOfExpressionNode>()) return eval_type_query(expr, type_of->type, false, out);
+
+    return fail(ComptimeStatus::NotConstant, expr, std::string(get_node_type_name(expr)) + " is not evaluated at compile time");
+}
+
+bool ComptimeEvaluator::eval_binary(BinaryExpressionNode* node, ComptimeValue& out) {
+    auto* left_expr = ast_cast_or_error<ExpressionNode>(node->left);
+    auto* right_expr = ast_cast_or_error<ExpressionNode>(node->right);
+    ComptimeValue left, right;
+    if (!eval(left_expr, left) || !eval(right_expr, right)) return false;
+
+    using Kind = ComptimeValue::Kind;
+    if (left.kind != right.kind) return fail(ComptimeStatus::NotConstant, node, "operands have different types");
+    int64_t a = left.int_value, b = right.int_value;
+
+    switch (node->opKind) {
+        case BinaryOperatorKind::Equals:
+        case BinaryOperatorKind::NotEquals: {
+            bool equal = left.kind == Kind::Type ? left.type_name == right.type_name : a == b;
+            out = bool_value(equal == (node->opKind == BinaryOperatorKind::Equals));
+            return true;
+        }
+        case BinaryOperatorKind::LogicalAnd:
+        case BinaryOperatorKind::LogicalOr:
+            if (left.kind != Kind::Bool) return fail(ComptimeStatus::NotConstant, node, "logical operators take bool operands");
+            out = bool_value(node->opKind == BinaryOperatorKind::LogicalAnd ? (a && b) : (a || b));
+            return true;
+        default:
+            break;
+    }
+
+    if (left.kind != Kind::Int) return fail(ComptimeStatus::NotConstant, node, "arithmetic takes i32 operands");
+    switch (node->opKind) {
+        case BinaryOperatorKind::Add: out = int_value(a + b); return true;
+        case BinaryOperatorKind::Subtract: out = int_value(a - b); return true;
+        case BinaryOperatorKind::Multiply: out = int_value(a * b); return true;
+        case BinaryOperatorKind::Divide:
+            if (b == 0) return fail(ComptimeStatus::DivisionByZero, node, "division by zero");
+            if (a == INT32_MIN && b == -1) return fail(ComptimeStatus::Overflow, node, "i32 division overflows");
+            out = int_value(a / b);
+            return true;
+        case BinaryOperatorKind::LessThan: out = bool_value(a < b); return true;
+        case BinaryOperatorKind::LessThanOrEqual: out = bool_value(a <= b); return true;
+        case BinaryOperatorKind::GreaterThan: out = bool_value(a > b); return true;
+        case BinaryOperatorKind::GreaterThanOrEqual: out = bool_value(a >= b); return true;
+        default:
+            // Operators codegen cannot emit stay unevaluated too, so folding never changes what compiles
+            return fail(ComptimeStatus::NotConstant, node, "operator is not supported");
+    }
+}
+
+bool ComptimeEvaluator::eval_unary(UnaryExpressionNode* node, ComptimeValue& out) {
+    using Kind = ComptimeValue::Kind;
+    switch (node->opKind) {
+        case UnaryOperatorKind::PreIncrement:
+        case UnaryOperatorKind::PreDecrement:
+        case UnaryOperatorKind::PostIncrement:
+        case UnaryOperatorKind::PostDecrement: {
+            ComptimeValue* local = find_local(table.get_binding(node->operand));
+            if (!local || local->kind != Kind::Int) return fail(ComptimeStatus::NotConstant, node, "increments a run-time value");
+            bool increment = node->opKind == UnaryOperatorKind::PreIncrement || node->opKind == UnaryOperatorKind::PostIncrement;
+            ComptimeValue old_value = *local;
+            *local = int_value(int64_t(local->int_value) + (increment ? 1 : -1));
+            out = node->isPostfix ? old_value : *local;
+            return step(node);
+        }
+        default:
+            break;
+    }
+
+    // -2147483648 is how INT32_MIN is written, though its literal alone does not fit
+    if (node->opKind == UnaryOperatorKind::Minus) {
+        auto* literal = node->operand ? node->operand->as<LiteralExpressionNode>() : nullptr;
+        if (literal && literal->kind == LiteralKind::Integer && literal->token && literal->token->text == "2147483648") {
+            out = int_value(INT32_MIN);
+            return true;
+        }
+    }
+
+    ComptimeValue operand;
+    if (!eval(node->operand, operand)) return false;
+    switch (node->opKind) {
+        case UnaryOperatorKind::Plus:
+        case UnaryOperatorKind::Minus:
+            if (operand.kind != Kind::Int) return fail(ComptimeStatus::NotConstant, node, "sign operators take an i32");
+            out = node->opKind == UnaryOperatorKind::Minus ? int_value(0 - int64_t(operand.int_value)) : operand;
+            return true;
+        case UnaryOperatorKind::Not:
+            if (operand.kind != Kind::Bool) return fail(ComptimeStatus::NotConstant, node, "'!' takes a bool");
+            out = bool_value(!operand.int_value);
+            return true;
+        default:
+            return fail(ComptimeStatus::NotConstant, node, "operator is not supported");
+    }
+}
+
+bool ComptimeEvaluator::eval_assignment(AssignmentExpressionNode* node, ComptimeValue& out) {
+    ComptimeValue* local = find_local(table.get_binding(node->target));
+    if (!local) return fail(ComptimeStatus::NotConstant, node, "assigns to something other than a local");
+    ComptimeValue value;
+    if (!eval(node->source, value)) return false;
+    local = find_local(table.get_binding(node->target));  // The source may have declared locals and moved the frame
+
+    if (node->opKind != AssignmentOperatorKind::Assign) {
+        if (local->kind != ComptimeValue::Kind::Int || value.kind != ComptimeValue::Kind::Int) {
+            return fail(ComptimeStatus::NotConstant, node, "compound assignment takes i32 operands");
+        }
+        int64_t a = local->int_value, b = value.int_value;
+        switch (node->opKind) {
+            case AssignmentOperatorKind::Add: value = int_value(a + b); break;
+            case AssignmentOperatorKind::Subtract: value = int_value(a - b); break;
+            case AssignmentOperatorKind::Multiply: value = int_value(a * b); break;
+            case AssignmentOperatorKind::Divide:
+                if (b == 0) return fail(ComptimeStatus::DivisionByZero, node, "division by zero");
+                if (a == INT32_MIN && b == -1) return fail(ComptimeStatus::Overflow, node, "i32 division overflows");
+                value = int_value(a / b);
+                break;
+            default:
+                return fail(ComptimeStatus::NotConstant, node, "operator is not supported");
+        }
+    }
+    *local = value;
+    out = value;
+    return true;
+}
+
+bool ComptimeEvaluator::eval_call(CallExpressionNode* node, ComptimeValue& out) {
+    Symbol* callee = node->target && node->target->is_a<IdentifierExpressionNode>() ? table.get_bound_symbol(node->target) : nullptr;
+    auto it = callee ? functions.find(callee->id) : functions.end();
+    if (it == functions.end()) return fail(ComptimeStatus::NotConstant, node, "calls something other than a function with a body");
+    FunctionDeclarationNode* function = it->second;
+    std::string_view callee_name = callee->name;
+
+    if (node->arguments.size != function->parameters.size) {
+        return fail(ComptimeStatus::NotConstant, node, "call to '" + std::string(callee_name) + "' does not pass every parameter");
+    }
+    ComptimeValue::Kind return_kind = kind_of(callee->data_type);
+    if (return_kind == ComptimeValue::Kind::None) {
+        return fail(ComptimeStatus::NotConstant, node, "'" + std::string(callee_name) + "' does not return an i32 or bool");
+    }
+
+    // Arguments are evaluated in the caller's frame, then bound in the callee's
+    std::vector<std::pair<SymbolId, ComptimeValue>> arguments;
+    for (int i = 0; i < node->arguments.size; ++i) {
+        auto* argument = ast_cast_or_error<ExpressionNode>(node->arguments.values[i]);
+        auto* parameter = ast_cast_or_error<ParameterNode>(function->parameters.values[i]);
+        Symbol* parameter_symbol = parameter ? table.get_bound_symbol(parameter->name) : nullptr;
+        ComptimeValue value;
+        if (!eval(argument, value)) return false;
+        if (!parameter_symbol || kind_of(parameter_symbol->data_type) != value.kind) {
+            return fail(ComptimeStatus::NotConstant, node, "call to '" + std::string(callee_name) + "' passes a value its parameter cannot hold");
+        }
+        arguments.emplace_back(parameter_symbol->id, value);
+    }
+    if (depth >= MAX_CALL_DEPTH) {
+        return fail(ComptimeStatus::CallTooDeep, node, "calls nest deeper than " + std::to_string(MAX_CALL_DEPTH));
+    }
+
+    size_t caller_base = frame_base;
+    frame_base = locals.size();
+    depth++;
+    for (auto& [symbol, value] : arguments) locals.emplace_back(symbol, value);
+    Flow flow = exec(function->body);
+    depth--;
+    locals.resize(frame_base);
+    frame_base = caller_base;
+
+    if (flow == Flow::Stop) {
+        // Errors keep the chain of calls that led to them
+        if (failure.status != ComptimeStatus::NotConstant) failure.message = "in call to '" + std::string(callee_name) + "': " + failure.message;
+        return false;
+    }
+    if (flow != Flow::Return || return_value.kind != return_kind) {
+        return fail(ComptimeStatus::NotConstant, node, "'" + std::string(callee_name) + "' does not return a value on this path");
+    }
+    out = return_value;
+    return true;
+}
+
+bool ComptimeEvaluator::eval_symbol(Symbol* symbol, AstNode* use, ComptimeValue& out) {
+    if (!symbol) return fail(ComptimeStatus::NotConstant, use, "name is not bound");
+
+    if (ComptimeValue* local = find_local(symbol->id)) {
+        if (local->kind == ComptimeValue::Kind::None) return fail(ComptimeStatus::NotConstant, use, "reads '" + std::string(symbol->name) + "' before it is assigned");
+        out = *local;
+        return true;
+    }
+
+    int enum_bits = table.get_enum_bits(symbol->scope_level);
+    if (enum_bits != -1 && symbol->type == SymbolType::VARIABLE) {
+        if (enum_bits == 0) return fail(ComptimeStatus::NotConstant, use, "cases of enums with payloads are not integers");
+        auto it = enum_values.find(symbol->id);
+        if (it == enum_values.end()) {
+            int32_t index = 0;
+            for (Symbol* member : table.get_all_symbols_in_scope(symbol->scope_level)) {
+                if (member->type == SymbolType::VARIABLE) enum_values[member->id] = index++;
+            }
+            it = enum_values.find(symbol->id);
+        }
+        out = int_value(it->second);
+        return true;
+    }
+
+    auto initializer = static_initializers.find(symbol->id);
+    if (initializer != static_initializers.end() && kind_of(symbol->data_type) != ComptimeValue::Kind::None) {
+        if (!initializing.insert(symbol->id).second) {
+            return fail(ComptimeStatus::NotConstant, use, "static field '" + std::string(symbol->name) + "' depends on itself");
+        }
+        // Initializers run outside any frame
+        size_t saved_base = frame_base;
+        int saved_depth = depth;
+        frame_base = locals.size();
+        depth = 0;
+        bool evaluated = eval(initializer->second, out);
+        frame_base = saved_base;
+        depth = saved_depth;
+        initializing.erase(symbol->id);
+        if (evaluated && out.kind != kind_of(symbol->data_type)) {
+            return fail(ComptimeStatus::NotConstant, use, "static field '" + std::string(symbol->name) + "' holds another type");
+        }
+        return evaluated;
+    }
+
+    return fail(ComptimeStatus::NotConstant, use, "'" + std::string(symbol->name) + "' is only known at run time");
+}
+
+bool ComptimeEvaluator::eval_type_query(ExpressionNode* node, TypeNameNode* type, bool size, ComptimeValue& out) {
+    if (!type || type->typeId != TypeNameNode::sTypeId || !type->identifier) {
+        return fail(ComptimeStatus::UnknownType, node, "takes a plain type name");
+    }
+    std::string_view name = type->identifier->name;
+    const char* query = size ? "sizeof" : "typeof";
+
+    if (auto builtin = TypeContext::global().builtin(name)) {
+        if (size && builtin->size_in_bytes() == 0) return fail(ComptimeStatus::UnknownType, node, "sizeof(" + std::string(name) + ") has no size");
+        out = size ? int_value(builtin->size_in_bytes()) : ComptimeValue{ComptimeValue::Kind::Type, 0, table.name_of(table.intern_name(name))};
+        return true;
+    }
+
+    int scope_id = table.find_type_scope(name);
+    if (scope_id == -1) {
+        return fail(ComptimeStatus::UnknownType, node, std::string(query) + "(" + std::string(name) + "): '" + std::string(name) + "' is not a type");
+    }
+    if (!size) {
+        out = ComptimeValue{ComptimeValue::Kind::Type, 0, table.name_of(table.intern_name(name))};
+    } else if (table.get_enum_bits(scope_id) != -1) {
+        out = int_value(IRType::i32().size_in_bytes());
+    } else {
+        // Under the table's field order and packing, as codegen lays it out
+        out = int_value(table.struct_type_of_scope(scope_id).size_in_bytes());
+    }
+    return true;
+}
+
+bool ComptimeEvaluator::eval_condition(ExpressionNode* condition, bool& out) {
+    ComptimeValue value;
+    if (!eval(condition, value)) return false;
+    if (value.kind != ComptimeValue::Kind::Bool) return fail(ComptimeStatus::NotConstant, condition, "condition is not a bool");
+    out = value.int_value != 0;
+    return true;
+}
+
+ComptimeEvaluator::Flow ComptimeEvaluator::exec(AstNode* statement) {
+    if (!statement) return Flow::Next;
+    if (!step(statement)) return Flow::Stop;
+
+    if (auto* block = statement->as<BlockStatementNode>()) {
+        for (int i = 0; i < block->statements.size; ++i) {
+            Flow flow = exec(block->statements.values[i]);
+            if (flow != Flow::Next) return flow;
+        }
+        return Flow::Next;
+    }
+    if (auto* expression_statement = statement->as<ExpressionStatementNode>()) {
+        ComptimeValue ignored;
+        return eval(ast_cast_or_error<ExpressionNode>(expression_statement->expression), ignored) ? Flow::Next : Flow::Stop;
+    }
+    if (auto* declaration = statement->as<VariableDeclarationNode>()) {
+        ComptimeValue value;
+        if (declaration->initializer && !eval(declaration->initializer, value)) return Flow::Stop;
+        for (int i = 0; i < declaration->names.size; ++i) {
+            declare_local(table.get_binding(declaration->names.values[i]), value);
+        }
+        return Flow::Next;
+    }
+    if (auto* return_statement = statement->as<ReturnStatementNode>()) {
+        return_value = ComptimeValue();
+        if (return_statement->expression && !eval(return_statement->expression, return_value)) return Flow::Stop;
+        return Flow::Return;
+    }
+    if (auto* if_statement = statement->as<IfStatementNode>()) {
+        bool condition = false;
+        if (!eval_condition(if_statement->condition, condition)) return Flow::Stop;
+        AstNode* branch = condition ? static_cast<AstNode*>(if_statement->thenStatement) : static_cast<AstNode*>(if_statement->elseStatement);
+        return exec(branch);
+    }
+    if (auto* while_statement = statement->as<WhileStatementNode>()) {
+        while (true) {
+            bool condition = false;
+            if (!eval_condition(while_statement->condition, condition)) return Flow::Stop;
+            if (!condition) return Flow::Next;
+            Flow flow = exec(while_statement->body);
+            if (flow == Flow::Break) return Flow::Next;
+            if (flow == Flow::Return || flow == Flow::Stop) return flow;
+        }
+    }
+    if (auto* for_statement = statement->as<ForStatementNode>()) {
+        Flow flow = exec(for_statement->initializer);
+        if (flow != Flow::Next) return flow;
+        while (true) {
+            bool condition = true;
+            if (for_statement->condition && !eval_condition(for_statement->condition, condition)) return Flow::Stop;
+            if (!condition) return Flow::Next;
+            flow = exec(for_statement->body);
+            if (flow == Flow::Break) return Flow::Next;
+            if (flow == Flow::Return || flow == Flow::Stop) return flow;
+            for (int i = 0; i < for_statement->incrementors.size; ++i) {
+                ComptimeValue ignored;
+                if (!eval(for_statement->incrementors.values[i], ignored)) return Flow::Stop;
+            }
+        }
+    }
+    if (statement->is_a<BreakStatementNode>()) return Flow::Break;
+    if (statement->is_a<ContinueStatementNode>()) return Flow::Continue;
+    if (statement->is_a<EmptyStatementNode>()) return Flow::Next;
+
+    fail(ComptimeStatus::NotConstant, statement, std::string(get_node_type_name(statement)) + " is not evaluated at compile time");
+    return Flow::Stop;
+}
+
+ComptimeValue* ComptimeEvaluator::find_local(SymbolId symbol) {
+    if (symbol == INVALID_SYMBOL_ID) return nullptr;
+    for (size_t i = locals.size(); i > frame_base; --i) {
+        if (locals[i - 1].first == symbol) return &locals[i - 1].second;
+    }
+    return nullptr;
+}
+
+void ComptimeEvaluator::declare_local(SymbolId symbol, ComptimeValue value) {
+    // A declaration in a loop body runs once per iteration and reuses its slot
+    if (ComptimeValue* local = find_local(symbol)) {
+        *local = value;
+    } else {
+        locals.emplace_back(symbol, value);
+    }
+}
+
+// Evaluates children before their parent, so each expression finds the
+// outcomes of its operands already recorded
+static void fold_subtree(ComptimeEvaluator& evaluator, SymbolTable& table, AstNode* node, std::vector<AstPassDiagnostic>& diagnostics) {
+    if (!node) return;
+    ast_dispatch(node, [&](auto* typed) {
+        ast_visit_fields(typed, [&](auto& field) {
+            if constexpr (std::is_convertible_v<decltype(field), AstNode*>) {
+                fold_subtree(evaluator, table, field, diagnostics);
+            } else {
+                for (int i = 0; i < field.size; ++i) fold_subtree(evaluator, table, field.values[i], diagnostics);
+            }
+        });
+    });
+
+    auto* expr = node->as<ExpressionNode>();
+    if (!expr || expr->is_a<LiteralExpressionNode>()) return;
+    ComptimeResult result = evaluator.evaluate(expr);
+    if (result.ok()) {
+        IRType type = result.value.kind == ComptimeValue::Kind::Int ? IRType::i32() : IRType::bool_();
+        if (result.value.kind != ComptimeValue::Kind::Type) table.set_constant(expr, ConstantValue{type, result.value.int_value});
+    } else if (result.status != ComptimeStatus::NotConstant) {
+        diagnostics.push_back({expr, "Cannot evaluate at compile time: " + result.message});
+    }
+}
+
+std::vector<AstPassDiagnostic> fold_constants(SymbolTable& table, CompilationUnitNode* ast, uint64_t step_budget) {
+    std::vector<AstPassDiagnostic> diagnostics;
+    ComptimeEvaluator evaluator(table, ast, step_budget);
+    fold_subtree(evaluator, table, ast, diagnostics);
+    return diagnostics;
+}
+
+} // namespace Mycelium::Scripting::Lang
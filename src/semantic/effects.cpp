@@ -0,0 +1,118 @@
+#include "semantic/effects.hpp"
+#include "ast/ast_walker.hpp"
+#include <algorithm>
+
+namespace Mycelium::Scripting::Lang {
+
+// What one body does by itself, leaving out its calls
+class BodyEffects : public AstWalker<BodyEffects> {
+public:
+    using AstWalker<BodyEffects>::visit;
+    SymbolTable& table;
+    int function_scope;
+    Purity purity = Purity::Pure;
+    bool loops = false;
+
+    BodyEffects(SymbolTable& symbol_table, int scope_id) : table(symbol_table), function_scope(scope_id) {}
+
+    void visit(IdentifierExpressionNode* node) {
+        if (!is_free(table.get_bound_symbol(node))) touch(Purity::ReadOnly);
+    }
+
+    void visit(MemberAccessExpressionNode* node) {
+        Symbol* member = table.get_bound_symbol(node);
+        if (member && member->type == SymbolType::VARIABLE && table.get_enum_bits(member->scope_level) == -1) {
+            touch(Purity::ReadOnly);
+        }
+        walk_children(node);
+    }
+
+    void visit(AssignmentExpressionNode* node) {
+        write(node->target);
+        walk_children(node);
+    }
+
+    void visit(UnaryExpressionNode* node) {
+        switch (node->opKind) {
+            case UnaryOperatorKind::PreIncrement:
+            case UnaryOperatorKind::PreDecrement:
+            case UnaryOperatorKind::PostIncrement:
+            case UnaryOperatorKind::PostDecrement:
+                write(node->operand);
+                break;
+            default:
+                break;
+        }
+        walk_children(node);
+    }
+
+    void visit(WhileStatementNode* node) { loops = true; walk_children(node); }
+    void visit(ForStatementNode* node) { loops = true; walk_children(node); }
+    void visit(ForInStatementNode* node) { loops = true; walk_children(node); }
+
+private:
+    void touch(Purity effect) { purity = std::max(purity, effect); }
+
+    // Only a named local can be written without the caller seeing it
+    void write(AstNode* target) {
+        if (!target || !target->as<IdentifierExpressionNode>() || !is_free(table.get_bound_symbol(target))) {
+            touch(Purity::SideEffecting);
+        }
+    }
+
+    // Names that cost nothing to use: this function's parameters and locals,
+    // and anything that is not a variable, such as functions, types and enum cases
+    bool is_free(Symbol* symbol) const {
+        if (!symbol) return true;
+        if (symbol->type == SymbolType::PARAMETER) return true;
+        if (symbol->type != SymbolType::VARIABLE) return true;
+        for (int scope = symbol->scope_level; scope != -1; scope = table.get_parent_scope(scope)) {
+            if (scope == function_scope) return true;
+            if (table.get_scope_kind(scope) != ScopeKind::BLOCK) break;
+        }
+        return table.get_enum_bits(symbol->scope_level) != -1;
+    }
+};
+
+void analyze_effects(SymbolTable& table, const CallGraph& graph) {
+    // Each function on its own
+    std::vector<FunctionEffects> effects(graph.size());
+    for (uint32_t index = 0; index < graph.size(); ++index) {
+        const CallGraph::Function& function = graph.function(index);
+        FunctionDeclarationNode* declaration = function.declaration;
+        if (!declaration->body || function.calls_unknown) continue;  // May run anything
+
+        BodyEffects body(table, table.get_node_scope(declaration));
+        body.walk(declaration->body);
+        effects[index].purity = body.purity;
+        effects[index].no_unwind = true;
+        effects[index].will_return = !body.loops && !function.recursive;
+    }
+
+    // Callers after callees; a component acts as one function
+    for (const std::vector<uint32_t>& component : graph.components()) {
+        FunctionEffects shared = effects[component.front()];
+        for (uint32_t member : component) {
+            FunctionEffects& own = effects[member];
+            for (uint32_t callee : graph.function(member).callees) {
+                const FunctionEffects& called = effects[callee];
+                own.purity = std::max(own.purity, called.purity);
+                own.no_unwind = own.no_unwind && called.no_unwind;
+                own.will_return = own.will_return && called.will_return;
+            }
+            shared.purity = std::max(shared.purity, own.purity);
+            shared.no_unwind = shared.no_unwind && own.no_unwind;
+        }
+        for (uint32_t member : component) {
+            effects[member].purity = shared.purity;
+            effects[member].no_unwind = shared.no_unwind;
+            table.set_function_effects(graph.function(member).symbol, effects[member]);
+        }
+    }
+}
+
+void analyze_effects(SymbolTable& table, CompilationUnitNode* ast) {
+    analyze_effects(table, CallGraph(table, ast));
+}
+
+} // namespace Mycelium::Scripting::Lang
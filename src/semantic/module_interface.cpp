@@ -0,0 +1,398 @@
+#include "semantic/module_interface.hpp"
+#include "common/logger.hpp"
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace Mycelium::Scripting::Lang {
+
+using namespace Mycelium::Scripting::Common;
+
+static const char MODULE_INTERFACE_MAGIC[4] = { 'M', 'M', 'O', 'D' };
+
+using Declaration = ModuleInterface::Declaration;
+
+// --- Extraction ---
+
+// Parameters of the function scope named name under parent_scope, without 'this'
+static std::vector<ModuleInterface::Member> parameters_of(SymbolTable& table, int parent_scope, std::string_view name) {
+    std::vector<ModuleInterface::Member> parameters;
+    int scope_id = table.find_child_scope(parent_scope, name);
+    if (scope_id == -1) return parameters;
+    for (Symbol* symbol : table.get_all_symbols_in_scope(scope_id)) {
+        if (symbol->type == SymbolType::PARAMETER && symbol->name != "this") {
+            parameters.push_back({ std::string(symbol->name), std::string(symbol->type_name) });
+        }
+    }
+    return parameters;
+}
+
+static Declaration function_declaration(SymbolTable& table, Symbol* function, int parent_scope) {
+    Declaration declaration;
+    declaration.kind = Declaration::Kind::Function;
+    declaration.name = function->name;
+    declaration.type_name = function->type_name;
+    declaration.members = parameters_of(table, parent_scope, function->name);
+    return declaration;
+}
+
+// Fields or cases, and methods, of a type or enum scope
+static void add_members(SymbolTable& table, int scope_id, bool cases, Declaration& declaration) {
+    for (Symbol* symbol : table.get_all_symbols_in_scope(scope_id)) {
+        if (symbol->removed) continue;
+        if (symbol->type == SymbolType::VARIABLE) {
+            declaration.members.push_back({ std::string(symbol->name), cases ? std::string() : std::string(symbol->type_name) });
+        } else if (symbol->type == SymbolType::FUNCTION) {
+            declaration.methods.push_back(function_declaration(table, symbol, scope_id));
+        }
+    }
+}
+
+static void add_layout(SymbolTable& table, int scope_id, Declaration& declaration) {
+    const StructLayout* layout = table.struct_type_of_scope(scope_id).struct_layout();
+    if (!layout) return;
+    std::unordered_map<std::string_view, uint32_t> indices;
+    for (uint32_t i = 0; i < declaration.members.size(); ++i) indices.emplace(declaration.members[i].name, i);
+    for (const StructLayout::Field& field : layout->fields) {
+        auto found = indices.find(field.name);
+        if (found != indices.end()) declaration.layout.push_back({ found->second, field.bit_width });
+    }
+    declaration.size = layout->total_size;
+    declaration.alignment = layout->alignment;
+}
+
+static bool is_public(const DeclarationNode* node) {
+    for (int i = 0; i < node->modifiers.size; ++i) {
+        if (node->modifiers.values[i] == ModifierKind::Public) return true;
+    }
+    return false;
+}
+
+ModuleInterface ModuleInterface::extract(SymbolTable& table, CompilationUnitNode* ast, std::string module_name, uint64_t source_hash) {
+    ModuleInterface module;
+    module.name = std::move(module_name);
+    module.source_hash = source_hash;
+    if (!ast) return module;
+
+    for (int i = 0; i < ast->statements.size; ++i) {
+        // Only what the script marks public leaves it; 'main' is its own entry point
+        auto* node = ast->statements.values[i]->as<DeclarationNode>();
+        if (!node || !node->name || !is_public(node) || node->name->name == "main") continue;
+        if (!node->is_a<FunctionDeclarationNode>() && !node->is_a<TypeDeclarationNode>() && !node->is_a<EnumDeclarationNode>()) continue;
+        Symbol* symbol = table.lookup_symbol_in_scope(0, node->name->name);
+        if (!symbol || symbol->removed) continue;
+        switch (symbol->type) {
+            case SymbolType::FUNCTION:
+                module.declarations.push_back(function_declaration(table, symbol, 0));
+                break;
+            case SymbolType::CLASS: {
+                int scope_id = table.find_child_scope(0, symbol->name);
+                if (scope_id == -1) break;
+                Declaration declaration;
+                declaration.kind = Declaration::Kind::Type;
+                declaration.name = symbol->name;
+                declaration.type_name = symbol->type_name;
+                declaration.flag = table.is_field_order_pinned(scope_id);
+                add_members(table, scope_id, false, declaration);
+                if (!declaration.members.empty()) add_layout(table, scope_id, declaration);
+                module.declarations.push_back(std::move(declaration));
+                break;
+            }
+            case SymbolType::ENUM: {
+                int scope_id = table.find_child_scope(0, symbol->name);
+                if (scope_id == -1) break;
+                Declaration declaration;
+                declaration.kind = Declaration::Kind::Enum;
+                declaration.name = symbol->name;
+                declaration.flag = table.get_enum_bits(scope_id) == 0;
+                add_members(table, scope_id, true, declaration);
+                module.declarations.push_back(std::move(declaration));
+                break;
+            }
+            default:
+                break;  // Globals stay private to their script
+        }
+    }
+    return module;
+}
+
+// --- Writer ---
+
+class ModuleInterfaceWriter {
+public:
+    std::vector<uint8_t> body;
+    std::vector<std::string_view> strings;
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            body.push_back(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        body.push_back(static_cast<uint8_t>(value));
+    }
+
+    void string(std::string_view text) {
+        auto found = ids.find(text);
+        if (found == ids.end()) {
+            found = ids.emplace(text, strings.size()).first;
+            strings.push_back(text);
+        }
+        varint(found->second);
+    }
+
+    void members(const std::vector<ModuleInterface::Member>& list, bool typed) {
+        varint(list.size());
+        for (const ModuleInterface::Member& member : list) {
+            string(member.name);
+            if (typed) string(member.type_name);
+        }
+    }
+
+    void declaration(const Declaration& declaration) {
+        varint(static_cast<uint8_t>(declaration.kind));
+        string(declaration.name);
+        switch (declaration.kind) {
+            case Declaration::Kind::Function:
+                string(declaration.type_name);
+                members(declaration.members, true);
+                return;
+            case Declaration::Kind::Enum:
+                varint(declaration.flag);
+                members(declaration.members, false);
+                methods(declaration);
+                return;
+            case Declaration::Kind::Type:
+                string(declaration.type_name);
+                varint(declaration.flag);
+                members(declaration.members, true);
+                methods(declaration);
+                varint(declaration.layout.size());
+                for (const ModuleInterface::LayoutSlot& slot : declaration.layout) {
+                    varint(slot.field);
+                    varint(slot.bit_width);
+                }
+                varint(declaration.size);
+                varint(declaration.alignment);
+                return;
+        }
+    }
+
+private:
+    std::unordered_map<std::string_view, uint64_t> ids;
+
+    void methods(const Declaration& owner) {
+        varint(owner.methods.size());
+        for (const Declaration& method : owner.methods) declaration(method);
+    }
+};
+
+void ModuleInterface::serialize(std::vector<uint8_t>& out) const {
+    ModuleInterfaceWriter writer;
+    writer.string(name);
+    writer.varint(declarations.size());
+    for (const Declaration& declaration : declarations) writer.declaration(declaration);
+
+    // The string table goes ahead of the declarations that index it
+    ModuleInterfaceWriter table;
+    table.varint(writer.strings.size());
+    for (std::string_view text : writer.strings) {
+        table.varint(text.size());
+        table.body.insert(table.body.end(), text.begin(), text.end());
+    }
+
+    ModuleInterfaceHeader header;
+    memcpy(header.magic, MODULE_INTERFACE_MAGIC, sizeof(header.magic));
+    header.version = MODULE_INTERFACE_VERSION;
+    header.sourceHash = source_hash;
+    header.totalSize = sizeof(header) + table.body.size() + writer.body.size();
+
+    out.resize(sizeof(header));
+    memcpy(out.data(), &header, sizeof(header));
+    out.insert(out.end(), table.body.begin(), table.body.end());
+    out.insert(out.end(), writer.body.begin(), writer.body.end());
+}
+
+bool ModuleInterface::save(const std::string& path) const {
+    std::vector<uint8_t> bytes;
+    serialize(bytes);
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    return static_cast<bool>(file);
+}
+
+// --- Reader ---
+
+// Every read is bounds checked; the first failure sticks and later reads return zeros
+class ModuleInterfaceReader {
+public:
+    const uint8_t* cursor;
+    const uint8_t* end;
+    std::vector<std::string_view> strings;
+    bool ok = true;
+
+    ModuleInterfaceReader(const uint8_t* data, size_t size) : cursor(data), end(data + size) {}
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; ok && shift < 64; shift += 7) {
+            if (cursor == end) break;
+            uint8_t byte = *cursor++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    std::string string() {
+        uint64_t id = varint();
+        if (id >= strings.size()) {
+            ok = false;
+            return {};
+        }
+        return std::string(strings[id]);
+    }
+
+    bool read_strings() {
+        uint64_t count = varint();
+        if (count > static_cast<uint64_t>(end - cursor)) return ok = false;  // Each string takes a byte at least
+        strings.reserve(count);
+        for (uint64_t i = 0; ok && i < count; ++i) {
+            uint64_t length = varint();
+            if (length > static_cast<uint64_t>(end - cursor)) return ok = false;
+            strings.emplace_back(reinterpret_cast<const char*>(cursor), length);
+            cursor += length;
+        }
+        return ok;
+    }
+
+    // A count of items that take a byte at least, so a corrupt count cannot reserve gigabytes
+    uint64_t count() {
+        uint64_t value = varint();
+        if (value > static_cast<uint64_t>(end - cursor)) ok = false;
+        return ok ? value : 0;
+    }
+
+    void members(std::vector<ModuleInterface::Member>& list, bool typed) {
+        uint64_t size = count();
+        list.resize(size);
+        for (ModuleInterface::Member& member : list) {
+            member.name = string();
+            if (typed) member.type_name = string();
+        }
+    }
+
+    void declaration(Declaration& declaration, int depth = 0) {
+        uint64_t kind = varint();
+        if (kind > static_cast<uint64_t>(Declaration::Kind::Function) || (depth > 0 && kind != static_cast<uint64_t>(Declaration::Kind::Function))) {
+            ok = false;
+            return;
+        }
+        declaration.kind = static_cast<Declaration::Kind>(kind);
+        declaration.name = string();
+        switch (declaration.kind) {
+            case Declaration::Kind::Function:
+                declaration.type_name = string();
+                members(declaration.members, true);
+                return;
+            case Declaration::Kind::Enum:
+                declaration.flag = varint() != 0;
+                members(declaration.members, false);
+                methods(declaration, depth);
+                return;
+            case Declaration::Kind::Type:
+                declaration.type_name = string();
+                declaration.flag = varint() != 0;
+                members(declaration.members, true);
+                methods(declaration, depth);
+                declaration.layout.resize(count());
+                for (ModuleInterface::LayoutSlot& slot : declaration.layout) {
+                    uint64_t field = varint();
+                    uint64_t bit_width = varint();
+                    if (field >= declaration.members.size() || bit_width > StructLayout::PACKED_WORD_BITS) ok = false;
+                    slot.field = static_cast<uint32_t>(field);
+                    slot.bit_width = static_cast<uint8_t>(bit_width);
+                }
+                declaration.size = varint();
+                declaration.alignment = varint();
+                return;
+        }
+    }
+
+private:
+    void methods(Declaration& owner, int depth) {
+        owner.methods.resize(count());
+        for (Declaration& method : owner.methods) {
+            if (!ok) return;
+            declaration(method, depth + 1);
+        }
+    }
+};
+
+bool ModuleInterface::deserialize(const uint8_t* data, size_t size, uint64_t expected_source_hash) {
+    *this = ModuleInterface();
+    ModuleInterfaceHeader header;
+    if (!data || size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, MODULE_INTERFACE_MAGIC, sizeof(header.magic)) != 0) return false;
+    if (header.version != MODULE_INTERFACE_VERSION || header.totalSize != size) return false;
+    if (expected_source_hash != 0 && header.sourceHash != expected_source_hash) return false;
+
+    ModuleInterfaceReader reader(data + sizeof(header), size - sizeof(header));
+    if (!reader.read_strings()) return false;
+    name = reader.string();
+    source_hash = header.sourceHash;
+    declarations.resize(reader.count());
+    for (Declaration& declaration : declarations) {
+        if (!reader.ok) break;
+        reader.declaration(declaration);
+    }
+    if (!reader.ok || reader.cursor != reader.end) {
+        *this = ModuleInterface();
+        return false;
+    }
+    return true;
+}
+
+bool ModuleInterface::load(const std::string& path, uint64_t expected_source_hash) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    std::vector<uint8_t> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(bytes.data()), bytes.size())) return false;
+    return deserialize(bytes.data(), bytes.size(), expected_source_hash);
+}
+
+// --- Imports ---
+
+// "A.B" for `using A.B;`
+static std::string module_name_of(TypeNameNode* type) {
+    if (!type) return "";
+    if (auto* qualified = type->as<QualifiedTypeNameNode>()) {
+        return module_name_of(qualified->left) + "." + std::string(qualified->right->name);
+    }
+    return type->identifier ? std::string(type->identifier->name) : "";
+}
+
+std::vector<AstPassDiagnostic> import_modules(SymbolTable& table, CompilationUnitNode* ast, const std::string& directory) {
+    std::vector<AstPassDiagnostic> diagnostics;
+    if (!ast) return diagnostics;
+    for (int i = 0; i < ast->statements.size; ++i) {
+        auto* directive = ast->statements.values[i]->as<UsingDirectiveNode>();
+        if (!directive) continue;
+        std::string module_name = module_name_of(directive->namespaceName);
+        std::string path = (directory.empty() ? "" : directory + "/") + module_name + ".mmi";
+
+        auto module = std::make_shared<ModuleInterface>();
+        if (module_name.empty() || !module->load(path)) {
+            diagnostics.push_back({ directive, "No usable module interface for '" + module_name + "' at '" + path + "'" });
+            continue;
+        }
+        LOG_DEBUG("Imported " + std::to_string(module->declarations.size()) + " declarations from '" + path + "'", LogCategory::SEMANTIC);
+        table.add_import(std::move(module));
+    }
+    return diagnostics;
+}
+
+} // namespace Mycelium::Scripting::Lang
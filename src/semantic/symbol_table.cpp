@@ -1,8 +1,13 @@
 #include "semantic/symbol_table.hpp"
+#include "semantic/module_interface.hpp"
 #include "ast/ast.hpp"
 #include "ast/ast_rtti.hpp"
+#include "ast/ast_walker.hpp"
+#include "ast/ast_parallel.hpp"
 #include "common/logger.hpp"
 #include "codegen/ir_command.hpp"
+#include "codegen/type_context.hpp"
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -11,9 +16,106 @@ namespace Mycelium::Scripting::Lang {
 
 using namespace Mycelium::Scripting::Common;
 
+// === NAME INTERNER ===
+NameId NameInterner::intern(std::string_view name) {
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    NameId id = static_cast<NameId>(names.size());
+    const std::string& stored = names.emplace_back(name);
+    ids.emplace(std::string_view(stored), id);
+    return id;
+}
+
+NameId NameInterner::find(std::string_view name) const {
+    auto it = ids.find(name);
+    return it != ids.end() ? it->second : INVALID_NAME_ID;
+}
+
+void NameInterner::clear() {
+    ids.clear();
+    names.clear();
+}
+
+// === SCOPE SYMBOLS ===
+static size_t scope_slot(NameId name, size_t mask) {
+    return (static_cast<size_t>(name) * 0x9E3779B1u) & mask;
+}
+
+SymbolId ScopeSymbols::find(NameId name) const {
+    if (heap.empty()) {
+        for (uint32_t i = 0; i < inline_count; i++) {
+            if (inline_entries[i].name == name) return inline_entries[i].symbol;
+        }
+        return INVALID_SYMBOL_ID;
+    }
+
+    size_t mask = index.size() - 1;
+    for (size_t slot = scope_slot(name, mask);; slot = (slot + 1) & mask) {
+        uint32_t position = index[slot];
+        if (position == 0) return INVALID_SYMBOL_ID;
+        if (heap[position - 1].name == name) return heap[position - 1].symbol;
+    }
+}
+
+bool ScopeSymbols::insert(NameId name, SymbolId symbol) {
+    if (find(name) != INVALID_SYMBOL_ID) {
+        return false;
+    }
+
+    if (heap.empty() && inline_count < INLINE_CAPACITY) {
+        inline_entries[inline_count++] = {name, symbol};
+        return true;
+    }
+
+    if (heap.empty()) {
+        // Outgrew the inline entries: move them out and start indexing
+        heap.assign(inline_entries.begin(), inline_entries.begin() + inline_count);
+        inline_count = 0;
+        rebuild_index(INLINE_CAPACITY * 4);
+    }
+
+    heap.push_back({name, symbol});
+    if (heap.size() * 2 > index.size()) {
+        rebuild_index(index.size() * 2);  // Keep the load factor at or below one half
+    } else {
+        add_to_index(static_cast<uint32_t>(heap.size() - 1));
+    }
+    return true;
+}
+
+void ScopeSymbols::truncate(size_t count) {
+    if (count >= size()) return;
+    if (heap.empty()) {
+        inline_count = static_cast<uint32_t>(count);
+        return;
+    }
+    
+    heap.resize(count);
+    rebuild_index(index.size());
+}
+
+void ScopeSymbols::add_to_index(uint32_t position) {
+    size_t mask = index.size() - 1;
+    size_t slot = scope_slot(heap[position].name, mask);
+    while (index[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    index[slot] = position + 1;
+}
+
+void ScopeSymbols::rebuild_index(size_t slot_count) {
+    index.assign(slot_count, 0);
+    for (uint32_t i = 0; i < heap.size(); i++) {
+        add_to_index(i);
+    }
+}
+
+// === SYMBOL TABLE ===
 SymbolTable::SymbolTable() : building_scope_level(0) {
     // Create global scope
-    all_scopes.emplace_back("global", -1);
+    all_scopes.emplace_back("global", -1, ScopeKind::GLOBAL);
     scope_name_to_id["global"] = 0;
     next_scope_id = 1;
     
@@ -22,20 +124,42 @@ SymbolTable::SymbolTable() : building_scope_level(0) {
 }
 
 // === BUILDING PHASE API ===
-void SymbolTable::enter_scope() {
-    // Create an anonymous scope for building
-    std::string scope_name = "scope_" + std::to_string(next_scope_id);
-    enter_named_scope(scope_name);
+static uint64_t child_scope_key(int parent_scope_id, NameId name) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(parent_scope_id)) << 32) | name;
 }
 
-void SymbolTable::enter_named_scope(const std::string& scope_name) {
+void SymbolTable::create_scope(const std::string& display_name, NameId name, ScopeKind kind) {
     int parent_id = building_scope_level;
-    all_scopes.emplace_back(scope_name, parent_id);
-    scope_name_to_id[scope_name] = next_scope_id;
+    int owner_type_id = all_scopes[parent_id].kind == ScopeKind::TYPE ? parent_id : all_scopes[parent_id].owner_type_scope_id;
+    
+    Scope& scope = all_scopes.emplace_back(display_name, parent_id, kind);
+    scope.owner_type_scope_id = owner_type_id;
+    scope.name_id = name;
+    if (name != INVALID_NAME_ID) {
+        child_scope_ids[child_scope_key(parent_id, name)] = next_scope_id;
+    }
+    scope_name_to_id[display_name] = next_scope_id;
+    touch_scope(next_scope_id);
     building_scope_level = next_scope_id;
     next_scope_id++;
 }
 
+void SymbolTable::enter_scope(ScopeKind kind) {
+    // Create an anonymous scope for building
+    create_scope("scope_" + std::to_string(next_scope_id), INVALID_NAME_ID, kind);
+}
+
+void SymbolTable::enter_named_scope(const std::string& scope_name, ScopeKind kind) {
+    // Functions declared in a type body get a qualified display name, so the
+    // same method name in two types stays distinct for find_scope_by_name()
+    const Scope& parent = all_scopes[building_scope_level];
+    if (kind == ScopeKind::FUNCTION && parent.kind == ScopeKind::TYPE) {
+        create_scope(parent.scope_name + "::" + scope_name, names.intern(scope_name), kind);
+    } else {
+        create_scope(scope_name, names.intern(scope_name), kind);
+    }
+}
+
 void SymbolTable::exit_scope() {
     if (building_scope_level > 0) {
         // Find parent scope
@@ -43,33 +167,58 @@ void SymbolTable::exit_scope() {
     }
 }
 
+Symbol* SymbolTable::create_symbol(NameId name, SymbolType type, const IRType& data_type, std::string_view type_name) {
+    // A new name can shadow what an inferred expression referred to. Once types
+    // are final only bodies declare, and nothing outside a body sees its locals.
+    ScopeKind kind = all_scopes[building_scope_level].kind;
+    bool body_local = kind == ScopeKind::FUNCTION || kind == ScopeKind::BLOCK;
+    if (expression_types.size() > 0 && !(expression_types_final && body_local)) {
+        expression_types.clear();
+        expression_types_final = false;
+    }
+    
+    Symbol& symbol = symbol_arena.emplace_back();
+    symbol.id = static_cast<SymbolId>(symbol_arena.size() - 1);
+    symbol.name_id = name;
+    symbol.name = names.str(name);
+    symbol.type = type;
+    symbol.data_type = data_type;
+    symbol.type_name = intern_view(type_name);
+    symbol.scope_level = building_scope_level;
+    all_scopes[building_scope_level].symbols.insert(name, symbol.id);
+    touch_scope(building_scope_level);
+    return &symbol;
+}
+
 bool SymbolTable::declare_symbol(const std::string& name, SymbolType type, const IRType& data_type, const std::string& type_name) {
-    if (symbol_exists_current_scope(name)) {
+    NameId name_id = names.intern(name);
+    if (all_scopes[building_scope_level].symbols.find(name_id) != INVALID_SYMBOL_ID) {
         return false;
     }
     
-    auto symbol = std::make_shared<Symbol>(name, type, data_type, type_name, building_scope_level);
+    Symbol* symbol = create_symbol(name_id, type, data_type, type_name);
     symbol->resolution_state = TypeResolutionState::RESOLVED;  // Explicit types are already resolved
-    all_scopes[building_scope_level].symbols[name] = symbol;
     return true;
 }
 
 bool SymbolTable::declare_unresolved_symbol(const std::string& name, SymbolType type, ExpressionNode* initializer) {
-    if (symbol_exists_current_scope(name)) {
+    NameId name_id = names.intern(name);
+    if (all_scopes[building_scope_level].symbols.find(name_id) != INVALID_SYMBOL_ID) {
         return false;
     }
     
     // Create symbol with placeholder type - will be resolved later
-    auto symbol = std::make_shared<Symbol>(name, type, IRType::i32(), "unresolved", building_scope_level);
+    Symbol* symbol = create_symbol(name_id, type, IRType::i32(), "unresolved");
     symbol->resolution_state = TypeResolutionState::UNRESOLVED;
     symbol->initializer_expression = initializer;
     
     // Extract dependencies from initializer if present
     if (initializer) {
-        symbol->dependencies = extract_dependencies(initializer);
+        for (const std::string& dependency : extract_dependencies(initializer)) {
+            symbol->dependencies.push_back(names.intern(dependency));
+        }
     }
     
-    all_scopes[building_scope_level].symbols[name] = symbol;
     return true;
 }
 
@@ -103,29 +252,25 @@ void SymbolTable::reset_navigation() {
 }
 
 // === QUERY API ===
-std::shared_ptr<Symbol> SymbolTable::lookup_symbol(const std::string& name) {
+Symbol* SymbolTable::lookup_symbol(std::string_view name) {
+    NameId name_id = names.find(name);
+    if (name_id == INVALID_NAME_ID) return nullptr;  // Never declared anywhere
+
     // Search from current scope up through parent chain
     for (int i = active_scope_stack.size() - 1; i >= 0; i--) {
         int scope_id = active_scope_stack[i];
-        auto it = all_scopes[scope_id].symbols.find(name);
-        if (it != all_scopes[scope_id].symbols.end()) {
-            return it->second;
+        SymbolId found = all_scopes[scope_id].symbols.find(name_id);
+        if (found != INVALID_SYMBOL_ID) {
+            return &symbol_arena[found];
         }
         
-        // Special handling for member function scopes - check for unqualified field access
-        // If we're in a member function scope (Type::function), check the parent type scope for fields
+        // Inside a member function, unqualified names can refer to fields of the owning type
         if (i == active_scope_stack.size() - 1) { // Only check from current scope
-            const std::string& scope_name = all_scopes[scope_id].scope_name;
-            if (scope_name.find("::") != std::string::npos) {
-                // This is a member function scope, extract the type name
-                std::string type_name = scope_name.substr(0, scope_name.find("::"));
-                int type_scope_id = find_scope_by_name(type_name);
-                if (type_scope_id != -1) {
-                    auto field_it = all_scopes[type_scope_id].symbols.find(name);
-                    if (field_it != all_scopes[type_scope_id].symbols.end() && 
-                        field_it->second->type == SymbolType::VARIABLE) {
-                        return field_it->second;
-                    }
+            int type_scope_id = all_scopes[scope_id].owner_type_scope_id;
+            if (type_scope_id != -1) {
+                SymbolId field = all_scopes[type_scope_id].symbols.find(name_id);
+                if (field != INVALID_SYMBOL_ID && symbol_arena[field].type == SymbolType::VARIABLE) {
+                    return &symbol_arena[field];
                 }
             }
         }
@@ -133,56 +278,68 @@ std::shared_ptr<Symbol> SymbolTable::lookup_symbol(const std::string& name) {
     return nullptr;
 }
 
-std::shared_ptr<Symbol> SymbolTable::lookup_symbol_current_scope(const std::string& name) {
+Symbol* SymbolTable::lookup_symbol_current_scope(std::string_view name) {
     if (active_scope_stack.empty()) return nullptr;
     
-    int current_scope = active_scope_stack.back();
-    auto it = all_scopes[current_scope].symbols.find(name);
-    if (it != all_scopes[current_scope].symbols.end()) {
-        return it->second;
-    }
-    return nullptr;
+    return lookup_symbol_in_scope(active_scope_stack.back(), name);
+}
+
+Symbol* SymbolTable::lookup_symbol_in_scope(int scope_id, std::string_view name) {
+    SymbolId found = lookup_symbol_id_in_scope(scope_id, names.find(name));
+    return found != INVALID_SYMBOL_ID ? &symbol_arena[found] : nullptr;
 }
 
-std::shared_ptr<Symbol> SymbolTable::lookup_symbol_in_scope(int scope_id, const std::string& name) {
-    if (scope_id < 0 || scope_id >= all_scopes.size()) return nullptr;
+SymbolId SymbolTable::lookup_symbol_id_in_scope(int scope_id, NameId name) const {
+    if (scope_id < 0 || scope_id >= static_cast<int>(all_scopes.size()) || name == INVALID_NAME_ID) return INVALID_SYMBOL_ID;
     
-    auto it = all_scopes[scope_id].symbols.find(name);
-    if (it != all_scopes[scope_id].symbols.end()) {
-        return it->second;
-    }
-    return nullptr;
+    return all_scopes[scope_id].symbols.find(name);
 }
 
-std::vector<std::shared_ptr<Symbol>> SymbolTable::get_all_symbols_in_scope(int scope_id) {
-    std::vector<std::shared_ptr<Symbol>> symbols;
+std::vector<Symbol*> SymbolTable::get_all_symbols_in_scope(int scope_id) {
+    std::vector<Symbol*> symbols;
     
     if (scope_id < 0 || scope_id >= all_scopes.size()) {
         return symbols; // Return empty vector for invalid scope_id
     }
     
     // Iterate through all symbols in the scope and collect them
-    for (const auto& [name, symbol] : all_scopes[scope_id].symbols) {
-        symbols.push_back(symbol);
+    for (const auto& entry : all_scopes[scope_id].symbols.entries()) {
+        symbols.push_back(&symbol_arena[entry.symbol]);
     }
     
     return symbols;
 }
 
-bool SymbolTable::symbol_exists(const std::string& name) {
+bool SymbolTable::symbol_exists(std::string_view name) {
     return lookup_symbol(name) != nullptr;
 }
 
-bool SymbolTable::symbol_exists_current_scope(const std::string& name) {
+bool SymbolTable::symbol_exists_current_scope(std::string_view name) {
     return lookup_symbol_current_scope(name) != nullptr;
 }
 
 // === SCOPE MANAGEMENT ===
-int SymbolTable::find_scope_by_name(const std::string& scope_name) {
+int SymbolTable::find_scope_by_name(const std::string& scope_name) const {
     auto it = scope_name_to_id.find(scope_name);
     return (it != scope_name_to_id.end()) ? it->second : -1;
 }
 
+int SymbolTable::find_type_scope(std::string_view type_name) const {
+    while (!type_name.empty() && type_name.back() == '*') {
+        type_name.remove_suffix(1);
+    }
+    int scope_id = find_scope_by_name(std::string(type_name));
+    return (scope_id != -1 && all_scopes[scope_id].kind == ScopeKind::TYPE) ? scope_id : -1;
+}
+
+int SymbolTable::find_child_scope(int parent_scope_id, std::string_view name) const {
+    NameId name_id = names.find(name);
+    if (parent_scope_id < 0 || name_id == INVALID_NAME_ID) return -1;
+    
+    auto it = child_scope_ids.find(child_scope_key(parent_scope_id, name_id));
+    return (it != child_scope_ids.end()) ? it->second : -1;
+}
+
 int SymbolTable::get_current_scope_id() const {
     return active_scope_stack.empty() ? -1 : active_scope_stack.back();
 }
@@ -192,25 +349,141 @@ std::string SymbolTable::get_current_scope_name() const {
     return (scope_id >= 0 && scope_id < all_scopes.size()) ? all_scopes[scope_id].scope_name : "";
 }
 
+int SymbolTable::get_parent_scope(int scope_id) const {
+    return (scope_id >= 0 && scope_id < static_cast<int>(all_scopes.size())) ? all_scopes[scope_id].parent_scope_id : -1;
+}
+
+int SymbolTable::get_owner_type_scope(int scope_id) const {
+    return (scope_id >= 0 && scope_id < static_cast<int>(all_scopes.size())) ? all_scopes[scope_id].owner_type_scope_id : -1;
+}
+
+ScopeKind SymbolTable::get_scope_kind(int scope_id) const {
+    return (scope_id >= 0 && scope_id < static_cast<int>(all_scopes.size())) ? all_scopes[scope_id].kind : ScopeKind::BLOCK;
+}
+
+uint64_t SymbolTable::get_scope_version(int scope_id) const {
+    return (scope_id >= 0 && scope_id < static_cast<int>(all_scopes.size())) ? all_scopes[scope_id].version : 0;
+}
+
+const std::string& SymbolTable::get_scope_name(int scope_id) const {
+    static const std::string empty;
+    return (scope_id >= 0 && scope_id < static_cast<int>(all_scopes.size())) ? all_scopes[scope_id].scope_name : empty;
+}
+
 void SymbolTable::clear() {
     all_scopes.clear();
+    symbol_arena.clear();
+    names.clear();
     scope_name_to_id.clear();
+    child_scope_ids.clear();
+    type_cycles.clear();
+    expression_types.clear();
+    node_scopes.clear();
+    name_bindings.clear();
+    constants.clear();
+    function_effects.clear();
+    dead_functions.clear();
+    body_extents.clear();
+    declaration_uses.clear();
+    expression_types_final = false;
     active_scope_stack.clear();
     building_scope_level = 0;
     next_scope_id = 0;
     
     // Recreate global scope
-    all_scopes.emplace_back("global", -1);
+    all_scopes.emplace_back("global", -1, ScopeKind::GLOBAL);
     scope_name_to_id["global"] = 0;
+    touch_scope(0);
     next_scope_id = 1;
     active_scope_stack.push_back(0);
 }
 
+// === FUNCTION EFFECTS ===
+void SymbolTable::set_function_effects(SymbolId function, FunctionEffects effects) {
+    if (function >= function_effects.size()) function_effects.resize(function + 1);
+    function_effects[function] = effects;
+}
+
+FunctionEffects SymbolTable::get_function_effects(SymbolId function) const {
+    return function < function_effects.size() ? function_effects[function] : FunctionEffects();
+}
+
+void SymbolTable::mark_dead_function(SymbolId function) {
+    if (function >= dead_functions.size()) dead_functions.resize(function + 1, false);
+    dead_functions[function] = true;
+}
+
+// === INCREMENTAL UPDATES ===
+const BodyExtent* SymbolTable::get_body_extent(int function_scope_id) const {
+    auto found = body_extents.find(function_scope_id);
+    return found != body_extents.end() ? &found->second : nullptr;
+}
+
+bool SymbolTable::is_read_outside_bodies(SymbolId symbol) const {
+    return std::binary_search(declaration_uses.begin(), declaration_uses.end(), symbol);
+}
+
+std::vector<int> SymbolTable::find_dependent_bodies(SymbolId symbol) const {
+    std::vector<int> dependents;
+    for (const auto& [scope_id, extent] : body_extents) {
+        if (std::binary_search(extent.uses.begin(), extent.uses.end(), symbol)) dependents.push_back(scope_id);
+    }
+    std::sort(dependents.begin(), dependents.end());
+    return dependents;
+}
+
+void SymbolTable::remove_scope(int scope_id) {
+    Scope& scope = all_scopes[scope_id];
+    for (const auto& entry : scope.symbols.entries()) symbol_arena[entry.symbol].removed = true;
+    scope.symbols = ScopeSymbols();
+    scope.removed = true;
+    touch_scope(scope_id);
+    
+    // Keep the name maps from handing out a scope that is gone
+    auto named = scope_name_to_id.find(scope.scope_name);
+    if (named != scope_name_to_id.end() && named->second == scope_id) scope_name_to_id.erase(named);
+    if (scope.name_id != INVALID_NAME_ID) {
+        auto child = child_scope_ids.find(child_scope_key(scope.parent_scope_id, scope.name_id));
+        if (child != child_scope_ids.end() && child->second == scope_id) child_scope_ids.erase(child);
+    }
+}
+
+void SymbolTable::remove_function_declarations(int function_scope_id) {
+    // Member functions declare 'this' first; it depends only on the owner type
+    Scope& scope = all_scopes[function_scope_id];
+    auto entries = scope.symbols.entries();
+    size_t kept = (!entries.empty() && symbol_arena[entries[0].symbol].name == "this") ? 1 : 0;
+    for (size_t i = kept; i < entries.size(); i++) symbol_arena[entries[i].symbol].removed = true;
+    scope.symbols.truncate(kept);
+    touch_scope(function_scope_id);
+    
+    if (auto extent = body_extents.find(function_scope_id); extent != body_extents.end()) {
+        for (int id = extent->second.first_scope; id < extent->second.end_scope; id++) remove_scope(id);
+        body_extents.erase(extent);
+    }
+    std::erase_if(type_cycles, [&](const std::vector<SymbolId>& cycle) { return symbol_arena[cycle[0]].removed; });
+}
+
+void SymbolTable::forget_node(const AstNode* node) {
+    if (node->nodeId < expression_types.size()) expression_types.set(node, {});
+    if (node->nodeId < name_bindings.size()) name_bindings.set(node, INVALID_SYMBOL_ID);
+    if (node->nodeId < node_scopes.size()) node_scopes.set(node, -1);
+    if (node->nodeId < constants.size()) constants.set(node, {});
+}
+
+void SymbolTable::set_symbol_type(SymbolId id, const std::string& type_name) {
+    Symbol& symbol = symbol_arena[id];
+    symbol.data_type = string_to_ir_type(type_name);
+    symbol.type_name = intern_view(type_name);
+    touch_scope(symbol.scope_level);
+}
+
 void SymbolTable::print_symbol_table() const {
     LOG_INFO("Total scopes: " + std::to_string(all_scopes.size()), LogCategory::SEMANTIC);
     
     for (size_t scope_id = 0; scope_id < all_scopes.size(); ++scope_id) {
         const auto& scope = all_scopes[scope_id];
+        if (scope.removed) continue;
         LOG_SEPARATOR('-', 60, LogCategory::SEMANTIC);
         std::string scope_info = "Scope " + std::to_string(scope_id) + ": \"" + scope.scope_name + "\"";
         if (scope.parent_scope_id >= 0) {
@@ -231,7 +504,8 @@ void SymbolTable::print_symbol_table() const {
                    << Colors::RESET;
             LOG_INFO(header.str(), LogCategory::SEMANTIC);
             
-            for (const auto& [name, symbol] : scope.symbols) {
+            for (const auto& entry : scope.symbols.entries()) {
+                const Symbol* symbol = &symbol_arena[entry.symbol];
                 std::string type_str;
                 switch (symbol->type) {
                     case SymbolType::VARIABLE: type_str = "VARIABLE"; break;
@@ -266,39 +540,141 @@ void SymbolTable::print_navigation_state() const {
     LOG_SEPARATOR('-', 30, LogCategory::SEMANTIC);
 }
 
+// === STRUCT LAYOUT ===
+void SymbolTable::set_field_order(FieldOrder order) {
+    field_order = order;
+    for (int id = 0; id < (int)all_scopes.size(); id++) {
+        if (all_scopes[id].kind == ScopeKind::TYPE) touch_scope(id);
+    }
+}
+
+void SymbolTable::set_bit_packing(bool enabled) {
+    bit_packing = enabled;
+    for (int id = 0; id < (int)all_scopes.size(); id++) {
+        if (all_scopes[id].kind == ScopeKind::TYPE) touch_scope(id);
+    }
+}
+
+void SymbolTable::pin_field_order(int type_scope_id) {
+    all_scopes[type_scope_id].pinned_field_order = true;
+    touch_scope(type_scope_id);
+}
+
+void SymbolTable::set_imported_layout(int type_scope_id, IRType struct_type) {
+    all_scopes[type_scope_id].imported_struct = struct_type;
+    touch_scope(type_scope_id);
+}
+
+bool SymbolTable::is_field_order_pinned(int type_scope_id) const {
+    return type_scope_id >= 0 && type_scope_id < static_cast<int>(all_scopes.size()) && all_scopes[type_scope_id].pinned_field_order;
+}
+
+void SymbolTable::mark_enum_scope(int enum_scope_id, bool cases_carry_data) {
+    int cases = 0;
+    for (const auto& entry : all_scopes[enum_scope_id].symbols.entries()) {
+        if (symbol_arena[entry.symbol].type == SymbolType::VARIABLE) cases++;
+    }
+    int bits = 1;
+    while (bits < 31 && (1 << bits) < cases) bits++;
+    all_scopes[enum_scope_id].enum_bits = static_cast<int8_t>(cases_carry_data ? 0 : bits);
+    touch_scope(enum_scope_id);
+}
+
+int SymbolTable::get_enum_bits(int scope_id) const {
+    return (scope_id >= 0 && scope_id < static_cast<int>(all_scopes.size())) ? all_scopes[scope_id].enum_bits : -1;
+}
+
+std::vector<StructLayout::Field> SymbolTable::declared_fields(int type_scope_id, bool pack) {
+    std::vector<StructLayout::Field> fields;
+    for (Symbol* symbol : get_all_symbols_in_scope(type_scope_id)) {
+        if (symbol && symbol->type == SymbolType::VARIABLE) {
+            StructLayout::Field field;
+            field.name = symbol->name;
+            field.type = symbol->data_type;
+            field.offset = 0; // Calculated by the type context
+            if (pack && symbol->data_type.kind == IRType::Kind::Bool) {
+                field.bit_width = 1;
+            } else if (pack && symbol->data_type.kind == IRType::Kind::I32) {
+                int enum_bits = get_enum_bits(find_type_scope(symbol->type_name));
+                if (enum_bits > 0 && enum_bits <= SMALL_ENUM_BITS) field.bit_width = static_cast<uint8_t>(enum_bits);
+            }
+            fields.push_back(field);
+        }
+    }
+    return fields;
+}
+
+IRType SymbolTable::struct_type_of_scope(int type_scope_id) {
+    if (get_scope_kind(type_scope_id) != ScopeKind::TYPE) return IRType(IRType::Kind::Struct);
+    
+    if (all_scopes[type_scope_id].imported_struct.kind == IRType::Kind::Struct) return all_scopes[type_scope_id].imported_struct;
+    
+    bool pinned = all_scopes[type_scope_id].pinned_field_order;
+    std::vector<StructLayout::Field> fields = declared_fields(type_scope_id, bit_packing && !pinned);
+    if (!pinned) StructLayout::order_fields(fields, field_order);
+    
+    // The context lays the struct out the first time it sees these fields
+    return TypeContext::global().struct_type(all_scopes[type_scope_id].scope_name, fields);
+}
+
+std::vector<LayoutSavings> SymbolTable::get_layout_savings() {
+    std::vector<LayoutSavings> savings;
+    for (int id = 0; id < (int)all_scopes.size(); id++) {
+        if (all_scopes[id].kind != ScopeKind::TYPE || all_scopes[id].removed || all_scopes[id].enum_bits != -1) continue;
+        
+        StructLayout declared;
+        declared.fields = declared_fields(id, false);
+        if (declared.fields.empty()) continue;
+        declared.calculate_layout();
+        
+        const StructLayout* layout = struct_type_of_scope(id).struct_layout();
+        savings.push_back({ all_scopes[id].scope_name, declared.total_size, layout ? layout->total_size : declared.total_size,
+                            all_scopes[id].pinned_field_order });
+    }
+    return savings;
+}
+
 // === PRIVATE HELPER FUNCTIONS ===
 IRType SymbolTable::string_to_ir_type(const std::string& type_str) {
-    // Check for array types first (e.g., "i32[]")
-    if (type_str.length() > 2 && type_str.substr(type_str.length() - 2) == "[]") {
+    // Primitive keywords are one hash lookup
+    TypeContext& types = TypeContext::global();
+    if (auto builtin = types.builtin(type_str)) {
+        return *builtin;
+    }
+    
+    std::string_view type_view = type_str;
+    if (type_view.size() > 2 && type_view.ends_with("[]")) {
         // For now, treat arrays as pointers to the element type
         // Later we can implement proper array types
-        std::string element_type = type_str.substr(0, type_str.length() - 2);
         // Arrays are represented as pointers in LLVM
         return IRType::ptr();
     }
     
-    if (type_str == "i32") {
-        return IRType::i32();
-    } else if (type_str == "i64") {
-        return IRType::i64();
-    } else if (type_str == "i8") {
-        return IRType::i8();
-    } else if (type_str == "i16") {
-        return IRType::i16();
-    } else if (type_str == "bool") {
-        return IRType::bool_();
-    } else if (type_str == "f32") {
-        return IRType::f32();
-    } else if (type_str == "f64") {
-        return IRType::f64();
-    } else if (type_str == "void") {
-        return IRType::void_();
-    } else if (type_str == "ptr") {
-        return IRType::ptr();
-    } else if (type_str == "string") {
-        // Strings are typically represented as pointers in LLVM
-        return IRType::ptr();
-    } else {
+    // Generic instances as the builder spells them, e.g. "List<i32, bool>"
+    size_t open_angle = type_view.find('<');
+    if (open_angle != std::string_view::npos && type_view.ends_with(">")) {
+        std::string base(type_view.substr(0, open_angle));
+        Symbol* base_symbol = lookup_symbol(base);
+        if (base_symbol && base_symbol->type == SymbolType::CLASS) {
+            std::vector<IRType> arguments;
+            std::string_view list = type_view.substr(open_angle + 1, type_view.size() - open_angle - 2);
+            int depth = 0;
+            size_t start = 0;
+            for (size_t i = 0; i <= list.size(); i++) {
+                if (i < list.size() && list[i] == '<') depth++;
+                if (i < list.size() && list[i] == '>') depth--;
+                if (i == list.size() || (list[i] == ',' && depth == 0)) {
+                    std::string_view argument = list.substr(start, i - start);
+                    while (argument.starts_with(' ')) argument.remove_prefix(1);
+                    arguments.push_back(string_to_ir_type(std::string(argument)));
+                    start = i + 1;
+                }
+            }
+            return types.generic_instance(base, arguments);
+        }
+    }
+    
+    {
         // Check if it's a custom type in the symbol table
         auto symbol = lookup_symbol(type_str);
         if (symbol) {
@@ -308,30 +684,7 @@ IRType SymbolTable::string_to_ir_type(const std::string& type_str) {
                     // Find the class scope to build the layout
                     int struct_scope_id = find_scope_by_name(type_str);
                     if (struct_scope_id != -1) {
-                        // Create the struct layout
-                        auto layout = std::make_shared<StructLayout>();
-                        layout->name = type_str;
-                        
-                        // Get all symbols in the struct scope
-                        auto field_symbols = get_all_symbols_in_scope(struct_scope_id);
-                        
-                        // Process all variable symbols (struct fields)
-                        for (const auto& field_symbol : field_symbols) {
-                            if (field_symbol && field_symbol->type == SymbolType::VARIABLE) {
-                                StructLayout::Field field;
-                                field.name = field_symbol->name;
-                                field.type = field_symbol->data_type;
-                                field.offset = 0; // Will be calculated by calculate_layout()
-                                
-                                layout->fields.push_back(field);
-                            }
-                        }
-                        
-                        // Calculate field offsets and total size
-                        layout->calculate_layout();
-                        
-                        // Create and return struct type with layout
-                        return IRType::struct_(layout);
+                        return struct_type_of_scope(struct_scope_id);
                     } else {
                         LOG_ERROR("Cannot find scope for class type: " + type_str, LogCategory::SEMANTIC);
                         return IRType::ptr(); // Fallback to pointer
@@ -352,62 +705,151 @@ IRType SymbolTable::string_to_ir_type(const std::string& type_str) {
 }
 
 // === TYPE RESOLUTION API ===
+// Symbol names of a cycle, for diagnostics
+static std::string cycle_members(SymbolTable& table, const std::vector<SymbolId>& cycle) {
+    std::string members;
+    for (SymbolId id : cycle) {
+        members += (members.empty() ? "" : ", ") + std::string(table.get_symbol(id)->name);
+    }
+    return members;
+}
+
 bool SymbolTable::resolve_all_types() {
     LOG_DEBUG("Starting type resolution for all unresolved symbols", LogCategory::SEMANTIC);
+    type_cycles.clear();
     
-    bool progress = true;
-    int max_iterations = 10;  // Prevent infinite loops
-    int iteration = 0;
+    std::vector<SymbolId> failed;
+    bool all_resolved = resolve_symbol_range(0, static_cast<SymbolId>(symbol_arena.size()), type_cycles, failed);
+    for (SymbolId id : failed) {
+        LOG_ERROR("Cannot infer type for symbol: " + std::string(symbol_arena[id].name), LogCategory::SEMANTIC);
+    }
+    for (const auto& cycle : type_cycles) {
+        LOG_ERROR("Circular type dependency between: " + cycle_members(*this, cycle), LogCategory::SEMANTIC);
+    }
     
-    while (progress && iteration < max_iterations) {
-        progress = false;
-        iteration++;
-        
-        LOG_DEBUG("Type resolution iteration " + std::to_string(iteration), LogCategory::SEMANTIC);
-        
-        // Try to resolve all unresolved symbols in all scopes
-        for (auto& scope : all_scopes) {
-            for (auto& [name, symbol] : scope.symbols) {
-                if (symbol->resolution_state == TypeResolutionState::UNRESOLVED) {
-                    LOG_DEBUG("Attempting to resolve symbol: " + name, LogCategory::SEMANTIC);
-                    if (resolve_symbol_type(name)) {
-                        progress = true;
-                        LOG_DEBUG("Successfully resolved symbol: " + name, LogCategory::SEMANTIC);
-                    }
-                }
-            }
+    // Whatever is still unresolved now stays that way, so inferred types are final
+    expression_types_final = true;
+    
+    if (all_resolved) {
+        LOG_DEBUG("Type resolution completed successfully", LogCategory::SEMANTIC);
+    }
+    return all_resolved;
+}
+
+// Unresolved symbols form a graph with an edge from each symbol to the
+// unresolved symbols its initializer reads. Tarjan's algorithm finishes a
+// strongly connected component only after every component it reaches, so
+// components come out dependencies-first and each symbol is inferred exactly
+// once. A component with several members, or one that reads itself, is a cycle.
+bool SymbolTable::resolve_symbol_range(SymbolId first, SymbolId end, std::vector<std::vector<SymbolId>>& cycles,
+                                       std::vector<SymbolId>& failed) {
+    // Number the unresolved symbols in declaration order
+    constexpr uint32_t NO_NODE = UINT32_MAX;
+    std::vector<SymbolId> nodes;
+    std::vector<uint32_t> node_of(end - first, NO_NODE);
+    for (SymbolId id = first; id < end; id++) {
+        if (symbol_arena[id].resolution_state == TypeResolutionState::UNRESOLVED) {
+            node_of[id - first] = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(id);
         }
     }
     
-    // Check if any symbols remain unresolved
-    bool all_resolved = true;
-    for (const auto& scope : all_scopes) {
-        for (const auto& [name, symbol] : scope.symbols) {
-            if (symbol->resolution_state == TypeResolutionState::UNRESOLVED) {
-                LOG_ERROR("Failed to resolve type for symbol: " + name, LogCategory::SEMANTIC);
-                all_resolved = false;
+    // Edges in one flat array; node n's targets are edges[edge_start[n] .. edge_start[n + 1])
+    std::vector<uint32_t> edge_start(nodes.size() + 1, 0);
+    std::vector<uint32_t> edges;
+    for (size_t n = 0; n < nodes.size(); n++) {
+        const Symbol& symbol = symbol_arena[nodes[n]];
+        for (NameId dependency : symbol.dependencies) {
+            SymbolId target = lookup_symbol_id_in_context(symbol.scope_level, dependency);
+            if (target >= first && target < end && node_of[target - first] != NO_NODE) {
+                edges.push_back(node_of[target - first]);
             }
         }
+        edge_start[n + 1] = static_cast<uint32_t>(edges.size());
     }
     
-    if (iteration >= max_iterations) {
-        LOG_ERROR("Type resolution exceeded maximum iterations - possible circular dependencies", LogCategory::SEMANTIC);
-        return false;
+    // Iterative Tarjan, so long inference chains cannot overflow the call stack
+    std::vector<uint32_t> index(nodes.size(), NO_NODE);
+    std::vector<uint32_t> lowlink(nodes.size(), 0);
+    std::vector<bool> on_stack(nodes.size(), false);
+    std::vector<uint32_t> component_stack;
+    std::vector<std::pair<uint32_t, uint32_t>> call_stack;  // (node, next edge to follow)
+    uint32_t next_index = 0;
+    bool all_resolved = true;
+    
+    auto discover = [&](uint32_t node) {
+        index[node] = lowlink[node] = next_index++;
+        component_stack.push_back(node);
+        on_stack[node] = true;
+        call_stack.push_back({node, edge_start[node]});
+    };
+    
+    for (uint32_t root = 0; root < nodes.size(); root++) {
+        if (index[root] != NO_NODE) continue;
+        discover(root);
+        
+        while (!call_stack.empty()) {
+            uint32_t node = call_stack.back().first;
+            uint32_t& next_edge = call_stack.back().second;
+            if (next_edge < edge_start[node + 1]) {
+                uint32_t target = edges[next_edge++];
+                if (index[target] == NO_NODE) {
+                    discover(target);
+                } else if (on_stack[target]) {
+                    lowlink[node] = std::min(lowlink[node], index[target]);
+                }
+                continue;
+            }
+            
+            call_stack.pop_back();
+            if (!call_stack.empty()) {
+                uint32_t parent = call_stack.back().first;
+                lowlink[parent] = std::min(lowlink[parent], lowlink[node]);
+            }
+            if (lowlink[node] != index[node]) continue;
+            
+            // node is the root of a finished component
+            std::vector<SymbolId> component;
+            uint32_t member;
+            do {
+                member = component_stack.back();
+                component_stack.pop_back();
+                on_stack[member] = false;
+                component.push_back(nodes[member]);
+            } while (member != node);
+            
+            bool self_edge = false;
+            for (uint32_t e = edge_start[node]; e < edge_start[node + 1]; e++) {
+                self_edge |= edges[e] == node;
+            }
+            
+            if (component.size() == 1 && !self_edge) {
+                if (!infer_symbol_type(symbol_arena[component[0]])) {
+                    failed.push_back(component[0]);
+                    all_resolved = false;
+                }
+                continue;
+            }
+            
+            std::sort(component.begin(), component.end());
+            cycles.push_back(std::move(component));
+            all_resolved = false;
+        }
     }
     
-    LOG_DEBUG("Type resolution completed successfully", LogCategory::SEMANTIC);
     return all_resolved;
 }
 
 bool SymbolTable::resolve_symbol_type(const std::string& name) {
     // Find the symbol in any scope
-    std::shared_ptr<Symbol> symbol = nullptr;
+    Symbol* symbol = nullptr;
     int symbol_scope_id = -1;
+    NameId name_id = names.find(name);
     
-    for (int scope_id = 0; scope_id < all_scopes.size(); scope_id++) {
-        auto it = all_scopes[scope_id].symbols.find(name);
-        if (it != all_scopes[scope_id].symbols.end()) {
-            symbol = it->second;
+    for (int scope_id = 0; name_id != INVALID_NAME_ID && scope_id < static_cast<int>(all_scopes.size()); scope_id++) {
+        SymbolId found = all_scopes[scope_id].symbols.find(name_id);
+        if (found != INVALID_SYMBOL_ID) {
+            symbol = &symbol_arena[found];
             symbol_scope_id = scope_id;
             break;
         }
@@ -430,7 +872,8 @@ bool SymbolTable::resolve_symbol_type(const std::string& name) {
     symbol->resolution_state = TypeResolutionState::RESOLVING;
     
     // Resolve dependencies first - need to search in the symbol's scope context
-    for (const std::string& dep : symbol->dependencies) {
+    for (NameId dep_id : symbol->dependencies) {
+        std::string dep(names.str(dep_id));
         if (!resolve_symbol_type_in_context(dep, symbol_scope_id)) {
             LOG_ERROR("Failed to resolve dependency '" + dep + "' for symbol '" + name + "'", LogCategory::SEMANTIC);
             symbol->resolution_state = TypeResolutionState::UNRESOLVED;
@@ -438,26 +881,38 @@ bool SymbolTable::resolve_symbol_type(const std::string& name) {
         }
     }
     
-    // Infer type from initializer expression
-    if (symbol->initializer_expression) {
-        std::string inferred_type = infer_type_from_expression_in_context(symbol->initializer_expression, symbol_scope_id);
+    if (!infer_symbol_type(*symbol)) {
+        LOG_ERROR("Cannot infer type for symbol: " + name, LogCategory::SEMANTIC);
+        return false;
+    }
+    return true;
+}
+
+// Infers the symbol's type from its initializer, read in the symbol's own scope.
+// Every dependency must already be resolved. The inferred name is a literal or
+// already interned, so nothing is added to the interner and distinct symbols
+// can be inferred from several threads.
+bool SymbolTable::infer_symbol_type(Symbol& symbol) {
+    std::string name(symbol.name);
+    if (symbol.initializer_expression) {
+        std::string_view inferred_view = infer_expression_type(symbol.initializer_expression, symbol.scope_level);
+        std::string inferred_type(inferred_view);
         if (inferred_type != "unresolved") {
             try {
-                symbol->data_type = string_to_ir_type(inferred_type);
-                symbol->type_name = inferred_type;
-                symbol->resolution_state = TypeResolutionState::RESOLVED;
+                symbol.data_type = string_to_ir_type(inferred_type);
+                symbol.type_name = inferred_view;
+                symbol.resolution_state = TypeResolutionState::RESOLVED;
                 LOG_DEBUG("Resolved symbol '" + name + "' to type '" + inferred_type + "'", LogCategory::SEMANTIC);
                 return true;
             } catch (const std::runtime_error& e) {
                 LOG_ERROR("Error converting inferred type '" + inferred_type + "' to IR type for symbol '" + name + "': " + e.what(), LogCategory::SEMANTIC);
-                symbol->resolution_state = TypeResolutionState::UNRESOLVED;
+                symbol.resolution_state = TypeResolutionState::UNRESOLVED;
                 return false;
             }
         }
     }
     
-    LOG_ERROR("Cannot infer type for symbol: " + name, LogCategory::SEMANTIC);
-    symbol->resolution_state = TypeResolutionState::UNRESOLVED;
+    symbol.resolution_state = TypeResolutionState::UNRESOLVED;
     return false;
 }
 
@@ -466,32 +921,61 @@ bool SymbolTable::resolve_symbol_type_in_context(const std::string& name, int co
     return resolve_symbol_type(name);
 }
 
-std::shared_ptr<Symbol> SymbolTable::lookup_symbol_in_context(const std::string& name, int context_scope_id) {
+Symbol* SymbolTable::lookup_symbol_in_context(std::string_view name, int context_scope_id) {
+    SymbolId found = lookup_symbol_id_in_context(context_scope_id, names.find(name));
+    return found != INVALID_SYMBOL_ID ? &symbol_arena[found] : nullptr;
+}
+
+SymbolId SymbolTable::lookup_symbol_id_in_context(int scope_id, NameId name) const {
+    if (name == INVALID_NAME_ID) return INVALID_SYMBOL_ID;
+
     // Search from the given scope up through parent chain
-    int current_scope_id = context_scope_id;
-    
-    while (current_scope_id >= 0 && current_scope_id < all_scopes.size()) {
-        auto it = all_scopes[current_scope_id].symbols.find(name);
-        if (it != all_scopes[current_scope_id].symbols.end()) {
-            return it->second;
+    while (scope_id >= 0 && scope_id < static_cast<int>(all_scopes.size())) {
+        SymbolId found = all_scopes[scope_id].symbols.find(name);
+        if (found != INVALID_SYMBOL_ID) {
+            return found;
         }
-        // Move to parent scope
-        current_scope_id = all_scopes[current_scope_id].parent_scope_id;
+        scope_id = all_scopes[scope_id].parent_scope_id;
     }
     
-    return nullptr;
+    return INVALID_SYMBOL_ID;
 }
 
 std::string SymbolTable::infer_type_from_expression_in_context(ExpressionNode* expr, int context_scope_id) {
+    return std::string(infer_expression_type(expr, context_scope_id));
+}
+
+std::string SymbolTable::infer_type_from_expression(ExpressionNode* expr) {
+    return std::string(infer_expression_type(expr, get_current_scope_id()));
+}
+
+// === EXPRESSION TYPES ===
+static constexpr std::string_view UNRESOLVED_TYPE = "unresolved";
+
+std::string_view SymbolTable::infer_expression_type(ExpressionNode* expr, int context_scope_id) {
     if (!expr) return "void";
     
+    std::string_view cached = expression_types.get(expr);
+    if (!cached.empty()) return cached;
+    
+    std::string_view type = compute_expression_type(expr, context_scope_id);
+    // An unresolved identifier may still resolve while symbols are being resolved
+    if (type != UNRESOLVED_TYPE || expression_types_final) {
+        expression_types[expr] = type;
+    }
+    return type;
+}
+
+// Every type returned here is a literal or a view interned by this table, so
+// results can be stored without copying and compared by content cheaply.
+std::string_view SymbolTable::compute_expression_type(ExpressionNode* expr, int context_scope_id) {
     if (auto* literal = expr->as<LiteralExpressionNode>()) {
         switch (literal->kind) {
             case LiteralKind::Integer: return "i32";
             case LiteralKind::Boolean: return "bool";
             case LiteralKind::String: return "string";
             case LiteralKind::Float: return "f32";
-            default: return "unresolved";
+            default: return UNRESOLVED_TYPE;
         }
     }
     
@@ -511,18 +995,18 @@ std::string SymbolTable::infer_type_from_expression_in_context(ExpressionNode* e
             // Arithmetic operators return the type of operands
             default:
                 if (auto* left_expr = ast_cast_or_error<ExpressionNode>(binary->left)) {
-                    std::string left_type = infer_type_from_expression_in_context(left_expr, context_scope_id);
-                    if (left_type != "unresolved") {
+                    std::string_view left_type = infer_expression_type(left_expr, context_scope_id);
+                    if (left_type != UNRESOLVED_TYPE) {
                         return left_type;
                     }
                 }
                 if (auto* right_expr = ast_cast_or_error<ExpressionNode>(binary->right)) {
-                    std::string right_type = infer_type_from_expression_in_context(right_expr, context_scope_id);
-                    if (right_type != "unresolved") {
+                    std::string_view right_type = infer_expression_type(right_expr, context_scope_id);
+                    if (right_type != UNRESOLVED_TYPE) {
                         return right_type;
                     }
                 }
-                return "unresolved";
+                return UNRESOLVED_TYPE;
         }
     }
     
@@ -533,334 +1017,221 @@ std::string SymbolTable::infer_type_from_expression_in_context(ExpressionNode* e
             case UnaryOperatorKind::Minus:
             case UnaryOperatorKind::Plus:
                 if (auto* operand_expr = ast_cast_or_error<ExpressionNode>(unary->operand)) {
-                    return infer_type_from_expression_in_context(operand_expr, context_scope_id);
+                    return infer_expression_type(operand_expr, context_scope_id);
                 }
-                return "unresolved";
+                return UNRESOLVED_TYPE;
             default:
-                return "unresolved";
+                return UNRESOLVED_TYPE;
         }
     }
     
     if (auto* identifier = expr->as<IdentifierExpressionNode>()) {
-        std::string var_name = std::string(identifier->identifier->name);
-        auto symbol = lookup_symbol_in_context(var_name, context_scope_id);
+        auto symbol = lookup_symbol_in_context(identifier->identifier->name, context_scope_id);
         if (symbol && symbol->resolution_state == TypeResolutionState::RESOLVED) {
             return symbol->type_name;
         }
-        return "unresolved";
+        return UNRESOLVED_TYPE;
+    }
+    
+    if (expr->is_a<ThisExpressionNode>()) {
+        auto symbol = lookup_symbol_in_context("this", context_scope_id);
+        return symbol ? symbol->type_name : UNRESOLVED_TYPE;
     }
     
     if (auto* call = expr->as<CallExpressionNode>()) {
-        if (auto* target_ident = call->target->as<IdentifierExpressionNode>()) {
+        if (auto* target_ident = node_cast<IdentifierExpressionNode>(call->target)) {
             // Regular function call: func()
-            std::string func_name = std::string(target_ident->identifier->name);
-            auto symbol = lookup_symbol_in_context(func_name, context_scope_id);
+            auto symbol = lookup_symbol_in_context(target_ident->identifier->name, context_scope_id);
             if (symbol && symbol->type == SymbolType::FUNCTION && symbol->resolution_state == TypeResolutionState::RESOLVED) {
                 return symbol->type_name;
             }
-        } else if (auto* member_access = call->target->as<MemberAccessExpressionNode>()) {
+        } else if (auto* member_access = node_cast<MemberAccessExpressionNode>(call->target)) {
             // Member function call: obj.method()
-            std::string target_type = infer_type_from_expression_in_context(member_access->target, context_scope_id);
-            if (target_type != "unresolved") {
+            std::string_view target_type = infer_expression_type(member_access->target, context_scope_id);
+            if (target_type != UNRESOLVED_TYPE) {
                 // Find the type scope for the target
-                int type_scope_id = find_scope_by_name(target_type);
+                int type_scope_id = find_type_scope(target_type);
                 if (type_scope_id != -1) {
                     // Look up the member function in the type scope
-                    std::string method_name = std::string(member_access->member->name);
-                    auto method_symbol = lookup_symbol_in_scope(type_scope_id, method_name);
+                    auto method_symbol = lookup_symbol_in_scope(type_scope_id, member_access->member->name);
                     if (method_symbol && method_symbol->type == SymbolType::FUNCTION && method_symbol->resolution_state == TypeResolutionState::RESOLVED) {
                         return method_symbol->type_name;
                     }
                 }
             }
         }
-        return "unresolved";
+        return UNRESOLVED_TYPE;
     }
     
     if (auto* assignment = expr->as<AssignmentExpressionNode>()) {
         if (auto* source_expr = ast_cast_or_error<ExpressionNode>(assignment->source)) {
-            return infer_type_from_expression_in_context(source_expr, context_scope_id);
+            return infer_expression_type(source_expr, context_scope_id);
         }
-        return "unresolved";
+        return UNRESOLVED_TYPE;
     }
     
     if (auto* new_expr = expr->as<NewExpressionNode>()) {
-        if (new_expr->type) {
-            // Get the type name from the TypeNameNode
-            if (new_expr->type->identifier) {
-                std::string type_name = std::string(new_expr->type->identifier->name);
-                // Check if it's a known type in the symbol table
-                auto symbol = lookup_symbol_in_context(type_name, context_scope_id);
-                if (symbol && (symbol->type == SymbolType::CLASS || symbol->type == SymbolType::ENUM)) {
-                    return type_name;
-                }
+        if (new_expr->type && new_expr->type->identifier) {
+            // Check if it's a known type in the symbol table
+            auto symbol = lookup_symbol_in_context(new_expr->type->identifier->name, context_scope_id);
+            if (symbol && (symbol->type == SymbolType::CLASS || symbol->type == SymbolType::ENUM)) {
+                return symbol->name;
             }
         }
-        return "unresolved";
+        return UNRESOLVED_TYPE;
     }
     
+    if (expr->is_a<SizeOfExpressionNode>()) return "i32";
+    if (expr->is_a<TypeOfExpressionNode>()) return "string";
+    
     if (auto* member_access = expr->as<MemberAccessExpressionNode>()) {
+        // A case of an enum, e.g. Mode.Hover, has the enum's type
+        if (auto* target_ident = member_access->target->as<IdentifierExpressionNode>()) {
+            auto target_symbol = lookup_symbol_in_context(target_ident->identifier->name, context_scope_id);
+            if (target_symbol && target_symbol->type == SymbolType::ENUM) {
+                int enum_scope_id = find_type_scope(target_symbol->name);
+                bool is_case = enum_scope_id != -1 && lookup_symbol_in_scope(enum_scope_id, member_access->member->name);
+                return is_case ? target_symbol->name : UNRESOLVED_TYPE;
+            }
+        }
+        
         // Get target type (e.g., "Player" for p.b where p is Player)
-        std::string target_type = infer_type_from_expression_in_context(member_access->target, context_scope_id);
-        if (target_type == "unresolved") return "unresolved";
+        std::string_view target_type = infer_expression_type(member_access->target, context_scope_id);
+        if (target_type == UNRESOLVED_TYPE) return UNRESOLVED_TYPE;
         
         // Find struct scope for the target type
-        int struct_scope_id = find_scope_by_name(target_type);
-        if (struct_scope_id == -1) return "unresolved";
+        int struct_scope_id = find_type_scope(target_type);
+        if (struct_scope_id == -1) return UNRESOLVED_TYPE;
         
         // Look up field in struct scope
-        std::string field_name = std::string(member_access->member->name);
-        auto field_symbol = lookup_symbol_in_scope(struct_scope_id, field_name);
+        auto field_symbol = lookup_symbol_in_scope(struct_scope_id, member_access->member->name);
         if (field_symbol && field_symbol->resolution_state == TypeResolutionState::RESOLVED) {
             return field_symbol->type_name;  // Returns field type (e.g., "i32" for Player.b)
         }
-        return "unresolved";
+        return UNRESOLVED_TYPE;
     }
     
     // Default for unknown expressions
-    return "unresolved";
+    return UNRESOLVED_TYPE;
 }
 
-std::string SymbolTable::infer_type_from_expression(ExpressionNode* expr) {
-    if (!expr) return "void";
+std::string_view SymbolTable::get_expression_type(const ExpressionNode* expr) const {
+    return expr ? expression_types.get(expr) : std::string_view();
+}
+
+void SymbolTable::set_node_scope(const AstNode* node, int scope_id) {
+    node_scopes[node] = scope_id;
+}
+
+int SymbolTable::get_node_scope(const AstNode* node) const {
+    return node ? node_scopes.get(node) : -1;
+}
+
+// Appends to one vector rather than concatenating per-node vectors, which
+// copied every name once per level of nesting.
+static void collect_dependencies(ExpressionNode* expr, std::vector<std::string>& dependencies) {
+    if (!expr) return;
     
-    if (auto* literal = expr->as<LiteralExpressionNode>()) {
-        switch (literal->kind) {
-            case LiteralKind::Integer: return "i32";
-            case LiteralKind::Boolean: return "bool";
-            case LiteralKind::String: return "string";
-            case LiteralKind::Float: return "f32";
-            default: return "unresolved";
-        }
+    if (auto* identifier = expr->as<IdentifierExpressionNode>()) {
+        dependencies.emplace_back(identifier->identifier->name);
+        return;
     }
     
     if (auto* binary = expr->as<BinaryExpressionNode>()) {
-        switch (binary->opKind) {
-            // Comparison and logical operators return bool
-            case BinaryOperatorKind::LessThan:
-            case BinaryOperatorKind::LessThanOrEqual:
-            case BinaryOperatorKind::GreaterThan:
-            case BinaryOperatorKind::GreaterThanOrEqual:
-            case BinaryOperatorKind::Equals:
-            case BinaryOperatorKind::NotEquals:
-            case BinaryOperatorKind::LogicalAnd:
-            case BinaryOperatorKind::LogicalOr:
-                return "bool";
-            
-            // Arithmetic operators return the type of operands
-            default:
-                if (auto* left_expr = ast_cast_or_error<ExpressionNode>(binary->left)) {
-                    std::string left_type = infer_type_from_expression(left_expr);
-                    if (left_type != "unresolved") {
-                        return left_type;
-                    }
-                }
-                if (auto* right_expr = ast_cast_or_error<ExpressionNode>(binary->right)) {
-                    std::string right_type = infer_type_from_expression(right_expr);
-                    if (right_type != "unresolved") {
-                        return right_type;
-                    }
-                }
-                return "unresolved";
-        }
+        collect_dependencies(ast_cast_or_error<ExpressionNode>(binary->left), dependencies);
+        collect_dependencies(ast_cast_or_error<ExpressionNode>(binary->right), dependencies);
+        return;
     }
     
     if (auto* unary = expr->as<UnaryExpressionNode>()) {
-        switch (unary->opKind) {
-            case UnaryOperatorKind::Not:
-                return "bool";
-            case UnaryOperatorKind::Minus:
-            case UnaryOperatorKind::Plus:
-                if (auto* operand_expr = ast_cast_or_error<ExpressionNode>(unary->operand)) {
-                    return infer_type_from_expression(operand_expr);
-                }
-                return "unresolved";
-            default:
-                return "unresolved";
-        }
-    }
-    
-    if (auto* identifier = expr->as<IdentifierExpressionNode>()) {
-        std::string var_name = std::string(identifier->identifier->name);
-        auto symbol = lookup_symbol(var_name);
-        if (symbol && symbol->resolution_state == TypeResolutionState::RESOLVED) {
-            return symbol->type_name;
-        }
-        return "unresolved";
-    }
-    
-    if (auto* call = expr->as<CallExpressionNode>()) {
-        if (auto* target_ident = call->target->as<IdentifierExpressionNode>()) {
-            // Regular function call: func()
-            std::string func_name = std::string(target_ident->identifier->name);
-            auto symbol = lookup_symbol(func_name);
-            if (symbol && symbol->type == SymbolType::FUNCTION && symbol->resolution_state == TypeResolutionState::RESOLVED) {
-                return symbol->type_name;
-            }
-        } else if (auto* member_access = call->target->as<MemberAccessExpressionNode>()) {
-            // Member function call: obj.method()
-            std::string target_type = infer_type_from_expression(member_access->target);
-            if (target_type != "unresolved") {
-                // Find the type scope for the target
-                int type_scope_id = find_scope_by_name(target_type);
-                if (type_scope_id != -1) {
-                    // Look up the member function in the type scope
-                    std::string method_name = std::string(member_access->member->name);
-                    auto method_symbol = lookup_symbol_in_scope(type_scope_id, method_name);
-                    if (method_symbol && method_symbol->type == SymbolType::FUNCTION && method_symbol->resolution_state == TypeResolutionState::RESOLVED) {
-                        return method_symbol->type_name;
-                    }
-                }
-            }
-        }
-        return "unresolved";
-    }
-    
-    if (auto* assignment = expr->as<AssignmentExpressionNode>()) {
-        if (auto* source_expr = ast_cast_or_error<ExpressionNode>(assignment->source)) {
-            return infer_type_from_expression(source_expr);
-        }
-        return "unresolved";
-    }
-    
-    if (auto* new_expr = expr->as<NewExpressionNode>()) {
-        if (new_expr->type) {
-            // Get the type name from the TypeNameNode
-            if (new_expr->type->identifier) {
-                std::string type_name = std::string(new_expr->type->identifier->name);
-                // Check if it's a known type in the symbol table
-                auto symbol = lookup_symbol(type_name);
-                if (symbol && (symbol->type == SymbolType::CLASS || symbol->type == SymbolType::ENUM)) {
-                    return type_name;
-                }
-            }
-        }
-        return "unresolved";
-    }
-    
-    if (auto* member_access = expr->as<MemberAccessExpressionNode>()) {
-        // Get target type (e.g., "Player" for p.b where p is Player)
-        std::string target_type = infer_type_from_expression(member_access->target);
-        if (target_type == "unresolved") return "unresolved";
-        
-        // Find struct scope for the target type
-        int struct_scope_id = find_scope_by_name(target_type);
-        if (struct_scope_id == -1) return "unresolved";
-        
-        // Look up field in struct scope
-        std::string field_name = std::string(member_access->member->name);
-        auto field_symbol = lookup_symbol_in_scope(struct_scope_id, field_name);
-        if (field_symbol && field_symbol->resolution_state == TypeResolutionState::RESOLVED) {
-            return field_symbol->type_name;  // Returns field type (e.g., "i32" for Player.b)
-        }
-        return "unresolved";
-    }
-    
-    // Default for unknown expressions
-    return "unresolved";
-}
-
-std::vector<std::string> SymbolTable::extract_dependencies(ExpressionNode* expr) {
-    std::vector<std::string> dependencies;
-    
-    if (!expr) return dependencies;
-    
-    if (auto* identifier = expr->as<IdentifierExpressionNode>()) {
-        std::string var_name = std::string(identifier->identifier->name);
-        dependencies.push_back(var_name);
-        return dependencies;
-    }
-    
-    if (auto* binary = expr->as<BinaryExpressionNode>()) {
-        if (auto* left_expr = ast_cast_or_error<ExpressionNode>(binary->left)) {
-            auto left_deps = extract_dependencies(left_expr);
-            dependencies.insert(dependencies.end(), left_deps.begin(), left_deps.end());
-        }
-        if (auto* right_expr = ast_cast_or_error<ExpressionNode>(binary->right)) {
-            auto right_deps = extract_dependencies(right_expr);
-            dependencies.insert(dependencies.end(), right_deps.begin(), right_deps.end());
-        }
-        return dependencies;
-    }
-    
-    if (auto* unary = expr->as<UnaryExpressionNode>()) {
-        if (auto* operand_expr = ast_cast_or_error<ExpressionNode>(unary->operand)) {
-            return extract_dependencies(operand_expr);
-        }
-        return dependencies;
+        collect_dependencies(ast_cast_or_error<ExpressionNode>(unary->operand), dependencies);
+        return;
     }
     
     if (auto* call = expr->as<CallExpressionNode>()) {
         // Add function name as dependency
-        if (auto* target_ident = call->target->as<IdentifierExpressionNode>()) {
+        if (auto* target_ident = node_cast<IdentifierExpressionNode>(call->target)) {
             // Simple function call: func()
-            std::string func_name = std::string(target_ident->identifier->name);
-            dependencies.push_back(func_name);
-        } else if (auto* member_access = call->target->as<MemberAccessExpressionNode>()) {
+            dependencies.emplace_back(target_ident->identifier->name);
+        } else if (auto* member_access = node_cast<MemberAccessExpressionNode>(call->target)) {
             // Member function call: obj.method() - add target object dependency
-            auto target_deps = extract_dependencies(member_access->target);
-            dependencies.insert(dependencies.end(), target_deps.begin(), target_deps.end());
+            collect_dependencies(member_access->target, dependencies);
         }
         
         // Add argument dependencies
         for (int i = 0; i < call->arguments.size; i++) {
-            if (auto* arg_expr = ast_cast_or_error<ExpressionNode>(call->arguments.values[i])) {
-                auto arg_deps = extract_dependencies(arg_expr);
-                dependencies.insert(dependencies.end(), arg_deps.begin(), arg_deps.end());
-            }
+            collect_dependencies(ast_cast_or_error<ExpressionNode>(call->arguments.values[i]), dependencies);
         }
-        return dependencies;
+        return;
     }
     
     if (auto* assignment = expr->as<AssignmentExpressionNode>()) {
-        if (auto* source_expr = ast_cast_or_error<ExpressionNode>(assignment->source)) {
-            return extract_dependencies(source_expr);
-        }
-        return dependencies;
+        collect_dependencies(ast_cast_or_error<ExpressionNode>(assignment->source), dependencies);
+        return;
     }
     
     if (auto* new_expr = expr->as<NewExpressionNode>()) {
         // Add the type as a dependency
         if (new_expr->type && new_expr->type->identifier) {
-            std::string type_name = std::string(new_expr->type->identifier->name);
-            dependencies.push_back(type_name);
+            dependencies.emplace_back(new_expr->type->identifier->name);
         }
         
         // If there's a constructor call, add argument dependencies
         if (new_expr->constructorCall) {
             for (int i = 0; i < new_expr->constructorCall->arguments.size; i++) {
-                if (auto* arg_expr = ast_cast_or_error<ExpressionNode>(new_expr->constructorCall->arguments.values[i])) {
-                    auto arg_deps = extract_dependencies(arg_expr);
-                    dependencies.insert(dependencies.end(), arg_deps.begin(), arg_deps.end());
-                }
+                collect_dependencies(ast_cast_or_error<ExpressionNode>(new_expr->constructorCall->arguments.values[i]), dependencies);
             }
         }
-        
-        return dependencies;
+        return;
     }
     
     if (auto* member_access = expr->as<MemberAccessExpressionNode>()) {
         // Add dependencies from the target (e.g., for p.b, add dependency on p)
-        if (member_access->target) {
-            auto target_deps = extract_dependencies(member_access->target);
-            dependencies.insert(dependencies.end(), target_deps.begin(), target_deps.end());
-        }
-        
         // Note: We don't need to add the struct type as a dependency here 
         // because the target variable (like 'p') already depends on it
-        
-        return dependencies;
+        collect_dependencies(member_access->target, dependencies);
+        return;
     }
     
     // For other expression types (literals, etc.), no dependencies
+}
+
+std::vector<std::string> SymbolTable::extract_dependencies(ExpressionNode* expr) {
+    std::vector<std::string> dependencies;
+    collect_dependencies(expr, dependencies);
     return dependencies;
 }
 
 using namespace Mycelium::Scripting::Lang;
 
-class SymbolTableBuilder {
+// One building step. Function bodies are walked off the main thread, so their
+// steps are recorded there and replayed into the table in source order.
+struct DeclarationStep {
+    enum class Kind { EnterScope, EnterNamedScope, ExitScope, Declare, DeclareInferred, PinFieldOrder, MarkEnum, ImportLayout };
+    
+    Kind kind;
+    const AstNode* node = nullptr;      // Node opening the scope, or the declared name to bind; none for imports
+    ScopeKind scope_kind = ScopeKind::BLOCK;
+    std::string name;
+    SymbolType symbol_type = SymbolType::VARIABLE;
+    IRType data_type;                   // Declare, or the struct for ImportLayout
+    std::string type_name;
+    ExpressionNode* initializer = nullptr;
+    bool cases_carry_data = false;      // MarkEnum
+    
+    explicit DeclarationStep(Kind step_kind) : kind(step_kind) {}
+};
+
+class SymbolTableBuilder : public AstWalker<SymbolTableBuilder> {
 private:
     SymbolTable& symbol_table;
+    std::vector<DeclarationStep>* recording = nullptr;           // Steps go here instead of the table when set
+    const NodeSideTable<uint8_t>* deferred_bodies = nullptr;     // Functions whose bodies are declared later
+    
+    // Top-level names the script declares, and the module each imported name came from
+    std::unordered_map<std::string_view, DeclarationNode*> script_names;
+    std::unordered_map<std::string_view, std::string_view> imported_names;
+    AstNode* root_node = nullptr;
     
     std::string get_type_string(TypeNameNode* type_node) {
         if (!type_node) return ""; // Return empty string to indicate no explicit type
@@ -901,38 +1272,240 @@ private:
         throw std::runtime_error("Unknown TypeNameNode type");
     }
     
-    void visit_declaration(DeclarationNode* node) {
-        if (!node) return;
+    // === BUILDING STEPS ===
+    // Every change to the table goes through these, so a recording builder
+    // touches nothing but its own step list and read-only table queries.
+    void step(DeclarationStep&& building_step) {
+        if (recording) {
+            recording->push_back(std::move(building_step));
+        } else {
+            apply(building_step);
+        }
+    }
+    
+    void open_scope(const AstNode* node, ScopeKind kind, std::string name = "") {
+        DeclarationStep building_step{name.empty() ? DeclarationStep::Kind::EnterScope : DeclarationStep::Kind::EnterNamedScope};
+        building_step.node = node;
+        building_step.scope_kind = kind;
+        building_step.name = std::move(name);
+        step(std::move(building_step));
+    }
+    
+    void close_scope() {
+        step(DeclarationStep{DeclarationStep::Kind::ExitScope});
+    }
+    
+    void declare(std::string name, const IdentifierNode* name_node, SymbolType type, const IRType& data_type, std::string type_name) {
+        DeclarationStep building_step{DeclarationStep::Kind::Declare};
+        building_step.node = name_node;
+        building_step.name = std::move(name);
+        building_step.symbol_type = type;
+        building_step.data_type = data_type;
+        building_step.type_name = std::move(type_name);
+        step(std::move(building_step));
+    }
+    
+    void declare_inferred(std::string name, const IdentifierNode* name_node, ExpressionNode* initializer) {
+        DeclarationStep building_step{DeclarationStep::Kind::DeclareInferred};
+        building_step.node = name_node;
+        building_step.name = std::move(name);
+        building_step.initializer = initializer;
+        step(std::move(building_step));
+    }
+    
+    void walk_body(FunctionDeclarationNode* node) {
+        if (!node->body || (deferred_bodies && deferred_bodies->get(node))) return;
         
-        if (auto type_decl = node->as<TypeDeclarationNode>()) {
-            visit_type_declaration(type_decl);
-        } else if (auto interface_decl = node->as<InterfaceDeclarationNode>()) {
-            visit_interface_declaration(interface_decl);
-        } else if (auto enum_decl = node->as<EnumDeclarationNode>()) {
-            visit_enum_declaration(enum_decl);
-        } else if (auto func_decl = node->as<FunctionDeclarationNode>()) {
-            visit_function_declaration(func_decl);
-        } else if (auto var_decl = node->as<VariableDeclarationNode>()) {
-            visit_variable_declaration(var_decl);
-        } else if (auto ns_decl = node->as<NamespaceDeclarationNode>()) {
-            visit_namespace_declaration(ns_decl);
-        }
-    }
-    
-    void visit_type_declaration(TypeDeclarationNode* node) {
+        // Walk the statements directly: the function scope already holds the body's names
+        for (int i = 0; i < node->body->statements.size; i++) {
+            if (auto* stmt = ast_cast_or_error<StatementNode>(node->body->statements.values[i])) {
+                walk(stmt);
+            }
+        }
+    }
+    
+    void declare_parameters(FunctionDeclarationNode* node) {
+        for (int i = 0; i < node->parameters.size; i++) {
+            LOG_DEBUG("Parameter " + std::to_string(i) + " has type ID: " + std::to_string((int)node->parameters.values[i]->typeId), LogCategory::SEMANTIC);
+            if (auto* param = ast_cast_or_error<ParameterNode>(node->parameters.values[i])) {
+                std::string param_type_str = get_type_string(param->type);
+                IRType param_ir_type = symbol_table.string_to_ir_type(param_type_str);
+                declare(std::string(param->name->name), param->name, SymbolType::PARAMETER, param_ir_type, param_type_str);
+            }
+        }
+    }
+    
+    void visit_member_function_declaration(FunctionDeclarationNode* node, const std::string& owner_type) {
+        std::string func_name = std::string(node->name->name);
+        std::string return_type_str = return_type_of(node);
+        
+        IRType return_ir_type = symbol_table.string_to_ir_type(return_type_str);
+        
+        // Register the member function in the current (type) scope
+        declare(func_name, node->name, SymbolType::FUNCTION, return_ir_type, return_type_str);
+        
+        // Entered from the type scope, so the table links it to its owner type
+        open_scope(node, ScopeKind::FUNCTION, func_name);
+        
+        LOG_DEBUG("Member function '" + func_name + "' in type '" + owner_type + "' has " + std::to_string(node->parameters.size) + " parameters", LogCategory::SEMANTIC);
+        
+        // Add implicit 'this' parameter for member functions
+        // 'this' is a pointer to the owner type
+        IRType this_type = IRType::ptr_to(symbol_table.string_to_ir_type(owner_type));
+        declare("this", nullptr, SymbolType::PARAMETER, this_type, owner_type + "*");
+        
+        // Process explicit parameters
+        declare_parameters(node);
+        
+        // Process function body - member functions can access type fields without qualification
+        walk_body(node);
+        
+        close_scope();
+    }
+
+    // === IMPORTED DECLARATIONS ===
+    // Declared like their source would be, but bound to no node and with no bodies
+    void declare_imported_function(const ModuleInterface::Declaration& function, const std::string& owner_type = "") {
+        declare(function.name, nullptr, SymbolType::FUNCTION, symbol_table.string_to_ir_type(function.type_name), function.type_name);
+        open_scope(nullptr, ScopeKind::FUNCTION, function.name);
+        if (!owner_type.empty()) {
+            declare("this", nullptr, SymbolType::PARAMETER, IRType::ptr_to(symbol_table.string_to_ir_type(owner_type)), owner_type + "*");
+        }
+        for (const ModuleInterface::Member& parameter : function.members) {
+            declare(parameter.name, nullptr, SymbolType::PARAMETER, symbol_table.string_to_ir_type(parameter.type_name), parameter.type_name);
+        }
+        close_scope();
+    }
+    
+    // A name the script or an earlier module already declares is reported, not shadowed
+    void declare_imported(const ModuleInterface::Declaration& declaration, const ModuleInterface& module) {
+        if (auto local = script_names.find(declaration.name); local != script_names.end()) {
+            diagnostics.push_back({ local->second, "'" + declaration.name + "' is declared both here and by module '" + module.name + "'" });
+            return;
+        }
+        if (auto [earlier, first] = imported_names.emplace(declaration.name, module.name); !first) {
+            diagnostics.push_back({ root_node, "'" + declaration.name + "' is declared by both module '" + std::string(earlier->second) +
+                                               "' and module '" + module.name + "'" });
+            return;
+        }
+        
+        using Kind = ModuleInterface::Declaration::Kind;
+        if (declaration.kind == Kind::Function) {
+            declare_imported_function(declaration);
+            return;
+        }
+        
+        if (declaration.kind == Kind::Enum) {
+            declare(declaration.name, nullptr, SymbolType::ENUM, IRType::i32(), "enum");
+            open_scope(nullptr, ScopeKind::TYPE, declaration.name);
+            for (const ModuleInterface::Member& enum_case : declaration.members) {
+                declare(enum_case.name, nullptr, SymbolType::VARIABLE, IRType::i32(), "enum case");
+            }
+            DeclarationStep mark{DeclarationStep::Kind::MarkEnum};
+            mark.cases_carry_data = declaration.flag;
+            step(std::move(mark));
+            // Enum methods take no 'this', as in visit(EnumDeclarationNode*)
+            for (const ModuleInterface::Declaration& method : declaration.methods) declare_imported_function(method);
+            close_scope();
+            return;
+        }
+        
+        declare(declaration.name, nullptr, SymbolType::CLASS, IRType::ptr(), declaration.type_name);
+        open_scope(nullptr, ScopeKind::TYPE, declaration.name);
+        if (declaration.flag) step(DeclarationStep{DeclarationStep::Kind::PinFieldOrder});
+        for (const ModuleInterface::Member& field : declaration.members) {
+            declare(field.name, nullptr, SymbolType::VARIABLE, symbol_table.string_to_ir_type(field.type_name), field.type_name);
+        }
+        if (!declaration.layout.empty()) {
+            // Rebuild the exporter's layout, so both sides agree whatever this table's policy
+            std::vector<StructLayout::Field> fields;
+            for (const ModuleInterface::LayoutSlot& slot : declaration.layout) {
+                const ModuleInterface::Member& member = declaration.members[slot.field];
+                StructLayout::Field field;
+                field.name = member.name;
+                field.type = symbol_table.string_to_ir_type(member.type_name);
+                field.offset = 0; // Calculated by the type context
+                field.bit_width = slot.bit_width;
+                fields.push_back(field);
+            }
+            IRType struct_type = TypeContext::global().struct_type(declaration.name, fields);
+            const StructLayout* layout = struct_type.struct_layout();
+            if (layout && layout->total_size == declaration.size && layout->alignment == declaration.alignment) {
+                DeclarationStep layout_step{DeclarationStep::Kind::ImportLayout};
+                layout_step.data_type = struct_type;
+                step(std::move(layout_step));
+            } else {
+                LOG_ERROR("Imported type '" + declaration.name + "' does not lay out as it was exported", LogCategory::SEMANTIC);
+            }
+        }
+        bool is_interface = declaration.type_name == "interface";
+        for (const ModuleInterface::Declaration& method : declaration.methods) {
+            declare_imported_function(method, is_interface ? "" : declaration.name);
+        }
+        close_scope();
+    }
+
+public:
+    std::vector<AstPassDiagnostic> diagnostics;  // Names an import clashes on
+    
+    SymbolTableBuilder(SymbolTable& table, const NodeSideTable<uint8_t>* deferred = nullptr)
+        : symbol_table(table), deferred_bodies(deferred) {}
+
+    // Node types without a handler below declare nothing
+    template <typename T> void visit(T*) {}
+
+    // Applies one step to the table, binding declared names to their new symbols
+    void apply(const DeclarationStep& building_step) {
+        switch (building_step.kind) {
+            case DeclarationStep::Kind::EnterScope:
+                symbol_table.enter_scope(building_step.scope_kind);
+                if (building_step.node) symbol_table.set_node_scope(building_step.node, symbol_table.get_current_scope_level());
+                return;
+            case DeclarationStep::Kind::EnterNamedScope:
+                symbol_table.enter_named_scope(building_step.name, building_step.scope_kind);
+                if (building_step.node) symbol_table.set_node_scope(building_step.node, symbol_table.get_current_scope_level());
+                return;
+            case DeclarationStep::Kind::ExitScope:
+                symbol_table.exit_scope();
+                return;
+            case DeclarationStep::Kind::PinFieldOrder:
+                symbol_table.pin_field_order(symbol_table.get_current_scope_level());
+                return;
+            case DeclarationStep::Kind::MarkEnum:
+                symbol_table.mark_enum_scope(symbol_table.get_current_scope_level(), building_step.cases_carry_data);
+                return;
+            case DeclarationStep::Kind::ImportLayout:
+                symbol_table.set_imported_layout(symbol_table.get_current_scope_level(), building_step.data_type);
+                return;
+            case DeclarationStep::Kind::Declare:
+                symbol_table.declare_symbol(building_step.name, building_step.symbol_type, building_step.data_type, building_step.type_name);
+                break;
+            case DeclarationStep::Kind::DeclareInferred:
+                symbol_table.declare_unresolved_symbol(building_step.name, SymbolType::VARIABLE, building_step.initializer);
+                break;
+        }
+        
+        if (building_step.node) {
+            int scope_id = symbol_table.get_current_scope_level();
+            symbol_table.bind_name(building_step.node, symbol_table.lookup_symbol_id_in_scope(scope_id, symbol_table.find_name(building_step.name)));
+        }
+    }
+
+    void visit(TypeDeclarationNode* node) {
         std::string type_name = std::string(node->name->name);
-        // Check modifiers to determine if it's a ref type (class) or value type (struct)
+        // Check modifiers to determine if it's a ref type (class) or value type (struct),
+        // and whether its layout has to match C
         bool is_ref_type = false;
+        bool is_extern = false;
         for (int i = 0; i < node->modifiers.size; i++) {
-            if (node->modifiers.values[i] == ModifierKind::Ref) {
-                is_ref_type = true;
-                break;
-            }
+            if (node->modifiers.values[i] == ModifierKind::Ref) is_ref_type = true;
+            if (node->modifiers.values[i] == ModifierKind::Extern) is_extern = true;
         }
         IRType class_ir_type = IRType::ptr(); // Classes are reference types
-        symbol_table.declare_symbol(type_name, SymbolType::CLASS, class_ir_type, is_ref_type ? "ref type" : "type");
+        declare(type_name, node->name, SymbolType::CLASS, class_ir_type, is_ref_type ? "ref type" : "type");
         
-        symbol_table.enter_named_scope(type_name);
+        open_scope(node, ScopeKind::TYPE, type_name);
+        if (is_extern) step(DeclarationStep{DeclarationStep::Kind::PinFieldOrder});
         
         for (int i = 0; i < node->members.size; i++) {
             if (auto* decl = ast_cast_or_error<DeclarationNode>(node->members.values[i])) {
@@ -940,141 +1513,73 @@ private:
                 if (auto* func_decl = decl->as<FunctionDeclarationNode>()) {
                     visit_member_function_declaration(func_decl, type_name);
                 } else {
-                    visit_declaration(decl);
+                    walk(decl);
                 }
             }
         }
         
-        symbol_table.exit_scope();
+        close_scope();
     }
     
-    void visit_interface_declaration(InterfaceDeclarationNode* node) {
+    void visit(InterfaceDeclarationNode* node) {
         std::string interface_name = std::string(node->name->name);
         IRType interface_ir_type = IRType::ptr(); // Interfaces are reference types
-        symbol_table.declare_symbol(interface_name, SymbolType::CLASS, interface_ir_type, "interface");
+        declare(interface_name, node->name, SymbolType::CLASS, interface_ir_type, "interface");
         
-        symbol_table.enter_named_scope(interface_name);
+        open_scope(node, ScopeKind::TYPE, interface_name);
         
         for (int i = 0; i < node->members.size; i++) {
             if (auto* decl = ast_cast_or_error<DeclarationNode>(node->members.values[i])) {
-                visit_declaration(decl);
+                walk(decl);
             }
         }
         
-        symbol_table.exit_scope();
+        close_scope();
     }
     
-    void visit_enum_declaration(EnumDeclarationNode* node) {
+    void visit(EnumDeclarationNode* node) {
         std::string enum_name = std::string(node->name->name);
         IRType enum_ir_type = IRType::i32(); // Enums are typically integers
-        symbol_table.declare_symbol(enum_name, SymbolType::ENUM, enum_ir_type, "enum");
+        declare(enum_name, node->name, SymbolType::ENUM, enum_ir_type, "enum");
         
-        symbol_table.enter_named_scope(enum_name);
+        open_scope(node, ScopeKind::TYPE, enum_name);
         
         // Handle enum cases
+        DeclarationStep mark{DeclarationStep::Kind::MarkEnum};
         for (int i = 0; i < node->cases.size; i++) {
             if (auto case_node = node->cases.values[i]) {
                 std::string case_name = std::string(case_node->name->name);
                 IRType case_ir_type = IRType::i32(); // Enum cases are integers
-                symbol_table.declare_symbol(case_name, SymbolType::VARIABLE, case_ir_type, "enum case");
+                declare(case_name, case_node->name, SymbolType::VARIABLE, case_ir_type, "enum case");
+                if (case_node->associatedData.size > 0) mark.cases_carry_data = true;
             }
         }
+        step(std::move(mark));
         
         // Handle enum methods
-        for (int i = 0; i < node->methods.size; i++) {
-            visit_function_declaration(node->methods.values[i]);
-        }
+        walk(node->methods);
         
-        symbol_table.exit_scope();
-    }
-    
-    void visit_member_function_declaration(FunctionDeclarationNode* node, const std::string& owner_type) {
-        std::string func_name = std::string(node->name->name);
-        std::string return_type_str = get_type_string(node->returnType);
-        
-        // If no explicit return type, default to void for now
-        // TODO: Implement type inference from return statements
-        if (return_type_str.empty()) {
-            return_type_str = "void";
-        }
-        
-        IRType return_ir_type = symbol_table.string_to_ir_type(return_type_str);
-        
-        // Register the member function in the current (type) scope
-        symbol_table.declare_symbol(func_name, SymbolType::FUNCTION, return_ir_type, return_type_str);
-        
-        // Create a unique scope name for the member function to avoid conflicts
-        std::string member_func_scope_name = owner_type + "::" + func_name;
-        symbol_table.enter_named_scope(member_func_scope_name);
-        
-        LOG_DEBUG("Member function '" + func_name + "' in type '" + owner_type + "' has " + std::to_string(node->parameters.size) + " parameters", LogCategory::SEMANTIC);
-        
-        // Add implicit 'this' parameter for member functions
-        // 'this' is a pointer to the owner type
-        IRType this_type = IRType::ptr_to(symbol_table.string_to_ir_type(owner_type));
-        symbol_table.declare_symbol("this", SymbolType::PARAMETER, this_type, owner_type + "*");
-        
-        // Process explicit parameters
-        for (int i = 0; i < node->parameters.size; i++) {
-            LOG_DEBUG("Parameter " + std::to_string(i) + " has type ID: " + std::to_string((int)node->parameters.values[i]->typeId), LogCategory::SEMANTIC);
-            if (auto* param = ast_cast_or_error<ParameterNode>(node->parameters.values[i])) {
-                std::string param_type_str = get_type_string(param->type);
-                IRType param_ir_type = symbol_table.string_to_ir_type(param_type_str);
-                symbol_table.declare_symbol(std::string(param->name->name), SymbolType::PARAMETER, param_ir_type, param_type_str);
-            }
-        }
-        
-        if (node->body) {
-            // Process function body - member functions can access type fields without qualification
-            for (int i = 0; i < node->body->statements.size; i++) {
-                if (auto* stmt = ast_cast_or_error<StatementNode>(node->body->statements.values[i])) {
-                    visit_statement(stmt);
-                }
-            }
-        }
-        
-        symbol_table.exit_scope();
+        close_scope();
     }
 
-    void visit_function_declaration(FunctionDeclarationNode* node) {
+    void visit(FunctionDeclarationNode* node) {
         std::string func_name = std::string(node->name->name);
-        std::string return_type_str = get_type_string(node->returnType);
-        
-        // If no explicit return type, default to void for now
-        // TODO: Implement type inference from return statements
-        if (return_type_str.empty()) {
-            return_type_str = "void";
-        }
+        std::string return_type_str = return_type_of(node);
         
         IRType return_ir_type = symbol_table.string_to_ir_type(return_type_str);
-        symbol_table.declare_symbol(func_name, SymbolType::FUNCTION, return_ir_type, return_type_str);
+        declare(func_name, node->name, SymbolType::FUNCTION, return_ir_type, return_type_str);
         
-        symbol_table.enter_named_scope(func_name);
+        open_scope(node, ScopeKind::FUNCTION, func_name);
         
         LOG_DEBUG("Function '" + func_name + "' has " + std::to_string(node->parameters.size) + " parameters", LogCategory::SEMANTIC);
-        for (int i = 0; i < node->parameters.size; i++) {
-            LOG_DEBUG("Parameter " + std::to_string(i) + " has type ID: " + std::to_string((int)node->parameters.values[i]->typeId), LogCategory::SEMANTIC);
-            if (auto* param = ast_cast_or_error<ParameterNode>(node->parameters.values[i])) {
-                std::string param_type_str = get_type_string(param->type);
-                IRType param_ir_type = symbol_table.string_to_ir_type(param_type_str);
-                symbol_table.declare_symbol(std::string(param->name->name), SymbolType::PARAMETER, param_ir_type, param_type_str);
-            }
-        }
+        declare_parameters(node);
         
-        if (node->body) {
-            // Process block contents directly without creating a new scope
-            // since the function already has its own scope
-            for (int i = 0; i < node->body->statements.size; i++) {
-                if (auto* stmt = ast_cast_or_error<StatementNode>(node->body->statements.values[i])) {
-                    visit_statement(stmt);
-                }
-            }
-        }
+        walk_body(node);
         
-        symbol_table.exit_scope();
+        close_scope();
     }
     
-    void visit_variable_declaration(VariableDeclarationNode* node) {
+    void visit(VariableDeclarationNode* node) {
         if (node->type) {
             // Explicit type declaration (e.g., "i32 x = 5;")
             std::string var_type_str = get_type_string(node->type);
@@ -1083,110 +1588,565 @@ private:
             // Handle multiple variable names (i32 x, y, z; or i32 a, b, c = 0;)
             for (int i = 0; i < node->names.size; i++) {
                 if (node->names.values[i]) {
-                    symbol_table.declare_symbol(std::string(node->names.values[i]->name), SymbolType::VARIABLE, var_ir_type, var_type_str);
+                    declare(std::string(node->names.values[i]->name), node->names.values[i], SymbolType::VARIABLE, var_ir_type, var_type_str);
                 }
             }
         } else {
             // Implicit type declaration (e.g., "var x = 5;") - requires type inference
             for (int i = 0; i < node->names.size; i++) {
                 if (node->names.values[i]) {
-                    std::string var_name = std::string(node->names.values[i]->name);
-                    symbol_table.declare_unresolved_symbol(var_name, SymbolType::VARIABLE, node->initializer);
+                    declare_inferred(std::string(node->names.values[i]->name), node->names.values[i], node->initializer);
                 }
             }
         }
     }
     
-    void visit_namespace_declaration(NamespaceDeclarationNode* node) {
-        symbol_table.enter_scope();
+    void visit(NamespaceDeclarationNode* node) {
+        open_scope(node, ScopeKind::NAMESPACE);
         
         if (node->body) {
-            visit_statement(node->body);
+            walk(node->body);
         }
         
-        symbol_table.exit_scope();
-    }
-    
-    void visit_statement(StatementNode* node) {
-        if (!node) return;
-        
-        if (auto block = node->as<BlockStatementNode>()) {
-            visit_block_statement(block);
-        } else if (auto local_var = node->as<VariableDeclarationNode>()) {
-            visit_variable_declaration(local_var);
-        } else if (auto if_stmt = node->as<IfStatementNode>()) {
-            visit_if_statement(if_stmt);
-        } else if (auto while_stmt = node->as<WhileStatementNode>()) {
-            visit_while_statement(while_stmt);
-        } else if (auto for_stmt = node->as<ForStatementNode>()) {
-            visit_for_statement(for_stmt);
-        }
+        close_scope();
     }
     
-    void visit_block_statement(BlockStatementNode* node) {
-        symbol_table.enter_scope();
+    void visit(BlockStatementNode* node) {
+        open_scope(node, ScopeKind::BLOCK);
         
         for (int i = 0; i < node->statements.size; i++) {
             if (auto* stmt = ast_cast_or_error<StatementNode>(node->statements.values[i])) {
-                visit_statement(stmt);
+                walk(stmt);
             }
         }
         
-        symbol_table.exit_scope();
+        close_scope();
     }
     
-    
-    void visit_if_statement(IfStatementNode* node) {
-        visit_statement(node->thenStatement);
+    void visit(IfStatementNode* node) {
+        walk(node->thenStatement);
         if (node->elseStatement) {
-            visit_statement(node->elseStatement);
+            walk(node->elseStatement);
         }
     }
     
-    void visit_while_statement(WhileStatementNode* node) {
-        visit_statement(node->body);
+    void visit(WhileStatementNode* node) {
+        walk(node->body);
     }
     
-    void visit_for_statement(ForStatementNode* node) {
-        symbol_table.enter_scope();
+    void visit(ForStatementNode* node) {
+        open_scope(node, ScopeKind::BLOCK);
         
         if (node->initializer) {
-            visit_statement(node->initializer);
+            walk(node->initializer);
         }
         
-        visit_statement(node->body);
+        walk(node->body);
         
-        symbol_table.exit_scope();
+        close_scope();
     }
 
-public:
-    SymbolTableBuilder(SymbolTable& table) : symbol_table(table) {}
-    
     void build_from_ast(CompilationUnitNode* root) {
         if (!root) return;
         
         symbol_table.clear();
         
+        // Imported modules come first, as if their declarations opened the script
+        root_node = root;
+        script_names.clear();
+        imported_names.clear();
+        for (int i = 0; i < root->statements.size; i++) {
+            auto* declaration = root->statements.values[i]->as<DeclarationNode>();
+            if (declaration && declaration->name) script_names.emplace(declaration->name->name, declaration);
+        }
+        for (const auto& module : symbol_table.get_imports()) {
+            for (const ModuleInterface::Declaration& declaration : module->declarations) declare_imported(declaration, *module);
+        }
+        
         for (int i = 0; i < root->statements.size; i++) {
-            auto stmt = root->statements.values[i];
             // Top-level statements in a compilation unit are often declarations
-            if (auto decl = ast_cast_or_error<DeclarationNode>(stmt)) {
-                visit_declaration(decl);
-            } else if (auto statement = ast_cast_or_error<StatementNode>(stmt)) {
-                visit_statement(statement);
+            if (auto statement = ast_cast_or_error<StatementNode>(root->statements.values[i])) {
+                walk(statement);
+            }
+        }
+    }
+    
+    // Records the steps declaring a deferred body's names, starting in the function's scope
+    void record_body(FunctionDeclarationNode* node, std::vector<DeclarationStep>& steps) {
+        recording = &steps;
+        walk_body(node);
+        recording = nullptr;
+    }
+    
+    // Records the parameters and the body, for a function being redone after an edit
+    void record_function(FunctionDeclarationNode* node, std::vector<DeclarationStep>& steps) {
+        recording = &steps;
+        declare_parameters(node);
+        walk_body(node);
+        recording = nullptr;
+    }
+    
+    std::string return_type_of(FunctionDeclarationNode* node) {
+        std::string return_type_str = get_type_string(node->returnType);
+        
+        // If no explicit return type, default to void for now
+        // TODO: Implement type inference from return statements
+        if (return_type_str.empty()) {
+            return_type_str = "void";
+        }
+        return return_type_str;
+    }
+    
+    // Return type and parameter types, in the form function_signature() reads back from the table
+    std::string signature_of(FunctionDeclarationNode* node) {
+        std::string signature = return_type_of(node) + "(";
+        bool first = true;
+        for (int i = 0; i < node->parameters.size; i++) {
+            if (auto* param = node->parameters.values[i]->as<ParameterNode>()) {
+                signature += (first ? "" : ",") + get_type_string(param->type);
+                first = false;
             }
         }
+        return signature + ")";
     }
 };
 
-void build_symbol_table(SymbolTable& table, CompilationUnitNode* ast) {
-    SymbolTableBuilder builder(table);
-    builder.build_from_ast(ast);
+// Infers every expression under node, switching to the scope of each node that
+// opened one. A parent's inference fills in its operands, so the walk reaching
+// them afterwards only reads the side table. Bodies of the functions flagged in
+// skip_bodies_of are left out; the body analysis pass covers them.
+static void check_subtree(SymbolTable& table, AstNode* node, int scope_id, std::vector<ExpressionNode*>* visited = nullptr,
+                          const NodeSideTable<uint8_t>* skip_bodies_of = nullptr);
+
+// Body of a function, constructor or accessor, if the node has one
+static AstNode* body_of(AstNode* node) {
+    if (auto* function = node->as<FunctionDeclarationNode>()) return function->body;
+    if (auto* constructor = node->as<ConstructorDeclarationNode>()) return constructor->body;
+    if (auto* accessor = node->as<PropertyAccessorNode>()) return accessor->body;
+    return nullptr;
+}
+
+static void check_subtree(SymbolTable& table, AstNode* node, int scope_id, std::vector<ExpressionNode*>* visited,
+                          const NodeSideTable<uint8_t>* skip_bodies_of) {
+    if (!node) return;
+    int node_scope = table.get_node_scope(node);
+    if (node_scope != -1) scope_id = node_scope;
+    
+    if (auto* expr = node->as<ExpressionNode>()) {
+        table.infer_expression_type(expr, scope_id);
+        if (visited) visited->push_back(expr);
+    }
+    AstNode* skipped = (skip_bodies_of && skip_bodies_of->get(node)) ? body_of(node) : nullptr;
+    ast_dispatch(node, [&](auto* typed) {
+        ast_visit_fields(typed, [&](auto& field) {
+            if constexpr (std::is_convertible_v<decltype(field), AstNode*>) {
+                AstNode* child = field;
+                if (child != skipped) check_subtree(table, child, scope_id, visited, skip_bodies_of);
+            } else {
+                for (int i = 0; i < field.size; ++i) check_subtree(table, field.values[i], scope_id, visited, skip_bodies_of);
+            }
+        });
+    });
+}
+
+void check_expression_types(SymbolTable& table, CompilationUnitNode* ast) {
+    check_subtree(table, ast, 0);
+}
+
+// Binds children before their parent, so a member access finds its target's
+// binding already in place and each name is reached in the order it appears.
+// Constructor and accessor bodies are skipped: the builder declares nothing
+// inside them, so their locals could never bind.
+static void bind_subtree(SymbolTable& table, AstNode* node, int scope_id, std::vector<AstNode*>& unbound,
+                         const NodeSideTable<uint8_t>* skip_bodies_of = nullptr) {
+    if (!node || node->is_a<ConstructorDeclarationNode>() || node->is_a<PropertyDeclarationNode>()) return;
+    int node_scope = table.get_node_scope(node);
+    if (node_scope != -1) scope_id = node_scope;
+    
+    AstNode* skipped = (skip_bodies_of && skip_bodies_of->get(node)) ? body_of(node) : nullptr;
+    ast_dispatch(node, [&](auto* typed) {
+        ast_visit_fields(typed, [&](auto& field) {
+            if constexpr (std::is_convertible_v<decltype(field), AstNode*>) {
+                AstNode* child = field;
+                if (child != skipped) bind_subtree(table, child, scope_id, unbound, skip_bodies_of);
+            } else {
+                for (int i = 0; i < field.size; ++i) bind_subtree(table, field.values[i], scope_id, unbound, skip_bodies_of);
+            }
+        });
+    });
+    
+    if (auto* identifier = node->as<IdentifierExpressionNode>()) {
+        Symbol* symbol = identifier->identifier ? table.lookup_symbol_in_context(identifier->identifier->name, scope_id) : nullptr;
+        if (symbol) table.bind_name(node, symbol->id);
+        else unbound.push_back(node);
+    } else if (node->is_a<ThisExpressionNode>()) {
+        if (Symbol* symbol = table.lookup_symbol_in_context("this", scope_id)) table.bind_name(node, symbol->id);
+    } else if (auto* member_access = node->as<MemberAccessExpressionNode>()) {
+        // Type.member reads the type's own scope; value.member the scope of the value's type
+        int type_scope_id = -1;
+        Symbol* target = table.get_bound_symbol(member_access->target);
+        if (target && (target->type == SymbolType::CLASS || target->type == SymbolType::ENUM)) {
+            type_scope_id = table.find_type_scope(target->name);
+        } else {
+            type_scope_id = table.find_type_scope(table.get_expression_type(member_access->target));
+        }
+        
+        // An unresolved target was reported already; only report members of known types
+        if (type_scope_id == -1 || !member_access->member) return;
+        if (Symbol* member = table.lookup_symbol_in_scope(type_scope_id, member_access->member->name)) {
+            table.bind_name(node, member->id);
+        } else {
+            unbound.push_back(node);
+        }
+    }
+}
+
+std::vector<AstNode*> bind_names(SymbolTable& table, CompilationUnitNode* ast) {
+    std::vector<AstNode*> unbound;
+    bind_subtree(table, ast, 0, unbound);
+    return unbound;
+}
+
+static std::string unresolved_name_message(AstNode* node) {
+    std::string_view name = "<unknown>";
+    if (auto* identifier = node->as<IdentifierExpressionNode>()) name = identifier->identifier->name;
+    if (auto* member_access = node->as<MemberAccessExpressionNode>()) name = member_access->member->name;
+    return "Unresolved name '" + std::string(name) + "'";
+}
+
+// Scope a body's expressions are read in. Functions opened a scope; constructors
+// and accessors fall back to their type's.
+static int body_scope(SymbolTable& table, const AstPassUnit& unit) {
+    int scope_id = table.get_node_scope(unit.owner);
+    if (scope_id == -1) scope_id = table.get_node_scope(unit.ownerType);
+    return scope_id != -1 ? scope_id : 0; // Global scope
+}
+
+static uint32_t max_node_id(AstNode* node) {
+    if (!node) return 0;
+    uint32_t max_id = node->nodeId;
+    ast_dispatch(node, [&](auto* typed) {
+        ast_visit_fields(typed, [&](auto& field) {
+            if constexpr (std::is_convertible_v<decltype(field), AstNode*>) {
+                max_id = std::max(max_id, max_node_id(field));
+            } else {
+                for (int i = 0; i < field.size; ++i) max_id = std::max(max_id, max_node_id(field.values[i]));
+            }
+        });
+    });
+    return max_id;
+}
+
+// Runs over function bodies in parallel. Each task infers the expressions of
+// its own body into the table's side table, which begin() sizes for the whole
+// tree so tasks only write their own slots. merge() copies the results out in
+// source order from the calling thread.
+class ExpressionTypePass : public AstParallelPass {
+private:
+    SymbolTable& table;
+    NodeSideTable<std::string>& types;
+    std::vector<std::vector<ExpressionNode*>> results;
+
+public:
+    ExpressionTypePass(SymbolTable& t, NodeSideTable<std::string>& out) : table(t), types(out) {}
+
+    AstPassGranularity granularity() const override { return AstPassGranularity::FunctionBodies; }
+
+    void begin(CompilationUnitNode* root, const std::vector<AstPassUnit>& units) override {
+        results.resize(units.size());
+        table.reserve_expression_types(max_node_id(root) + 1);
+    }
+
+    void run(const AstPassUnit& unit, AstPassContext& context) override {
+        check_subtree(table, unit.node, body_scope(table, unit), &results[context.unit_index()]);
+    }
+
+    void merge(const AstPassUnit&, AstPassContext& context) override {
+        for (ExpressionNode* expr : results[context.unit_index()]) {
+            types.set(expr, std::string(table.get_expression_type(expr)));
+        }
+        results[context.unit_index()].clear();
+    }
+};
+
+// Symbols and scopes one body declared, as consecutive id ranges
+struct BodyDeclarations {
+    SymbolId first_symbol = 0;
+    SymbolId end_symbol = 0;
+    int first_scope = 0;
+    int end_scope = 0;
+};
+
+// Declares the names inside each deferred function body. run() walks a body
+// with a recording builder, which only reads the table; merge() replays the
+// steps in source order, so scopes and symbols get the same ids whatever the
+// thread count. Each body's symbols end up as one contiguous id range.
+class BodyDeclarationPass : public AstParallelPass {
+private:
+    SymbolTable& table;
+    const NodeSideTable<uint8_t>& deferred;
+    std::vector<BodyDeclarations>& declared;
+    std::vector<std::vector<DeclarationStep>> steps;
+
+public:
+    BodyDeclarationPass(SymbolTable& t, const NodeSideTable<uint8_t>& d, std::vector<BodyDeclarations>& out)
+        : table(t), deferred(d), declared(out) {}
+
+    AstPassGranularity granularity() const override { return AstPassGranularity::FunctionBodies; }
+
+    void begin(CompilationUnitNode*, const std::vector<AstPassUnit>& units) override {
+        steps.resize(units.size());
+        declared.assign(units.size(), {});
+    }
+
+    void run(const AstPassUnit& unit, AstPassContext& context) override {
+        auto* function = unit.owner->as<FunctionDeclarationNode>();
+        if (!function || !deferred.get(function)) return;
+        SymbolTableBuilder recorder(table);
+        recorder.record_body(function, steps[context.unit_index()]);
+    }
+
+    void merge(const AstPassUnit& unit, AstPassContext& context) override {
+        BodyDeclarations& body = declared[context.unit_index()];
+        body.first_symbol = static_cast<SymbolId>(table.symbol_count());
+        body.first_scope = static_cast<int>(table.scope_count());
+        std::vector<DeclarationStep>& unit_steps = steps[context.unit_index()];
+        if (!unit_steps.empty()) {
+            table.resume_scope(table.get_node_scope(unit.owner));
+            SymbolTableBuilder builder(table);
+            for (const DeclarationStep& building_step : unit_steps) builder.apply(building_step);
+            table.resume_scope(0);
+            unit_steps.clear();
+        }
+        body.end_symbol = static_cast<SymbolId>(table.symbol_count());
+        body.end_scope = static_cast<int>(table.scope_count());
+    }
+};
+
+// Appends the symbols the subtree's expressions bind to that were declared
+// outside every body: globals, type members and namespace members.
+static void collect_uses(SymbolTable& table, AstNode* node, std::vector<SymbolId>& uses,
+                         const NodeSideTable<uint8_t>* skip_bodies_of = nullptr) {
+    if (!node) return;
+    if (node->is_a<ExpressionNode>()) {
+        if (Symbol* symbol = table.get_bound_symbol(node)) {
+            ScopeKind kind = table.get_scope_kind(symbol->scope_level);
+            if (kind != ScopeKind::FUNCTION && kind != ScopeKind::BLOCK) uses.push_back(symbol->id);
+        }
+    }
     
-    // After building the symbol table, resolve all types
+    AstNode* skipped = (skip_bodies_of && skip_bodies_of->get(node)) ? body_of(node) : nullptr;
+    ast_dispatch(node, [&](auto* typed) {
+        ast_visit_fields(typed, [&](auto& field) {
+            if constexpr (std::is_convertible_v<decltype(field), AstNode*>) {
+                AstNode* child = field;
+                if (child != skipped) collect_uses(table, child, uses, skip_bodies_of);
+            } else {
+                for (int i = 0; i < field.size; ++i) collect_uses(table, field.values[i], uses, skip_bodies_of);
+            }
+        });
+    });
+}
+
+static void sort_uses(std::vector<SymbolId>& uses) {
+    std::sort(uses.begin(), uses.end());
+    uses.erase(std::unique(uses.begin(), uses.end()), uses.end());
+}
+
+// Resolves, types and binds one body whose symbols are the declared range, and
+// lists the outside symbols it reads. Only the body's own symbols and nodes are
+// written, so bodies can be analyzed concurrently.
+static void analyze_body(SymbolTable& table, const AstPassUnit& unit, const BodyDeclarations& declared,
+                         std::vector<std::vector<SymbolId>>& cycles, std::vector<SymbolId>& uses,
+                         std::vector<AstPassDiagnostic>& diagnostics) {
+    std::vector<SymbolId> failed;
+    table.resolve_symbol_range(declared.first_symbol, declared.end_symbol, cycles, failed);
+    for (SymbolId id : failed) {
+        diagnostics.push_back({ unit.owner, "Cannot infer type for symbol: " + std::string(table.get_symbol(id)->name) });
+    }
+    for (const auto& cycle : cycles) {
+        diagnostics.push_back({ unit.owner, "Circular type dependency between: " + cycle_members(table, cycle) });
+    }
+    
+    int scope_id = body_scope(table, unit);
+    check_subtree(table, unit.node, scope_id);
+    
+    // The builder declares nothing in constructor and accessor bodies, so there is nothing to bind to
+    if (!unit.owner->is_a<FunctionDeclarationNode>()) return;
+    std::vector<AstNode*> unbound;
+    bind_subtree(table, unit.node, scope_id, unbound);
+    for (AstNode* node : unbound) diagnostics.push_back({ node, unresolved_name_message(node) });
+    collect_uses(table, unit.node, uses);
+    sort_uses(uses);
+}
+
+// Resolves, types and binds each body on its own. A body's locals are visible
+// only inside it, so a task resolves its own symbol range and writes side-table
+// entries for its own nodes, while everything it reads outside the body was
+// settled before the pass began. Cycles and body extents go to the table in merge().
+class BodyAnalysisPass : public AstParallelPass {
+private:
+    SymbolTable& table;
+    const std::vector<BodyDeclarations>& declared;
+    std::vector<std::vector<std::vector<SymbolId>>> cycles;
+    std::vector<std::vector<SymbolId>> uses;
+
+public:
+    BodyAnalysisPass(SymbolTable& t, const std::vector<BodyDeclarations>& in) : table(t), declared(in) {}
+
+    AstPassGranularity granularity() const override { return AstPassGranularity::FunctionBodies; }
+
+    void begin(CompilationUnitNode* root, const std::vector<AstPassUnit>& units) override {
+        cycles.resize(units.size());
+        uses.resize(units.size());
+        uint32_t node_count = max_node_id(root) + 1;
+        table.reserve_expression_types(node_count);
+        table.reserve_name_bindings(node_count);
+        table.freeze_declarations();
+    }
+
+    void run(const AstPassUnit& unit, AstPassContext& context) override {
+        size_t index = context.unit_index();
+        std::vector<AstPassDiagnostic> diagnostics;
+        analyze_body(table, unit, declared[index], cycles[index], uses[index], diagnostics);
+        for (AstPassDiagnostic& diagnostic : diagnostics) context.report(diagnostic.node, std::move(diagnostic.message));
+    }
+
+    void merge(const AstPassUnit& unit, AstPassContext& context) override {
+        size_t index = context.unit_index();
+        for (auto& cycle : cycles[index]) table.add_type_cycle(std::move(cycle));
+        cycles[index].clear();
+        
+        int scope_id = table.get_node_scope(unit.owner);
+        if (unit.owner->is_a<FunctionDeclarationNode>() && scope_id != -1) {
+            table.set_body_extent(scope_id, { unit.owner, declared[index].first_scope, declared[index].end_scope, std::move(uses[index]) });
+        }
+    }
+};
+
+std::vector<AstPassDiagnostic> build_symbol_table(SymbolTable& table, CompilationUnitNode* ast, AstTaskPool& pool) {
+    std::vector<AstPassDiagnostic> diagnostics;
+    if (!ast) return diagnostics;
+    
+    // Phase one, serial: every type, field, enum case and function signature.
+    // Bodies the parallel passes will visit are deferred.
+    NodeSideTable<uint8_t> deferred;
+    for (const AstPassUnit& unit : ast_collect_pass_units(ast, AstPassGranularity::FunctionBodies)) {
+        deferred[unit.owner] = 1;
+    }
+    SymbolTableBuilder builder(table, &deferred);
+    builder.build_from_ast(ast);
     if (!table.resolve_all_types()) {
         LOG_ERROR("Failed to resolve all types in symbol table", LogCategory::SEMANTIC);
     }
+    
+    // Phase two, one body per task against the settled declarations
+    std::vector<BodyDeclarations> declared;
+    BodyDeclarationPass declarations(table, deferred, declared);
+    ast_run_parallel_pass(ast, declarations, pool);
+    BodyAnalysisPass analysis(table, declared);
+    diagnostics = std::move(builder.diagnostics);
+    for (AstPassDiagnostic& diagnostic : ast_run_parallel_pass(ast, analysis, pool)) diagnostics.push_back(std::move(diagnostic));
+    
+    // Whatever lies outside bodies: field and global initializers, top-level statements
+    check_subtree(table, ast, 0, nullptr, &deferred);
+    std::vector<AstNode*> unbound;
+    bind_subtree(table, ast, 0, unbound, &deferred);
+    for (AstNode* node : unbound) diagnostics.push_back({ node, unresolved_name_message(node) });
+    std::vector<SymbolId> uses;
+    collect_uses(table, ast, uses, &deferred);
+    sort_uses(uses);
+    table.set_declaration_uses(std::move(uses));
+    return diagnostics;
+}
+
+void build_symbol_table(SymbolTable& table, CompilationUnitNode* ast) {
+    AstTaskPool pool(1);
+    for (const AstPassDiagnostic& diagnostic : build_symbol_table(table, ast, pool)) {
+        LOG_ERROR(diagnostic.message, LogCategory::SEMANTIC);
+    }
+}
+
+// The signature as the table holds it, in the form SymbolTableBuilder::signature_of() builds
+static std::string function_signature(SymbolTable& table, const Symbol& function, int scope_id) {
+    std::string signature = std::string(function.type_name) + "(";
+    bool first = true;
+    for (Symbol* param : table.get_all_symbols_in_scope(scope_id)) {
+        if (param->type != SymbolType::PARAMETER || param->name == "this") continue;
+        signature += (first ? "" : ",") + std::string(param->type_name);
+        first = false;
+    }
+    return signature + ")";
+}
+
+static void forget_subtree(SymbolTable& table, AstNode* node) {
+    if (!node) return;
+    table.forget_node(node);
+    ast_dispatch(node, [&](auto* typed) {
+        ast_visit_fields(typed, [&](auto& field) {
+            if constexpr (std::is_convertible_v<decltype(field), AstNode*>) {
+                forget_subtree(table, field);
+            } else {
+                for (int i = 0; i < field.size; ++i) forget_subtree(table, field.values[i]);
+            }
+        });
+    });
+}
+
+// Drops a function's parameters and body and declares, resolves, types and binds them again
+static void redo_function(SymbolTable& table, FunctionDeclarationNode* function, int scope_id, std::vector<AstPassDiagnostic>& diagnostics) {
+    table.remove_function_declarations(scope_id);
+    for (int i = 0; i < function->parameters.size; i++) forget_subtree(table, function->parameters.values[i]);
+    forget_subtree(table, function->body);
+    
+    std::vector<DeclarationStep> steps;
+    SymbolTableBuilder builder(table);
+    builder.record_function(function, steps);
+    
+    BodyDeclarations declared;
+    declared.first_symbol = static_cast<SymbolId>(table.symbol_count());
+    declared.first_scope = static_cast<int>(table.scope_count());
+    table.resume_scope(scope_id);
+    for (const DeclarationStep& building_step : steps) builder.apply(building_step);
+    table.resume_scope(0);
+    declared.end_symbol = static_cast<SymbolId>(table.symbol_count());
+    declared.end_scope = static_cast<int>(table.scope_count());
+    
+    std::vector<std::vector<SymbolId>> cycles;
+    std::vector<SymbolId> uses;
+    analyze_body(table, { function->body, function, nullptr }, declared, cycles, uses, diagnostics);
+    for (auto& cycle : cycles) table.add_type_cycle(std::move(cycle));
+    table.set_body_extent(scope_id, { function, declared.first_scope, declared.end_scope, std::move(uses) });
+}
+
+bool update_function(SymbolTable& table, FunctionDeclarationNode* function, std::vector<AstPassDiagnostic>& diagnostics) {
+    int scope_id = function ? table.get_node_scope(function) : -1;
+    Symbol* symbol = scope_id != -1 ? table.get_bound_symbol(function->name) : nullptr;
+    if (!symbol || symbol->name != function->name->name) return false;
+    
+    // Settle whether the edit stays inside bodies before touching anything
+    SymbolTableBuilder builder(table);
+    bool signature_changed = builder.signature_of(function) != function_signature(table, *symbol, scope_id);
+    if (signature_changed && table.is_read_outside_bodies(symbol->id)) return false;
+    
+    if (signature_changed) table.set_symbol_type(symbol->id, builder.return_type_of(function));
+    table.clear_constants();
+    table.clear_function_effects();
+    table.clear_dead_functions();
+    redo_function(table, function, scope_id, diagnostics);
+    if (!signature_changed) return true;
+    
+    // Callers keep their bindings, since the symbol stays, but may infer other local types now
+    for (int dependent : table.find_dependent_bodies(symbol->id)) {
+        auto* owner = table.get_body_extent(dependent)->owner->as<FunctionDeclarationNode>();
+        if (dependent != scope_id && owner) redo_function(table, owner, dependent, diagnostics);
+    }
+    return true;
+}
+
+void infer_expression_types(SymbolTable& table, CompilationUnitNode* ast, NodeSideTable<std::string>& types, AstTaskPool& pool) {
+    ExpressionTypePass pass(table, types);
+    ast_run_parallel_pass(ast, pass, pool);
 }
 
 } // namespace Mycelium::Scripting::Lang
\ No newline at end of file
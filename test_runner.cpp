@@ -3,6 +3,7 @@
 #include "test/test_framework.hpp"
 #include "common/logger.hpp"
 #include <iostream>
+#include <string_view>
 
 using namespace Mycelium::Testing;
 using namespace Mycelium::Scripting::Common;
@@ -14,12 +15,39 @@ void run_parser_tests();
 void run_parse_result_tests();
 void run_pratt_parser_tests();
 void run_recursive_parser_tests();
+void run_ast_walker_tests();
+void run_ast_serializer_tests();
+void run_ast_side_table_tests();
+void run_ast_source_index_tests();
+void run_ast_hash_tests();
+void run_ast_dumper_tests();
+void run_ast_handle_tests();
+void run_ast_compact_tests();
+void run_ast_parallel_tests();
+void run_symbol_arena_tests();
+void run_scope_tree_tests();
+void run_type_resolution_tests();
+void run_expression_types_tests();
+void run_name_binding_tests();
+void run_parallel_semantics_tests();
+void run_incremental_symbols_tests();
+void run_type_context_tests();
+void run_struct_layout_cache_tests();
+void run_field_layout_tests();
+void run_bit_packing_tests();
+void run_comptime_tests();
+void run_effects_tests();
+void run_dead_functions_tests();
+void run_module_interface_tests();
 void run_command_generation_tests();
 void run_ir_generation_tests();
 void run_jit_execution_tests();
 void run_integration_tests();
 
-int main() {
+int main(int argc, char** argv) {
+    // "--front-end" runs the lexer, parser, AST and semantic suites only
+    bool front_end_only = argc > 1 && std::string_view(argv[1]) == "--front-end";
+    
     // Initialize logger for test output
     Logger& logger = Logger::get_instance();
     logger.initialize();
@@ -29,9 +57,7 @@ int main() {
     
     logger.test_suite_start("🔬 Mycelium Compiler Test Suite 🔬");
     
-    // Initialize RTTI (required for AST operations)
-    Mycelium::Scripting::Lang::AstTypeInfo::initialize();
-    LOG_INFO("RTTI Initialized. Total types: " + std::to_string(Mycelium::Scripting::Lang::AstNode::sTypeInfo.fullDerivedCount + 1), LogCategory::TEST);
+    LOG_INFO("AST RTTI total types: " + std::to_string(Mycelium::Scripting::Lang::AST_TYPE_COUNT), LogCategory::TEST);
     
     // Clear any previous test results
     TestTracker::instance().clear();
@@ -43,17 +69,45 @@ int main() {
     LOG_INFO("🧪 Running Parser Tests...", LogCategory::TEST);
     run_parser_tests();
     
-    LOG_INFO("🧪 Running Command Generation Tests...", LogCategory::TEST);
-    run_command_generation_tests();
-    
-    LOG_INFO("🧪 Running IR Generation Tests...", LogCategory::TEST);
-    run_ir_generation_tests();
-    
-    LOG_INFO("🧪 Running JIT Execution Tests...", LogCategory::TEST);
-    run_jit_execution_tests();
+    LOG_INFO("🧪 Running AST Walker Tests...", LogCategory::TEST);
+    run_ast_walker_tests();
+    run_ast_serializer_tests();
+    run_ast_side_table_tests();
+    run_ast_source_index_tests();
+    run_ast_hash_tests();
+    run_ast_dumper_tests();
+    run_ast_handle_tests();
+    run_ast_compact_tests();
+    run_ast_parallel_tests();
+    run_symbol_arena_tests();
+    run_scope_tree_tests();
+    run_type_resolution_tests();
+    run_expression_types_tests();
+    run_name_binding_tests();
+    run_parallel_semantics_tests();
+    run_incremental_symbols_tests();
+    run_type_context_tests();
+    run_struct_layout_cache_tests();
+    run_field_layout_tests();
+    run_bit_packing_tests();
+    run_comptime_tests();
+    run_effects_tests();
+    run_dead_functions_tests();
+    run_module_interface_tests();
     
-    LOG_INFO("🧪 Running Integration Tests...", LogCategory::TEST);
-    run_integration_tests();
+    if (!front_end_only) {
+        LOG_INFO("🧪 Running Command Generation Tests...", LogCategory::TEST);
+        run_command_generation_tests();
+        
+        LOG_INFO("🧪 Running IR Generation Tests...", LogCategory::TEST);
+        run_ir_generation_tests();
+        
+        LOG_INFO("🧪 Running JIT Execution Tests...", LogCategory::TEST);
+        run_jit_execution_tests();
+        
+        LOG_INFO("🧪 Running Integration Tests...", LogCategory::TEST);
+        run_integration_tests();
+    }
     
     // Print comprehensive final summary
     TestTracker::instance().print_final_summary();
@@ -0,0 +1,169 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "ast/ast.hpp"
+#include "ast/ast_compact.hpp"
+#include "ast/ast_dumper.hpp"
+#include "ast/ast_hash.hpp"
+#include "ast/ast_walker.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+// Records node ids in visit order and touches each node's span
+class CompactOrderWalker : public AstWalker<CompactOrderWalker> {
+public:
+    using AstWalker<CompactOrderWalker>::visit;
+    std::vector<uint32_t> ids;
+    long long span_sum = 0;
+
+    template <typename T>
+    void record(T* node) {
+        ids.push_back(node->nodeId);
+        span_sum += node->sourceLength;
+        walk_children(node);
+    }
+
+    #define COMPACT_ORDER_WALKER_VISIT(NodeType, BaseType) \
+        void visit(NodeType* node) { record(node); }
+    AST_NODE_LIST(COMPACT_ORDER_WALKER_VISIT)
+    #undef COMPACT_ORDER_WALKER_VISIT
+};
+
+static std::string dump_json(AstNode* node) {
+    std::ostringstream out;
+    ast_dump(node, AstDumpFormat::Json, out);
+    return out.str();
+}
+
+TestResult test_compact_preserves_tree() {
+    std::string source =
+        "using System;\n"
+        "namespace Demo;\n"
+        "type Point { i32 x, y; fn len(): i32 { return x * x + y * y; } }\n"
+        "fn main(): i32 { var p = new Point(); for (var i = 0; i < 3; i++) { p.x = p.x + i; } return p.len(); }\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+
+    AstAllocator target;
+    CompilationUnitNode* compacted = ast_compact(result.get_node(), target);
+    ASSERT_TRUE(compacted != nullptr && compacted != result.get_node(), "Compaction should produce a new root");
+    ASSERT_STR_EQ(dump_json(result.get_node()), dump_json(compacted), "Compacted tree should dump identically");
+    ASSERT_EQ(ast_structural_hash(result.get_node()), ast_structural_hash(compacted), "Structural hash should be unchanged");
+
+    // Aliases must point into the new tree, not back at the parser's nodes
+    auto* type = node_cast<TypeDeclarationNode>(compacted->statements[2]);
+    ASSERT_TRUE(type != nullptr, "Third statement should be the type declaration");
+    auto* field = node_cast<VariableDeclarationNode>(type->members[0]);
+    ASSERT_TRUE(field != nullptr, "First member should be a field");
+    ASSERT_TRUE(field->name == field->names[0], "Field name should alias the copied first name");
+
+    return TestResult(true, "Compacted tree matches the original");
+}
+
+TestResult test_compact_assigns_preorder_ids() {
+    std::string source =
+        "fn add(i32 a, i32 b): i32 { return a + b; }\n"
+        "fn main(): i32 { while (true) { if (add(1, 2) > 2) { break; } } return 0; }\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+
+    AstAllocator target;
+    CompilationUnitNode* compacted = ast_compact(result.get_node(), target);
+
+    CompactOrderWalker walker;
+    walker.walk(compacted);
+    ASSERT_EQ((size_t)target.node_count(), walker.ids.size(), "Every copied node should be reachable");
+    for (size_t i = 0; i < walker.ids.size(); ++i) {
+        ASSERT_EQ((uint32_t)i, walker.ids[i], "Node ids should follow pre-order");
+    }
+    ASSERT_TRUE(target.node_count() <= parser.get_allocator().node_count(), "Compaction should not add nodes");
+
+    // Pre-order ids come with pre-order placement: each node sits after its parent
+    ASSERT_TRUE((uint8_t*)compacted->statements[0] > (uint8_t*)compacted, "Children should be placed after their parent");
+    ASSERT_TRUE((uint8_t*)compacted->statements[1] > (uint8_t*)compacted->statements[0], "Siblings should be placed in order");
+
+    return TestResult(true, "Compacted nodes are numbered and placed in pre-order");
+}
+
+static std::string generate_compact_script(int function_count) {
+    std::string source;
+    source += "type Point { i32 x; i32 y; fn sum(): i32 { return x + y; } }\n";
+    for (int i = 0; i < function_count; ++i) {
+        std::string n = std::to_string(i);
+        source += "fn f" + n + "(i32 a, i32 b): i32 {\n";
+        source += "    var total = a * 2 + b - " + n + ";\n";
+        source += "    for (var i = 0; i < 10; i++) { total = total + i * (a - b); }\n";
+        source += "    if (total > 100) { total = total / 2; }\n";
+        source += "    while (total < 0) { total = total + 7; }\n";
+        source += "    return total + f" + std::to_string(i > 0 ? i - 1 : 0) + "(a, b);\n";
+        source += "}\n";
+    }
+    return source;
+}
+
+static double time_walk(AstNode* root, int iterations, size_t& visited) {
+    using Clock = std::chrono::steady_clock;
+    CompactOrderWalker walker;
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        walker = CompactOrderWalker();
+        walker.walk(root);
+    }
+    visited = walker.ids.size();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / iterations;
+}
+
+TestResult test_compact_traversal_benchmark() {
+    const int iterations = 50;
+
+    std::string source = generate_compact_script(450);
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+
+    using Clock = std::chrono::steady_clock;
+    AstAllocator target;
+    auto start = Clock::now();
+    CompilationUnitNode* compacted = ast_compact(result.get_node(), target);
+    double compact_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    size_t before_nodes = 0, after_nodes = 0;
+    double before_ms = time_walk(result.get_node(), iterations, before_nodes);
+    double after_ms = time_walk(compacted, iterations, after_nodes);
+    ASSERT_EQ(before_nodes, after_nodes, "Both trees should have the same reachable nodes");
+
+    size_t before_kb = parser.get_allocator().page_count() * sizeof(AstPage) / 1024;
+    size_t after_kb = target.page_count() * sizeof(AstPage) / 1024;
+    LOG_INFO("AST compaction on " + std::to_string(after_nodes) + " reachable nodes (" +
+             std::to_string(parser.get_allocator().node_count()) + " allocated):", LogCategory::TEST);
+    LOG_INFO("  compact " + std::to_string(compact_ms) + " ms, " + std::to_string(before_kb) + " KB -> " +
+             std::to_string(after_kb) + " KB", LogCategory::TEST);
+    LOG_INFO("  full walk " + std::to_string(before_ms) + " ms before, " + std::to_string(after_ms) + " ms after",
+             LogCategory::TEST);
+
+    return TestResult(true, "Walk " + std::to_string(before_ms) + " ms -> " + std::to_string(after_ms) + " ms");
+}
+
+void run_ast_compact_tests() {
+    TestSuite suite("AST Compaction Tests");
+
+    suite.add_test("Compaction Preserves Tree", test_compact_preserves_tree);
+    suite.add_test("Compaction Assigns Pre-order Ids", test_compact_assigns_preorder_ids);
+    suite.add_test("Compaction Traversal Benchmark", test_compact_traversal_benchmark);
+
+    suite.run_all();
+}
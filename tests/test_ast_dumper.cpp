@@ -0,0 +1,199 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "ast/ast.hpp"
+#include "ast/ast_dumper.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+static std::string dump_to_string(AstNode* root, AstDumpFormat format) {
+    std::ostringstream out;
+    ast_dump(root, format, out);
+    return out.str();
+}
+
+// Checks that brackets balance outside string literals
+static bool brackets_balance(const std::string& text, char open, char close) {
+    int depth = 0;
+    bool in_string = false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (in_string) {
+            if (c == '\\') i++;
+            else if (c == '"') in_string = false;
+        } else if (c == '"') {
+            in_string = true;
+        } else if (c == open) {
+            depth++;
+        } else if (c == close) {
+            if (--depth < 0) return false;
+        }
+    }
+    return depth == 0 && !in_string;
+}
+
+static const char* DUMPER_TEST_SOURCE = R"(type Point {
+    i32 x;
+    i32 y;
+    fn sum(): i32 { return x + y; }
+}
+fn main(): i32 {
+    var p = new Point();
+    string label = "say \"hi\"";
+    i32 total = 0;
+    for (var i = 0; i < 10; i++) { total = total + i; }
+    return total;
+}
+)";
+
+TestResult test_dump_pseudo_code() {
+    std::string source = DUMPER_TEST_SOURCE;
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse dumper test source");
+
+    std::string text = dump_to_string(result.get_node(), AstDumpFormat::PseudoCode);
+    ASSERT_TRUE(text.rfind("// Compilation Unit\n", 0) == 0, "Pseudo-code dump should start with the unit header");
+    ASSERT_TRUE(text.find("type Point {") != std::string::npos, "Pseudo-code dump should contain the type header");
+    ASSERT_TRUE(text.find("fn main(): i32") != std::string::npos, "Pseudo-code dump should contain the function signature");
+    ASSERT_TRUE(text.find("    return x + y;") != std::string::npos, "Pseudo-code dump should indent nested statements");
+    ASSERT_TRUE(text.find("\x1b[") == std::string::npos, "Pseudo-code dump should not contain color codes");
+
+    return TestResult(true, std::to_string(text.size()) + " bytes of pseudo-code");
+}
+
+TestResult test_dump_sexpression() {
+    std::string source = DUMPER_TEST_SOURCE;
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse dumper test source");
+
+    std::string text = dump_to_string(result.get_node(), AstDumpFormat::SExpression);
+    ASSERT_TRUE(text.rfind("(CompilationUnitNode", 0) == 0, "S-expression dump should start with the root");
+    ASSERT_TRUE(brackets_balance(text, '(', ')'), "S-expression parentheses should balance");
+    ASSERT_TRUE(text.find("(BinaryExpressionNode :op +") != std::string::npos, "Binary nodes should carry their operator");
+    ASSERT_TRUE(text.find("(IdentifierNode :name \"main\")") != std::string::npos, "Identifiers should carry their name");
+    ASSERT_TRUE(text.find("(LiteralExpressionNode :kind Integer") != std::string::npos, "Literals should carry their kind");
+    ASSERT_TRUE(text.find("\"\\\"say \\\\\\\"hi\\\\\\\"\\\"\"") != std::string::npos, "String literal text should be escaped");
+
+    return TestResult(true, std::to_string(text.size()) + " bytes of S-expressions");
+}
+
+TestResult test_dump_json() {
+    std::string source = DUMPER_TEST_SOURCE;
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse dumper test source");
+
+    std::string text = dump_to_string(result.get_node(), AstDumpFormat::Json);
+    ASSERT_TRUE(text.rfind("{\"type\":\"CompilationUnitNode\",\"span\":[0,", 0) == 0, "JSON dump should start with the root object");
+    ASSERT_TRUE(brackets_balance(text, '{', '}'), "JSON braces should balance");
+    ASSERT_TRUE(brackets_balance(text, '[', ']'), "JSON brackets should balance");
+    ASSERT_TRUE(text.find("\"op\":\"+\"") != std::string::npos, "Binary nodes should carry their operator");
+    ASSERT_TRUE(text.find("\"name\":\"Point\"") != std::string::npos, "Identifiers should carry their name");
+    ASSERT_TRUE(text.find(",\n]") == std::string::npos && text.find(",}") == std::string::npos, "JSON should have no trailing commas");
+
+    size_t main_offset = source.find("fn main");
+    std::string main_span = "\"type\":\"FunctionDeclarationNode\",\"span\":[" + std::to_string(main_offset) + ",";
+    ASSERT_TRUE(text.find(main_span) != std::string::npos, "Nodes should carry their source span");
+
+    return TestResult(true, std::to_string(text.size()) + " bytes of JSON");
+}
+
+TestResult test_dump_to_file_descriptor() {
+    std::string source = DUMPER_TEST_SOURCE;
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse dumper test source");
+
+    std::FILE* file = std::tmpfile();
+    ASSERT_TRUE(file != nullptr, "Should be able to create a temporary file");
+    ast_dump(result.get_node(), AstDumpFormat::SExpression, fileno(file));
+
+    std::string written;
+    std::rewind(file);
+    char chunk[4096];
+    size_t read;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        written.append(chunk, read);
+    }
+    std::fclose(file);
+
+    ASSERT_STR_EQ(dump_to_string(result.get_node(), AstDumpFormat::SExpression), written, "Descriptor and stream output should match");
+    return TestResult(true, "Descriptor output matches stream output");
+}
+
+// Stays under ~500 top-level declarations, the most one allocator page can list
+static std::string generate_dumper_script(int function_count) {
+    std::string source;
+    source += "type Point { i32 x; i32 y; fn sum(): i32 { return x + y; } }\n";
+    for (int i = 0; i < function_count; ++i) {
+        std::string n = std::to_string(i);
+        source += "fn f" + n + "(i32 a, i32 b): i32 {\n";
+        source += "    var total = a * 2 + b - " + n + ";\n";
+        for (int j = 0; j < 3; ++j) {
+            source += "    for (var i = 0; i < 10; i++) { total = total + i * (a - b); }\n";
+            source += "    if (total > 100) { total = total / 2; }\n";
+            source += "    while (total < 0) { total = total + 7; }\n";
+        }
+        source += "    return total + f" + std::to_string(i > 0 ? i - 1 : 0) + "(a, b);\n";
+        source += "}\n";
+    }
+    return source;
+}
+
+TestResult test_dump_benchmark() {
+    std::string source = generate_dumper_script(450);
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+    uint32_t node_count = parser.get_allocator().node_count();
+
+    using Clock = std::chrono::steady_clock;
+    std::string report;
+    for (auto [format, name] : { std::pair{AstDumpFormat::PseudoCode, "pseudo"},
+                                 std::pair{AstDumpFormat::SExpression, "sexpr"},
+                                 std::pair{AstDumpFormat::Json, "json"} }) {
+        std::ofstream sink("ast_dump_benchmark.tmp", std::ios::binary);
+        auto start = Clock::now();
+        ast_dump(result.get_node(), format, sink);
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        size_t bytes = static_cast<size_t>(sink.tellp());
+        ASSERT_TRUE(bytes > 0, std::string("Dump should produce output for ") + name);
+
+        LOG_INFO("  AST dump " + std::string(name) + ": " + std::to_string(ms) + " ms, " + std::to_string(bytes) + " bytes", LogCategory::TEST);
+        report += std::string(name) + " " + std::to_string(ms) + " ms ";
+    }
+    std::remove("ast_dump_benchmark.tmp");
+
+    LOG_INFO("AST dump benchmark: " + std::to_string(node_count) + " nodes", LogCategory::TEST);
+    return TestResult(true, std::to_string(node_count) + " nodes: " + report);
+}
+
+void run_ast_dumper_tests() {
+    TestSuite suite("AST Dumper Tests");
+
+    suite.add_test("Dump Pseudo Code", test_dump_pseudo_code);
+    suite.add_test("Dump S-Expression", test_dump_sexpression);
+    suite.add_test("Dump JSON", test_dump_json);
+    suite.add_test("Dump To File Descriptor", test_dump_to_file_descriptor);
+    suite.add_test("Dump Benchmark", test_dump_benchmark);
+
+    suite.run_all();
+}
@@ -0,0 +1,133 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "ast/ast.hpp"
+#include "ast/ast_handle.hpp"
+#include "ast/ast_walker.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+// Reads every child field, the access pattern the handle layout is meant to speed up
+class HandleSumWalker : public AstWalker<HandleSumWalker> {
+public:
+    using AstWalker<HandleSumWalker>::visit;
+    int node_count = 0;
+    long long span_sum = 0;
+
+    template <typename T>
+    void count(T* node) {
+        node_count++;
+        span_sum += node->sourceLength;
+        walk_children(node);
+    }
+
+    #define HANDLE_SUM_WALKER_VISIT(NodeType, BaseType) \
+        void visit(NodeType* node) { count(node); }
+    AST_NODE_LIST(HANDLE_SUM_WALKER_VISIT)
+    #undef HANDLE_SUM_WALKER_VISIT
+};
+
+TestResult test_handle_behaves_like_pointer() {
+    // Handles only name arena memory, so place the nodes there directly; this
+    // works whether or not the build stores fields as handles.
+    void* page = AstArena::allocate_page();
+    ASSERT_TRUE(page != nullptr && AstArena::base != nullptr, "Arena should hand out a page");
+
+    auto* binary = new (page) BinaryExpressionNode();
+    binary->init_with_type_id(BinaryExpressionNode::sTypeId);
+    binary->opKind = Mycelium::Scripting::BinaryOperatorKind::Add;
+    auto* token = new (static_cast<uint8_t*>(page) + sizeof(BinaryExpressionNode)) TokenNode();
+    token->init_with_type_id(TokenNode::sTypeId);
+
+    AstHandle<ExpressionNode> handle = binary;
+    AstHandle<TokenNode> empty = nullptr;
+
+    ASSERT_EQ(4, sizeof(handle), "A handle should be 32 bits");
+    ASSERT_TRUE(handle.offset() != 0 && empty.offset() == 0, "Only null should encode as offset 0");
+    ASSERT_TRUE(handle.get() == binary && handle == binary, "Handle should decode to the node");
+    ASSERT_TRUE(empty == nullptr && !empty, "Null handle should compare equal to nullptr");
+    ASSERT_TRUE(handle->typeId == BinaryExpressionNode::sTypeId, "operator-> should reach the node");
+    ASSERT_TRUE(static_cast<BinaryExpressionNode*>(handle)->opKind == Mycelium::Scripting::BinaryOperatorKind::Add, "static_cast should downcast");
+    ASSERT_TRUE(node_is<BinaryExpressionNode>(handle), "RTTI helpers should accept handles");
+
+    AstNode* as_base = handle;
+    ASSERT_TRUE(as_base == binary, "Handles should convert to base pointers");
+    empty = token;
+    ASSERT_TRUE(empty.get() == token, "Assigning a pointer should re-encode the handle");
+
+    AstArena::release_page(page);
+    return TestResult(true, "Handles convert, compare and cast like pointers");
+}
+
+static std::string generate_handle_script(int function_count) {
+    std::string source;
+    source += "type Point { i32 x; i32 y; fn sum(): i32 { return x + y; } }\n";
+    for (int i = 0; i < function_count; ++i) {
+        std::string n = std::to_string(i);
+        source += "fn f" + n + "(i32 a, i32 b): i32 {\n";
+        source += "    var total = a * 2 + b - " + n + ";\n";
+        source += "    for (var i = 0; i < 10; i++) { total = total + i * (a - b); }\n";
+        source += "    if (total > 100) { total = total / 2; }\n";
+        source += "    while (total < 0) { total = total + 7; }\n";
+        source += "    return total + f" + std::to_string(i > 0 ? i - 1 : 0) + "(a, b);\n";
+        source += "}\n";
+    }
+    return source;
+}
+
+TestResult test_handle_footprint_benchmark() {
+    const int iterations = 50;
+
+    std::string source = generate_handle_script(450);
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+
+    size_t tree_bytes = parser.get_allocator().page_count() * sizeof(AstPage);
+    uint32_t node_count = parser.get_allocator().node_count();
+
+    using Clock = std::chrono::steady_clock;
+    HandleSumWalker walker;
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        walker = HandleSumWalker();
+        walker.walk(result.get_node());
+    }
+    double walk_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / iterations;
+    ASSERT_EQ((int)node_count, walker.node_count, "Walk should reach every node");
+
+#ifdef MYCELIUM_AST_COMPRESSED_HANDLES
+    const char* layout = "compressed handles";
+#else
+    const char* layout = "raw pointers";
+#endif
+    LOG_INFO(std::string("AST footprint with ") + layout + ":", LogCategory::TEST);
+    LOG_INFO("  sizeof: Binary " + std::to_string(sizeof(BinaryExpressionNode)) +
+             ", Call " + std::to_string(sizeof(CallExpressionNode)) +
+             ", For " + std::to_string(sizeof(ForStatementNode)) +
+             ", Function " + std::to_string(sizeof(FunctionDeclarationNode)) +
+             ", Token " + std::to_string(sizeof(TokenNode)), LogCategory::TEST);
+    LOG_INFO("  " + std::to_string(node_count) + " nodes in " + std::to_string(tree_bytes / 1024) + " KB, full walk " +
+             std::to_string(walk_ms) + " ms", LogCategory::TEST);
+
+    return TestResult(true, std::string(layout) + ": " + std::to_string(tree_bytes / 1024) + " KB, walk " + std::to_string(walk_ms) + " ms");
+}
+
+void run_ast_handle_tests() {
+    TestSuite suite("AST Handle Tests");
+
+    suite.add_test("Handle Behaves Like Pointer", test_handle_behaves_like_pointer);
+    suite.add_test("Handle Footprint Benchmark", test_handle_footprint_benchmark);
+
+    suite.run_all();
+}
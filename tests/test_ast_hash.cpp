@@ -0,0 +1,188 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "ast/ast.hpp"
+#include "ast/ast_hash.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+
+// Keeps the source and token stream alive alongside the parsed tree.
+struct HashTestParse {
+    std::string source;
+    TokenStream stream;
+    Parser parser;
+    ParseResult<CompilationUnitNode> result;
+
+    explicit HashTestParse(const std::string& text)
+        : source(text), stream(tokenize_test_source(source)), parser(stream), result(parser.parse()) {}
+
+    // Structural hash of each top-level declaration, keyed by name
+    std::map<std::string, uint64_t> declaration_hashes() {
+        std::map<std::string, uint64_t> hashes;
+        CompilationUnitNode* unit = result.get_node();
+        for (int i = 0; i < unit->statements.size; ++i) {
+            if (auto* function = node_cast<FunctionDeclarationNode>(unit->statements.values[i])) {
+                hashes[std::string(function->name->name)] = function->structuralHash;
+            } else if (auto* type = node_cast<TypeDeclarationNode>(unit->statements.values[i])) {
+                hashes[std::string(type->name->name)] = type->structuralHash;
+            }
+        }
+        return hashes;
+    }
+};
+
+static const char* HASH_TEST_SOURCE = R"(type Counter {
+    i32 count;
+    fn add(i32 amount): i32 { count = count + amount; return count; }
+}
+fn square(i32 x): i32 { return x * x; }
+fn main(): i32 {
+    var c = new Counter();
+    i32 total = square(3);
+    while (total < 100) { total = total + c.add(1); }
+    return total;
+}
+)";
+
+TestResult test_hash_ignores_layout_and_comments() {
+    HashTestParse original(HASH_TEST_SOURCE);
+    ASSERT_TRUE(original.result.is_success(), "Parser should successfully parse hash test source");
+
+    std::string reformatted = R"(// Leading comment
+type Counter
+{
+    i32 count;  // trailing comment
+    fn add(i32 amount): i32
+    {
+        count = count + amount;
+        return count;
+    }
+}
+
+fn square(i32 x): i32 {
+    /* block comment */ return x*x;
+}
+
+fn main(): i32 {
+    var c = new Counter();
+    i32 total = square(3);
+    while (total < 100) { total = total + c.add(1); }
+    return total;
+}
+)";
+    HashTestParse other(reformatted);
+    ASSERT_TRUE(other.result.is_success(), "Parser should successfully parse reformatted source");
+
+    auto a = original.declaration_hashes();
+    auto b = other.declaration_hashes();
+    ASSERT_EQ(3, a.size(), "Should find three top-level declarations");
+    for (const auto& [name, hash] : a) {
+        ASSERT_TRUE(hash != 0, "Declaration " + name + " should have a hash");
+        ASSERT_TRUE(b[name] == hash, "Declaration " + name + " should hash the same after reformatting");
+    }
+    ASSERT_TRUE(ast_structural_hash(original.result.get_node()) == ast_structural_hash(other.result.get_node()),
+                "Whole units should hash the same after reformatting");
+
+    return TestResult(true, "Hashes ignore whitespace, comments and offsets");
+}
+
+TestResult test_hash_tracks_edited_declaration_only() {
+    HashTestParse original(HASH_TEST_SOURCE);
+    std::string edited_text = HASH_TEST_SOURCE;
+    edited_text.replace(edited_text.find("x * x"), 5, "x * x + 1");
+    HashTestParse edited(edited_text);
+    ASSERT_TRUE(original.result.is_success() && edited.result.is_success(), "Both sources should parse");
+
+    auto a = original.declaration_hashes();
+    auto b = edited.declaration_hashes();
+    ASSERT_TRUE(a["square"] != b["square"], "The edited function should change hash");
+    ASSERT_TRUE(a["main"] == b["main"], "Untouched functions should keep their hash");
+    ASSERT_TRUE(a["Counter"] == b["Counter"], "Untouched types should keep their hash");
+
+    return TestResult(true, "Only the edited declaration changes hash");
+}
+
+TestResult test_hash_distinguishes_operators_and_names() {
+    auto hash_of = [](const std::string& body) {
+        HashTestParse parse("fn f(i32 a, i32 b): i32 { " + body + " }");
+        return parse.result.is_success() ? parse.declaration_hashes()["f"] : 0;
+    };
+
+    uint64_t base = hash_of("return a + b;");
+    ASSERT_TRUE(base != 0, "Base function should parse and hash");
+    ASSERT_TRUE(base == hash_of("return a + b;"), "Identical functions should hash the same");
+    ASSERT_TRUE(base != hash_of("return a - b;"), "Changing an operator should change the hash");
+    ASSERT_TRUE(base != hash_of("return b + a;"), "Swapping operands should change the hash");
+    ASSERT_TRUE(base != hash_of("return a + 1;"), "Replacing a name with a literal should change the hash");
+    ASSERT_TRUE(hash_of("return a + 1;") != hash_of("return a + 2;"), "Changing a literal value should change the hash");
+
+    return TestResult(true, "Operators, operand order, names and literals all feed the hash");
+}
+
+TestResult test_hash_survives_reordering() {
+    std::string reordered = R"(fn main(): i32 {
+    var c = new Counter();
+    i32 total = square(3);
+    while (total < 100) { total = total + c.add(1); }
+    return total;
+}
+fn square(i32 x): i32 { return x * x; }
+type Counter {
+    i32 count;
+    fn add(i32 amount): i32 { count = count + amount; return count; }
+}
+)";
+    HashTestParse original(HASH_TEST_SOURCE);
+    HashTestParse moved(reordered);
+    ASSERT_TRUE(original.result.is_success() && moved.result.is_success(), "Both sources should parse");
+
+    auto a = original.declaration_hashes();
+    auto b = moved.declaration_hashes();
+    for (const auto& [name, hash] : a) {
+        ASSERT_TRUE(b[name] == hash, "Declaration " + name + " should keep its hash when moved");
+    }
+    ASSERT_TRUE(ast_structural_hash(original.result.get_node()) != ast_structural_hash(moved.result.get_node()),
+                "The unit hash should reflect declaration order");
+
+    return TestResult(true, "Declarations keep their hash when moved");
+}
+
+TestResult test_hash_type_follows_members() {
+    std::string edited_text = HASH_TEST_SOURCE;
+    edited_text.replace(edited_text.find("count + amount"), 14, "count + amount * 2");
+    HashTestParse original(HASH_TEST_SOURCE);
+    HashTestParse edited(edited_text);
+    ASSERT_TRUE(original.result.is_success() && edited.result.is_success(), "Both sources should parse");
+
+    auto* type = node_cast<TypeDeclarationNode>(original.result.get_node()->statements.values[0]);
+    auto* edited_type = node_cast<TypeDeclarationNode>(edited.result.get_node()->statements.values[0]);
+    ASSERT_TRUE(type && edited_type, "First declaration should be the type");
+    ASSERT_TRUE(type->structuralHash != edited_type->structuralHash, "A member body edit should change the type hash");
+
+    FunctionDeclarationNode* method = nullptr;
+    for (int i = 0; i < type->members.size; ++i) {
+        if (auto* function = node_cast<FunctionDeclarationNode>(type->members.values[i])) method = function;
+    }
+    ASSERT_TRUE(method != nullptr, "Type should have a member function");
+    ASSERT_TRUE(method->structuralHash == ast_structural_hash(method), "Stored hash should match a fresh computation");
+
+    return TestResult(true, "Type hashes include their members");
+}
+
+void run_ast_hash_tests() {
+    TestSuite suite("AST Structural Hash Tests");
+
+    suite.add_test("Hash Ignores Layout And Comments", test_hash_ignores_layout_and_comments);
+    suite.add_test("Hash Tracks Edited Declaration Only", test_hash_tracks_edited_declaration_only);
+    suite.add_test("Hash Distinguishes Operators And Names", test_hash_distinguishes_operators_and_names);
+    suite.add_test("Hash Survives Reordering", test_hash_survives_reordering);
+    suite.add_test("Hash Type Follows Members", test_hash_type_follows_members);
+
+    suite.run_all();
+}
@@ -0,0 +1,264 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "ast/ast.hpp"
+#include "ast/ast_dumper.hpp"
+#include "ast/ast_hash.hpp"
+#include "ast/ast_parallel.hpp"
+#include "ast/ast_walker.hpp"
+#include "semantic/symbol_table.hpp"
+#include "common/logger.hpp"
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+static std::string generate_parallel_script(int function_count) {
+    std::string source;
+    source += "type Point { i32 x; i32 y; fn sum(): i32 { return x + y; } }\n";
+    for (int i = 0; i < function_count; ++i) {
+        std::string n = std::to_string(i);
+        source += "fn f" + n + "(i32 a, i32 b): i32 {\n";
+        source += "    var total = a * 2 + b - " + n + ";\n";
+        source += "    for (var i = 0; i < 10; i++) { total = total + i * (a - b); }\n";
+        source += "    if (total > 100) { total = total / 2; }\n";
+        source += "    while (total < 0) { total = total + 7; }\n";
+        source += "    return total + f" + std::to_string(i > 0 ? i - 1 : 0) + "(a, b);\n";
+        source += "}\n";
+    }
+    return source;
+}
+
+static const char* PARALLEL_SAMPLE =
+    "using System;\n"
+    "type Point {\n"
+    "    i32 x;\n"
+    "    i32 y;\n"
+    "    fn length(): i32 { return x * x + y * y; }\n"
+    "    fn scale(i32 factor): i32 { return x * factor; }\n"
+    "}\n"
+    "fn main(): i32 { var count = 3; var flag = count > 2; return count + 1; }\n";
+
+TestResult test_task_pool_runs_every_task_once() {
+    AstTaskPool pool(4);
+    ASSERT_EQ(4u, pool.worker_count(), "Pool should use the requested worker count");
+
+    const size_t count = 1000;
+    std::vector<std::atomic<int>> runs(count);
+    std::atomic<int> on_helpers{0};
+    pool.run(count, [&](size_t index, unsigned worker) {
+        // Make the first block slow so the other workers have to steal from it
+        if (index < count / 4) {
+            volatile int spin = 0;
+            for (int i = 0; i < 20000; ++i) spin = spin + i;
+        }
+        runs[index]++;
+        if (worker != 0) on_helpers++;
+    });
+
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(1, runs[i].load(), "Every task should run exactly once");
+    }
+    LOG_INFO("Task pool: " + std::to_string(on_helpers.load()) + " of " + std::to_string(count) + " tasks ran on helper threads", LogCategory::TEST);
+
+    // The pool can be reused, and reports the failure of the lowest failing task
+    std::string message;
+    try {
+        pool.run(100, [](size_t index, unsigned) {
+            if (index == 70 || index == 30) throw std::runtime_error("task " + std::to_string(index));
+        });
+    } catch (const std::runtime_error& error) {
+        message = error.what();
+    }
+    ASSERT_STR_EQ("task 30", message, "Lowest failing task should be reported");
+
+    return TestResult(true, "Every task ran once and errors are deterministic");
+}
+
+TestResult test_collect_pass_units() {
+    std::string source = PARALLEL_SAMPLE;
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+    CompilationUnitNode* root = result.get_node();
+
+    auto top_level = ast_collect_pass_units(root, AstPassGranularity::TopLevel);
+    ASSERT_EQ((size_t)3, top_level.size(), "Using, type and function are top-level units");
+
+    auto members = ast_collect_pass_units(root, AstPassGranularity::Members);
+    ASSERT_EQ((size_t)6, members.size(), "Using, four type members and main are member units");
+    ASSERT_TRUE(node_is<UsingDirectiveNode>(members[0].node), "Units should stay in source order");
+    ASSERT_TRUE(node_is<TypeDeclarationNode>(members[1].ownerType), "Type members should know their type");
+    ASSERT_TRUE(members[5].ownerType == nullptr, "Free functions have no owner type");
+
+    auto bodies = ast_collect_pass_units(root, AstPassGranularity::FunctionBodies);
+    ASSERT_EQ((size_t)3, bodies.size(), "Each function body is a unit");
+    for (const auto& body : bodies) {
+        ASSERT_TRUE(node_is<BlockStatementNode>(body.node), "Body units should be blocks");
+        ASSERT_TRUE(node_is<FunctionDeclarationNode>(body.owner), "Body units should know their function");
+    }
+    ASSERT_TRUE(bodies[0].ownerType != nullptr && bodies[2].ownerType == nullptr, "Only methods have an owner type");
+
+    return TestResult(true, "Units cover top-level statements, members and bodies");
+}
+
+// Reports one diagnostic per body, using the unit's scratch allocator
+class BodyCountPass : public AstParallelPass {
+public:
+    std::vector<int> counts;
+    std::vector<int> merged;
+
+    AstPassGranularity granularity() const override { return AstPassGranularity::FunctionBodies; }
+
+    void begin(CompilationUnitNode*, const std::vector<AstPassUnit>& units) override {
+        counts.assign(units.size(), 0);
+    }
+
+    void run(const AstPassUnit& unit, AstPassContext& context) override {
+        int* scratch = context.scratch().alloc_array<int>(16);
+        scratch[0] = static_cast<int>(unit.node->sourceStart);
+        counts[context.unit_index()] = scratch[0];
+        auto* function = node_cast<FunctionDeclarationNode>(unit.owner);
+        context.report(unit.node, "body of " + std::string(function->name->name));
+    }
+
+    void merge(const AstPassUnit&, AstPassContext& context) override {
+        merged.push_back(counts[context.unit_index()]);
+    }
+};
+
+TestResult test_parallel_pass_merges_in_order() {
+    std::string source = generate_parallel_script(200);
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+
+    AstTaskPool serial_pool(1);
+    AstTaskPool pool(4);
+    BodyCountPass serial_pass, parallel_pass;
+    auto serial = ast_run_parallel_pass(result.get_node(), serial_pass, serial_pool);
+    auto parallel = ast_run_parallel_pass(result.get_node(), parallel_pass, pool);
+
+    ASSERT_EQ((size_t)201, parallel.size(), "One diagnostic per body");
+    ASSERT_EQ(serial.size(), parallel.size(), "Diagnostic count should not depend on threads");
+    for (size_t i = 0; i < serial.size(); ++i) {
+        ASSERT_TRUE(serial[i].node == parallel[i].node && serial[i].message == parallel[i].message, "Diagnostics should come back in unit order");
+    }
+    ASSERT_STR_EQ("body of sum", parallel[0].message, "First diagnostic should be the first body");
+    ASSERT_TRUE(serial_pass.merged == parallel_pass.merged, "Merge should run in unit order");
+
+    return TestResult(true, "Results and diagnostics merge deterministically");
+}
+
+TestResult test_parallel_builtin_passes_match_serial() {
+    std::string source = generate_parallel_script(120);
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+    CompilationUnitNode* root = result.get_node();
+    AstTaskPool pool(4);
+
+    // Hashing: the parser already stored serial hashes
+    std::vector<uint64_t> serial_hashes;
+    for (AstNode* statement : root->statements) {
+        if (auto* function = node_cast<FunctionDeclarationNode>(statement)) {
+            serial_hashes.push_back(function->structuralHash);
+            function->structuralHash = 0;
+        }
+    }
+    ast_compute_structural_hashes(root, pool);
+    size_t h = 0;
+    for (AstNode* statement : root->statements) {
+        if (auto* function = node_cast<FunctionDeclarationNode>(statement)) {
+            ASSERT_EQ(serial_hashes[h++], function->structuralHash, "Parallel hash should match serial hash");
+        }
+    }
+
+    // Printing: byte-identical in every format
+    for (AstDumpFormat format : { AstDumpFormat::PseudoCode, AstDumpFormat::SExpression, AstDumpFormat::Json }) {
+        std::ostringstream serial_out, parallel_out;
+        ast_dump(root, format, serial_out);
+        {
+            AstDumpWriter writer(parallel_out);
+            ast_dump(root, format, writer, pool);
+        }
+        ASSERT_TRUE(!serial_out.str().empty(), "Dump should not be empty");
+        ASSERT_TRUE(serial_out.str() == parallel_out.str(), "Parallel dump should match serial dump");
+    }
+
+    // Type inference: same table as a single-threaded run
+    SymbolTable table;
+    build_symbol_table(table, root);
+    AstTaskPool serial_pool(1);
+    NodeSideTable<std::string> serial_types, parallel_types;
+    infer_expression_types(table, root, serial_types, serial_pool);
+    infer_expression_types(table, root, parallel_types, pool);
+    ASSERT_EQ(serial_types.size(), parallel_types.size(), "Type tables should cover the same nodes");
+
+    auto* first = node_cast<FunctionDeclarationNode>(root->statements[1]);
+    auto* declaration = node_cast<VariableDeclarationNode>(first->body->statements[0]);
+    ASSERT_TRUE(declaration != nullptr, "First statement should declare total");
+    AstNode* initializer = declaration->initializer;
+    ASSERT_STR_EQ("i32", parallel_types.get(initializer), "a * 2 + b - 0 should infer as i32");
+
+    return TestResult(true, "Hashing, printing and type inference match their serial versions");
+}
+
+TestResult test_parallel_pass_benchmark() {
+    const int iterations = 10;
+
+    std::string source = generate_parallel_script(450);
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+    CompilationUnitNode* root = result.get_node();
+
+    using Clock = std::chrono::steady_clock;
+    auto time_ms = [&](auto&& body) {
+        auto start = Clock::now();
+        for (int i = 0; i < iterations; ++i) body();
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / iterations;
+    };
+
+    AstTaskPool pool;
+    double hash_serial = time_ms([&] { ast_compute_structural_hashes(root); });
+    double hash_parallel = time_ms([&] { ast_compute_structural_hashes(root, pool); });
+    double dump_serial = time_ms([&] { std::ostringstream out; ast_dump(root, AstDumpFormat::Json, out); });
+    double dump_parallel = time_ms([&] {
+        std::ostringstream out;
+        AstDumpWriter writer(out);
+        ast_dump(root, AstDumpFormat::Json, writer, pool);
+    });
+
+    LOG_INFO("Parallel passes with " + std::to_string(pool.worker_count()) + " workers on " +
+             std::to_string(parser.get_allocator().node_count()) + " nodes:", LogCategory::TEST);
+    LOG_INFO("  hash " + std::to_string(hash_serial) + " ms serial, " + std::to_string(hash_parallel) + " ms parallel", LogCategory::TEST);
+    LOG_INFO("  json dump " + std::to_string(dump_serial) + " ms serial, " + std::to_string(dump_parallel) + " ms parallel", LogCategory::TEST);
+
+    return TestResult(true, std::to_string(pool.worker_count()) + " workers: hash " + std::to_string(hash_parallel) +
+                      " ms, dump " + std::to_string(dump_parallel) + " ms");
+}
+
+void run_ast_parallel_tests() {
+    TestSuite suite("AST Parallel Pass Tests");
+
+    suite.add_test("Task Pool Runs Every Task Once", test_task_pool_runs_every_task_once);
+    suite.add_test("Collect Pass Units", test_collect_pass_units);
+    suite.add_test("Parallel Pass Merges In Order", test_parallel_pass_merges_in_order);
+    suite.add_test("Parallel Built-in Passes Match Serial", test_parallel_builtin_passes_match_serial);
+    suite.add_test("Parallel Pass Benchmark", test_parallel_pass_benchmark);
+
+    suite.run_all();
+}
@@ -0,0 +1,237 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "ast/ast.hpp"
+#include "ast/ast_serializer.hpp"
+#include "ast/ast_walker.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <type_traits>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium::Scripting::Common;
+using namespace Mycelium;
+
+// Flattens a tree into a string of node types, texts and operator kinds so two
+// trees can be compared structurally.
+class TreeSignature : public AstWalker<TreeSignature> {
+public:
+    using AstWalker<TreeSignature>::visit;
+    std::string text;
+
+    template <typename T>
+    void record(T* node) {
+        text += get_node_type_name(node);
+        if constexpr (std::is_same_v<T, BinaryExpressionNode>) text += std::to_string((int)node->opKind);
+        text += "(";
+        ast_visit_data_fields(node, [this](auto& field) { append_data(field); });
+        walk_children(node);
+        text += ")";
+    }
+
+    void append_data(std::string_view value) { text += "'" + std::string(value) + "'"; }
+    void append_data(const SizedArray<Mycelium::Scripting::ModifierKind>& modifiers) { text += "m" + std::to_string(modifiers.size); }
+    void append_data(const std::string& value) { text += value; }
+
+    #define TREE_SIGNATURE_VISIT(NodeType, BaseType) \
+        void visit(NodeType* node) { record(node); }
+    AST_NODE_LIST(TREE_SIGNATURE_VISIT)
+    #undef TREE_SIGNATURE_VISIT
+};
+
+static std::string signature_of(AstNode* node) {
+    TreeSignature signature;
+    signature.walk(node);
+    return signature.text;
+}
+
+static const char* SERIALIZER_TEST_SOURCE = R"(
+    type Point {
+        i32 x;
+        i32 y;
+        fn length_squared(): i32 { return x * x + y * y; }
+    }
+    enum Color { Red, Green, Blue }
+    fn main(): i32 {
+        var p = new Point();
+        i32 a, b = 3;
+        for (var i = 0; i < 10; i++) { a = a + i; }
+        if (a > 5 && b != 2) { return -a; }
+        return p.length_squared() + a;
+    }
+)";
+
+TestResult test_serializer_roundtrip_copy() {
+    std::string source = SERIALIZER_TEST_SOURCE;
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse serializer test source");
+
+    std::vector<uint8_t> bytes;
+    ASSERT_TRUE(ast_serialize(result.get_node(), source, bytes), "Serialization should succeed");
+
+    AstBinaryFile file;
+    ASSERT_TRUE(file.open_memory(bytes), "Image should open from memory");
+
+    AstAllocator allocator;
+    CompilationUnitNode* loaded = file.load_into(allocator, ast_hash_source(source));
+    ASSERT_TRUE(loaded != nullptr, "Image should load into an allocator");
+
+    // The copy must not depend on the image
+    file.close();
+
+    ASSERT_STR_EQ(signature_of(result.get_node()), signature_of(loaded), "Loaded tree should match the parsed tree");
+    return TestResult(true, "Copied tree matches the parsed tree");
+}
+
+TestResult test_serializer_roundtrip_mmap_in_place() {
+    std::string source = SERIALIZER_TEST_SOURCE;
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse serializer test source");
+
+    std::string path = (std::filesystem::temp_directory_path() / "myre_ast_serializer_test.mast").string();
+    ASSERT_TRUE(ast_save_binary(result.get_node(), source, path), "Image should be written to disk");
+
+    AstBinaryFile file;
+    ASSERT_TRUE(file.open(path), "Image should map from disk");
+#ifdef MYCELIUM_AST_COMPRESSED_HANDLES
+    ASSERT_TRUE(file.load_in_place(ast_hash_source(source)) == nullptr, "Handles cannot point into a mapped image");
+    file.close();
+    std::filesystem::remove(path);
+    return TestResult(true, "In-place loading is unavailable with compressed handles");
+#endif
+    CompilationUnitNode* loaded = file.load_in_place(ast_hash_source(source));
+    ASSERT_TRUE(loaded != nullptr, "Image should relocate in place");
+    ASSERT_TRUE(file.load_in_place(ast_hash_source(source)) == loaded, "Loading twice should return the same tree");
+
+    std::string expected = signature_of(result.get_node());
+    std::string actual = signature_of(loaded);
+    file.close();
+    std::filesystem::remove(path);
+
+    ASSERT_STR_EQ(expected, actual, "Mapped tree should match the parsed tree");
+    return TestResult(true, "Mapped tree matches the parsed tree");
+}
+
+TestResult test_serializer_rejects_stale_images() {
+    std::string source = SERIALIZER_TEST_SOURCE;
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse serializer test source");
+
+    std::vector<uint8_t> bytes;
+    ASSERT_TRUE(ast_serialize(result.get_node(), source, bytes), "Serialization should succeed");
+
+    AstAllocator allocator;
+    AstBinaryFile file;
+    ASSERT_TRUE(file.open_memory(bytes), "Image should open from memory");
+    ASSERT_TRUE(file.load_into(allocator, ast_hash_source(source + " ")) == nullptr, "Changed source should invalidate the image");
+
+    std::vector<uint8_t> wrong_version = bytes;
+    reinterpret_cast<AstBinaryHeader*>(wrong_version.data())->version++;
+    ASSERT_TRUE(file.open_memory(wrong_version), "Image should open from memory");
+    ASSERT_TRUE(file.load_into(allocator, ast_hash_source(source)) == nullptr, "Different format version should invalidate the image");
+
+    std::vector<uint8_t> truncated(bytes.begin(), bytes.begin() + bytes.size() / 2);
+    ASSERT_TRUE(file.open_memory(truncated), "Image should open from memory");
+    ASSERT_TRUE(file.load_into(allocator, ast_hash_source(source)) == nullptr, "Truncated image should be rejected");
+
+    // Point the root's first statement back at the root
+    std::vector<uint8_t> cyclic = bytes;
+    uint64_t root = reinterpret_cast<AstBinaryHeader*>(cyclic.data())->rootOffset;
+    auto* unit = reinterpret_cast<CompilationUnitNode*>(cyclic.data() + root - 1);
+    uint64_t statements = 0;  // The encoded slot is pointer or handle wide
+    memcpy(&statements, &unit->statements.values, sizeof(unit->statements.values));
+    memcpy(cyclic.data() + statements - 1, &root, sizeof(root));
+    ASSERT_TRUE(file.open_memory(cyclic), "Image should open from memory");
+    ASSERT_TRUE(file.load_into(allocator, ast_hash_source(source)) == nullptr, "A child pointing at an ancestor should be rejected");
+    ASSERT_TRUE(file.open_memory(cyclic), "Image should open from memory");
+    ASSERT_TRUE(file.load_in_place(ast_hash_source(source)) == nullptr, "In place as well");
+
+    return TestResult(true, "Stale and corrupt images are rejected");
+}
+
+TestResult test_serializer_rejects_error_trees() {
+    std::string source = "fn broken( { return 1 }";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+
+    std::vector<uint8_t> bytes;
+    if (result.get_node() && result.get_node()->contains_errors) {
+        ASSERT_TRUE(!ast_serialize(result.get_node(), source, bytes), "Trees with errors should not be serialized");
+    }
+    return TestResult(true, "Trees with errors are not cached");
+}
+
+TestResult test_serializer_load_benchmark() {
+    std::string source;
+    for (int i = 0; i < 400; ++i) {
+        std::string n = std::to_string(i);
+        source += "fn f" + n + "(i32 a, i32 b): i32 {\n";
+        source += "    var total = a * 2 + b - " + n + ";\n";
+        source += "    for (var i = 0; i < 10; i++) { total = total + i * (a - b); }\n";
+        source += "    if (total > 100) { total = total / 2; }\n";
+        source += "    while (total < 0) { total = total + 7; }\n";
+        source += "    return total;\n";
+        source += "}\n";
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const int iterations = 5;
+
+    std::vector<uint8_t> bytes;
+    std::string parsed_signature;
+    auto parse_start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        TokenStream stream = tokenize_test_source(source);
+        Parser parser(stream);
+        auto result = parser.parse();
+        ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+        if (i == 0) {
+            ASSERT_TRUE(ast_serialize(result.get_node(), source, bytes), "Serialization should succeed");
+            parsed_signature = signature_of(result.get_node());
+        }
+    }
+    auto parse_time = std::chrono::duration<double, std::milli>(Clock::now() - parse_start).count();
+
+    uint64_t source_hash = ast_hash_source(source);
+    auto load_start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        AstBinaryFile file;
+        file.open_memory(bytes);
+        AstAllocator allocator;
+        CompilationUnitNode* loaded = file.load_into(allocator, source_hash);
+        ASSERT_TRUE(loaded != nullptr, "Image should load");
+        if (i == 0) ASSERT_STR_EQ(parsed_signature, signature_of(loaded), "Loaded tree should match the parsed tree");
+    }
+    auto load_time = std::chrono::duration<double, std::milli>(Clock::now() - load_start).count();
+
+    LOG_INFO("AST cache benchmark: " + std::to_string(bytes.size()) + " byte image, " + std::to_string(iterations) + " runs", LogCategory::TEST);
+    LOG_INFO("  Lex + parse:      " + std::to_string(parse_time) + " ms", LogCategory::TEST);
+    LOG_INFO("  Load into arena:  " + std::to_string(load_time) + " ms", LogCategory::TEST);
+
+    return TestResult(true, "Load " + std::to_string(load_time) + " ms vs parse " + std::to_string(parse_time) + " ms");
+}
+
+void run_ast_serializer_tests() {
+    TestSuite suite("AST Serializer Tests");
+
+    suite.add_test("Serializer Roundtrip Copy", test_serializer_roundtrip_copy);
+    suite.add_test("Serializer Roundtrip Mmap In Place", test_serializer_roundtrip_mmap_in_place);
+    suite.add_test("Serializer Rejects Stale Images", test_serializer_rejects_stale_images);
+    suite.add_test("Serializer Rejects Error Trees", test_serializer_rejects_error_trees);
+    suite.add_test("Serializer Load Benchmark", test_serializer_load_benchmark);
+
+    suite.run_all();
+}
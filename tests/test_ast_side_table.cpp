@@ -0,0 +1,174 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "ast/ast.hpp"
+#include "ast/ast_side_table.hpp"
+#include "ast/ast_serializer.hpp"
+#include "ast/ast_walker.hpp"
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+
+// Collects every reachable node along with the node it was reached from.
+class ParentCollector : public AstWalker<ParentCollector> {
+public:
+    using AstWalker<ParentCollector>::visit;
+    std::vector<AstNode*> nodes;
+    std::vector<AstNode*> parents;
+    AstNode* current = nullptr;
+
+    template <typename T>
+    void collect(T* node) {
+        nodes.push_back(node);
+        parents.push_back(current);
+        AstNode* saved = current;
+        current = node;
+        walk_children(node);
+        current = saved;
+    }
+
+    #define PARENT_COLLECTOR_VISIT(NodeType, BaseType) \
+        void visit(NodeType* node) { collect(node); }
+    AST_NODE_LIST(PARENT_COLLECTOR_VISIT)
+    #undef PARENT_COLLECTOR_VISIT
+};
+
+static const char* SIDE_TABLE_TEST_SOURCE = R"(
+    type Point {
+        i32 x;
+        fn value(): i32 { return x; }
+    }
+    fn main(): i32 {
+        var p = new Point();
+        for (var i = 0; i < 3; i++) { p.x = p.x + i; }
+        return p.value();
+    }
+)";
+
+static bool ids_are_unique_and_below(const std::vector<AstNode*>& nodes, uint32_t count) {
+    std::vector<bool> seen(count, false);
+    for (AstNode* node : nodes) {
+        if (node->nodeId >= count || seen[node->nodeId]) return false;
+        seen[node->nodeId] = true;
+    }
+    return true;
+}
+
+TestResult test_node_ids_are_dense() {
+    std::string source = SIDE_TABLE_TEST_SOURCE;
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse side table test source");
+
+    ParentCollector collector;
+    collector.walk(result.get_node());
+
+    uint32_t count = parser.get_allocator().node_count();
+    ASSERT_TRUE(collector.nodes.size() <= count, "Every reachable node should have been counted by the allocator");
+    ASSERT_TRUE(ids_are_unique_and_below(collector.nodes, count), "Node ids should be unique and below the allocator's node count");
+
+    return TestResult(true, std::to_string(collector.nodes.size()) + " reachable nodes, " + std::to_string(count) + " ids");
+}
+
+TestResult test_side_table_lookup() {
+    std::string source = SIDE_TABLE_TEST_SOURCE;
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse side table test source");
+
+    ParentCollector collector;
+    collector.walk(result.get_node());
+
+    NodeSideTable<int> depth(-1);
+    NodeSideTable<bool> is_expression;
+    for (size_t i = 0; i < collector.nodes.size(); ++i) {
+        AstNode* node = collector.nodes[i];
+        AstNode* parent = collector.parents[i];
+        depth[node] = parent ? depth.get(parent) + 1 : 0;
+        is_expression.set(node, node_is<ExpressionNode>(node));
+    }
+
+    ASSERT_EQ(0, depth.get(result.get_node()), "Root should have depth 0");
+    for (size_t i = 0; i < collector.nodes.size(); ++i) {
+        AstNode* node = collector.nodes[i];
+        if (collector.parents[i]) {
+            ASSERT_EQ(depth.get(collector.parents[i]) + 1, depth.get(node), "Child depth should be one more than its parent");
+        }
+        ASSERT_TRUE(is_expression.get(node) == node_is<ExpressionNode>(node), "Flag should match the node type");
+    }
+
+    NodeSideTable<int> empty(-1);
+    ASSERT_EQ(-1, empty.get(result.get_node()), "Unset entries should return the default");
+    ASSERT_EQ(0, (int)empty.size(), "Reading should not grow the table");
+
+    return TestResult(true, "Side tables store per-node values");
+}
+
+TestResult test_parent_index_matches_walk() {
+    std::string source = SIDE_TABLE_TEST_SOURCE;
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse side table test source");
+
+    ParentCollector collector;
+    collector.walk(result.get_node());
+
+    AstParentIndex index(result.get_node());
+    for (size_t i = 0; i < collector.nodes.size(); ++i) {
+        ASSERT_TRUE(index.parent_of(collector.nodes[i]) == collector.parents[i], "Parent index should match the walk");
+    }
+
+    int checked = 0;
+    for (AstNode* node : collector.nodes) {
+        if (node_is<ReturnStatementNode>(node)) {
+            auto* function = index.find_ancestor<FunctionDeclarationNode>(node);
+            ASSERT_TRUE(function != nullptr, "Return statements should have an enclosing function");
+            checked++;
+        }
+    }
+    ASSERT_EQ(2, checked, "Both return statements should be checked");
+
+    return TestResult(true, "Parent index matches the tree");
+}
+
+TestResult test_loaded_tree_gets_fresh_ids() {
+    std::string source = SIDE_TABLE_TEST_SOURCE;
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse side table test source");
+
+    std::vector<uint8_t> bytes;
+    ASSERT_TRUE(ast_serialize(result.get_node(), source, bytes), "Serialization should succeed");
+
+    AstBinaryFile file;
+    ASSERT_TRUE(file.open_memory(bytes), "Image should open from memory");
+    AstAllocator allocator;
+    CompilationUnitNode* loaded = file.load_into(allocator, ast_hash_source(source));
+    ASSERT_TRUE(loaded != nullptr, "Image should load into an allocator");
+
+    ParentCollector collector;
+    collector.walk(loaded);
+    ASSERT_EQ((uint32_t)collector.nodes.size(), allocator.node_count(), "Loaded tree should use exactly one id per node");
+    ASSERT_TRUE(ids_are_unique_and_below(collector.nodes, allocator.node_count()), "Loaded ids should be dense");
+
+    return TestResult(true, "Loaded trees are renumbered densely");
+}
+
+void run_ast_side_table_tests() {
+    TestSuite suite("AST Side Table Tests");
+
+    suite.add_test("Node Ids Are Dense", test_node_ids_are_dense);
+    suite.add_test("Side Table Lookup", test_side_table_lookup);
+    suite.add_test("Parent Index Matches Walk", test_parent_index_matches_walk);
+    suite.add_test("Loaded Tree Gets Fresh Ids", test_loaded_tree_gets_fresh_ids);
+
+    suite.run_all();
+}
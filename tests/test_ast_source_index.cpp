@@ -0,0 +1,162 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "ast/ast.hpp"
+#include "ast/ast_source_index.hpp"
+#include "ast/ast_walker.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+
+// Brute force reference: every node whose span contains the offset.
+class ContainingNodes : public AstWalker<ContainingNodes> {
+public:
+    using AstWalker<ContainingNodes>::visit;
+    int offset = 0;
+    std::vector<AstNode*> nodes;
+
+    template <typename T>
+    void check(T* node) {
+        if (node->sourceLength > 0 && node->sourceStart <= offset && offset < node->sourceStart + node->sourceLength) {
+            nodes.push_back(node);
+        }
+        walk_children(node);
+    }
+
+    #define CONTAINING_NODES_VISIT(NodeType, BaseType) \
+        void visit(NodeType* node) { check(node); }
+    AST_NODE_LIST(CONTAINING_NODES_VISIT)
+    #undef CONTAINING_NODES_VISIT
+};
+
+static const char* SOURCE_INDEX_TEST_SOURCE = R"(type Point {
+    i32 x;
+    i32 y;
+    fn length_squared(): i32 { return x * x + y * y; }
+}
+fn main(): i32 {
+    var p = new Point();
+    i32 total = 0;
+    for (var i = 0; i < 10; i++) { total = total + i; }
+    if (total > 5) { return p.length_squared(); }
+    return total;
+}
+)";
+
+TestResult test_parser_records_spans() {
+    std::string source = SOURCE_INDEX_TEST_SOURCE;
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source index test source");
+
+    AstSourceIndex index(result.get_node());
+    for (const auto& entry : index.entries()) {
+        ASSERT_TRUE(entry.start >= 0 && entry.end <= (int)source.size(), "Spans should lie inside the source");
+        if (entry.parent >= 0) {
+            const auto& parent = index.entries()[entry.parent];
+            ASSERT_TRUE(parent.start <= entry.start && entry.end <= parent.end, "Entries should nest inside their parent");
+        }
+    }
+
+    auto* function = index.innermost_at((int)source.find("fn main"));
+    ASSERT_TRUE(node_is<FunctionDeclarationNode>(function), "The 'fn' keyword should belong to the function declaration");
+    std::string function_text = source.substr(function->sourceStart, function->sourceLength);
+    ASSERT_TRUE(function_text.rfind("fn main", 0) == 0, "Function span should start at 'fn'");
+    ASSERT_TRUE(function_text.back() == '}', "Function span should end at the closing brace");
+
+    return TestResult(true, std::to_string(index.size()) + " spans indexed");
+}
+
+TestResult test_source_index_innermost_and_enclosing() {
+    std::string source = SOURCE_INDEX_TEST_SOURCE;
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source index test source");
+
+    AstSourceIndex index(result.get_node());
+
+    int call_offset = (int)source.find("p.length_squared()") + 5;
+    auto* innermost = index.innermost_at(call_offset);
+    ASSERT_TRUE(node_is<IdentifierNode>(innermost), "Innermost node inside a member name should be the identifier");
+    ASSERT_TRUE(static_cast<IdentifierNode*>(innermost)->name == "length_squared", "Identifier should be the called member");
+
+    auto enclosing = index.enclosing_at(call_offset);
+    auto has = [&](auto predicate) { return std::any_of(enclosing.begin(), enclosing.end(), predicate); };
+    ASSERT_TRUE(has([](AstNode* n) { return node_is<CallExpressionNode>(n); }), "Enclosing nodes should include the call");
+    ASSERT_TRUE(has([](AstNode* n) { return node_is<IfStatementNode>(n); }), "Enclosing nodes should include the if statement");
+    ASSERT_TRUE(enclosing.back() == result.get_node(), "Outermost enclosing node should be the compilation unit");
+
+    // Compare against a full walk at every offset
+    for (int offset = 0; offset < (int)source.size(); ++offset) {
+        ContainingNodes reference;
+        reference.offset = offset;
+        reference.walk(result.get_node());
+        auto indexed = index.enclosing_at(offset);
+
+        ASSERT_EQ(reference.nodes.size(), indexed.size(), "Index and walk should find the same number of nodes at offset " + std::to_string(offset));
+        for (AstNode* node : reference.nodes) {
+            ASSERT_TRUE(std::find(indexed.begin(), indexed.end(), node) != indexed.end(), "Index should find every containing node");
+        }
+    }
+
+    ASSERT_TRUE(index.innermost_at((int)source.size() + 10) == nullptr, "Offsets past the end should find nothing");
+    return TestResult(true, "Index queries match a full walk at every offset");
+}
+
+TestResult test_source_index_replace_subtree() {
+    std::string source = SOURCE_INDEX_TEST_SOURCE;
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source index test source");
+    AstSourceIndex index(result.get_node());
+
+    // Edit the body of the first declaration, then reparse the edited text to
+    // obtain the replacement subtree.
+    std::string edited = source;
+    std::string before = "return x * x + y * y;";
+    edited.replace(edited.find(before), before.size(), "return x * x + y * y + x * y + 1;");
+
+    TokenStream edited_stream = tokenize_test_source(edited);
+    Parser edited_parser(edited_stream);
+    auto edited_result = edited_parser.parse();
+    ASSERT_TRUE(edited_result.is_success(), "Parser should successfully parse edited source");
+
+    AstNode* old_type = result.get_node()->statements[0];
+    AstNode* new_type = edited_result.get_node()->statements[0];
+    ASSERT_TRUE(index.replace_subtree(old_type, new_type), "Replacing an indexed subtree should succeed");
+    result.get_node()->statements.values[0] = new_type;
+
+    // The patched index must agree with one built from scratch on the edited tree
+    AstSourceIndex fresh(edited_result.get_node());
+    ASSERT_EQ(fresh.size(), index.size(), "Patched index should have as many entries as a fresh one");
+    for (size_t i = 0; i < fresh.size(); ++i) {
+        const auto& a = fresh.entries()[i];
+        const auto& b = index.entries()[i];
+        ASSERT_TRUE(a.start == b.start && a.end == b.end && a.depth == b.depth && a.node->typeId == b.node->typeId &&
+                    a.parent == b.parent && a.jump == b.jump,
+                    "Patched entry " + std::to_string(i) + " should match the fresh index");
+    }
+
+    auto* moved = index.innermost_at((int)edited.find("return total;"));
+    ASSERT_TRUE(node_is<ReturnStatementNode>(moved), "Nodes after the edit should be found at their shifted offsets");
+
+    return TestResult(true, "Patched index matches a rebuilt one");
+}
+
+void run_ast_source_index_tests() {
+    TestSuite suite("AST Source Index Tests");
+
+    suite.add_test("Parser Records Spans", test_parser_records_spans);
+    suite.add_test("Source Index Innermost And Enclosing", test_source_index_innermost_and_enclosing);
+    suite.add_test("Source Index Replace Subtree", test_source_index_replace_subtree);
+
+    suite.run_all();
+}
@@ -0,0 +1,187 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "ast/ast.hpp"
+#include "ast/ast_walker.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <type_traits>
+#include <string>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium::Scripting::Common;
+using namespace Mycelium;
+
+// Counts every node reachable from the root using the static walker.
+class CountingWalker : public AstWalker<CountingWalker> {
+public:
+    using AstWalker<CountingWalker>::visit;
+
+    int node_count = 0;
+    int call_count = 0;
+
+    template <typename T>
+    void count(T* node) {
+        node_count++;
+        if constexpr (std::is_same_v<T, CallExpressionNode>) call_count++;
+        walk_children(node);
+    }
+
+    #define COUNTING_WALKER_VISIT(NodeType, BaseType) \
+        void visit(NodeType* node) { count(node); }
+    AST_NODE_LIST(COUNTING_WALKER_VISIT)
+    #undef COUNTING_WALKER_VISIT
+};
+
+// The same traversal as CountingWalker, dispatched through accept() and the
+// virtual StructuralVisitor instead. Used as the baseline for the benchmark.
+class CountingVisitor : public StructuralVisitor {
+public:
+    int node_count = 0;
+    int call_count = 0;
+
+    template <typename T>
+    void count(T* node) {
+        node_count++;
+        if constexpr (std::is_same_v<T, CallExpressionNode>) call_count++;
+        ast_visit_fields(node, [this](auto& field) { visit_field(field); });
+    }
+
+    void visit_field(AstNode* node) {
+        if (node) node->accept(this);
+    }
+
+    template <typename T>
+    void visit_field(const SizedArray<T*>& nodes) {
+        for (int i = 0; i < nodes.size; ++i) {
+            visit_field(nodes.values[i]);
+        }
+    }
+
+    #define COUNTING_VISITOR_VISIT(NodeType, BaseType) \
+        void visit(NodeType* node) override { count(node); }
+    AST_NODE_LIST(COUNTING_VISITOR_VISIT)
+    #undef COUNTING_VISITOR_VISIT
+};
+
+// Builds a script with many functions mixing declarations, control flow and calls.
+static std::string generate_large_script(int function_count) {
+    std::string source;
+    source += "type Point { i32 x; i32 y; fn sum(): i32 { return x + y; } }\n";
+    for (int i = 0; i < function_count; ++i) {
+        std::string n = std::to_string(i);
+        source += "fn f" + n + "(i32 a, i32 b): i32 {\n";
+        source += "    var total = a * 2 + b - " + n + ";\n";
+        source += "    for (var i = 0; i < 10; i++) { total = total + i * (a - b); }\n";
+        source += "    if (total > 100) { total = total / 2; } else { total = -total; }\n";
+        source += "    while (total < 0) { total = total + 7; }\n";
+        source += "    return total + f" + std::to_string(i > 0 ? i - 1 : 0) + "(a, b);\n";
+        source += "}\n";
+    }
+    return source;
+}
+
+TestResult test_walker_visits_all_children() {
+    std::string source = R"(
+        fn add(i32 a, i32 b): i32 {
+            return a + b;
+        }
+        fn main(): i32 {
+            var x = add(1, 2);
+            return x;
+        }
+    )";
+
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse walker test source");
+
+    CountingWalker walker;
+    walker.walk(result.get_node());
+
+    CountingVisitor visitor;
+    result.get_node()->accept(&visitor);
+
+    ASSERT_TRUE(walker.node_count > 0, "Walker should visit nodes");
+    ASSERT_EQ(visitor.node_count, walker.node_count, "Walker and visitor should reach the same nodes");
+    ASSERT_EQ(1, walker.call_count, "Walker should dispatch the call expression to its exact type");
+    ASSERT_EQ(1, visitor.call_count, "Visitor should dispatch the call expression to its exact type");
+
+    return TestResult(true, "Walker visited " + std::to_string(walker.node_count) + " nodes");
+}
+
+TestResult test_walker_default_visit_descends() {
+    std::string source = "fn main() { if (a) { b(); } else { c(d()); } }";
+
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse walker test source");
+
+    // Only CallExpressionNode is handled; every other node falls back to the
+    // default visit, which must still reach calls nested in statements.
+    struct CallCounter : AstWalker<CallCounter> {
+        using AstWalker<CallCounter>::visit;
+        int calls = 0;
+        void visit(CallExpressionNode* node) { calls++; walk_children(node); }
+    } counter;
+    counter.walk(result.get_node());
+
+    ASSERT_EQ(3, counter.calls, "Default visits should reach every nested call");
+    return TestResult(true, "Default visits reach nested calls");
+}
+
+TestResult test_walker_vs_virtual_visitor_benchmark() {
+    const int function_count = 500;
+    const int iterations = 20;
+
+    // Tokens view the source text, so it has to outlive the parse
+    std::string source = generate_large_script(function_count);
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+    CompilationUnitNode* unit = result.get_node();
+
+    using Clock = std::chrono::steady_clock;
+
+    int visitor_nodes = 0;
+    auto visitor_start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        CountingVisitor visitor;
+        unit->accept(&visitor);
+        visitor_nodes = visitor.node_count;
+    }
+    auto visitor_time = std::chrono::duration<double, std::milli>(Clock::now() - visitor_start).count();
+
+    int walker_nodes = 0;
+    auto walker_start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        CountingWalker walker;
+        walker.walk(unit);
+        walker_nodes = walker.node_count;
+    }
+    auto walker_time = std::chrono::duration<double, std::milli>(Clock::now() - walker_start).count();
+
+    ASSERT_EQ(visitor_nodes, walker_nodes, "Walker and visitor should reach the same nodes");
+
+    LOG_INFO("AST traversal benchmark: " + std::to_string(walker_nodes) + " nodes x " + std::to_string(iterations) + " passes", LogCategory::TEST);
+    LOG_INFO("  StructuralVisitor (virtual): " + std::to_string(visitor_time) + " ms", LogCategory::TEST);
+    LOG_INFO("  AstWalker (static):          " + std::to_string(walker_time) + " ms", LogCategory::TEST);
+
+    return TestResult(true, "Walker " + std::to_string(walker_time) + " ms vs visitor " + std::to_string(visitor_time) + " ms");
+}
+
+void run_ast_walker_tests() {
+    TestSuite suite("AST Walker Tests");
+
+    suite.add_test("Walker Visits All Children", test_walker_visits_all_children);
+    suite.add_test("Walker Default Visit Descends", test_walker_default_visit_descends);
+    suite.add_test("Walker vs Virtual Visitor Benchmark", test_walker_vs_virtual_visitor_benchmark);
+
+    suite.run_all();
+}
@@ -0,0 +1,137 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "semantic/symbol_table.hpp"
+#include "codegen/codegen.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+static const StructLayout::Field* find_layout_field(const StructLayout* layout, const std::string& name) {
+    for (const auto& field : layout->fields) if (field.name == name) return &field;
+    return nullptr;
+}
+
+TestResult test_flags_share_words() {
+    std::string source =
+        "enum Mode { Idle, Hover, Press }\n"
+        "enum Shape { Dot, Box(i32, i32) }\n"
+        "type State { bool visible; i32 width; bool enabled; Mode mode; bool focused; Shape shape; }\n"
+        "extern type CState { bool visible; i32 width; bool enabled; }\n"
+        "fn main(): i32 { var s = new State(); s.focused = true; s.mode = 2; var f = s.focused; return s.width; }\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+
+    SymbolTable table;
+    table.set_bit_packing(true);
+    build_symbol_table(table, result.get_node());
+    ASSERT_EQ(2, table.get_enum_bits(table.find_type_scope("Mode")), "Three cases need two bits");
+    ASSERT_EQ(0, table.get_enum_bits(table.find_type_scope("Shape")), "Enums with payloads are not small");
+
+    // The bools and the small enum share one byte in place of 'visible'; the payload enum stays whole
+    const StructLayout* state = table.struct_type_of_scope(table.find_type_scope("State")).struct_layout();
+    ASSERT_EQ((size_t)3, state->elements.size(), "One packed word, 'width' and 'shape'");
+    ASSERT_TRUE(state->elements[0] == IRType::i8(), "Five bits fit in a byte");
+    const StructLayout::Field* mode = find_layout_field(state, "mode");
+    const StructLayout::Field* focused = find_layout_field(state, "focused");
+    ASSERT_TRUE(mode->packed() && mode->element == 0 && mode->bit_offset == 2 && mode->bit_width == 2,
+                "mode should take bits 2-3 of the word");
+    ASSERT_TRUE(focused->element == 0 && focused->bit_offset == 4, "focused should follow mode");
+    ASSERT_TRUE(!find_layout_field(state, "shape")->packed(), "A payload enum keeps its i32");
+    ASSERT_EQ((size_t)12, state->total_size, "Packed State should be a word, then two i32s");
+
+    const StructLayout* c_state = table.struct_type_of_scope(table.find_type_scope("CState")).struct_layout();
+    ASSERT_EQ((size_t)3, c_state->elements.size(), "Extern types are never packed");
+
+    auto savings = table.get_layout_savings();
+    ASSERT_EQ((size_t)2, savings.size(), "Enums should not be reported as structs");
+    ASSERT_TRUE(savings[0].declared_size == 24 && savings[0].size == 12, "State should halve");
+
+    // Reads shift and truncate, writes widen, shift and merge
+    CodeGenerator generator(table);
+    auto commands = generator.generate_code(result.get_node());
+    int shifts_left = 0, shifts_right = 0, widens = 0, narrows = 0;
+    for (const Command& command : commands) {
+        if (command.op == Op::Shl) shifts_left++;
+        if (command.op == Op::LShr) shifts_right++;
+        if (command.op == Op::ZExt) widens++;
+        if (command.op == Op::Trunc) narrows++;
+    }
+    ASSERT_EQ(2, shifts_left, "Both packed stores should shift into place");
+    ASSERT_EQ(1, shifts_right, "The packed read should shift down");
+    ASSERT_TRUE(widens == 1 && narrows == 2, "bool widens to the word, the i32 and the read narrow");
+
+    return TestResult(true, "Flags and small enums share words");
+}
+
+// A UI state struct as the host sees it: one flag read per instance
+static double scan_flags(std::vector<unsigned char>& buffer, size_t stride, size_t offset, unsigned bit, size_t count, long long& set) {
+    for (size_t i = 0; i < count; ++i) buffer[i * stride + offset] = static_cast<unsigned char>((i % 3 == 0) << bit);
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    set = 0;
+    for (int round = 0; round < 5; ++round) {
+        for (size_t i = 0; i < count; ++i) set += (buffer[i * stride + offset] >> bit) & 1;
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+TestResult test_bit_packing_benchmark() {
+    const size_t instances = 1000000;
+    std::string source = "enum Align { Start, Center, End, Stretch }\ntype Flags { i32 id;";
+    const char* flags[] = { "visible", "enabled", "hovered", "pressed", "focused", "dirty", "clip", "scroll" };
+    for (const char* flag : flags) source += std::string(" bool ") + flag + ";";
+    source += " Align horizontal; Align vertical; i32 z; }\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+
+    SymbolTable plain;
+    build_symbol_table(plain, result.get_node());
+    SymbolTable packed;
+    packed.set_bit_packing(true);
+    packed.set_field_order(FieldOrder::MinimizePadding);
+    build_symbol_table(packed, result.get_node());
+
+    const StructLayout* plain_layout = plain.struct_type_of_scope(plain.find_type_scope("Flags")).struct_layout();
+    const StructLayout* packed_layout = packed.struct_type_of_scope(packed.find_type_scope("Flags")).struct_layout();
+    ASSERT_TRUE(packed_layout->total_size < plain_layout->total_size, "Packing should shrink the flags");
+    const StructLayout::Field* plain_dirty = find_layout_field(plain_layout, "dirty");
+    const StructLayout::Field* packed_dirty = find_layout_field(packed_layout, "dirty");
+    ASSERT_TRUE(packed_dirty->packed(), "dirty should be packed");
+
+    std::vector<unsigned char> buffer(instances * plain_layout->total_size);
+    long long plain_set = 0, packed_set = 0;
+    double plain_ms = scan_flags(buffer, plain_layout->total_size, plain_dirty->offset, 0, instances, plain_set);
+    double packed_ms = scan_flags(buffer, packed_layout->total_size, packed_dirty->offset + packed_dirty->bit_offset / 8,
+                                  packed_dirty->bit_offset % 8, instances, packed_set);
+    ASSERT_EQ(plain_set, packed_set, "Both layouts should read the same flags");
+
+    LOG_INFO("Flag struct: " + std::to_string(plain_layout->total_size) + " -> " + std::to_string(packed_layout->total_size) +
+             " bytes packed and reordered", LogCategory::TEST);
+    LOG_INFO("  reading a flag of 1M instances x5: bytes " + std::to_string(plain_ms) + " ms, bits " +
+             std::to_string(packed_ms) + " ms", LogCategory::TEST);
+
+    return TestResult(true, "Flags " + std::to_string(plain_layout->total_size) + " -> " +
+                      std::to_string(packed_layout->total_size) + " bytes");
+}
+
+void run_bit_packing_tests() {
+    TestSuite suite("Bit Packing Tests");
+
+    suite.add_test("Flags Share Words", test_flags_share_words);
+    suite.add_test("Bit Packing Benchmark", test_bit_packing_benchmark);
+
+    suite.run_all();
+}
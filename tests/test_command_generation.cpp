@@ -8,9 +8,6 @@ using namespace Mycelium::Testing;
 using namespace Mycelium::Scripting::Lang;
 
 TestResult test_literal_generation() {
-    // Initialize RTTI
-    AstTypeInfo::initialize();
-    
     AstAllocator allocator;
     TestASTBuilder builder(allocator);
     SymbolTable symbol_table;
@@ -0,0 +1,179 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "semantic/symbol_table.hpp"
+#include "semantic/comptime.hpp"
+#include "codegen/codegen.hpp"
+#include "codegen/command_processor.hpp"
+#include "codegen/jit_engine.hpp"
+#include "ast/ast_walker.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+// Finds the initializer of a named local
+class InitializerFinder : public AstWalker<InitializerFinder> {
+public:
+    using AstWalker<InitializerFinder>::visit;
+    std::string name;
+    ExpressionNode* found = nullptr;
+
+    void visit(VariableDeclarationNode* node) {
+        if (node->names.size > 0 && node->names.values[0]->name == name) found = node->initializer;
+        walk_children(node);
+    }
+};
+
+static ExpressionNode* initializer_of(CompilationUnitNode* root, const std::string& name) {
+    InitializerFinder finder;
+    finder.name = name;
+    finder.walk(root);
+    return finder.found;
+}
+
+static int count_calls(const std::vector<Command>& commands, const std::string& function_name) {
+    int calls = 0;
+    for (const Command& command : commands) {
+        if (command.op == Op::Call && std::get<std::string>(command.data) == function_name) calls++;
+    }
+    return calls;
+}
+
+TestResult test_constants_folded_before_codegen() {
+    std::string source =
+        "enum Mode { Idle, Hover, Press }\n"
+        "type Node { i32 width; bool visible; }\n"
+        "type Config { static i32 limit = 4 * 16; static i32 retries = 3; fn reset(): i32 { retries = 0; return 0; } }\n"
+        "fn fib(i32 n): i32 { if (n < 2) { return n; } return fib(n - 1) + fib(n - 2); }\n"
+        "fn sum_to(i32 n): i32 { var total = 0; for (var i = 1; i <= n; i = i + 1) { total = total + i; } return total; }\n"
+        "fn spin(): i32 { var i = 0; while (true) { i = i + 1; } return i; }\n"
+        "fn main(): i32 {\n"
+        "    var a = fib(10);\n"
+        "    var total = sum_to(100) - 50;\n"
+        "    var size = sizeof(Node);\n"
+        "    var mode = Mode.Press;\n"
+        "    var same = typeof(i32) == typeof(Node);\n"
+        "    var limit = Config.limit;\n"
+        "    var retries = Config.retries;\n"
+        "    var twice = fib(a);\n"
+        "    var stuck = spin();\n"
+        "    var broken = 10 / (5 - 5);\n"
+        "    var lowest = -2147483648;\n"
+        
+        "    return a;\n"
+        "}\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+    CompilationUnitNode* root = result.get_node();
+
+    SymbolTable table;
+    build_symbol_table(table, root);
+    auto diagnostics = fold_constants(table, root, 20000);
+
+    auto constant = [&](const char* name) { return table.get_constant(initializer_of(root, name)); };
+    ASSERT_EQ((int64_t)55, constant("a").value, "Recursive calls with constant arguments should fold");
+    ASSERT_EQ((int64_t)5000, constant("total").value, "Loops should run at compile time");
+    ASSERT_EQ((int64_t)8, constant("size").value, "sizeof should use the struct layout");
+    ASSERT_EQ((int64_t)2, constant("mode").value, "Enum cases should fold to their index");
+    ASSERT_TRUE(constant("same").is_constant() && constant("same").type == IRType::bool_() && constant("same").value == 0,
+                "Comparing types should fold to a bool");
+    ASSERT_EQ((int64_t)64, constant("limit").value, "Static fields nothing assigns should fold");
+    ASSERT_TRUE(!constant("retries").is_constant(), "Assigned static fields stay run-time values");
+    ASSERT_TRUE(!constant("twice").is_constant(), "Calls with local arguments stay calls");
+    ASSERT_EQ((int64_t)INT32_MIN, constant("lowest").value, "A negated 2147483648 is INT32_MIN");
+
+    // Only real failures are reported, each once, with the call chain
+    ASSERT_EQ((size_t)2, diagnostics.size(), "The endless loop and the division by zero should be reported");
+    ASSERT_TRUE(diagnostics[0].node == initializer_of(root, "stuck") &&
+                diagnostics[0].message.find("in call to 'spin'") != std::string::npos &&
+                diagnostics[0].message.find("budget of 20000 steps") != std::string::npos,
+                "An endless loop should run out of budget inside its call");
+    ASSERT_TRUE(diagnostics[1].message.find("division by zero") != std::string::npos, "Division by zero should be reported");
+
+    std::string overflow_source = "fn huge(): i32 { return 0 - 2147483648; }\n";
+    TokenStream overflow_stream = tokenize_test_source(overflow_source);
+    Parser overflow_parser(overflow_stream);
+    auto overflow_result = overflow_parser.parse();
+    ASSERT_TRUE(overflow_result.is_success(), "Parser should successfully parse the overflow source");
+    SymbolTable overflow_table;
+    build_symbol_table(overflow_table, overflow_result.get_node());
+    auto overflow = fold_constants(overflow_table, overflow_result.get_node());
+    ASSERT_TRUE(overflow.size() == 1 && overflow[0].message.find("does not fit in i32") != std::string::npos,
+                "2147483648 that is not negated does not fit");
+
+    ComptimeEvaluator evaluator(table, root, 20000);
+    ComptimeResult not_constant = evaluator.evaluate(initializer_of(root, "twice"));
+    ASSERT_TRUE(not_constant.status == ComptimeStatus::NotConstant && not_constant.message.find("'a'") != std::string::npos,
+                "A non-constant evaluation should say what it needed");
+
+    // main keeps only the calls whose arguments were not known
+    CodeGenerator generator(table);
+    auto commands = generator.generate_code(root);
+    ASSERT_EQ(3, count_calls(commands, "fib"), "fib should be called by itself twice and by main once");
+    ASSERT_EQ(0, count_calls(commands, "sum_to"), "Folded calls should not be emitted");
+
+    return TestResult(true, "Calls, loops, sizeof, typeof, enum cases and static fields fold");
+}
+
+static double time_main(const std::vector<Command>& commands, int& value) {
+    std::string ir = CommandProcessor::process_to_ir_string(commands, "Comptime");
+    JITEngine jit;
+    if (ir.empty() || !jit.initialize_from_ir(ir, "Comptime")) return -1;
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    for (int run = 0; run < 20; ++run) value = jit.execute_function("main");
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+TestResult test_comptime_benchmark() {
+    std::string source =
+        "fn fib(i32 n): i32 { if (n < 2) { return n; } return fib(n - 1) + fib(n - 2); }\n"
+        "fn main(): i32 { return fib(24); }\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+    CompilationUnitNode* root = result.get_node();
+
+    SymbolTable table;
+    build_symbol_table(table, root);
+    std::vector<Command> at_run_time = CodeGenerator(table).generate_code(root);
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    auto diagnostics = fold_constants(table, root, 10000000);
+    double fold_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    ASSERT_TRUE(diagnostics.empty(), "fib(24) should fit the budget");
+    std::vector<Command> folded = CodeGenerator(table).generate_code(root);
+
+    int run_time_value = 0, folded_value = 0;
+    double run_time_ms = time_main(at_run_time, run_time_value);
+    double folded_ms = time_main(folded, folded_value);
+    ASSERT_EQ(3, count_calls(at_run_time, "fib"), "Unfolded main should call fib");
+    ASSERT_EQ(2, count_calls(folded, "fib"), "Folded main should not call fib");
+    ASSERT_EQ(46368, run_time_value, "fib(24) computed at run time");
+    ASSERT_EQ(46368, folded_value, "fib(24) folded at compile time");
+
+    LOG_INFO("fib(24): folding once " + std::to_string(fold_ms) + " ms; 20 runs of main: computed " +
+             std::to_string(run_time_ms) + " ms, folded " + std::to_string(folded_ms) + " ms", LogCategory::TEST);
+
+    return TestResult(true, "Folded main runs in " + std::to_string(folded_ms) + " ms");
+}
+
+void run_comptime_tests() {
+    TestSuite suite("Comptime Tests");
+
+    suite.add_test("Constants Folded Before Codegen", test_constants_folded_before_codegen);
+    suite.add_test("Comptime Benchmark", test_comptime_benchmark);
+
+    suite.run_all();
+}
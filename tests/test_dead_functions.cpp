@@ -0,0 +1,174 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "semantic/symbol_table.hpp"
+#include "semantic/call_graph.hpp"
+#include "semantic/comptime.hpp"
+#include "codegen/codegen.hpp"
+#include "codegen/command_processor.hpp"
+#include "codegen/jit_engine.hpp"
+#include "common/logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+// Names of the functions the commands define, in order
+static std::vector<std::string> generated_functions(const std::vector<Command>& commands) {
+    std::vector<std::string> names;
+    for (const Command& command : commands) {
+        if (command.op != Op::FunctionBegin) continue;
+        const std::string& signature = std::get<std::string>(command.data);
+        size_t end = signature.find(':');
+        while (end != std::string::npos && end + 1 < signature.size() && signature[end + 1] == ':') end = signature.find(':', end + 2);
+        names.push_back(signature.substr(0, end));
+    }
+    return names;
+}
+
+TestResult test_unreachable_functions_removed() {
+    std::string source =
+        "type Widget { i32 size; fn draw(): i32 { return size; } fn resize(): i32 { return 0; } virtual fn on_event(): i32 { return log(1); } }\n"
+        "fn log(i32 x): i32 { return x; }\n"
+        "fn helper(i32 x): i32 { return x + 1; }\n"
+        "fn compute(i32 x): i32 { return helper(x) * 2; }\n"
+        "fn orphan(): i32 { return stray(); }\n"
+        "fn stray(): i32 { return orphan(); }\n"
+        "public fn api(): i32 { return 7; }\n"
+        "fn main(): i32 { var w = new Widget(); return compute(3) + w.draw(); }\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+    CompilationUnitNode* root = result.get_node();
+
+    SymbolTable table;
+    build_symbol_table(table, root);
+    CallGraph graph(table, root);
+    ASSERT_TRUE(graph.function(graph.index_of(table.lookup_symbol_in_scope(0, "api")->id)).entry, "Public functions are entry points");
+
+    DeadFunctionReport report = eliminate_dead_functions(table, graph);
+    const std::vector<std::string> expected = { "Widget::resize", "orphan", "stray" };
+    ASSERT_EQ(expected.size(), report.removed.size(), "Only unreachable functions should be removed");
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_STR_EQ(expected[i], report.removed[i], "Removed functions come back qualified, in declaration order");
+    }
+    ASSERT_EQ((size_t)7, report.kept, "main, its callees, the virtual method and its callee, and the public function stay");
+
+    std::vector<std::string> generated = generated_functions(CodeGenerator(table).generate_code(root));
+    for (const std::string& removed : expected) {
+        ASSERT_TRUE(std::find(generated.begin(), generated.end(), removed) == generated.end(), "Removed functions generate no code");
+    }
+    ASSERT_TRUE(std::find(generated.begin(), generated.end(), "Widget::on_event") != generated.end(), "Virtual methods are kept");
+    ASSERT_EQ((size_t)7, generated.size(), "Every kept function is generated");
+
+    // Without an entry point a tree is a library, and everything stays
+    std::string library = "fn a(): i32 { return b(); }\nfn b(): i32 { return 1; }\n";
+    TokenStream library_stream = tokenize_test_source(library);
+    Parser library_parser(library_stream);
+    auto library_result = library_parser.parse();
+    ASSERT_TRUE(library_result.is_success(), "Parser should successfully parse the library");
+    SymbolTable library_table;
+    build_symbol_table(library_table, library_result.get_node());
+    DeadFunctionReport library_report = eliminate_dead_functions(library_table, library_result.get_node());
+    ASSERT_TRUE(library_report.removed.empty() && library_report.kept == 2, "A library keeps all its functions");
+
+    return TestResult(true, "Removed " + std::to_string(report.removed.size()) + " unreachable functions");
+}
+
+TestResult test_folded_calls_removed() {
+    std::string source =
+        "fn square(i32 x): i32 { return x * x; }\n"
+        "fn sum(i32 n): i32 { var total = 0; for (var i = 1; i <= n; i = i + 1) { total = total + i; } return total; }\n"
+        "fn twice(i32 x): i32 { return x * 2; }\n"
+        "fn main(): i32 { var n = 3; return square(7) + sum(10) + twice(n); }\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+    CompilationUnitNode* root = result.get_node();
+
+    SymbolTable table;
+    build_symbol_table(table, root);
+    ASSERT_TRUE(fold_constants(table, root).empty(), "Folding should succeed");
+    DeadFunctionReport report = eliminate_dead_functions(table, root);
+    const std::vector<std::string> expected = { "square", "sum" };
+    ASSERT_EQ(expected.size(), report.removed.size(), "Functions only called with constant arguments should be removed");
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_STR_EQ(expected[i], report.removed[i], "Removed functions come back in declaration order");
+    }
+
+    std::string ir = CommandProcessor::process_to_ir_string(CodeGenerator(table).generate_code(root), "DeadFunctions");
+    ASSERT_TRUE(!ir.empty() && ir.find("@square") == std::string::npos && ir.find("@sum") == std::string::npos,
+                "Folded callees are not generated");
+    ASSERT_TRUE(ir.find("define i32 @twice") != std::string::npos, "Calls with run-time arguments keep their callee");
+
+    return TestResult(true, "Functions used only through folded calls are removed");
+}
+
+static double time_compile(CompilationUnitNode* root, SymbolTable& table, int& value) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    std::string ir = CommandProcessor::process_to_ir_string(CodeGenerator(table).generate_code(root), "DeadFunctions");
+    JITEngine jit;
+    if (ir.empty() || !jit.initialize_from_ir(ir, "DeadFunctions")) return -1;
+    value = jit.execute_function("main");
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+TestResult test_dead_function_benchmark() {
+    // A helper library of which main uses three functions
+    const int library_size = 300;
+    std::string source;
+    for (int i = 0; i < library_size; ++i) {
+        std::string n = std::to_string(i);
+        source += "fn helper" + n + "(i32 x): i32 { var y = x * " + n + "; if (y > 100) { return y - 100; } return y + " + n + "; }\n";
+    }
+    source += "fn main(): i32 { return helper1(2) + helper2(3) + helper3(4); }\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+    CompilationUnitNode* root = result.get_node();
+
+    SymbolTable table;
+    build_symbol_table(table, root);
+    int full_value = 0, pruned_value = 0;
+    size_t full_functions = generated_functions(CodeGenerator(table).generate_code(root)).size();
+    double full_ms = time_compile(root, table, full_value);
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    DeadFunctionReport report = eliminate_dead_functions(table, root);
+    double eliminate_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    double pruned_ms = time_compile(root, table, pruned_value);
+    size_t pruned_functions = generated_functions(CodeGenerator(table).generate_code(root)).size();
+
+    ASSERT_EQ((size_t)(library_size + 1), full_functions, "The full module should define every function");
+    ASSERT_EQ((size_t)4, pruned_functions, "The pruned module should define main and its three helpers");
+    ASSERT_EQ((size_t)(library_size - 3), report.removed.size(), "Every helper main does not call should be removed");
+    ASSERT_EQ(full_value, pruned_value, "Removing dead functions should not change the result");
+    ASSERT_EQ((2 + 1) + (6 + 2) + (12 + 3), pruned_value, "main should add up its three helpers");
+
+    LOG_INFO("Dead functions: " + std::to_string(library_size + 1) + " functions, kept " + std::to_string(report.kept) +
+             " (found in " + std::to_string(eliminate_ms) + " ms); codegen + IR + JIT " + std::to_string(full_ms) +
+             " ms -> " + std::to_string(pruned_ms) + " ms", LogCategory::TEST);
+
+    return TestResult(true, "Compile " + std::to_string(full_ms) + " ms -> " + std::to_string(pruned_ms) + " ms");
+}
+
+void run_dead_functions_tests() {
+    TestSuite suite("Dead Function Tests");
+
+    suite.add_test("Unreachable Functions Removed", test_unreachable_functions_removed);
+    suite.add_test("Folded Calls Removed", test_folded_calls_removed);
+    suite.add_test("Dead Function Benchmark", test_dead_function_benchmark);
+
+    suite.run_all();
+}
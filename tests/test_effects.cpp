@@ -0,0 +1,153 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "semantic/symbol_table.hpp"
+#include "semantic/effects.hpp"
+#include "codegen/codegen.hpp"
+#include "codegen/command_processor.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+static FunctionEffects effects_of(SymbolTable& table, const std::string& scope, const std::string& name) {
+    Symbol* symbol = table.lookup_symbol_in_scope(scope.empty() ? 0 : table.find_scope_by_name(scope), name);
+    return symbol ? table.get_function_effects(symbol->id) : FunctionEffects();
+}
+
+// Attribute group a function is defined with in printed IR, as "nounwind readnone ..."
+static std::string ir_attributes_of(const std::string& ir, const std::string& name) {
+    size_t define = ir.find("@" + name + "(");
+    size_t line_end = define == std::string::npos ? define : ir.find('\n', define);
+    size_t hash = define == std::string::npos ? define : ir.rfind('#', line_end);
+    if (hash == std::string::npos || hash < define) return "";
+    std::string group = ir.substr(hash, ir.find(' ', hash) - hash);
+    size_t attributes = ir.find("attributes " + group + " = { ");
+    if (attributes == std::string::npos) return "";
+    attributes += group.size() + 16;
+    return ir.substr(attributes, ir.find(" }", attributes) - attributes);
+}
+
+TestResult test_functions_classified() {
+    std::string source =
+        "type Counter { i32 count; fn total(): i32 { return count; } fn bump(): i32 { count = count + 1; return count; } }\n"
+        "fn square(i32 x): i32 { var y = x * x; return y; }\n"
+        "fn is_even(i32 n): bool { if (n == 0) { return true; } return is_odd(n - 1); }\n"
+        "fn is_odd(i32 n): bool { if (n == 0) { return false; } return is_even(n - 1); }\n"
+        "fn sum_to(i32 n): i32 { var total = 0; for (var i = 1; i <= n; i = i + 1) { total = total + i; } return total; }\n"
+        "fn read(Counter c): i32 { return c.total() + square(2); }\n"
+        "fn touch(Counter c): i32 { return c.bump(); }\n"
+        "fn report(i32 x): i32 { print(x); return x; }\n"
+        "fn main(): i32 { return square(3) + sum_to(4); }\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+    CompilationUnitNode* root = result.get_node();
+
+    SymbolTable table;
+    build_symbol_table(table, root);
+    CallGraph graph(table, root);
+    ASSERT_EQ((size_t)10, graph.size(), "Member functions are part of the graph");
+    ASSERT_EQ((size_t)9, graph.components().size(), "Only the mutual recursion shares a component");
+    analyze_effects(table, graph);
+
+    FunctionEffects square = effects_of(table, "", "square");
+    ASSERT_TRUE(square.purity == Purity::Pure && square.no_unwind && square.will_return, "Arithmetic on locals is pure");
+    FunctionEffects even = effects_of(table, "", "is_even");
+    ASSERT_TRUE(even.purity == Purity::Pure && even.no_unwind && !even.will_return,
+                "Mutual recursion stays pure but may not return");
+    FunctionEffects sum = effects_of(table, "", "sum_to");
+    ASSERT_TRUE(sum.purity == Purity::Pure && !sum.will_return, "Loops over locals are pure but may not end");
+    ASSERT_TRUE(effects_of(table, "Counter", "total").purity == Purity::ReadOnly, "Reading a field is read-only");
+    ASSERT_TRUE(effects_of(table, "Counter", "bump").purity == Purity::SideEffecting, "Writing a field is a side effect");
+    FunctionEffects read = effects_of(table, "", "read");
+    ASSERT_TRUE(read.purity == Purity::ReadOnly && read.will_return, "Callers take on what their callees read");
+    ASSERT_TRUE(effects_of(table, "", "touch").purity == Purity::SideEffecting, "Callers take on what their callees write");
+    FunctionEffects report = effects_of(table, "", "report");
+    ASSERT_TRUE(report.purity == Purity::SideEffecting && !report.no_unwind, "Unknown calls can do anything");
+    FunctionEffects main = effects_of(table, "", "main");
+    ASSERT_TRUE(main.purity == Purity::Pure && !main.will_return, "main is as pure as its callees and may loop");
+
+    return TestResult(true, "Functions are pure, read-only or side-effecting through their callees");
+}
+
+TestResult test_effects_exported_as_attributes() {
+    std::string source =
+        "fn square(i32 x): i32 { return x * x; }\n"
+        "fn fib(i32 n): i32 { if (n < 2) { return n; } return fib(n - 1) + fib(n - 2); }\n"
+        "fn main(): i32 { return square(3) + fib(5); }\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+    CompilationUnitNode* root = result.get_node();
+
+    SymbolTable table;
+    build_symbol_table(table, root);
+    std::string plain = CommandProcessor::process_to_ir_string(CodeGenerator(table).generate_code(root), "Effects");
+    ASSERT_TRUE(!plain.empty() && ir_attributes_of(plain, "square").empty(), "Unanalyzed functions get no attributes");
+
+    analyze_effects(table, root);
+    std::string ir = CommandProcessor::process_to_ir_string(CodeGenerator(table).generate_code(root), "Effects");
+    ASSERT_STR_EQ("nounwind readnone willreturn", ir_attributes_of(ir, "square"), "Pure leaf functions get every attribute");
+    ASSERT_STR_EQ("nounwind readnone", ir_attributes_of(ir, "fib"), "Recursive functions are not known to return");
+    ASSERT_STR_EQ("nounwind readnone", ir_attributes_of(ir, "main"), "Callers inherit what their callees guarantee");
+
+    return TestResult(true, "Effects reach the IR as function attributes");
+}
+
+TestResult test_effects_benchmark() {
+    // A long call chain of pure functions, then a ring of mutually recursive ones.
+    // The top-level statement array has to fit in a single allocator page.
+    const int chain = 300;
+    const int ring = 100;
+    std::string source;
+    for (int i = 0; i < chain; ++i) {
+        std::string callee = i + 1 < chain ? "c" + std::to_string(i + 1) + "(x + 1)" : "x";
+        source += "fn c" + std::to_string(i) + "(i32 x): i32 { return " + callee + "; }\n";
+    }
+    for (int i = 0; i < ring; ++i) {
+        source += "fn r" + std::to_string(i) + "(i32 x): i32 { return r" + std::to_string((i + 1) % ring) + "(x); }\n";
+    }
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+    CompilationUnitNode* root = result.get_node();
+
+    SymbolTable table;
+    build_symbol_table(table, root);
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    CallGraph graph(table, root);
+    analyze_effects(table, graph);
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    ASSERT_EQ((size_t)(chain + 1), graph.components().size(), "Each chain link is its own component and the ring is one");
+    FunctionEffects head = effects_of(table, "", "c0");
+    ASSERT_TRUE(head.purity == Purity::Pure && head.will_return, "The whole chain should be pure and return");
+    FunctionEffects cycle = effects_of(table, "", "r0");
+    ASSERT_TRUE(cycle.purity == Purity::Pure && !cycle.will_return, "The ring should be pure but may not return");
+
+    LOG_INFO("Effect analysis of " + std::to_string(chain + ring) + " functions (chain of " + std::to_string(chain) +
+             ", ring of " + std::to_string(ring) + "): " + std::to_string(ms) + " ms", LogCategory::TEST);
+
+    return TestResult(true, "Analyzed " + std::to_string(chain + ring) + " functions in " + std::to_string(ms) + " ms");
+}
+
+void run_effects_tests() {
+    TestSuite suite("Effects Tests");
+
+    suite.add_test("Functions Classified", test_functions_classified);
+    suite.add_test("Effects Exported As Attributes", test_effects_exported_as_attributes);
+    suite.add_test("Effects Benchmark", test_effects_benchmark);
+
+    suite.run_all();
+}
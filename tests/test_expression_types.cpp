@@ -0,0 +1,133 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "semantic/symbol_table.hpp"
+#include "ast/ast_walker.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+// Collects every expression and the initializer of every named variable
+class ExpressionCollector : public AstWalker<ExpressionCollector> {
+public:
+    using AstWalker<ExpressionCollector>::visit;
+    std::vector<ExpressionNode*> expressions;
+    std::vector<std::pair<std::string, ExpressionNode*>> initializers;
+
+    template <typename T>
+    void record(T* node) {
+        if (auto* expr = node->template as<ExpressionNode>()) expressions.push_back(expr);
+        if (auto* declaration = node->template as<VariableDeclarationNode>(); declaration && declaration->initializer) {
+            initializers.emplace_back(std::string(declaration->name->name), declaration->initializer);
+        }
+        walk_children(node);
+    }
+
+    #define EXPRESSION_COLLECTOR_VISIT(NodeType, BaseType) \
+        void visit(NodeType* node) { record(node); }
+    AST_NODE_LIST(EXPRESSION_COLLECTOR_VISIT)
+    #undef EXPRESSION_COLLECTOR_VISIT
+
+    ExpressionNode* initializer_of(const std::string& name, int occurrence = 0) {
+        for (auto& [declared, initializer] : initializers) {
+            if (declared == name && occurrence-- == 0) return initializer;
+        }
+        return nullptr;
+    }
+};
+
+TestResult test_every_expression_annotated() {
+    std::string source =
+        "type Point { i32 x; i32 y; fn len(): i32 { return x * x + y * y; } }\n"
+        "fn main(): i32 {\n"
+        "    var p = new Point();\n"
+        "    var a = 1;\n"
+        "    if (a > 0) { var a = true; var inner = !a; }\n"
+        "    var sum = p.x + a;\n"
+        "    var length = p.len();\n"
+        "    var flag = a < sum;\n"
+        "    return sum;\n"
+        "}\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+
+    SymbolTable table;
+    build_symbol_table(table, result.get_node());
+
+    ExpressionCollector collector;
+    collector.walk(result.get_node());
+    ASSERT_TRUE(!collector.expressions.empty(), "The script should contain expressions");
+    for (ExpressionNode* expr : collector.expressions) {
+        ASSERT_TRUE(!table.get_expression_type(expr).empty(), "Every expression should carry a type after the build");
+    }
+
+    ASSERT_STR_EQ("Point", std::string(table.get_expression_type(collector.initializer_of("p"))), "new Point() should be a Point");
+    ASSERT_STR_EQ("i32", std::string(table.get_expression_type(collector.initializer_of("sum"))), "Field arithmetic should be i32");
+    ASSERT_STR_EQ("i32", std::string(table.get_expression_type(collector.initializer_of("length"))), "Method calls should take the return type");
+    ASSERT_STR_EQ("bool", std::string(table.get_expression_type(collector.initializer_of("flag"))), "Comparisons should be bool");
+    ASSERT_STR_EQ("bool", std::string(table.get_expression_type(collector.initializer_of("inner"))),
+                  "Expressions in a block should see the block's own declarations");
+
+    // Repeated queries return the stored view rather than a fresh inference
+    ExpressionNode* sum = collector.initializer_of("sum");
+    ASSERT_TRUE(table.infer_expression_type(sum, 0).data() == table.get_expression_type(sum).data(),
+                "Inference should return the memoized view");
+
+    return TestResult(true, "Every expression is typed once in its own scope");
+}
+
+static double time_check(int terms, size_t& typed) {
+    std::string source = "fn main(): i32 {\n    var seed = 1;\n    var total = seed";
+    for (int i = 0; i < terms; ++i) source += " + seed";
+    source += ";\n    return total;\n}\n";
+
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    if (!result.is_success()) return -1;
+
+    SymbolTable table;
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    build_symbol_table(table, result.get_node());
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    ExpressionCollector collector;
+    collector.walk(result.get_node());
+    typed = 0;
+    for (ExpressionNode* expr : collector.expressions) {
+        if (table.get_expression_type(expr) == "i32") typed++;
+    }
+    return ms;
+}
+
+TestResult test_expression_typing_scales_linearly() {
+    // A left-deep sum: inferring each node from scratch would walk its whole left spine
+    size_t small_typed = 0, large_typed = 0;
+    double small_ms = time_check(100, small_typed);
+    double large_ms = time_check(400, large_typed);
+    ASSERT_TRUE(large_typed > 400 * 2, "Every operand and partial sum should be typed i32");
+
+    LOG_INFO("Expression typing of a left-deep sum: 100 terms " + std::to_string(small_ms) + " ms, 400 terms " +
+             std::to_string(large_ms) + " ms", LogCategory::TEST);
+
+    return TestResult(true, "Typed " + std::to_string(large_typed) + " expressions in " + std::to_string(large_ms) + " ms");
+}
+
+void run_expression_types_tests() {
+    TestSuite suite("Expression Type Tests");
+
+    suite.add_test("Every Expression Annotated", test_every_expression_annotated);
+    suite.add_test("Expression Typing Scales Linearly", test_expression_typing_scales_linearly);
+
+    suite.run_all();
+}
@@ -0,0 +1,203 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "ast/ast_compact.hpp"
+#include "ast/ast_parallel.hpp"
+#include "ast/ast_walker.hpp"
+#include "semantic/symbol_table.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+// A parsed script that stays alive with its source, so edits can be copied out of it
+struct ParsedScript {
+    std::string source;
+    TokenStream stream;
+    Parser parser;
+    CompilationUnitNode* root = nullptr;
+
+    explicit ParsedScript(std::string text)
+        : source(std::move(text)), stream(tokenize_test_source(source)), parser(stream) {
+        auto result = parser.parse();
+        if (result.is_success()) root = result.get_node();
+    }
+
+    FunctionDeclarationNode* function(std::string_view name) {
+        for (int i = 0; root && i < root->statements.size; i++) {
+            auto* function = root->statements.values[i]->as<FunctionDeclarationNode>();
+            if (function && function->name->name == name) return function;
+        }
+        return nullptr;
+    }
+};
+
+// Copies the edited function's return type and body into the original tree, as an editor would
+static void splice_function(ParsedScript& target, ParsedScript& edited, std::string_view name) {
+    FunctionDeclarationNode* original = target.function(name);
+    FunctionDeclarationNode* replacement = edited.function(name);
+    AstAllocator& allocator = target.parser.get_allocator();
+    original->returnType = replacement->returnType ? ast_compact(ast_ptr_get(replacement->returnType), allocator) : nullptr;
+    original->body = ast_compact(ast_ptr_get(replacement->body), allocator);
+}
+
+// Collects every node of the tree
+class IncrementalNodeCollector : public AstWalker<IncrementalNodeCollector> {
+public:
+    using AstWalker<IncrementalNodeCollector>::visit;
+    std::vector<AstNode*> nodes;
+
+    template <typename T>
+    void record(T* node) {
+        nodes.push_back(node);
+        walk_children(node);
+    }
+
+    #define INCREMENTAL_NODE_COLLECTOR_VISIT(NodeType, BaseType) \
+        void visit(NodeType* node) { record(node); }
+    AST_NODE_LIST(INCREMENTAL_NODE_COLLECTOR_VISIT)
+    #undef INCREMENTAL_NODE_COLLECTOR_VISIT
+};
+
+// The updated table types and binds every node the way a fresh build does
+static bool matches_rebuild(SymbolTable& updated, CompilationUnitNode* root) {
+    SymbolTable rebuilt;
+    AstTaskPool pool(1);
+    build_symbol_table(rebuilt, root, pool);
+
+    IncrementalNodeCollector collector;
+    collector.walk(root);
+    for (AstNode* node : collector.nodes) {
+        if (auto* expr = node->as<ExpressionNode>()) {
+            if (updated.get_expression_type(expr) != rebuilt.get_expression_type(expr)) return false;
+        }
+        Symbol* a = updated.get_bound_symbol(node);
+        Symbol* b = rebuilt.get_bound_symbol(node);
+        if (!a != !b) return false;
+        if (a && (a->removed || a->name != b->name || a->type_name != b->type_name)) return false;
+    }
+    return updated.get_type_cycles().size() == rebuilt.get_type_cycles().size();
+}
+
+static Symbol* local_named(SymbolTable& table, FunctionDeclarationNode* function, std::string_view name) {
+    return table.lookup_symbol_in_scope(table.get_node_scope(function), name);
+}
+
+TestResult test_incremental_updates_match_rebuild() {
+    const char* source =
+        "fn helper(): i32 { return 1; }\n"
+        "fn user(): i32 { var h = helper(); return h; }\n"
+        "fn other(i32 n): i32 { var o = n * 2; return o; }\n";
+    ParsedScript script(source);
+    ASSERT_TRUE(script.root != nullptr, "Parser should successfully parse source");
+
+    SymbolTable table;
+    AstTaskPool pool(1);
+    build_symbol_table(table, script.root, pool);
+    SymbolId user_local = local_named(table, script.function("user"), "h")->id;
+    SymbolId helper_symbol = table.get_bound_symbol(script.function("helper")->name)->id;
+    size_t scopes_before = table.scope_count();
+
+    // A body edit redoes that function and nothing else
+    ParsedScript body_edit(
+        "fn helper(): i32 { return 1; }\n"
+        "fn user(): i32 { var h = helper(); return h; }\n"
+        "fn other(i32 n): i32 { var o = n > 2; var lost = missing; if (o) { var inner = n; } return 1; }\n");
+    splice_function(script, body_edit, "other");
+    SymbolId old_other = local_named(table, script.function("other"), "o")->id;
+    std::vector<AstPassDiagnostic> diagnostics;
+    ASSERT_TRUE(update_function(table, script.function("other"), diagnostics), "A body edit should update in place");
+    ASSERT_TRUE(table.get_symbol(old_other)->removed, "The old locals should be removed");
+    ASSERT_STR_EQ("bool", std::string(local_named(table, script.function("other"), "o")->type_name), "The new local should be typed");
+    ASSERT_EQ(user_local, local_named(table, script.function("user"), "h")->id, "Other functions should keep their symbols");
+    ASSERT_EQ(scopes_before + 1, table.scope_count(), "Only the new block should open a scope");
+    ASSERT_EQ((size_t)2, diagnostics.size(), "The edited body should report its own problems");
+    ASSERT_TRUE(matches_rebuild(table, script.root), "The updated table should match a rebuild");
+
+    // A signature edit also redoes the functions that call it
+    ParsedScript signature_edit("fn helper(): bool { return true; }\n");
+    splice_function(script, signature_edit, "helper");
+    SymbolId other_local = local_named(table, script.function("other"), "o")->id;
+    diagnostics.clear();
+    ASSERT_TRUE(update_function(table, script.function("helper"), diagnostics), "A signature read only in bodies should update in place");
+    ASSERT_EQ(helper_symbol, table.get_bound_symbol(script.function("helper")->name)->id, "The function keeps its symbol");
+    ASSERT_STR_EQ("bool", std::string(local_named(table, script.function("user"), "h")->type_name), "Callers should infer the new return type");
+    ASSERT_EQ(other_local, local_named(table, script.function("other"), "o")->id, "Functions that do not call it should be left alone");
+    ASSERT_TRUE(matches_rebuild(table, script.root), "The updated table should match a rebuild");
+
+    // A signature read by a global initializer needs a rebuild, and nothing changes until then
+    ParsedScript global_script("var g = helper();\nfn helper(): i32 { return 1; }\n");
+    ASSERT_TRUE(global_script.root != nullptr, "Parser should successfully parse source");
+    SymbolTable global_table;
+    build_symbol_table(global_table, global_script.root, pool);
+    ParsedScript global_edit("fn helper(): bool { return true; }\n");
+    splice_function(global_script, global_edit, "helper");
+    size_t symbols_before = global_table.symbol_count();
+    ASSERT_TRUE(!update_function(global_table, global_script.function("helper"), diagnostics), "The edit reaches a global initializer");
+    ASSERT_EQ(symbols_before, global_table.symbol_count(), "A refused update should leave the table alone");
+
+    return TestResult(true, "Incremental updates redo the edited function and its callers");
+}
+
+TestResult test_incremental_update_benchmark() {
+    const int function_count = 400;
+    const int edits = 20;
+
+    auto generate = [&](int edited_value) {
+        std::string source = "type Point { i32 x; i32 y; fn len(): i32 { return x * x + y * y; } }\n";
+        for (int i = 0; i < function_count; ++i) {
+            std::string n = std::to_string(i);
+            int value = i == function_count / 2 ? edited_value : i;
+            source += "fn f" + n + "(i32 a): i32 { var p = new Point(); var b = a * " + std::to_string(value) +
+                      "; for (var i = 0; i < 4; i++) { b = b + p.len(); } return b; }\n";
+        }
+        return source;
+    };
+
+    ParsedScript script(generate(0));
+    ASSERT_TRUE(script.root != nullptr, "Parser should successfully parse generated script");
+    std::string edited_name = "f" + std::to_string(function_count / 2);
+    std::vector<std::unique_ptr<ParsedScript>> versions;
+    for (int e = 1; e <= edits; ++e) versions.push_back(std::make_unique<ParsedScript>(generate(e)));
+
+    using Clock = std::chrono::steady_clock;
+    SymbolTable table;
+    AstTaskPool pool(1);
+    auto start = Clock::now();
+    build_symbol_table(table, script.root, pool);
+    double build_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    double update_ms = 0;
+    for (auto& version : versions) {
+        splice_function(script, *version, edited_name);
+        std::vector<AstPassDiagnostic> diagnostics;
+        start = Clock::now();
+        bool updated = update_function(table, script.function(edited_name), diagnostics);
+        update_ms += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        ASSERT_TRUE(updated && diagnostics.empty(), "Every edit should update in place");
+    }
+    update_ms /= edits;
+    ASSERT_TRUE(matches_rebuild(table, script.root), "The updated table should match a rebuild");
+
+    LOG_INFO("Symbol table for " + std::to_string(function_count) + " functions:", LogCategory::TEST);
+    LOG_INFO("  full build " + std::to_string(build_ms) + " ms, one body updated " + std::to_string(update_ms) + " ms",
+             LogCategory::TEST);
+
+    return TestResult(true, "Build " + std::to_string(build_ms) + " ms -> update " + std::to_string(update_ms) + " ms");
+}
+
+void run_incremental_symbols_tests() {
+    TestSuite suite("Incremental Symbol Tests");
+
+    suite.add_test("Incremental Updates Match Rebuild", test_incremental_updates_match_rebuild);
+    suite.add_test("Incremental Update Benchmark", test_incremental_update_benchmark);
+
+    suite.run_all();
+}
@@ -134,12 +134,60 @@ TestResult test_arithmetic_ir() {
     return TestResult(true);
 }
 
+// "main" calls "add" with the given arguments, then "add" is defined with definition_signature
+static std::vector<Command> declared_call_commands(int argument_count, const std::string& definition_signature) {
+    std::vector<Command> commands;
+    Command declare(Op::FunctionDeclare, ValueRef::invalid(), {});
+    declare.data = std::string("add:i32:i32,i32");
+    commands.push_back(declare);
+    
+    Command main_begin(Op::FunctionBegin, ValueRef::invalid(), {});
+    main_begin.data = std::string("main:i32");
+    commands.push_back(main_begin);
+    std::vector<ValueRef> args;
+    for (int i = 0; i < argument_count; ++i) {
+        Command const_cmd(Op::Const, ValueRef(i + 1, IRType::i32()), {});
+        const_cmd.data = static_cast<int64_t>(i);
+        commands.push_back(const_cmd);
+        args.push_back(ValueRef(i + 1, IRType::i32()));
+    }
+    Command call(Op::Call, ValueRef(10, IRType::i32()), args);
+    call.data = std::string("add");
+    commands.push_back(call);
+    commands.push_back(Command(Op::Ret, ValueRef::invalid(), {ValueRef(10, IRType::i32())}));
+    commands.push_back(Command(Op::FunctionEnd, ValueRef::invalid(), {}));
+    
+    Command add_begin(Op::FunctionBegin, ValueRef::invalid(), {});
+    add_begin.data = definition_signature;
+    commands.push_back(add_begin);
+    Command zero(Op::Const, ValueRef(11, IRType::i32()), {});
+    zero.data = static_cast<int64_t>(0);
+    commands.push_back(zero);
+    commands.push_back(Command(Op::Ret, ValueRef::invalid(), {ValueRef(11, IRType::i32())}));
+    commands.push_back(Command(Op::FunctionEnd, ValueRef::invalid(), {}));
+    return commands;
+}
+
+TestResult test_declared_signature_ir() {
+    std::string ir = CommandProcessor::process_to_ir_string(declared_call_commands(2, "add:i32:i32,i32"), "TestModule");
+    ASSERT_TRUE(ir.find("define i32 @add(i32 %0, i32 %1)") != std::string::npos, "The definition fills in the declaration");
+    ASSERT_TRUE(ir.find("add.1") == std::string::npos, "A matching definition is not renamed");
+    
+    ASSERT_TRUE(CommandProcessor::process_to_ir_string(declared_call_commands(2, "add:i32:i32"), "TestModule").empty(),
+                "A definition that differs from its declaration is an error");
+    ASSERT_TRUE(CommandProcessor::process_to_ir_string(declared_call_commands(1, "add:i32:i32,i32"), "TestModule").empty(),
+                "A call that differs from the declaration is an error");
+    
+    return TestResult(true);
+}
+
 void run_ir_generation_tests() {
     TestSuite suite("IR Generation Tests");
     
     suite.add_test("Simple Function IR", test_simple_function_ir);
     suite.add_test("Void Function IR", test_void_function_ir);
     suite.add_test("Arithmetic IR", test_arithmetic_ir);
+    suite.add_test("Declared Signature IR", test_declared_signature_ir);
     
     suite.run_all();
 }
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "semantic/symbol_table.hpp"
+#include "semantic/module_interface.hpp"
+#include "codegen/codegen.hpp"
+#include "codegen/command_processor.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+TestResult test_module_interface_round_trip() {
+    std::string library =
+        "public enum Mode { Idle, Busy, Done }\n"
+        "public type Task { bool urgent; i32 id; Mode mode; bool done; i32 cost; fn total(): i32 { return id + cost; } }\n"
+        "public fn scale(i32 value, i32 factor): i32 { return value * factor; }\n"
+        "fn twice(i32 value): i32 { return scale(value, 2); }\n"
+        "public fn main(): i32 { return twice(3); }\n";
+    TokenStream library_stream = tokenize_test_source(library);
+    Parser library_parser(library_stream);
+    auto library_result = library_parser.parse();
+    ASSERT_TRUE(library_result.is_success(), "Parser should successfully parse the library");
+
+    // The library packs its flags; the script using it does not
+    SymbolTable library_table;
+    library_table.set_bit_packing(true);
+    library_table.set_field_order(FieldOrder::MinimizePadding);
+    build_symbol_table(library_table, library_result.get_node());
+    const StructLayout* exported_layout = library_table.struct_type_of_scope(library_table.find_scope_by_name("Task")).struct_layout();
+
+    ModuleInterface exported = ModuleInterface::extract(library_table, library_result.get_node(), "Tasks", 42);
+    ASSERT_EQ((size_t)3, exported.declarations.size(), "The public enum, type and function are exported");
+    for (const ModuleInterface::Declaration& declaration : exported.declarations) {
+        ASSERT_TRUE(declaration.name != "twice" && declaration.name != "main", "Private functions and 'main' stay in the library");
+    }
+    std::vector<uint8_t> bytes;
+    exported.serialize(bytes);
+
+    ModuleInterface loaded;
+    ASSERT_FALSE(loaded.deserialize(bytes.data(), bytes.size(), 7), "An interface for other source is rejected");
+    ASSERT_FALSE(loaded.deserialize(bytes.data(), bytes.size() - 1), "A truncated interface is rejected");
+    ASSERT_TRUE(loaded.deserialize(bytes.data(), bytes.size(), 42), "The interface reads back");
+    ASSERT_STR_EQ("Tasks", loaded.name, "The module keeps its name");
+    ASSERT_EQ((size_t)1, loaded.declarations[1].methods.size(), "Methods travel with their type");
+
+    std::string script =
+        "using Tasks;\n"
+        "fn main(): i32 { return scale(scale(3, 2), 7); }\n";
+    TokenStream script_stream = tokenize_test_source(script);
+    Parser script_parser(script_stream);
+    auto script_result = script_parser.parse();
+    ASSERT_TRUE(script_result.is_success(), "Parser should successfully parse the script");
+    CompilationUnitNode* root = script_result.get_node();
+
+    SymbolTable table;
+    table.add_import(std::make_shared<ModuleInterface>(std::move(loaded)));
+    build_symbol_table(table, root);
+
+    Symbol* scale = table.lookup_symbol_in_scope(0, "scale");
+    ASSERT_TRUE(scale && scale->type == SymbolType::FUNCTION, "Imported functions are declared");
+    Symbol* mode = table.lookup_symbol_in_scope(0, "Mode");
+    ASSERT_TRUE(mode && mode->type == SymbolType::ENUM, "Imported enums are declared");
+    int task_scope = table.find_scope_by_name("Task");
+    ASSERT_TRUE(task_scope != -1 && table.lookup_symbol_in_scope(task_scope, "total"), "Imported types keep their methods");
+    int total_scope = table.find_child_scope(task_scope, "total");
+    ASSERT_TRUE(total_scope != -1 && table.lookup_symbol_in_scope(total_scope, "this"), "Imported methods take 'this'");
+    const StructLayout* imported_layout = table.struct_type_of_scope(task_scope).struct_layout();
+    ASSERT_TRUE(imported_layout != nullptr, "Imported types have a layout");
+    ASSERT_EQ(exported_layout->total_size, imported_layout->total_size, "The exporter's layout is used whatever the importer's policy");
+
+    std::string ir = CommandProcessor::process_to_ir_string(CodeGenerator(table).generate_code(root), "ModuleInterface");
+    ASSERT_TRUE(ir.find("declare i32 @scale(i32, i32)") != std::string::npos, "Calls into the module become external declarations");
+    ASSERT_TRUE(ir.find("define i32 @scale") == std::string::npos, "Imported functions are not generated again");
+
+    ASSERT_TRUE(import_modules(table, root, "/nonexistent").size() == 1, "A missing interface is reported");
+    
+    // A script declaring a name the module exports is told so rather than shadowing it
+    std::string clashing =
+        "using Tasks;\n"
+        "fn scale(i32 value): i32 { return value; }\n"
+        "fn main(): i32 { return scale(3); }\n";
+    TokenStream clashing_stream = tokenize_test_source(clashing);
+    Parser clashing_parser(clashing_stream);
+    auto clashing_result = clashing_parser.parse();
+    ASSERT_TRUE(clashing_result.is_success(), "Parser should successfully parse the clashing script");
+    SymbolTable clashing_table;
+    clashing_table.add_import(table.get_imports()[0]);
+    AstTaskPool pool(1);
+    std::vector<AstPassDiagnostic> clashes = build_symbol_table(clashing_table, clashing_result.get_node(), pool);
+    ASSERT_EQ((size_t)1, clashes.size(), "The clash is reported once");
+    ASSERT_TRUE(clashes[0].message.find("'scale' is declared both here and by module 'Tasks'") != std::string::npos, "The clash names the module");
+
+    return TestResult(true, "Interface of " + std::to_string(bytes.size()) + " bytes imported");
+}
+
+TestResult test_module_interface_benchmark() {
+    // A library of typed helpers the script only needs the signatures of
+    const int library_size = 300;
+    std::string library;
+    for (int i = 0; i < library_size; ++i) {
+        std::string n = std::to_string(i);
+        library += "public fn helper" + n + "(i32 x, i32 y): i32 { var z = x * " + n + " + y; if (z > 100) { return z - 100; } return z; }\n";
+    }
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    TokenStream stream = tokenize_test_source(library);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated library");
+    SymbolTable library_table;
+    build_symbol_table(library_table, result.get_node());
+    double source_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::vector<uint8_t> bytes;
+    ModuleInterface::extract(library_table, result.get_node(), "Helpers").serialize(bytes);
+
+    std::string script = "using Helpers;\nfn main(): i32 { return helper7(1, 2); }\n";
+    TokenStream script_stream = tokenize_test_source(script);
+    Parser script_parser(script_stream);
+    auto script_result = script_parser.parse();
+    ASSERT_TRUE(script_result.is_success(), "Parser should successfully parse the script");
+
+    start = Clock::now();
+    auto module = std::make_shared<ModuleInterface>();
+    ASSERT_TRUE(module->deserialize(bytes.data(), bytes.size()), "The interface reads back");
+    SymbolTable table;
+    table.add_import(std::move(module));
+    build_symbol_table(table, script_result.get_node());
+    double interface_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    ASSERT_TRUE(table.lookup_symbol_in_scope(0, "helper299") != nullptr, "Every helper is declared from the interface");
+
+    LOG_INFO("Module interface: " + std::to_string(library_size) + " functions, " + std::to_string(library.size()) +
+             " bytes of source -> " + std::to_string(bytes.size()) + " bytes of interface; parse + build " +
+             std::to_string(source_ms) + " ms -> load + import " + std::to_string(interface_ms) + " ms", LogCategory::TEST);
+
+    return TestResult(true, "Parse + build " + std::to_string(source_ms) + " ms -> load + import " + std::to_string(interface_ms) + " ms");
+}
+
+void run_module_interface_tests() {
+    TestSuite suite("Module Interface Tests");
+
+    suite.add_test("Module Interface Round Trip", test_module_interface_round_trip);
+    suite.add_test("Module Interface Benchmark", test_module_interface_benchmark);
+
+    suite.run_all();
+}
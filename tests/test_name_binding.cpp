@@ -0,0 +1,182 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "semantic/symbol_table.hpp"
+#include "ast/ast_walker.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+// Collects identifier uses, member accesses and declared variable and parameter names in walk order
+class NameUseCollector : public AstWalker<NameUseCollector> {
+public:
+    using AstWalker<NameUseCollector>::visit;
+    std::vector<IdentifierExpressionNode*> uses;
+    std::vector<MemberAccessExpressionNode*> members;
+    std::vector<IdentifierNode*> declared;
+
+    template <typename T>
+    void record(T* node) {
+        if (auto* use = node->template as<IdentifierExpressionNode>()) uses.push_back(use);
+        if (auto* member = node->template as<MemberAccessExpressionNode>()) members.push_back(member);
+        if (auto* declaration = node->template as<VariableDeclarationNode>()) {
+            for (int i = 0; i < declaration->names.size; ++i) declared.push_back(declaration->names.values[i]);
+        }
+        if (auto* param = node->template as<ParameterNode>()) declared.push_back(param->name);
+        walk_children(node);
+    }
+
+    #define NAME_USE_COLLECTOR_VISIT(NodeType, BaseType) \
+        void visit(NodeType* node) { record(node); }
+    AST_NODE_LIST(NAME_USE_COLLECTOR_VISIT)
+    #undef NAME_USE_COLLECTOR_VISIT
+
+    IdentifierExpressionNode* use_of(const std::string& name, int occurrence = 0) {
+        for (auto* use : uses) {
+            if (use->identifier->name == name && occurrence-- == 0) return use;
+        }
+        return nullptr;
+    }
+
+    MemberAccessExpressionNode* member_of(const std::string& name) {
+        for (auto* member : members) {
+            if (member->member->name == name) return member;
+        }
+        return nullptr;
+    }
+
+    IdentifierNode* declaration_of(const std::string& name, int occurrence = 0) {
+        for (auto* declaration : declared) {
+            if (declaration->name == name && occurrence-- == 0) return declaration;
+        }
+        return nullptr;
+    }
+};
+
+TestResult test_names_bind_to_declarations() {
+    std::string source =
+        "type Point { i32 x; i32 y; fn len(): i32 { return x * x + y; } fn scaled(i32 k): i32 { var x = k; return x * y; } }\n"
+        "fn helper(i32 v): i32 { return v; }\n"
+        "fn main(): i32 {\n"
+        "    var p = new Point();\n"
+        "    var a = 1;\n"
+        "    if (a > 0) { var a = true; var inner = !a; }\n"
+        "    var sum = p.y + a + helper(a) + p.len();\n"
+        "    var lost = missing + p.nothing;\n"
+        "    return sum;\n"
+        "}\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+
+    SymbolTable table;
+    build_symbol_table(table, result.get_node());
+
+    NameUseCollector collector;
+    collector.walk(result.get_node());
+    for (IdentifierNode* declaration : collector.declared) {
+        ASSERT_TRUE(table.get_binding(declaration) != INVALID_SYMBOL_ID, "Every declared name should be bound by the builder");
+    }
+
+    // Block shadowing: the use inside the block sees the block's own declaration
+    SymbolId outer_a = table.get_binding(collector.declaration_of("a", 0));
+    SymbolId inner_a = table.get_binding(collector.declaration_of("a", 1));
+    ASSERT_TRUE(outer_a != inner_a, "Shadowing declarations should be distinct symbols");
+    ASSERT_EQ(outer_a, table.get_binding(collector.use_of("a", 0)), "The condition reads the outer variable");
+    ASSERT_EQ(inner_a, table.get_binding(collector.use_of("a", 1)), "The block reads its own variable");
+    ASSERT_EQ(outer_a, table.get_binding(collector.use_of("a", 2)), "After the block the outer variable is visible again");
+
+    // Fields, parameters, methods and functions
+    int point_scope = table.find_scope_by_name("Point");
+    SymbolId field_x = table.lookup_symbol_in_scope(point_scope, "x")->id;
+    ASSERT_EQ(field_x, table.get_binding(collector.use_of("x", 0)), "Unqualified fields bind to the type's field");
+    ASSERT_EQ(table.get_binding(collector.declaration_of("x", 1)), table.get_binding(collector.use_of("x", 2)),
+              "A local in a method shadows the field");
+    ASSERT_EQ(table.get_binding(collector.declaration_of("k")), table.get_binding(collector.use_of("k")),
+              "Parameter uses bind to the parameter");
+    ASSERT_EQ(table.lookup_symbol_in_scope(point_scope, "y")->id, table.get_binding(collector.member_of("y")),
+              "Member access binds in the target's type");
+    Symbol* method = table.get_bound_symbol(collector.member_of("len"));
+    ASSERT_TRUE(method && method->type == SymbolType::FUNCTION, "Method calls bind to the method");
+    Symbol* helper = table.get_bound_symbol(collector.use_of("helper"));
+    ASSERT_TRUE(helper && helper->type == SymbolType::FUNCTION, "Function calls bind to the function");
+
+    // Unresolved names come back from one place, in source order
+    std::vector<AstNode*> unbound = bind_names(table, result.get_node());
+    ASSERT_EQ((size_t)2, unbound.size(), "The unknown variable and the unknown member should be reported");
+    ASSERT_TRUE(unbound[0] == collector.use_of("missing"), "The unknown variable is reported first");
+    ASSERT_TRUE(unbound[1] == collector.member_of("nothing"), "The unknown member is reported second");
+
+    return TestResult(true, "Every name binds to the symbol its scope declares");
+}
+
+TestResult test_binding_lookup_benchmark() {
+    const int function_count = 64;
+    const int rounds = 200;
+
+    std::string source;
+    for (int f = 0; f < function_count; ++f) {
+        source += "fn f" + std::to_string(f) + "(i32 a, i32 b): i32 { var c = a + b; if (c > a) { var d = c * b; return d + a; } return c; }\n";
+    }
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+
+    SymbolTable table;
+    build_symbol_table(table, result.get_node());
+
+    // Each use paired with the scope codegen would be in when it reached it
+    NameUseCollector collector;
+    collector.walk(result.get_node());
+    std::vector<int> use_scopes;
+    for (IdentifierExpressionNode* use : collector.uses) {
+        SymbolId symbol = table.get_binding(use);
+        ASSERT_TRUE(symbol != INVALID_SYMBOL_ID, "Every use should be bound");
+        use_scopes.push_back(table.get_symbol(symbol)->scope_level);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    size_t found_lookup = 0, found_binding = 0;
+
+    auto start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < collector.uses.size(); ++i) {
+            if (table.lookup_symbol_in_context(collector.uses[i]->identifier->name, use_scopes[i])) found_lookup++;
+        }
+    }
+    double lookup_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (IdentifierExpressionNode* use : collector.uses) {
+            if (table.get_bound_symbol(use)) found_binding++;
+        }
+    }
+    double binding_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    ASSERT_EQ(found_lookup, found_binding, "Both paths should find every use");
+
+    LOG_INFO("Identifier resolution, " + std::to_string(found_binding) + " uses:", LogCategory::TEST);
+    LOG_INFO("  scoped string lookup " + std::to_string(lookup_ms) + " ms, binding " + std::to_string(binding_ms) + " ms",
+             LogCategory::TEST);
+
+    return TestResult(true, "Resolution " + std::to_string(lookup_ms) + " ms -> " + std::to_string(binding_ms) + " ms");
+}
+
+void run_name_binding_tests() {
+    TestSuite suite("Name Binding Tests");
+
+    suite.add_test("Names Bind To Declarations", test_names_bind_to_declarations);
+    suite.add_test("Binding Lookup Benchmark", test_binding_lookup_benchmark);
+
+    suite.run_all();
+}
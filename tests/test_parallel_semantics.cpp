@@ -0,0 +1,146 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "ast/ast_parallel.hpp"
+#include "ast/ast_walker.hpp"
+#include "semantic/symbol_table.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+static std::string generate_semantic_script(int function_count) {
+    std::string source = "type Point { i32 x; i32 y; var scale = 2; fn len(): i32 { var sq = x * x; return sq + y * scale; } }\n";
+    for (int i = 0; i < function_count; ++i) {
+        std::string n = std::to_string(i);
+        source += "fn f" + n + "(i32 a, i32 b): i32 {\n";
+        source += "    var p = new Point();\n";
+        source += "    var d = c + 1;\n";
+        source += "    var c = a * b + p.x;\n";
+        source += "    if (d > " + n + ") { var c = true; var flag = !c; }\n";
+        source += "    for (var i = 0; i < 4; i++) { d = d + i * c; }\n";
+        if (i % 7 == 3) source += "    var loop = loop + 1;\n";
+        if (i % 11 == 5) source += "    var lost = missing + p.nothing;\n";
+        source += "    return d + p.len();\n";
+        source += "}\n";
+    }
+    return source;
+}
+
+// Collects every node of the tree
+class SemanticNodeCollector : public AstWalker<SemanticNodeCollector> {
+public:
+    using AstWalker<SemanticNodeCollector>::visit;
+    std::vector<AstNode*> nodes;
+
+    template <typename T>
+    void record(T* node) {
+        nodes.push_back(node);
+        walk_children(node);
+    }
+
+    #define SEMANTIC_NODE_COLLECTOR_VISIT(NodeType, BaseType) \
+        void visit(NodeType* node) { record(node); }
+    AST_NODE_LIST(SEMANTIC_NODE_COLLECTOR_VISIT)
+    #undef SEMANTIC_NODE_COLLECTOR_VISIT
+};
+
+TestResult test_parallel_build_matches_single_thread() {
+    std::string source = generate_semantic_script(40);
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+    CompilationUnitNode* root = result.get_node();
+
+    SymbolTable serial_table, parallel_table;
+    AstTaskPool serial_pool(1), parallel_pool(4);
+    auto serial_diagnostics = build_symbol_table(serial_table, root, serial_pool);
+    auto parallel_diagnostics = build_symbol_table(parallel_table, root, parallel_pool);
+
+    // The same symbols, in the same scopes, with the same ids and resolved types
+    ASSERT_EQ(serial_table.symbol_count(), parallel_table.symbol_count(), "Both builds should declare the same symbols");
+    ASSERT_EQ(serial_table.scope_count(), parallel_table.scope_count(), "Both builds should open the same scopes");
+    for (SymbolId id = 0; id < serial_table.symbol_count(); ++id) {
+        Symbol* serial = serial_table.get_symbol(id);
+        Symbol* parallel = parallel_table.get_symbol(id);
+        ASSERT_TRUE(serial->name == parallel->name && serial->scope_level == parallel->scope_level,
+                    "Symbols should get the same id and scope");
+        ASSERT_TRUE(serial->resolution_state == parallel->resolution_state && serial->type_name == parallel->type_name,
+                    "Symbols should resolve to the same type");
+    }
+    Symbol* local_c = parallel_table.lookup_symbol_in_scope(parallel_table.find_scope_by_name("f9"), "d");
+    ASSERT_TRUE(local_c && local_c->resolution_state == TypeResolutionState::RESOLVED, "Locals read before their declaration should resolve");
+    ASSERT_STR_EQ("i32", std::string(local_c->type_name), "d reads c, which reads parameters and a field");
+
+    // Every node gets the same expression type, binding and scope
+    SemanticNodeCollector collector;
+    collector.walk(root);
+    for (AstNode* node : collector.nodes) {
+        if (auto* expr = node->as<ExpressionNode>()) {
+            ASSERT_TRUE(serial_table.get_expression_type(expr) == parallel_table.get_expression_type(expr),
+                        "Expression types should match");
+        }
+        ASSERT_EQ(serial_table.get_binding(node), parallel_table.get_binding(node), "Bindings should match");
+        ASSERT_EQ(serial_table.get_node_scope(node), parallel_table.get_node_scope(node), "Node scopes should match");
+    }
+
+    // Cycles and diagnostics arrive in source order regardless of scheduling
+    ASSERT_EQ(serial_table.get_type_cycles().size(), parallel_table.get_type_cycles().size(), "Both builds should find the same cycles");
+    ASSERT_EQ((size_t)6, parallel_table.get_type_cycles().size(), "Each self-referencing loop variable is a cycle");
+    ASSERT_EQ(serial_diagnostics.size(), parallel_diagnostics.size(), "Both builds should report the same diagnostics");
+    for (size_t i = 0; i < serial_diagnostics.size(); ++i) {
+        ASSERT_TRUE(serial_diagnostics[i].node == parallel_diagnostics[i].node &&
+                    serial_diagnostics[i].message == parallel_diagnostics[i].message, "Diagnostics should come back in the same order");
+    }
+    // 6 cycles; 4 bodies with an unknown variable, an unknown member and an uninferable local
+    ASSERT_EQ((size_t)(6 + 4 * 3), parallel_diagnostics.size(), "Cycles, unknown names and failed inference should each be reported");
+
+    return TestResult(true, "Parallel semantic analysis builds the single-threaded table");
+}
+
+TestResult test_parallel_semantics_benchmark() {
+    const int iterations = 5;
+
+    std::string source = generate_semantic_script(450);
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+    CompilationUnitNode* root = result.get_node();
+
+    using Clock = std::chrono::steady_clock;
+    auto time_ms = [&](AstTaskPool& pool) {
+        auto start = Clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            SymbolTable table;
+            build_symbol_table(table, root, pool);
+        }
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / iterations;
+    };
+
+    AstTaskPool serial_pool(1), pool;
+    double serial_ms = time_ms(serial_pool);
+    double parallel_ms = time_ms(pool);
+
+    LOG_INFO("Semantic analysis of " + std::to_string(parser.get_allocator().node_count()) + " nodes:", LogCategory::TEST);
+    LOG_INFO("  1 worker " + std::to_string(serial_ms) + " ms, " + std::to_string(pool.worker_count()) + " workers " +
+             std::to_string(parallel_ms) + " ms", LogCategory::TEST);
+
+    return TestResult(true, std::to_string(pool.worker_count()) + " workers: " + std::to_string(parallel_ms) + " ms");
+}
+
+void run_parallel_semantics_tests() {
+    TestSuite suite("Parallel Semantics Tests");
+
+    suite.add_test("Parallel Build Matches Single Thread", test_parallel_build_matches_single_thread);
+    suite.add_test("Parallel Semantics Benchmark", test_parallel_semantics_benchmark);
+
+    suite.run_all();
+}
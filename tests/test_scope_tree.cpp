@@ -0,0 +1,128 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "semantic/symbol_table.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+TestResult test_scope_tree_links() {
+    std::string source =
+        "type Point { i32 x; i32 y; fn len(): i32 { var total = 0; for (var i = 0; i < 2; i++) { total = total + x; } return total; } }\n"
+        "type Size { i32 w; fn len(): i32 { return w; } }\n"
+        "fn main(): i32 { return 0; }\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+
+    SymbolTable table;
+    build_symbol_table(table, result.get_node());
+
+    int point_scope = table.find_scope_by_name("Point");
+    int size_scope = table.find_scope_by_name("Size");
+    int main_scope = table.find_scope_by_name("main");
+    ASSERT_TRUE(table.get_scope_kind(0) == ScopeKind::GLOBAL, "Scope 0 should be the global scope");
+    ASSERT_TRUE(table.get_scope_kind(point_scope) == ScopeKind::TYPE, "Types should get a TYPE scope");
+    ASSERT_TRUE(table.get_scope_kind(main_scope) == ScopeKind::FUNCTION, "Functions should get a FUNCTION scope");
+    ASSERT_EQ(-1, table.get_owner_type_scope(main_scope), "Top-level functions have no owner type");
+
+    // Member functions are reached from their type without building "Type::name"
+    int point_len = table.find_child_scope(point_scope, "len");
+    int size_len = table.find_child_scope(size_scope, "len");
+    ASSERT_TRUE(point_len != -1 && size_len != -1 && point_len != size_len, "Same-named methods should have distinct scopes");
+    ASSERT_EQ(point_len, table.find_scope_by_name("Point::len"), "Member scopes keep their qualified display name");
+    ASSERT_EQ(point_scope, table.get_parent_scope(point_len), "Member scopes should be children of the type scope");
+    ASSERT_EQ(point_scope, table.get_owner_type_scope(point_len), "Member scopes should link to their type");
+    ASSERT_EQ(-1, table.find_child_scope(point_scope, "missing"), "Unknown children should not be found");
+
+    // Blocks inside a member function inherit the owner link
+    int loop_scope = -1;
+    for (int id = 0; id < (int)table.scope_count(); ++id) {
+        if (table.get_parent_scope(id) == point_len) loop_scope = id;
+    }
+    ASSERT_TRUE(loop_scope != -1, "The for loop should have its own scope");
+    ASSERT_TRUE(table.get_scope_kind(loop_scope) == ScopeKind::BLOCK, "Loops should get a BLOCK scope");
+    ASSERT_EQ(point_scope, table.get_owner_type_scope(loop_scope), "Nested blocks should link to the owner type");
+
+    // Unqualified field access resolves through the owner link
+    table.push_scope(point_len);
+    Symbol* field = table.lookup_symbol("x");
+    ASSERT_TRUE(field != nullptr && field->type == SymbolType::VARIABLE, "Fields should resolve inside member functions");
+    ASSERT_TRUE(table.lookup_symbol("w") == nullptr, "Fields of other types should not resolve");
+    table.pop_scope();
+    ASSERT_TRUE(table.lookup_symbol("x") == nullptr, "Fields should not resolve outside the type");
+
+    return TestResult(true, "Scopes link to their parent and owner type");
+}
+
+TestResult test_scope_tree_field_lookup_benchmark() {
+    const int type_count = 64;
+    const int rounds = 2000;
+
+    std::string source;
+    for (int t = 0; t < type_count; ++t) {
+        std::string n = std::to_string(t);
+        source += "type T" + n + " { i32 a; i32 b; fn run(): i32 { return a + b; } }\n";
+    }
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+
+    SymbolTable table;
+    build_symbol_table(table, result.get_node());
+    std::vector<int> method_scopes;
+    for (int t = 0; t < type_count; ++t) {
+        method_scopes.push_back(table.find_child_scope(table.find_scope_by_name("T" + std::to_string(t)), "run"));
+    }
+
+    using Clock = std::chrono::steady_clock;
+    size_t found_old = 0, found_new = 0;
+
+    // What codegen used to do for each unqualified field: split the scope name and look the type up again
+    auto start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (int scope_id : method_scopes) {
+            std::string scope_name = table.get_scope_name(scope_id);
+            if (scope_name.find("::") == std::string::npos) continue;
+            std::string type_name = scope_name.substr(0, scope_name.find("::"));
+            if (table.lookup_symbol_in_scope(table.find_scope_by_name(type_name), "b")) found_old++;
+        }
+    }
+    double old_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (int scope_id : method_scopes) {
+            int type_scope_id = table.get_owner_type_scope(scope_id);
+            if (type_scope_id != -1 && table.lookup_symbol_in_scope(type_scope_id, "b")) found_new++;
+        }
+    }
+    double new_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    ASSERT_EQ(found_old, found_new, "Both paths should find every field");
+    ASSERT_EQ((size_t)(type_count * rounds), found_new, "Every method should reach its type's field");
+
+    LOG_INFO("Member field lookup, " + std::to_string(found_new) + " lookups:", LogCategory::TEST);
+    LOG_INFO("  scope name parsing " + std::to_string(old_ms) + " ms, owner link " + std::to_string(new_ms) + " ms",
+             LogCategory::TEST);
+
+    return TestResult(true, "Field lookup " + std::to_string(old_ms) + " ms -> " + std::to_string(new_ms) + " ms");
+}
+
+void run_scope_tree_tests() {
+    TestSuite suite("Scope Tree Tests");
+
+    suite.add_test("Scope Tree Links", test_scope_tree_links);
+    suite.add_test("Field Lookup Benchmark", test_scope_tree_field_lookup_benchmark);
+
+    suite.run_all();
+}
@@ -0,0 +1,128 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "semantic/symbol_table.hpp"
+#include "codegen/codegen.hpp"
+#include "codegen/type_context.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+// Field indices of every GEP in emission order
+static std::vector<std::string> gep_indices(const std::vector<Command>& commands) {
+    std::vector<std::string> indices;
+    for (const Command& command : commands) {
+        if (command.op == Op::GEP) indices.push_back(std::get<std::string>(command.data));
+    }
+    return indices;
+}
+
+TestResult test_layout_follows_type_changes() {
+    const std::string main_source =
+        "fn main(): i32 { var p = new Point(); p.y = 3; var a = p.x; var b = p.y; return a + b; }\n";
+    std::string first_source = "type Point { i32 x; i32 y; fn sum(): i32 { return x + y; } }\n" + main_source;
+    std::string second_source = "type Point { i32 y; i32 x; fn sum(): i32 { return x + y; } }\n" + main_source;
+
+    TokenStream first_stream = tokenize_test_source(first_source);
+    Parser first_parser(first_stream);
+    auto first = first_parser.parse();
+    TokenStream second_stream = tokenize_test_source(second_source);
+    Parser second_parser(second_stream);
+    auto second = second_parser.parse();
+    ASSERT_TRUE(first.is_success() && second.is_success(), "Parser should successfully parse both sources");
+
+    SymbolTable table;
+    build_symbol_table(table, first.get_node());
+    CodeGenerator generator(table);
+
+    // Unqualified fields in sum(), then the assignment and the two reads in main()
+    std::vector<std::string> expected = { "0", "1", "1", "0", "1" };
+    auto indices = gep_indices(generator.generate_code(first.get_node()));
+    ASSERT_TRUE(indices == expected, "Fields should index in declaration order");
+    ASSERT_TRUE(gep_indices(generator.generate_code(first.get_node())) == expected, "A reused layout should index the same");
+
+    // Rebuilding the table with the fields swapped must not reuse the old layout
+    uint64_t old_version = table.get_scope_version(table.find_type_scope("Point"));
+    table.clear();
+    build_symbol_table(table, second.get_node());
+    ASSERT_TRUE(table.get_scope_version(table.find_type_scope("Point")) != old_version,
+                "A rebuilt type scope should carry a new version");
+
+    std::vector<std::string> swapped = { "1", "0", "0", "1", "0" };
+    ASSERT_TRUE(gep_indices(generator.generate_code(second.get_node())) == swapped,
+                "A changed type should be laid out again");
+
+    return TestResult(true, "Layouts are reused until their type changes");
+}
+
+// What codegen used to do for every member access: lay the type out again and scan its fields by name
+static int legacy_field_index(SymbolTable& table, const std::string& type_name, const std::string& member) {
+    std::vector<StructLayout::Field> fields;
+    for (Symbol* symbol : table.get_all_symbols_in_scope(table.find_scope_by_name(type_name))) {
+        if (symbol->type == SymbolType::VARIABLE) fields.push_back({ std::string(symbol->name), symbol->data_type, 0 });
+    }
+    const StructLayout* layout = TypeContext::global().struct_type(type_name, fields).struct_layout();
+    for (size_t i = 0; i < layout->fields.size(); ++i) {
+        if (layout->fields[i].name == member) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+TestResult test_member_access_benchmark() {
+    const int field_count = 32;
+    const int reads = 400;
+
+    std::string source = "type Wide {";
+    for (int f = 0; f < field_count; ++f) source += " i32 f" + std::to_string(f) + ";";
+    source += " }\nfn main(): i32 {\n    var w = new Wide();\n";
+    std::vector<std::string> members;
+    for (int i = 0; i < reads; ++i) {
+        members.push_back("f" + std::to_string((i * 7) % field_count));
+        source += "    var v" + std::to_string(i) + " = w." + members.back() + ";\n";
+    }
+    source += "    return 0;\n}\n";
+
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+
+    SymbolTable table;
+    build_symbol_table(table, result.get_node());
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    std::vector<std::string> legacy;
+    for (const std::string& member : members) legacy.push_back(std::to_string(legacy_field_index(table, "Wide", member)));
+    double legacy_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    CodeGenerator generator(table);
+    auto commands = generator.generate_code(result.get_node());
+    double codegen_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    ASSERT_TRUE(gep_indices(commands) == legacy, "Cached lookups should pick the same fields as a rebuilt layout");
+
+    LOG_INFO("Member access on a " + std::to_string(field_count) + "-field type, " + std::to_string(reads) + " reads:",
+             LogCategory::TEST);
+    LOG_INFO("  per-access layout rebuild alone " + std::to_string(legacy_ms) + " ms, whole codegen with cached layout " +
+             std::to_string(codegen_ms) + " ms", LogCategory::TEST);
+
+    return TestResult(true, "Layout work " + std::to_string(legacy_ms) + " ms -> codegen " + std::to_string(codegen_ms) + " ms");
+}
+
+void run_struct_layout_cache_tests() {
+    TestSuite suite("Struct Layout Cache Tests");
+
+    suite.add_test("Layout Follows Type Changes", test_layout_follows_type_changes);
+    suite.add_test("Member Access Benchmark", test_member_access_benchmark);
+
+    suite.run_all();
+}
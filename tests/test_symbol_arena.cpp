@@ -0,0 +1,173 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "semantic/symbol_table.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+TestResult test_scope_symbols_small_and_indexed() {
+    ScopeSymbols scope;
+    const int count = 40;
+
+    for (int i = 0; i < count; ++i) {
+        // Spread the name ids out so the index sees collisions and wrap-around
+        ASSERT_TRUE(scope.insert(static_cast<NameId>(i * 7), static_cast<SymbolId>(100 + i)), "New names should insert");
+        ASSERT_TRUE(!scope.insert(static_cast<NameId>(i * 7), 999), "Duplicate names should be rejected");
+        ASSERT_EQ((size_t)(i + 1), scope.size(), "Size should count distinct names");
+
+        for (int j = 0; j <= i; ++j) {
+            ASSERT_EQ((SymbolId)(100 + j), scope.find(static_cast<NameId>(j * 7)), "Every inserted name should be found");
+        }
+        ASSERT_EQ(INVALID_SYMBOL_ID, scope.find(static_cast<NameId>(i * 7 + 1)), "Missing names should not be found");
+    }
+
+    auto entries = scope.entries();
+    for (int i = 0; i < count; ++i) {
+        ASSERT_EQ((NameId)(i * 7), entries[i].name, "Entries should stay in declaration order");
+    }
+
+    return TestResult(true, "Scope tables work below and above the inline capacity");
+}
+
+TestResult test_symbol_table_arena_and_interning() {
+    SymbolTable table;
+    ASSERT_TRUE(table.declare_symbol("first", SymbolType::VARIABLE, IRType::i32(), "i32"), "Declare should succeed");
+    Symbol* first = table.lookup_symbol("first");
+    ASSERT_TRUE(first != nullptr, "Declared symbol should be found");
+    ASSERT_TRUE(!table.declare_symbol("first", SymbolType::VARIABLE, IRType::i32(), "i32"), "Redeclaring in one scope should fail");
+
+    // Enough declarations to grow the arena many times over
+    table.enter_named_scope("inner");
+    for (int i = 0; i < 2000; ++i) {
+        table.declare_symbol("local" + std::to_string(i), SymbolType::VARIABLE, IRType::i32(), "i32");
+    }
+    table.exit_scope();
+
+    ASSERT_TRUE(table.lookup_symbol("first") == first, "Symbol pointers should stay valid as the arena grows");
+    ASSERT_TRUE(table.get_symbol(first->id) == first, "SymbolId should map back to the symbol");
+    ASSERT_EQ((size_t)2001, table.symbol_count(), "Arena should hold every symbol");
+
+    Symbol* local = table.lookup_symbol_in_scope(table.find_scope_by_name("inner"), "local1999");
+    ASSERT_TRUE(local != nullptr, "Symbols in large scopes should be found");
+    ASSERT_TRUE(local->type_name.data() == first->type_name.data(), "Equal type names should share interned storage");
+    ASSERT_TRUE(table.lookup_symbol("local5") == nullptr, "Inner symbols should not be visible from the global scope");
+    ASSERT_EQ(INVALID_NAME_ID, table.find_name("never_declared"), "Unknown names should have no id");
+    ASSERT_EQ(first->name_id, table.find_name("first"), "Names should intern to the symbol's id");
+
+    table.clear();
+    ASSERT_EQ((size_t)0, table.symbol_count(), "Clear should empty the arena");
+    ASSERT_TRUE(table.lookup_symbol("first") == nullptr, "Clear should forget names");
+
+    return TestResult(true, "Symbols are stable, addressable by id and share interned names");
+}
+
+TestResult test_struct_fields_in_declaration_order() {
+    std::string source = "type Vec { i32 z; i32 a; i32 m; bool flag; i32 b; }\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+
+    SymbolTable table;
+    build_symbol_table(table, result.get_node());
+    auto fields = table.get_all_symbols_in_scope(table.find_scope_by_name("Vec"));
+    ASSERT_EQ((size_t)5, fields.size(), "All fields should be in the type scope");
+
+    const char* expected[] = { "z", "a", "m", "flag", "b" };
+    for (size_t i = 0; i < fields.size(); ++i) {
+        ASSERT_STR_EQ(expected[i], fields[i]->name, "Fields should come back in declaration order");
+    }
+
+    return TestResult(true, "Scope contents follow declaration order");
+}
+
+TestResult test_symbol_lookup_benchmark() {
+    const int scope_count = 64;
+    const int names_per_scope = 6;
+    const int rounds = 200;
+
+    SymbolTable table;
+    std::vector<std::unordered_map<std::string, std::shared_ptr<Symbol>>> baseline(scope_count);
+    std::vector<int> scope_ids;
+    std::vector<std::string> queries;
+    for (int s = 0; s < scope_count; ++s) {
+        table.enter_named_scope("scope" + std::to_string(s));
+        scope_ids.push_back(table.find_scope_by_name("scope" + std::to_string(s)));
+        for (int n = 0; n < names_per_scope; ++n) {
+            std::string name = "value_" + std::to_string(n);
+            table.declare_symbol(name, SymbolType::VARIABLE, IRType::i32(), "i32");
+            baseline[s][name] = std::make_shared<Symbol>(*table.lookup_symbol_in_scope(scope_ids.back(), name));
+            queries.push_back(name);
+        }
+        table.exit_scope();
+    }
+
+    using Clock = std::chrono::steady_clock;
+    size_t found_old = 0, found_new = 0;
+
+    auto start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (int s = 0; s < scope_count; ++s) {
+            for (int n = 0; n < names_per_scope; ++n) {
+                auto it = baseline[s].find(queries[n]);
+                std::shared_ptr<Symbol> symbol = it != baseline[s].end() ? it->second : nullptr;
+                if (symbol) found_old++;
+            }
+        }
+    }
+    double old_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (int s = 0; s < scope_count; ++s) {
+            for (int n = 0; n < names_per_scope; ++n) {
+                if (table.lookup_symbol_in_scope(scope_ids[s], queries[n])) found_new++;
+            }
+        }
+    }
+    double new_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    // Passes that intern names up front skip the string hash entirely
+    std::vector<NameId> query_ids;
+    for (int n = 0; n < names_per_scope; ++n) query_ids.push_back(table.find_name(queries[n]));
+    size_t found_ids = 0;
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (int s = 0; s < scope_count; ++s) {
+            for (int n = 0; n < names_per_scope; ++n) {
+                if (table.lookup_symbol_id_in_scope(scope_ids[s], query_ids[n]) != INVALID_SYMBOL_ID) found_ids++;
+            }
+        }
+    }
+    double id_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    ASSERT_EQ(found_old, found_new, "Both tables should find every name");
+    ASSERT_EQ(found_old, found_ids, "Id lookups should find every name");
+
+    LOG_INFO("Symbol lookup, " + std::to_string(found_new) + " lookups in scopes of " + std::to_string(names_per_scope) + ":", LogCategory::TEST);
+    LOG_INFO("  string map + shared_ptr " + std::to_string(old_ms) + " ms, interned arena " + std::to_string(new_ms) +
+             " ms, by NameId " + std::to_string(id_ms) + " ms", LogCategory::TEST);
+
+    return TestResult(true, "Lookups " + std::to_string(old_ms) + " ms -> " + std::to_string(new_ms) + " ms");
+}
+
+void run_symbol_arena_tests() {
+    TestSuite suite("Symbol Arena Tests");
+
+    suite.add_test("Scope Symbols Small And Indexed", test_scope_symbols_small_and_indexed);
+    suite.add_test("Symbol Table Arena And Interning", test_symbol_table_arena_and_interning);
+    suite.add_test("Struct Fields In Declaration Order", test_struct_fields_in_declaration_order);
+    suite.add_test("Symbol Lookup Benchmark", test_symbol_lookup_benchmark);
+
+    suite.run_all();
+}
@@ -0,0 +1,151 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "codegen/type_context.hpp"
+#include "semantic/symbol_table.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+static StructLayout::Field layout_field(const std::string& name, IRType type) {
+    StructLayout::Field field;
+    field.name = name;
+    field.type = type;
+    field.offset = 0;
+    return field;
+}
+
+TestResult test_types_are_canonical() {
+    TypeContext& types = TypeContext::global();
+    ASSERT_TRUE(sizeof(IRType) <= 8, "A type should be a small handle");
+
+    // Pointers are found again by their pointee
+    IRType i32_ptr = IRType::ptr_to(IRType::i32());
+    ASSERT_TRUE(i32_ptr == IRType::ptr_to(IRType::i32()), "Equal pointers should share an id");
+    ASSERT_TRUE(i32_ptr != IRType::ptr_to(IRType::i64()), "Pointers to different types should differ");
+    ASSERT_TRUE(i32_ptr != IRType::ptr(), "A typed pointer is not the bare pointer");
+    ASSERT_TRUE(i32_ptr.pointee() && *i32_ptr.pointee() == IRType::i32(), "The pointee should be kept");
+    ASSERT_TRUE(IRType::ptr().pointee() == nullptr, "The bare pointer has no pointee");
+    ASSERT_TRUE(IRType::ptr_to(i32_ptr).pointee()->pointee() != nullptr, "Pointers should nest");
+
+    // Structs are identified by name and fields, and laid out once
+    IRType pair = types.struct_type("ContextPair", { layout_field("tag", IRType::i8()), layout_field("value", IRType::i32()) });
+    IRType same = types.struct_type("ContextPair", { layout_field("tag", IRType::i8()), layout_field("value", IRType::i32()) });
+    IRType wider = types.struct_type("ContextPair", { layout_field("tag", IRType::i8()), layout_field("value", IRType::i64()) });
+    ASSERT_TRUE(pair == same, "Equal structs should share an id");
+    ASSERT_TRUE(pair.struct_layout() == same.struct_layout(), "Equal structs should share one layout");
+    ASSERT_TRUE(pair != wider, "A struct with other fields is another type");
+    ASSERT_EQ((size_t)4, pair.struct_layout()->fields[1].offset, "Fields should be aligned");
+    ASSERT_EQ((size_t)8, pair.size_in_bytes(), "The struct should be padded to its alignment");
+    ASSERT_EQ((size_t)16, wider.size_in_bytes(), "Wider fields should widen the struct");
+    ASSERT_STR_EQ("struct.ContextPair", pair.to_string(), "Structs print by name");
+
+    IRType outer = types.struct_type("ContextOuter", { layout_field("flag", IRType::bool_()), layout_field("inner", wider) });
+    ASSERT_EQ((size_t)8, outer.struct_layout()->fields[1].offset, "Nested structs should align to their own alignment");
+    ASSERT_EQ((size_t)24, outer.size_in_bytes(), "Nested structs should count their full size");
+
+    // Source type names go through the same context
+    std::string source = "type Box { i32 value; bool full; }\nfn main(): i32 { return 0; }\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+    SymbolTable table;
+    build_symbol_table(table, result.get_node());
+
+    ASSERT_TRUE(table.string_to_ir_type("i32") == IRType::i32(), "Primitive names should map to their kind");
+    ASSERT_TRUE(table.string_to_ir_type("string") == IRType::ptr(), "Strings are pointers");
+    IRType box = table.string_to_ir_type("Box");
+    ASSERT_TRUE(box.kind == IRType::Kind::Struct && box == table.string_to_ir_type("Box"), "Declared types should be canonical structs");
+    ASSERT_EQ((size_t)2, box.struct_layout()->fields.size(), "The struct should carry the declared fields");
+    IRType generic = table.string_to_ir_type("Box<i32, Box>");
+    ASSERT_TRUE(generic == table.string_to_ir_type("Box<i32, Box>"), "Generic instances should be canonical");
+    ASSERT_TRUE(generic != table.string_to_ir_type("Box<i32, bool>"), "Different arguments make a different instance");
+    ASSERT_TRUE(generic.kind == IRType::Kind::Ptr, "Generic instances are references");
+
+    // A host compiling again starts from the bare kinds
+    TypeContext compilation;
+    size_t bare = compilation.size();
+    IRType first = compilation.struct_type("ContextPair", { layout_field("tag", IRType::i8()), layout_field("value", IRType::i32()) });
+    compilation.struct_type("ContextOuter", { layout_field("flag", IRType::bool_()) });
+    ASSERT_EQ(bare + 2, compilation.size(), "Each struct is one entry");
+    compilation.reset();
+    ASSERT_EQ(bare, compilation.size(), "A reset forgets every struct");
+    ASSERT_TRUE(compilation.struct_layout(first.id + 1) == nullptr, "Ids from before a reset find nothing");
+    IRType again = compilation.struct_type("ContextPair", { layout_field("tag", IRType::i8()), layout_field("value", IRType::i32()) });
+    ASSERT_TRUE(again.id == first.id && compilation.struct_layout(again.id)->total_size == 8, "Types are laid out again after a reset");
+
+    return TestResult(true, "Every type has one canonical id");
+}
+
+// How types were represented before: every copy bumps reference counts and
+// equality walks the pointee chain
+struct LegacyType {
+    IRType::Kind kind;
+    std::shared_ptr<LegacyType> pointee_type;
+
+    bool operator==(const LegacyType& other) const {
+        if (kind != other.kind) return false;
+        if (!pointee_type || !other.pointee_type) return !pointee_type && !other.pointee_type;
+        return *pointee_type == *other.pointee_type;
+    }
+};
+
+TestResult test_type_context_benchmark() {
+    const int count = 20000;
+    const int depth = 3;
+
+    std::vector<LegacyType> legacy;
+    std::vector<IRType> interned;
+    for (int i = 0; i < count; ++i) {
+        IRType::Kind base = i % 2 ? IRType::Kind::I32 : IRType::Kind::I64;
+        LegacyType old_type{base, nullptr};
+        IRType type(base);
+        for (int d = 0; d < depth; ++d) {
+            old_type = LegacyType{IRType::Kind::Ptr, std::make_shared<LegacyType>(old_type)};
+            type = IRType::ptr_to(type);
+        }
+        legacy.push_back(old_type);
+        interned.push_back(type);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    size_t equal_old = 0, equal_new = 0;
+
+    // Copy every type and compare it against the one two back, which has the same base
+    auto start = Clock::now();
+    std::vector<LegacyType> legacy_copy = legacy;
+    for (int i = 2; i < count; ++i) equal_old += legacy_copy[i] == legacy_copy[i - 2];
+    double old_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    std::vector<IRType> interned_copy = interned;
+    for (int i = 2; i < count; ++i) equal_new += interned_copy[i] == interned_copy[i - 2];
+    double new_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    ASSERT_EQ(equal_old, equal_new, "Both representations should agree on equality");
+    ASSERT_EQ((size_t)(count - 2), equal_new, "Types built the same way should be equal");
+
+    LOG_INFO("Copying and comparing " + std::to_string(count) + " pointer types of depth " + std::to_string(depth) + ":", LogCategory::TEST);
+    LOG_INFO("  shared_ptr chains " + std::to_string(old_ms) + " ms, interned ids " + std::to_string(new_ms) + " ms, " +
+             std::to_string(TypeContext::global().size()) + " distinct types", LogCategory::TEST);
+
+    return TestResult(true, "Copy and compare " + std::to_string(old_ms) + " ms -> " + std::to_string(new_ms) + " ms");
+}
+
+void run_type_context_tests() {
+    TestSuite suite("Type Context Tests");
+
+    suite.add_test("Types Are Canonical", test_types_are_canonical);
+    suite.add_test("Type Context Benchmark", test_type_context_benchmark);
+
+    suite.run_all();
+}
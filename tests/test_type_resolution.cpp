@@ -0,0 +1,100 @@
+#include "test/test_framework.hpp"
+#include "test/lexer_test_helpers.hpp"
+#include "parser/parser.h"
+#include "parser/lexer.hpp"
+#include "parser/token_stream.hpp"
+#include "semantic/symbol_table.hpp"
+#include "common/logger.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace Mycelium::Testing;
+using namespace Mycelium::Scripting::Lang;
+using namespace Mycelium;
+
+TestResult test_deep_inference_chain() {
+    // One block's statement array has to fit in a single allocator page
+    const int depth = 400;
+
+    // Each variable reads the next one, so declaration order is the reverse of resolution order
+    std::string source = "fn main(): i32 {\n";
+    for (int i = 0; i < depth; ++i) {
+        source += "    var v" + std::to_string(i) + " = v" + std::to_string(i + 1) + " + 1;\n";
+    }
+    source += "    var v" + std::to_string(depth) + " = 2;\n";
+    source += "    return 0;\n}\n";
+
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse generated script");
+
+    SymbolTable table;
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    build_symbol_table(table, result.get_node());
+    double build_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    int main_scope = table.find_scope_by_name("main");
+    for (int i = 0; i <= depth; ++i) {
+        Symbol* symbol = table.lookup_symbol_in_scope(main_scope, "v" + std::to_string(i));
+        ASSERT_TRUE(symbol != nullptr, "Every chain variable should be declared");
+        ASSERT_TRUE(symbol->resolution_state == TypeResolutionState::RESOLVED, "Every chain variable should resolve");
+        ASSERT_STR_EQ("i32", std::string(symbol->type_name), "Chain variables should infer i32");
+    }
+    ASSERT_TRUE(table.get_type_cycles().empty(), "A chain has no cycles");
+
+    LOG_INFO("Type resolution of a " + std::to_string(depth) + "-deep var chain: build and resolve " +
+             std::to_string(build_ms) + " ms", LogCategory::TEST);
+
+    return TestResult(true, "Resolved a chain of depth " + std::to_string(depth));
+}
+
+TestResult test_dependency_cycles_reported() {
+    std::string source =
+        "fn main(): i32 {\n"
+        "    var a = b;\n"
+        "    var b = c;\n"
+        "    var c = a;\n"
+        "    var d = 1;\n"
+        "    var e = a;\n"
+        "    var s = s + 1;\n"
+        "    return 0;\n"
+        "}\n";
+    TokenStream stream = tokenize_test_source(source);
+    Parser parser(stream);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.is_success(), "Parser should successfully parse source");
+
+    SymbolTable table;
+    build_symbol_table(table, result.get_node());
+    ASSERT_TRUE(!table.resolve_all_types(), "Resolution should report failure while cycles remain");
+
+    const auto& cycles = table.get_type_cycles();
+    ASSERT_EQ((size_t)2, cycles.size(), "The three-way cycle and the self-reference should be reported");
+    ASSERT_EQ((size_t)3, cycles[0].size(), "The first cycle should have exactly three members");
+    const char* expected[] = { "a", "b", "c" };
+    for (size_t i = 0; i < cycles[0].size(); ++i) {
+        ASSERT_STR_EQ(expected[i], std::string(table.get_symbol(cycles[0][i])->name), "Cycle members come back in declaration order");
+    }
+    ASSERT_EQ((size_t)1, cycles[1].size(), "A self-reference is a cycle of one");
+    ASSERT_STR_EQ("s", std::string(table.get_symbol(cycles[1][0])->name), "The self-referencing symbol should be named");
+
+    int main_scope = table.find_scope_by_name("main");
+    ASSERT_TRUE(table.lookup_symbol_in_scope(main_scope, "d")->resolution_state == TypeResolutionState::RESOLVED,
+                "Symbols outside cycles should still resolve");
+    ASSERT_TRUE(table.lookup_symbol_in_scope(main_scope, "e")->resolution_state == TypeResolutionState::UNRESOLVED,
+                "Symbols reading a cycle stay unresolved without being cycle members");
+
+    return TestResult(true, "Cycles are reported with their exact members");
+}
+
+void run_type_resolution_tests() {
+    TestSuite suite("Type Resolution Tests");
+
+    suite.add_test("Deep Inference Chain", test_deep_inference_chain);
+    suite.add_test("Dependency Cycles Reported", test_dependency_cycles_reported);
+
+    suite.run_all();
+}